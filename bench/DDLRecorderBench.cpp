@@ -9,19 +9,27 @@
 
 #include "bench/Benchmark.h"
 
+#include "include/core/SkBBHFactory.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkDeferredDisplayListRecorder.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkString.h"
 #include "include/core/SkSurfaceCharacterization.h"
 #include "include/gpu/GrDirectContext.h"
+#include "src/base/SkRandom.h"
+#include "tools/DDLTileHelper.h"
 
-static SkSurfaceCharacterization create_characterization(GrDirectContext* direct) {
+static SkSurfaceCharacterization create_characterization(GrDirectContext* direct,
+                                                         int width = 32, int height = 32) {
     size_t maxResourceBytes = direct->getResourceCacheLimit();
 
     if (!direct->colorTypeSupportedAsSurface(kRGBA_8888_SkColorType)) {
         return SkSurfaceCharacterization();
     }
 
-    SkImageInfo ii = SkImageInfo::Make(32, 32, kRGBA_8888_SkColorType,
+    SkImageInfo ii = SkImageInfo::Make(width, height, kRGBA_8888_SkColorType,
                                        kPremul_SkAlphaType, nullptr);
 
     GrBackendFormat backendFormat = direct->defaultBackendFormat(kRGBA_8888_SkColorType,
@@ -92,3 +100,114 @@ private:
 };
 
 DEF_BENCH(return new DDLRecorderBench();)
+
+// This benchmark measures how the recording of a tiled frame scales with the number of
+// recording threads. Each run splits the same picture into a grid of tiles (via DDLTileHelper)
+// and records all the tile DDLs, plus the compose DDL, on a dedicated thread pool.
+// Most of the picture's content is clustered in one corner so the tiles' costs are uneven.
+class DDLTiledRecorderBench : public Benchmark {
+public:
+    DDLTiledRecorderBench(int numThreads, DDLTileHelper::SchedulingPolicy policy)
+            : fNumThreads(numThreads)
+            , fPolicy(policy) {
+        fName.printf("DDLRecorder_tiled_%dx%d_%dthreads%s",
+                     kNumDivisions, kNumDivisions, fNumThreads,
+                     policy == DDLTileHelper::SchedulingPolicy::kCostliestFirst
+                             ? "_costliestFirst" : "");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return kGPU_Backend == backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(kSize, kSize), &factory);
+
+        SkRandom rand;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < kNumDraws; ++i) {
+            // Three out of four draws land in the top-left quarter of the picture
+            SkScalar extent = (i % 4) ? kSize / 4.0f : kSize;
+            SkScalar x = rand.nextRangeScalar(0, extent - 32);
+            SkScalar y = rand.nextRangeScalar(0, extent - 32);
+            paint.setColor(rand.nextU() | 0xFF000000);
+
+            switch (i % 3) {
+                case 0:
+                    canvas->drawRect(SkRect::MakeXYWH(x, y, 24, 24), paint);
+                    break;
+                case 1:
+                    canvas->drawCircle(x + 12, y + 12, 12, paint);
+                    break;
+                default: {
+                    SkPath path;
+                    path.moveTo(x, y);
+                    path.cubicTo(x + 32, y, x, y + 32, x + 32, y + 32);
+                    path.lineTo(x, y + 24);
+                    canvas->drawPath(path, paint);
+                    break;
+                }
+            }
+        }
+
+        fPicture = recorder.finishRecordingAsPicture();
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fNumThreads);
+    }
+
+    void onDraw(int loops, SkCanvas* origCanvas) override {
+        if (!fTiles) {
+            return;
+        }
+
+        for (int i = 0; i < loops; ++i) {
+            fTiles->createDDLsInParallel(fPicture.get(), fExecutor.get());
+            fTiles->resetAllTiles();
+        }
+    }
+
+private:
+    void onPerCanvasPreDraw(SkCanvas* origCanvas) override {
+        auto context = origCanvas->recordingContext()->asDirectContext();
+        if (!context) {
+            return;
+        }
+
+        SkSurfaceCharacterization c = create_characterization(context, kSize, kSize);
+        if (!c.isValid()) {
+            return;
+        }
+
+        fTiles = std::make_unique<DDLTileHelper>(context, c, SkIRect::MakeWH(kSize, kSize),
+                                                 kNumDivisions, kNumDivisions,
+                                                 /* addRandomPaddingToDst */ false);
+        fTiles->setSchedulingPolicy(fPolicy);
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        fTiles.reset();
+    }
+
+    static constexpr int kSize = 1024;
+    static constexpr int kNumDivisions = 4;
+    static constexpr int kNumDraws = 4000;
+
+    const int                              fNumThreads;
+    const DDLTileHelper::SchedulingPolicy  fPolicy;
+    SkString                               fName;
+    sk_sp<SkPicture>                       fPicture;
+    std::unique_ptr<SkExecutor>            fExecutor;
+    std::unique_ptr<DDLTileHelper>         fTiles;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new DDLTiledRecorderBench(1, DDLTileHelper::SchedulingPolicy::kRowMajor);)
+DEF_BENCH(return new DDLTiledRecorderBench(2, DDLTileHelper::SchedulingPolicy::kRowMajor);)
+DEF_BENCH(return new DDLTiledRecorderBench(4, DDLTileHelper::SchedulingPolicy::kRowMajor);)
+DEF_BENCH(return new DDLTiledRecorderBench(8, DDLTileHelper::SchedulingPolicy::kRowMajor);)
+DEF_BENCH(return new DDLTiledRecorderBench(4, DDLTileHelper::SchedulingPolicy::kCostliestFirst);)
+DEF_BENCH(return new DDLTiledRecorderBench(8, DDLTileHelper::SchedulingPolicy::kCostliestFirst);)
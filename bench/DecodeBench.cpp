@@ -6,11 +6,16 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkStream.h"
 #include "modules/skottie/include/Skottie.h"
 #include "tools/Resources.h"
 
+#include <algorithm>
+#include <memory>
+
 class DecodeBench : public Benchmark {
 protected:
     DecodeBench(const char* name, const char* source)
@@ -54,6 +59,78 @@ private:
     using INHERITED = DecodeBench;
 };
 
+// Like a network or a chunked storage layer, delivers the encoded image kChunkSize bytes at a
+// time. The stream is not in memory as far as the codecs can tell.
+class ChunkedStream final : public SkStream {
+public:
+    static constexpr size_t kChunkSize = 4096;
+
+    ChunkedStream(sk_sp<SkData> data)
+        : fSize(data->size())
+        , fStream(std::move(data)) {}
+
+    void addChunk() { fAvailable = std::min(fSize, fAvailable + kChunkSize); }
+
+    bool isAllDataAvailable() const { return fAvailable == fSize; }
+
+    size_t read(void* buffer, size_t size) override {
+        return fStream.read(buffer, std::min(size, fAvailable - fStream.getPosition()));
+    }
+    bool isAtEnd() const override { return fStream.isAtEnd(); }
+    bool rewind() override { return fStream.rewind(); }
+
+private:
+    const size_t   fSize;
+    size_t         fAvailable = std::min(fSize, kChunkSize);
+    SkMemoryStream fStream;
+};
+
+// Decodes an image with SkCodec's incremental decoder, adding one chunk of the image to the
+// stream each time the decoder runs out of data.
+class ChunkedDecodeBench final : public DecodeBench {
+public:
+    ChunkedDecodeBench(const char* name, const char* source)
+        : INHERITED(name, source)
+    {}
+
+    void onDelayedSetup() override {
+        INHERITED::onDelayedSetup();
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fData);
+        SkASSERT(codec);
+        fBitmap.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType)
+                                            .makeAlphaType(kPremul_SkAlphaType));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            auto stream = std::make_unique<ChunkedStream>(fData);
+            ChunkedStream* chunks = stream.get();
+            // The first chunk holds the headers of all of the images below.
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromStream(std::move(stream));
+            SkASSERT(codec);
+
+            SkCodec::Result result;
+            while (SkCodec::kIncompleteInput == (result = codec->startIncrementalDecode(
+                           fBitmap.info(), fBitmap.getPixels(), fBitmap.rowBytes()))) {
+                chunks->addChunk();
+            }
+            SkASSERT(SkCodec::kSuccess == result);
+
+            while (SkCodec::kIncompleteInput == (result = codec->incrementalDecode())) {
+                if (chunks->isAllDataAvailable()) {
+                    break;
+                }
+                chunks->addChunk();
+            }
+            SkASSERT(SkCodec::kSuccess == result);
+        }
+    }
+
+private:
+    SkBitmap fBitmap;
+
+    using INHERITED = DecodeBench;
+};
 
 class SkottieDecodeBench final : public DecodeBench {
 public:
@@ -233,3 +310,14 @@ DEF_BENCH(return new BitmapDecodeBench("png_small"    /*  32x  32*/, "images/man
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_connecting"   , "images/Connecting.png"));
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_generic_error", "images/Generic_Error.png"));
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_onboard"      , "images/Onboard.png"));
+
+DEF_BENCH(return new ChunkedDecodeBench("chunked_gif"           /*640x479*/,
+                                        "images/test640x479.gif"));
+DEF_BENCH(return new ChunkedDecodeBench("chunked_webp_lossy"    /*400x301*/,
+                                        "images/yellow_rose.webp"));
+DEF_BENCH(return new ChunkedDecodeBench("chunked_webp_lossless" /*320x240*/,
+                                        "images/webp-color-profile-lossless.webp"));
+DEF_BENCH(return new ChunkedDecodeBench("chunked_jpeg"          /*512x512*/,
+                                        "images/mandrill_512_q075.jpg"));
+DEF_BENCH(return new ChunkedDecodeBench("chunked_jpeg_progressive" /*512x512*/,
+                                        "images/brickwork-texture.jpg"));
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/DecodeCorpusBench.h"
+
+#include "bench/CodecBenchPriv.h"
+#include "include/codec/SkAndroidCodec.h"
+#include "tools/ProcStats.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+using Subset = DecodeCorpusBench::Subset;
+
+static const char* subset_to_str(Subset subset) {
+    switch (subset) {
+        case Subset::kFull:
+            return "Full";
+        case Subset::kTile:
+            return "Tile";
+        case Subset::kStrip:
+            return "Strip";
+    }
+    SkUNREACHABLE;
+}
+
+// Returns false if the image is too small for subset at sampleSize.
+static bool make_src_rect(SkISize dimensions, int sampleSize, Subset subset, SkIRect* srcRect) {
+    switch (subset) {
+        case Subset::kFull:
+            *srcRect = SkIRect::MakeSize(dimensions);
+            return true;
+        case Subset::kTile: {
+            const int size = DecodeCorpusBench::kTileSize * sampleSize;
+            if (size > dimensions.width() || size > dimensions.height()) {
+                return false;
+            }
+            *srcRect = SkIRect::MakeXYWH((dimensions.width() - size) / 2,
+                                         (dimensions.height() - size) / 2, size, size);
+            return true;
+        }
+        case Subset::kStrip: {
+            const int height = dimensions.height() / 8;
+            *srcRect = SkIRect::MakeXYWH(0, (dimensions.height() - height) / 2,
+                                         dimensions.width(), height);
+            return !srcRect->isEmpty();
+        }
+    }
+    SkUNREACHABLE;
+}
+
+DecodeCorpusBench* DecodeCorpusBench::Make(SkString basename, sk_sp<SkData> encoded,
+                                           SkColorType colorType, int sampleSize,
+                                           Subset subset) {
+    std::unique_ptr<SkAndroidCodec> codec = SkAndroidCodec::MakeFromData(encoded);
+    if (!codec) {
+        return nullptr;
+    }
+
+    SkIRect srcRect;
+    if (!make_src_rect(codec->getInfo().dimensions(), sampleSize, subset, &srcRect) ||
+        !codec->getSupportedSubset(&srcRect)) {
+        return nullptr;
+    }
+    if (10 * sampleSize > std::min(srcRect.width(), srcRect.height())) {
+        // Avoid benchmarking scaled decodes of already small images.
+        return nullptr;
+    }
+
+    SkAndroidCodec::AndroidOptions options;
+    options.fSampleSize = sampleSize;
+    SkISize dimensions = codec->getSampledDimensions(sampleSize);
+    if (Subset::kFull != subset) {
+        options.fSubset = &srcRect;
+        dimensions = codec->getSampledSubsetDimensions(sampleSize, srcRect);
+    }
+    SkImageInfo info = codec->getInfo().makeDimensions(dimensions).makeColorType(colorType);
+    if (kUnpremul_SkAlphaType == info.alphaType()) {
+        info = info.makeAlphaType(kPremul_SkAlphaType);
+    }
+
+    // Make sure we can decode to this color type.
+    SkAutoMalloc storage(info.computeMinByteSize());
+    switch (codec->getAndroidPixels(info, storage.get(), info.minRowBytes(), &options)) {
+        case SkCodec::kSuccess:
+        case SkCodec::kIncompleteInput:
+            break;
+        default:
+            return nullptr;
+    }
+
+    SkString name;
+    name.printf("DecodeCorpus_%s_%s_SampleSize%d_%s", basename.c_str(),
+                color_type_to_str(colorType), sampleSize, subset_to_str(subset));
+    return new DecodeCorpusBench(std::move(name), std::move(encoded), info, sampleSize, subset,
+                                 srcRect, codec->estimateDecodeCost(info, &options));
+}
+
+DecodeCorpusBench::DecodeCorpusBench(SkString name, sk_sp<SkData> encoded,
+                                     const SkImageInfo& info, int sampleSize, Subset subset,
+                                     const SkIRect& srcRect, const SkCodec::DecodeCost& cost)
+    : fName(std::move(name))
+    , fData(std::move(encoded))
+    , fInfo(info)
+    , fSampleSize(sampleSize)
+    , fSubset(subset)
+    , fSrcRect(srcRect)
+    , fCost(cost)
+{}
+
+const char* DecodeCorpusBench::onGetName() {
+    return fName.c_str();
+}
+
+bool DecodeCorpusBench::isSuitableFor(Backend backend) {
+    return kNonRendering_Backend == backend;
+}
+
+void DecodeCorpusBench::onDelayedSetup() {
+    fPixelStorage.reset(fInfo.computeMinByteSize());
+}
+
+SkCodec::Result DecodeCorpusBench::decode(void* pixels) const {
+    SkAndroidCodec::AndroidOptions options;
+    options.fSampleSize = fSampleSize;
+    if (Subset::kFull != fSubset) {
+        options.fSubset = &fSrcRect;
+    }
+    std::unique_ptr<SkAndroidCodec> codec = SkAndroidCodec::MakeFromData(fData);
+    return codec->getAndroidPixels(fInfo, pixels, fInfo.minRowBytes(), &options);
+}
+
+void DecodeCorpusBench::onDraw(int n, SkCanvas*) {
+    for (int i = 0; i < n; i++) {
+#ifdef SK_DEBUG
+        const SkCodec::Result result =
+#endif
+        this->decode(fPixelStorage.get());
+        SkASSERT(result == SkCodec::kSuccess || result == SkCodec::kIncompleteInput);
+    }
+}
+
+int64_t DecodeCorpusBench::measurePeakBytes() const {
+    if (!sk_tools::resetPeakResidentSetSize()) {
+        return -1;
+    }
+    const int64_t before = sk_tools::getCurrResidentSetSizeBytes();
+    {
+        SkAutoMalloc pixels(fInfo.computeMinByteSize());
+        this->decode(pixels.get());
+    }
+    const int64_t peak = sk_tools::getPeakResidentSetSizeBytes();
+    if (before < 0 || peak < 0) {
+        return -1;
+    }
+    return std::max<int64_t>(peak - before, 0);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef DecodeCorpusBench_DEFINED
+#define DecodeCorpusBench_DEFINED
+
+#include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkString.h"
+#include "src/base/SkAutoMalloc.h"
+
+/**
+ *  Times SkAndroidCodec decodes of an image from the --images corpus, to one color type,
+ *  sample size and subset shape, and estimates their cost with
+ *  SkAndroidCodec::estimateDecodeCost() so that the estimate can be compared to the timing.
+ */
+class DecodeCorpusBench : public Benchmark {
+public:
+    enum class Subset {
+        kFull,   // The whole image.
+        kTile,   // A square in the middle that decodes to kTileSize pixels on a side.
+        kStrip,  // Rows across the middle, an eighth of the image's height.
+    };
+    static constexpr int kSubsetCount = 3;
+    static constexpr int kTileSize = 512;
+
+    /**
+     *  Returns nullptr if the image cannot be decoded to colorType, or is too small to be
+     *  decoded with sampleSize or subset.
+     */
+    static DecodeCorpusBench* Make(SkString basename, sk_sp<SkData> encoded,
+                                   SkColorType colorType, int sampleSize, Subset subset);
+
+    // The source pixels that each decode covers, in millions.
+    double srcMegapixels() const { return fSrcRect.width() * (double) fSrcRect.height() / 1e6; }
+
+    size_t dstBytes() const { return fInfo.computeMinByteSize(); }
+
+    const SkCodec::DecodeCost& estimatedCost() const { return fCost; }
+
+    /**
+     *  Decodes once, into newly allocated pixels, and returns how much the process's peak
+     *  resident set size grew, or -1 if that cannot be measured on this platform. This is a
+     *  lower bound on what the decode allocates, since memory that the allocator reuses, or
+     *  that is already resident, is not counted.
+     */
+    int64_t measurePeakBytes() const;
+
+protected:
+    const char* onGetName() override;
+    bool isSuitableFor(Backend backend) override;
+    void onDraw(int n, SkCanvas* canvas) override;
+    void onDelayedSetup() override;
+
+private:
+    SkCodec::Result decode(void* pixels) const;
+
+    DecodeCorpusBench(SkString name, sk_sp<SkData> encoded, const SkImageInfo& info,
+                      int sampleSize, Subset subset, const SkIRect& srcRect,
+                      const SkCodec::DecodeCost& cost);
+
+    const SkString            fName;
+    const sk_sp<SkData>       fData;
+    const SkImageInfo         fInfo;
+    const int                 fSampleSize;
+    const Subset              fSubset;
+    const SkIRect             fSrcRect;
+    const SkCodec::DecodeCost fCost;
+    SkAutoMalloc              fPixelStorage;  // Set in onDelayedSetup.
+
+    using INHERITED = Benchmark;
+};
+
+#endif  // DecodeCorpusBench_DEFINED
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkFontMgr.h"
+#include "include/core/SkFontStyle.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTypeface.h"
+
+#include <vector>
+
+/**
+ *  Measures SkFontMgr::matchFamilyStyleCharacter the way text layout calls it:
+ *  mixed-script text where every codepoint the primary font lacks is looked up again.
+ */
+class FontFallbackBench : public Benchmark {
+public:
+    FontFallbackBench(const char* name, const char* language) : fLanguage(language) {
+        fName.printf("fontfallback_%s", name);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fFontMgr = SkFontMgr::RefDefault();
+        // A few characters from each of the common scripts
+        const SkUnichar ranges[][2] = {
+            { 0x0041, 0x005A },   // Latin
+            { 0x0410, 0x042F },   // Cyrillic
+            { 0x05D0, 0x05EA },   // Hebrew
+            { 0x0627, 0x064A },   // Arabic
+            { 0x0905, 0x0939 },   // Devanagari
+            { 0x0E01, 0x0E2E },   // Thai
+            { 0x3041, 0x3096 },   // Hiragana
+            { 0x4E00, 0x4E80 },   // CJK
+            { 0xAC00, 0xAC80 },   // Hangul
+            { 0x1F600, 0x1F640 }, // Emoji
+        };
+        fCharacters.clear();
+        for (int i = 0; i < 128; ++i) {
+            for (const auto& range : ranges) {
+                fCharacters.push_back(range[0] + (i * 7) % (range[1] - range[0] + 1));
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const char* bcp47[] = { fLanguage };
+        const int bcp47Count = fLanguage ? 1 : 0;
+        for (int loop = 0; loop < loops; ++loop) {
+            for (SkUnichar character : fCharacters) {
+                sk_sp<SkTypeface> typeface = fFontMgr->matchFamilyStyleCharacter(
+                        nullptr, SkFontStyle(), bcp47, bcp47Count, character);
+            }
+        }
+    }
+
+private:
+    SkString fName;
+    const char* fLanguage;
+    sk_sp<SkFontMgr> fFontMgr;
+    std::vector<SkUnichar> fCharacters;
+};
+
+DEF_BENCH(return new FontFallbackBench("mixed", nullptr);)
+DEF_BENCH(return new FontFallbackBench("mixed_ja", "ja");)
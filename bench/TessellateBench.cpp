@@ -107,6 +107,7 @@ protected:
         for (int i = 0; i < loops; ++i) {
             this->runBench();
             fTarget->resetAllocator();
+            ++fFrame;
         }
     }
 
@@ -114,6 +115,7 @@ protected:
 
     SkString fName;
     std::unique_ptr<GrMockOpTarget> fTarget;
+    int fFrame = 0;
     const SkPath fPath;
     const SkMatrix fMatrix;
 };
@@ -156,6 +158,19 @@ DEF_PATH_TESS_BENCH(GrPathWedgeTessellator, make_cubic_path(8), SkMatrix::I()) {
                   fPath.countVerbs());
 }
 
+// Simulates panning over a large path: the translation changes every frame, but the scale/skew and
+// the path do not, so after the first frame the patches are found in the PatchCache.
+DEF_PATH_TESS_BENCH(GrPathWedgeTessellator_cached_pan, make_cubic_path(8), SkMatrix::I()) {
+    SkArenaAlloc arena(1024);
+    auto tess = PathWedgeTessellator::Make(&arena,
+                                           fTarget->caps().shaderCaps()->fInfinitySupport);
+    SkMatrix shaderMatrix = SkMatrix::Translate(fFrame % 256, (fFrame / 256) % 256);
+    tess->prepareWithPatchCache(fTarget.get(),
+                                shaderMatrix,
+                                {gAlmostIdentity, fPath, SK_PMColor4fTRANSPARENT},
+                                fPath.countVerbs());
+}
+
 static void benchmark_wangs_formula_cubic_log2(const SkMatrix& matrix, const SkPath& path) {
     int sum = 0;
     wangs_formula::VectorXform xform(matrix);
@@ -313,10 +328,12 @@ public:
     TessPrepareBench(MakePathStrokesFn makePathStrokesFn,
                      PatchAttribs attribs,
                      float matrixScale,
-                     const char* suffix)
+                     const char* suffix,
+                     bool panWithPatchCache = false)
             : fMakePathStrokesFn(makePathStrokesFn)
             , fPatchAttribs(attribs)
-            , fMatrixScale(matrixScale) {
+            , fMatrixScale(matrixScale)
+            , fPanWithPatchCache(panWithPatchCache) {
         fName.printf("tessellate_%s", suffix);
     }
 
@@ -344,10 +361,19 @@ private:
 
     void onDraw(int loops, SkCanvas*) final {
         for (int i = 0; i < loops; ++i) {
-            fTessellator->prepare(fTarget.get(),
-                                  SkMatrix::Scale(fMatrixScale, fMatrixScale),
-                                  fPathStrokes.data(),
-                                  fTotalVerbCount);
+            SkMatrix matrix = SkMatrix::Scale(fMatrixScale, fMatrixScale);
+            if (fPanWithPatchCache) {
+                matrix.postTranslate(i % 256, (i / 256) % 256);
+                fTessellator->prepareWithPatchCache(fTarget.get(),
+                                                    matrix,
+                                                    fPathStrokes.data(),
+                                                    fTotalVerbCount);
+            } else {
+                fTessellator->prepare(fTarget.get(),
+                                      matrix,
+                                      fPathStrokes.data(),
+                                      fTotalVerbCount);
+            }
             fTarget->resetAllocator();
         }
     }
@@ -356,6 +382,7 @@ private:
     MakePathStrokesFn fMakePathStrokesFn;
     const PatchAttribs fPatchAttribs;
     float fMatrixScale;
+    const bool fPanWithPatchCache;
     std::unique_ptr<GrMockOpTarget> fTarget;
     std::vector<PathStrokeList> fPathStrokes;
     std::unique_ptr<StrokeTessellator> fTessellator;
@@ -378,4 +405,9 @@ DEF_BENCH(return new TessPrepareBench(
         "GrStrokeFixedCountTessellator_motionmark");
 )
 
+DEF_BENCH(return new TessPrepareBench(
+        make_simple_cubic_path, PatchAttribs::kNone, 1,
+        "GrStrokeFixedCountTessellator_cached_pan", /*panWithPatchCache=*/true);
+)
+
 }  // namespace skgpu::ganesh
@@ -13,6 +13,7 @@
 #include "bench/Benchmark.h"
 #include "bench/CodecBench.h"
 #include "bench/CodecBenchPriv.h"
+#include "bench/DecodeCorpusBench.h"
 #include "bench/GMBench.h"
 #include "bench/MSKPBench.h"
 #include "bench/RecordingBench.h"
@@ -173,6 +174,9 @@ static DEFINE_string(images, "",
                      " is treated as a fatal error.");
 static DEFINE_bool(simpleCodec, false,
                    "Runs of a subset of the codec tests, always N32, Premul or Opaque");
+static DEFINE_bool(decodeCorpus, false,
+                   "Also time decodes of --images at each color type, sample size and subset "
+                   "shape, and report their throughput and estimated cost.");
 
 static DEFINE_string2(match, m, nullptr,
                "[~][^]substring[$] [...] of name to run.\n"
@@ -1145,6 +1149,44 @@ public:
             fCurrentSampleSize = 0;
         }
 
+        // Run DecodeCorpusBenches
+        const int decodeSampleSizes[] = { 1, 2, 4, 8 };
+        for (; FLAGS_decodeCorpus && fCurrentDecodeImage < fImages.size(); fCurrentDecodeImage++) {
+            fSourceType = "image";
+            fBenchType = "decode";
+
+            const SkString& path = fImages[fCurrentDecodeImage];
+            if (CommandLineFlags::ShouldSkip(FLAGS_match, path.c_str())) {
+                continue;
+            }
+            sk_sp<SkData> encoded(SkData::MakeFromFileName(path.c_str()));
+
+            while (fCurrentColorType < fColorTypes.size()) {
+                while (fCurrentSampleSize < (int) std::size(decodeSampleSizes)) {
+                    while (fCurrentDecodeSubset < DecodeCorpusBench::kSubsetCount) {
+                        const auto subset = (DecodeCorpusBench::Subset) fCurrentDecodeSubset++;
+                        DecodeCorpusBench* bench = DecodeCorpusBench::Make(
+                                SkOSPath::Basename(path.c_str()), encoded,
+                                fColorTypes[fCurrentColorType],
+                                decodeSampleSizes[fCurrentSampleSize], subset);
+                        if (bench) {
+                            fDecodeMegapixels = bench->srcMegapixels();
+                            fDecodeEstimatedPeakBytes = bench->dstBytes() +
+                                                        bench->estimatedCost().fScratchBytes;
+                            fDecodeMeasuredPeakBytes = bench->measurePeakBytes();
+                            fDecodeWork = bench->estimatedCost().fWork;
+                            return bench;
+                        }
+                    }
+                    fCurrentDecodeSubset = 0;
+                    fCurrentSampleSize++;
+                }
+                fCurrentSampleSize = 0;
+                fCurrentColorType++;
+            }
+            fCurrentColorType = 0;
+        }
+
 #ifdef SK_ENABLE_ANDROID_UTILS
         // Run the BRDBenches
         // We intend to create benchmarks that model the use cases in
@@ -1246,11 +1288,21 @@ public:
         }
     }
 
-    void fillCurrentMetrics(NanoJSONResultsWriter& log) const {
+    void fillCurrentMetrics(NanoJSONResultsWriter& log, double minMs) const {
         if (0 == strcmp(fBenchType, "recording")) {
             log.appendMetric("bytes", fSKPBytes);
             log.appendMetric("ops", fSKPOps);
         }
+        if (0 == strcmp(fBenchType, "decode")) {
+            log.appendMetric("megapixels", fDecodeMegapixels);
+            log.appendMetric("megapixels_per_second",
+                             sk_ieee_double_divide(fDecodeMegapixels, minMs * 1e-3));
+            log.appendMetric("estimated_work", fDecodeWork);
+            log.appendMetric("estimated_peak_bytes", fDecodeEstimatedPeakBytes);
+            if (fDecodeMeasuredPeakBytes >= 0) {
+                log.appendMetric("measured_peak_bytes", fDecodeMeasuredPeakBytes);
+            }
+        }
     }
 
 private:
@@ -1283,6 +1335,9 @@ private:
 
     double fSKPBytes, fSKPOps;
 
+    // Set with each DecodeCorpusBench.
+    double fDecodeMegapixels, fDecodeEstimatedPeakBytes, fDecodeMeasuredPeakBytes, fDecodeWork;
+
     const char* fSourceType;  // What we're benching: bench, GM, SKP, ...
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording = 0;
@@ -1294,6 +1349,8 @@ private:
     int fCurrentTextBlobTrace = 0;
     int fCurrentCodec = 0;
     int fCurrentAndroidCodec = 0;
+    int fCurrentDecodeImage = 0;
+    int fCurrentDecodeSubset = 0;
 #ifdef SK_ENABLE_ANDROID_UTILS
     int fCurrentBRDImage = 0;
     int fCurrentSubsetType = 0;
@@ -1569,7 +1626,7 @@ int main(int argc, char** argv) {
                 log.appendDoubleDigits(sample, 16);
             }
             log.endArray(); // samples
-            benchStream.fillCurrentMetrics(log);
+            benchStream.fillCurrentMetrics(log, stats.min);
             if (!keys.empty()) {
                 // dump to json, only SKPBench currently returns valid keys / values
                 SkASSERT(keys.size() == values.size());
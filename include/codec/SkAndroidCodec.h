@@ -257,6 +257,13 @@ public:
      */
     SkCodec::Result getAndroidPixels(const SkImageInfo& info, void* pixels, size_t rowBytes);
 
+    /**
+     *  Estimates the cost of getAndroidPixels() with the same info and options, e.g. to pick a
+     *  sample size. See SkCodec::estimateDecodeCost().
+     */
+    SkCodec::DecodeCost estimateDecodeCost(const SkImageInfo& info,
+                                           const AndroidOptions* options = nullptr) const;
+
     SkCodec::Result getPixels(const SkImageInfo& info, void* pixels, size_t rowBytes) {
         return this->getAndroidPixels(info, pixels, rowBytes);
     }
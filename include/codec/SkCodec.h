@@ -27,12 +27,14 @@
 #include <vector>
 
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
 class SkSampler;
 class SkStream;
 struct SkGainmapInfo;
+struct SkSamplingOptions;
 enum SkAlphaType : int;
 enum class SkEncodedImageFormat;
 
@@ -298,6 +300,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -341,6 +344,15 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, codecs that support it split the work of a getPixels() or
+         *  incremental decode between the threads of this executor. Currently only
+         *  PNG does, converting rows to the dst format on the executor while the
+         *  rows after them are inflated and unfiltered on the calling thread. The
+         *  executor must outlive the decode.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -391,6 +403,61 @@ public:
         return this->getPixels(pm.info(), pm.writable_addr(), pm.rowBytes(), opts);
     }
 
+    /**
+     *  Decode the first frame into dst, resizing it to dst's dimensions with sampling.
+     *
+     *  Unlike a getPixels() at full size followed by SkPixmap::scalePixels(), this does
+     *  not allocate a full resolution intermediate when it can avoid it. If the codec can
+     *  scale natively (e.g. JPEG), it decodes at the smallest supported size that is at
+     *  least as large as dst. The scanlines are then converted to dst's color type and
+     *  color space one at a time and filtered straight into dst, holding only the rows
+     *  that the filter reaches. This applies to kRGBA_8888 and kBGRA_8888 dsts that are
+     *  premultiplied or opaque, and to codecs that support top down scanline decoding;
+     *  anything else falls back to decoding the intermediate and scaling it.
+     *
+     *  If a scanline decode is in progress, scanline mode will end.
+     *
+     *  @return Result kSuccess, kIncompleteInput if the missing rows were filled before
+     *      resizing, or another value explaining the type of failure.
+     */
+    Result getResizedPixels(const SkPixmap& dst, const SkSamplingOptions& sampling);
+
+    /**
+     *  An estimate of what a decode costs, made from the encoded headers without decoding.
+     */
+    struct DecodeCost {
+        /**
+         *  The work the decode does, in units of decoding one pixel of a sequential (not
+         *  progressive or interlaced) image and writing it to the destination. This is
+         *  comparable across codecs and images, so it can be used to balance decodes across
+         *  threads, or to compare the decodes of an image at different sizes.
+         */
+        double fWork = 0;
+
+        /**
+         *  Bytes that the decoder allocates for the decode, in addition to the destination.
+         */
+        size_t fScratchBytes = 0;
+    };
+
+    /**
+     *  Estimates the cost of getPixels() (or an incremental decode) to dstInfo with options.
+     *
+     *  The estimate accounts for the decoded area (the subset, or the whole image), the frames
+     *  that have to be decoded to get to options->fFrameIndex, and what the codec knows about
+     *  the encoding, e.g. that a JPEG is progressive or that a PNG is interlaced.
+     *
+     *  dstInfo may be smaller than the decoded area, as it is for a sampled
+     *  SkAndroidCodec decode. The estimate then assumes that every pixel in the decoded area is
+     *  still decompressed, but only the pixels in dstInfo are converted, unless the codec can
+     *  decompress at a smaller size (e.g. a JPEG's scaled IDCT).
+     *
+     *  dstInfo and options are not validated, and an estimate does not imply that the decode
+     *  would succeed.
+     */
+    DecodeCost estimateDecodeCost(const SkImageInfo& dstInfo,
+                                  const Options* options = nullptr) const;
+
     /**
      *  Return an image containing the pixels.
      */
@@ -891,6 +958,15 @@ protected:
         return 0;
     }
 
+    /**
+     *  Adjusts cost, which already holds the estimate for a sequential decode of srcRect to
+     *  dstInfo, by the costs that are specific to how the image is encoded (e.g. extra passes,
+     *  whole image buffers, or decompressing at a smaller size).
+     */
+    virtual void onEstimateDecodeCost(const SkImageInfo& /*dstInfo*/,
+                                      const SkIRect& /*srcRect*/,
+                                      DecodeCost*) const {}
+
 private:
     const SkEncodedInfo                fEncodedInfo;
     XformFormat                        fSrcXformFormat;
@@ -17,7 +17,6 @@
 
 #if defined(SK_GRAPHITE)
 #include "include/gpu/graphite/GraphiteTypes.h"
-class SkYUVAPixmaps;
 #endif
 
 #include <cstddef>
@@ -40,6 +39,7 @@ class SkPicture;
 class SkPixmap;
 class SkShader;
 class SkSurfaceProps;
+class SkYUVAPixmaps;
 enum SkColorType : int;
 enum class SkEncodedImageFormat;
 enum class SkTextureCompressionType;
@@ -230,6 +230,24 @@ SK_API sk_sp<SkImage> RasterFromData(const SkImageInfo& info,
                                      sk_sp<SkData> pixels,
                                      size_t rowBytes);
 
+/** Creates CPU-backed SkImage from SkYUVAPixmaps, converting the planes to N32 pixels.
+    This is the raster counterpart of TextureFromYUVAPixmaps(). For example, a JPEG can be
+    decoded with SkCodec::getYUVAPlanes() and converted here, instead of SkCodec::getPixels().
+    The SkColorSpace of the resulting RGB values is specified by imageColorSpace.
+    SkYUVAPixmaps does not need to remain valid after this returns.
+
+    SkImage is returned if the planes hold 8-bit channels, are 4:4:4, 4:2:2, 4:2:0 or 4:4:0
+    subsampled with centered siting, and have kTopLeft_SkEncodedOrigin. The image is opaque
+    unless the planes have alpha.
+
+    @param pixmaps          The planes as pixmaps with supported SkYUVAInfo that
+                            specifies conversion to RGB.
+    @param imageColorSpace  range of colors of the resulting image; may be nullptr
+    @return                 created SkImage, or nullptr
+*/
+SK_API sk_sp<SkImage> RasterFromYUVAPixmaps(const SkYUVAPixmaps& pixmaps,
+                                            sk_sp<SkColorSpace> imageColorSpace = nullptr);
+
 }  // namespace SkImages
 
 /** \class SkImage
@@ -15,6 +15,7 @@
 
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkJpegEncoderMgr;
 class SkPixmap;
 class SkWStream;
@@ -85,6 +86,17 @@ public:
          */
         const skcms_ICCProfile* fICCProfile = nullptr;
         const char* fICCProfileDescription = nullptr;
+
+        /**
+         *  If set, Encode() splits a large enough |src| into horizontal stripes, encodes them
+         *  concurrently on |fExecutor|, and joins them with restart markers into a single
+         *  baseline jpeg.  Because each stripe must share the same Huffman tables, this uses
+         *  libjpeg's standard tables rather than tables optimized for the image, so the
+         *  output is somewhat larger.
+         *
+         *  This is ignored by Make() and when encoding an SkYUVAPixmaps.
+         */
+        SkExecutor* fExecutor = nullptr;
     };
 
     /**
@@ -127,7 +139,10 @@ private:
                                            const SkPixmap* src,
                                            const SkYUVAPixmaps* srcYUVA,
                                            const SkColorSpace* srcYUVAColorSpace,
-                                           const Options& options);
+                                           const Options& options,
+                                           int restartInterval = 0);
+
+    static bool EncodeStripes(SkWStream* dst, const SkPixmap& src, const Options& options);
 
     std::unique_ptr<SkJpegEncoderMgr> fEncoderMgr;
     const SkYUVAPixmaps* fSrcYUVA = nullptr;
@@ -48,6 +48,12 @@ namespace SkWebpEncoder {
          */
         const skcms_ICCProfile* fICCProfile = nullptr;
         const char* fICCProfileDescription = nullptr;
+
+        /**
+         *  Passed to libwebp as |thread_level|.  If non-zero, libwebp may use a worker
+         *  thread, e.g. to encode the alpha plane of a lossy image alongside the color.
+         */
+        int fThreadLevel = 0;
     };
 
     /**
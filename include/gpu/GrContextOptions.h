@@ -105,6 +105,13 @@ struct SK_API GrContextOptions {
      */
     SkExecutor* fExecutor = nullptr;
 
+    /**
+     * If true (and fExecutor is set), flushes first do the CPU heavy part of preparing the ops
+     * that support it (e.g., triangulating paths) concurrently on fExecutor's threads. The ops are
+     * then prepared and executed in order on the flushing thread, as usual.
+     */
+    bool fThreadedOpPrepare = false;
+
     /** Construct mipmaps manually, via repeated downsampling draw-calls. This is used when
         the driver's implementation (glGenerateMipmap) contains bugs. This requires mipmap
         level control (ie desktop or ES3). */
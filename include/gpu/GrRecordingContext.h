@@ -222,6 +222,9 @@ protected:
         int numPathMaskCacheHits() const { return fNumPathMaskCacheHits; }
         void incNumPathMasksCacheHits() { fNumPathMaskCacheHits++; }
 
+        int numThreadedOpPrepares() const { return fNumThreadedOpPrepares; }
+        void incNumThreadedOpPrepares() { fNumThreadedOpPrepares++; }
+
 #if GR_TEST_UTILS
         void dump(SkString* out) const;
         void dumpKeyValuePairs(skia_private::TArray<SkString>* keys,
@@ -231,10 +234,12 @@ protected:
     private:
         int fNumPathMasksGenerated{0};
         int fNumPathMaskCacheHits{0};
+        int fNumThreadedOpPrepares{0};
 
 #else // GR_GPU_STATS
         void incNumPathMasksGenerated() {}
         void incNumPathMasksCacheHits() {}
+        void incNumThreadedOpPrepares() {}
 
 #if GR_TEST_UTILS
         void dump(SkString*) const {}
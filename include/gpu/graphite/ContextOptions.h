@@ -8,6 +8,8 @@
 #ifndef skgpu_graphite_ContextOptions_DEFINED
 #define skgpu_graphite_ContextOptions_DEFINED
 
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
 #include "include/private/base/SkAPI.h"
 
 namespace skgpu { class ShaderErrorHandler; }
@@ -17,6 +19,24 @@ namespace skgpu::graphite {
 struct SK_API ContextOptions {
     ContextOptions() {}
 
+    /**
+     * Abstract class which stores Skia data in a cache that persists between sessions. Currently,
+     * Skia stores the compiled backend shaders (e.g. MSL or SPIR-V) of the graphics pipelines it
+     * creates, keyed by a description of the pipeline that is stable across runs. The methods can
+     * be called from any thread that creates pipelines so implementations must be thread safe.
+     */
+    class SK_API PersistentPipelineStorage {
+    public:
+        virtual ~PersistentPipelineStorage() = default;
+
+        /**
+         * Returns the data previously stored for 'key', or null if there is none.
+         */
+        virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+        virtual void store(const SkData& key, const SkData& data) = 0;
+    };
+
     /**
      * Disables correctness workarounds that are enabled for particular GPUs, OSes, or drivers.
      * This does not affect code path choices that are made for perfomance reasons nor does it
@@ -30,6 +50,12 @@ struct SK_API ContextOptions {
      */
     skgpu::ShaderErrorHandler* fShaderErrorHandler = nullptr;
 
+    /**
+     * If present, the compiled shaders of graphics pipelines are loaded from and stored in this
+     * object so that later sessions can skip generating and compiling them.
+     */
+    PersistentPipelineStorage* fPersistentPipelineStorage = nullptr;
+
     /**
      * Will the client make sure to only ever be executing one thread that uses the Context and all
      * derived classes (e.g. Recorders, Recordings, etc.) at a time. If so we can possibly make some
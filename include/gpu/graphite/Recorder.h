@@ -41,6 +41,7 @@ class Device;
 class DrawBufferManager;
 class GlobalCache;
 class ImageProvider;
+class PipelineKeyCollector;
 class ProxyCache;
 class RecorderPriv;
 class ResourceProvider;
@@ -134,6 +135,20 @@ public:
     // Recording snap, at which point it is deleted.
     SkCanvas* makeDeferredCanvas(const SkImageInfo&, const TextureInfo&);
 
+    // Totals of the draws and binding changes encoded by all the DrawPasses this Recorder has
+    // created, e.g. to measure how well a client's draws batch. These are plain counters that are
+    // updated when a DrawPass is made, so they are always available.
+    struct DrawPassStats {
+        int fNumDrawPasses = 0;
+        int fNumDrawSteps = 0;
+        int fNumCulledDraws = 0;   // draws hidden by later opaque draws
+        int fPipelineChanges = 0;
+        int fUniformChanges = 0;   // geometry or shading uniform rebinds
+        int fTextureChanges = 0;
+    };
+    const DrawPassStats& drawPassStats() const { return fDrawPassStats; }
+    void resetDrawPassStats() { fDrawPassStats = {}; }
+
     // Provides access to functions that aren't part of the public API.
     RecorderPriv priv();
     const RecorderPriv priv() const;  // NOLINT(readability-const-return-type)
@@ -191,6 +206,7 @@ private:
     std::unique_ptr<sktext::gpu::TextBlobRedrawCoordinator> fTextBlobCache;
     std::unique_ptr<ProxyCache> fProxyCache;
     sk_sp<ImageProvider> fClientImageProvider;
+    PipelineKeyCollector* fPipelineKeyCollector = nullptr;
 
     // In debug builds we guard against improper thread handling
     // This guard is passed to the ResourceCache.
@@ -203,6 +219,8 @@ private:
 
     skia_private::TArray<sk_sp<RefCntedCallback>> fFinishedProcs;
 
+    DrawPassStats fDrawPassStats;
+
 #if GRAPHITE_TEST_UTILS
     // For testing use only -- the Context used to create this Recorder
     Context* fContext = nullptr;
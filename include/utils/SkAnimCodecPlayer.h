@@ -12,12 +12,17 @@
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSize.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+class SkExecutor;
 class SkImage;
+class SkTaskGroup;
 
 class SkAnimCodecPlayer {
 public:
@@ -51,16 +56,59 @@ public:
      */
     bool seek(uint32_t msec);
 
+    /**
+     *  Limits the memory used to keep decoded frames for later calls to getFrame(). Past the
+     *  limit, the least recently used frames are released, key frames (see
+     *  setKeyFrameInterval()) last. The current frame is always kept. Defaults to no limit.
+     */
+    void setFrameCacheLimit(size_t bytes);
+
+    /**
+     *  When a frame depends on frames that are not decoded yet, those are decoded first, and
+     *  every interval'th of them is kept as a key frame. A later seek then only replays the
+     *  frames after the closest key frame, instead of every frame back to one that can be
+     *  decoded on its own. Defaults to 8.
+     */
+    void setKeyFrameInterval(int interval);
+
+    /**
+     *  If not null, getFrame() decodes the following frame on executor while the caller draws
+     *  the current one, as long as that frame only depends on frames that are already decoded.
+     *  The executor must outlive this player, or a later call to this method.
+     */
+    void setDecodeAheadExecutor(SkExecutor* executor);
+
+    /**
+     *  Returns the number of bytes used by the decoded frames that are kept.
+     */
+    size_t frameCacheBytes();
 
 private:
     std::unique_ptr<SkCodec>        fCodec;
     SkImageInfo                     fImageInfo;
     std::vector<SkCodec::FrameInfo> fFrameInfos;
     std::vector<sk_sp<SkImage> >    fImages;
+    // For each frame, the value of fUseCount when it was last returned or decoded.
+    std::vector<uint64_t>           fLastUse SK_GUARDED_BY(fMutex);
+    uint64_t                        fUseCount SK_GUARDED_BY(fMutex) = 0;
+    size_t                          fCacheBytes SK_GUARDED_BY(fMutex) = 0;
+    size_t                          fCacheLimit SK_GUARDED_BY(fMutex) = SIZE_MAX;
+    int                             fKeyFrameInterval SK_GUARDED_BY(fMutex) = 8;
+    int                             fDecodeAheadIndex SK_GUARDED_BY(fMutex) = -1;
     int                             fCurrIndex = 0;
     uint32_t                        fTotalDuration;
 
-    sk_sp<SkImage> getFrameAt(int index);
+    // Guards decoding with fCodec and the decoded frames in fImages, which are shared with the
+    // decode ahead tasks.
+    SkMutex                         fMutex;
+    std::unique_ptr<SkTaskGroup>    fDecodeAhead;
+
+    sk_sp<SkImage> getFrameAt(int index) SK_REQUIRES(fMutex);
+    sk_sp<SkImage> decodeFrame(int index, const sk_sp<SkImage>& requiredImage)
+            SK_REQUIRES(fMutex);
+    void cacheFrame(int index, sk_sp<SkImage> image) SK_REQUIRES(fMutex);
+    void purgeFrames() SK_REQUIRES(fMutex);
+    void decodeAhead();
 };
 
 #endif
@@ -7,6 +7,7 @@
 #include <set>
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkRefCnt.h"
+#include "include/private/base/SkMutex.h"
 #include "modules/skparagraph/include/FontArguments.h"
 #include "modules/skparagraph/include/ParagraphCache.h"
 #include "modules/skparagraph/include/TextStyle.h"
@@ -17,6 +18,10 @@ namespace textlayout {
 
 class TextStyle;
 class Paragraph;
+
+// FontCollection can be shared by paragraphs that are laid out on different threads:
+// all the caches it keeps are guarded by a mutex. The font managers and the fallback
+// settings must not be changed while any layout is in progress.
 class FontCollection : public SkRefCnt {
 public:
     FontCollection();
@@ -51,6 +56,8 @@ private:
 
     sk_sp<SkTypeface> matchTypeface(const SkString& familyName, SkFontStyle fontStyle);
 
+    void resetFallbackTypefaces();
+
     struct FamilyKey {
         FamilyKey(const std::vector<SkString>& familyNames, SkFontStyle style, const std::optional<FontArguments>& args)
                 : fFamilyNames(familyNames), fFontStyle(style), fFontArguments(args) {}
@@ -75,6 +82,27 @@ private:
     sk_sp<SkFontMgr> fDynamicFontManager;
     sk_sp<SkFontMgr> fTestFontManager;
 
+    struct FallbackKey {
+        FallbackKey(SkUnichar unicode, SkFontStyle fontStyle, const SkString& locale)
+            : fUnicode(unicode), fFontStyle(fontStyle), fLocale(locale) { }
+
+        SkUnichar fUnicode;
+        SkFontStyle fFontStyle;
+        SkString fLocale;
+
+        bool operator==(const FallbackKey& other) const;
+
+        struct Hasher {
+            uint32_t operator()(const FallbackKey& key) const;
+        };
+    };
+
+    // Keeping all the typefaces found for the codepoints (including the missing ones)
+    skia_private::THashMap<FallbackKey, sk_sp<SkTypeface>, FallbackKey::Hasher> fFallbackTypefaces;
+    // TypefaceFontProvider::RegistrationGeneration() when fFallbackTypefaces were found
+    uint32_t fFallbackGeneration;
+    SkMutex fCacheMutex;
+
     std::vector<SkString> fDefaultFamilyNames;
     ParagraphCache fParagraphCache;
 };
@@ -0,0 +1,33 @@
+// Copyright 2023 Google LLC.
+#ifndef ParallelLayout_DEFINED
+#define ParallelLayout_DEFINED
+
+#include "include/core/SkScalar.h"
+#include "include/core/SkSpan.h"
+
+class SkExecutor;
+
+namespace skia {
+namespace textlayout {
+
+class Paragraph;
+
+struct ParagraphLayoutRequest {
+    Paragraph* fParagraph;
+    SkScalar fWidth;
+};
+
+/** Lays out independent paragraphs concurrently and waits until all of them are done
+ *
+ * The paragraphs may share a FontCollection (and its font fallback and paragraph caches)
+ * but each paragraph must appear in the requests only once.
+ *
+ * @param requests   paragraphs (as built by ParagraphBuilder) and the widths to lay them out
+ * @param executor   the executor to run the layouts on; nullptr lays them out on this thread
+ */
+void LayoutParagraphs(SkSpan<const ParagraphLayoutRequest> requests, SkExecutor* executor);
+
+}  // namespace textlayout
+}  // namespace skia
+
+#endif  // ParallelLayout_DEFINED
@@ -38,6 +38,10 @@ public:
     size_t registerTypeface(sk_sp<SkTypeface> typeface);
     size_t registerTypeface(sk_sp<SkTypeface> typeface, const SkString& alias);
 
+    // Changes every time a typeface is registered into any provider, so the caches built
+    // from what the providers returned can tell when they are out of date
+    static uint32_t RegistrationGeneration();
+
     int onCountFamilies() const override;
 
     void onGetFamilyName(int index, SkString* familyName) const override;
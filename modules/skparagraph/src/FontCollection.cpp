@@ -2,6 +2,7 @@
 #include "include/core/SkTypeface.h"
 #include "modules/skparagraph/include/FontCollection.h"
 #include "modules/skparagraph/include/Paragraph.h"
+#include "modules/skparagraph/include/TypefaceFontProvider.h"
 #include "modules/skparagraph/src/ParagraphImpl.h"
 #include "modules/skshaper/include/SkShaper.h"
 
@@ -25,38 +26,55 @@ size_t FontCollection::FamilyKey::Hasher::operator()(const FontCollection::Famil
            std::hash<std::optional<FontArguments>>()(key.fFontArguments);
 }
 
+bool FontCollection::FallbackKey::operator==(const FontCollection::FallbackKey& other) const {
+    return fUnicode == other.fUnicode && fFontStyle == other.fFontStyle && fLocale == other.fLocale;
+}
+
+uint32_t FontCollection::FallbackKey::Hasher::operator()(const FontCollection::FallbackKey& key) const {
+    return SkGoodHash()(key.fUnicode) ^
+           SkGoodHash()(key.fFontStyle) ^
+           SkGoodHash()(key.fLocale);
+}
+
 FontCollection::FontCollection()
         : fEnableFontFallback(true)
+        , fFallbackGeneration(TypefaceFontProvider::RegistrationGeneration())
         , fDefaultFamilyNames({SkString(DEFAULT_FONT_FAMILY)}) { }
 
 size_t FontCollection::getFontManagersCount() const { return this->getFontManagerOrder().size(); }
 
 void FontCollection::setAssetFontManager(sk_sp<SkFontMgr> font_manager) {
     fAssetFontManager = font_manager;
+    this->resetFallbackTypefaces();
 }
 
 void FontCollection::setDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
     fDynamicFontManager = font_manager;
+    this->resetFallbackTypefaces();
 }
 
 void FontCollection::setTestFontManager(sk_sp<SkFontMgr> font_manager) {
     fTestFontManager = font_manager;
+    this->resetFallbackTypefaces();
 }
 
 void FontCollection::setDefaultFontManager(sk_sp<SkFontMgr> fontManager,
                                            const char defaultFamilyName[]) {
     fDefaultFontManager = std::move(fontManager);
     fDefaultFamilyNames.emplace_back(defaultFamilyName);
+    this->resetFallbackTypefaces();
 }
 
 void FontCollection::setDefaultFontManager(sk_sp<SkFontMgr> fontManager,
                                            const std::vector<SkString>& defaultFamilyNames) {
     fDefaultFontManager = std::move(fontManager);
     fDefaultFamilyNames = defaultFamilyNames;
+    this->resetFallbackTypefaces();
 }
 
 void FontCollection::setDefaultFontManager(sk_sp<SkFontMgr> fontManager) {
     fDefaultFontManager = fontManager;
+    this->resetFallbackTypefaces();
 }
 
 // Return the available font managers in the order they should be queried.
@@ -84,11 +102,16 @@ std::vector<sk_sp<SkTypeface>> FontCollection::findTypefaces(const std::vector<S
 std::vector<sk_sp<SkTypeface>> FontCollection::findTypefaces(const std::vector<SkString>& familyNames, SkFontStyle fontStyle, const std::optional<FontArguments>& fontArgs) {
     // Look inside the font collections cache first
     FamilyKey familyKey(familyNames, fontStyle, fontArgs);
-    auto found = fTypefaces.find(familyKey);
-    if (found) {
-        return *found;
+    {
+        SkAutoMutexExclusive lock(fCacheMutex);
+        auto found = fTypefaces.find(familyKey);
+        if (found) {
+            return *found;
+        }
     }
 
+    // Font managers are thread safe so we do not hold the lock while we are matching
+
     std::vector<sk_sp<SkTypeface>> typefaces;
     for (const SkString& familyName : familyNames) {
         sk_sp<SkTypeface> match = matchTypeface(familyName, fontStyle);
@@ -121,6 +144,7 @@ std::vector<sk_sp<SkTypeface>> FontCollection::findTypefaces(const std::vector<S
         }
     }
 
+    SkAutoMutexExclusive lock(fCacheMutex);
     fTypefaces.set(familyKey, typefaces);
     return typefaces;
 }
@@ -144,18 +168,39 @@ sk_sp<SkTypeface> FontCollection::matchTypeface(const SkString& familyName, SkFo
 // Find ANY font in available font managers that resolves the unicode codepoint
 sk_sp<SkTypeface> FontCollection::defaultFallback(SkUnichar unicode, SkFontStyle fontStyle, const SkString& locale) {
 
+    // All the paragraphs share the results so the font managers are asked only once per codepoint
+    FallbackKey fallbackKey(unicode, fontStyle, locale);
+    // A typeface registered into a provider we already asked can resolve an earlier miss
+    const uint32_t generation = TypefaceFontProvider::RegistrationGeneration();
+    {
+        SkAutoMutexExclusive lock(fCacheMutex);
+        if (generation != fFallbackGeneration) {
+            fFallbackTypefaces.reset();
+            fFallbackGeneration = generation;
+        }
+        if (auto found = fFallbackTypefaces.find(fallbackKey)) {
+            return *found;
+        }
+    }
+
+    sk_sp<SkTypeface> typeface;
     for (const auto& manager : this->getFontManagerOrder()) {
         std::vector<const char*> bcp47;
         if (!locale.isEmpty()) {
             bcp47.push_back(locale.c_str());
         }
-        sk_sp<SkTypeface> typeface(manager->matchFamilyStyleCharacter(
-                nullptr, fontStyle, bcp47.data(), bcp47.size(), unicode));
+        typeface = manager->matchFamilyStyleCharacter(
+                nullptr, fontStyle, bcp47.data(), bcp47.size(), unicode);
         if (typeface != nullptr) {
-            return typeface;
+            break;
         }
     }
-    return nullptr;
+
+    SkAutoMutexExclusive lock(fCacheMutex);
+    if (generation == fFallbackGeneration) {
+        fFallbackTypefaces.set(fallbackKey, typeface);
+    }
+    return typeface;
 }
 
 sk_sp<SkTypeface> FontCollection::defaultFallback() {
@@ -173,12 +218,30 @@ sk_sp<SkTypeface> FontCollection::defaultFallback() {
 }
 
 
-void FontCollection::disableFontFallback() { fEnableFontFallback = false; }
-void FontCollection::enableFontFallback() { fEnableFontFallback = true; }
+void FontCollection::disableFontFallback() {
+    fEnableFontFallback = false;
+    this->resetFallbackTypefaces();
+}
+
+void FontCollection::enableFontFallback() {
+    fEnableFontFallback = true;
+    this->resetFallbackTypefaces();
+}
+
+// The fallback results (misses included) depend on the font managers that were asked,
+// so they are dropped whenever those change
+void FontCollection::resetFallbackTypefaces() {
+    SkAutoMutexExclusive lock(fCacheMutex);
+    fFallbackTypefaces.reset();
+}
 
 void FontCollection::clearCaches() {
     fParagraphCache.reset();
-    fTypefaces.reset();
+    {
+        SkAutoMutexExclusive lock(fCacheMutex);
+        fTypefaces.reset();
+        fFallbackTypefaces.reset();
+    }
     SkShaper::PurgeCaches();
 }
 
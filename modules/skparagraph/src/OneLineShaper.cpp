@@ -435,7 +435,7 @@ void OneLineShaper::matchResolvedFonts(const TextStyle& textStyle,
             auto unresolvedRange = fUnresolvedBlocks.front().fText;
             auto unresolvedText = fParagraph->text(unresolvedRange);
             const char* ch = unresolvedText.begin();
-            // We have the global cache for all already found typefaces for SkUnichar
+            // FontCollection caches all already found typefaces for SkUnichar
             // but we still need to keep track of all SkUnichars used in this unresolved block
             THashSet<SkUnichar> alreadyTriedCodepoints;
             THashSet<SkTypefaceID> alreadyTriedTypefaces;
@@ -459,21 +459,11 @@ void OneLineShaper::matchResolvedFonts(const TextStyle& textStyle,
                 }
                 SkASSERT(unicode != -1);
 
-                // First try to find in in a cache
-                sk_sp<SkTypeface> typeface;
-                FontKey fontKey(unicode, textStyle.getFontStyle(), textStyle.getLocale());
-                auto found = fFallbackFonts.find(fontKey);
-                if (found != nullptr) {
-                    typeface = *found;
-                } else {
-                    typeface = fParagraph->fFontCollection->defaultFallback(
-                            unicode, textStyle.getFontStyle(), textStyle.getLocale());
-
-                    if (typeface == nullptr) {
-                        // There is no fallback font for this character, so move on to the next character.
-                        continue;
-                    }
-                    fFallbackFonts.set(fontKey, typeface);
+                sk_sp<SkTypeface> typeface = fParagraph->fFontCollection->defaultFallback(
+                        unicode, textStyle.getFontStyle(), textStyle.getLocale());
+                if (typeface == nullptr) {
+                    // There is no fallback font for this character, so move on to the next character.
+                    continue;
                 }
 
                 // Check if we already tried this font on this text range
@@ -754,15 +744,5 @@ TextRange OneLineShaper::clusteredText(GlyphRange& glyphs) {
     return { textRange.start, textRange.end };
 }
 
-bool OneLineShaper::FontKey::operator==(const OneLineShaper::FontKey& other) const {
-    return fUnicode == other.fUnicode && fFontStyle == other.fFontStyle && fLocale == other.fLocale;
-}
-
-uint32_t OneLineShaper::FontKey::Hasher::operator()(const OneLineShaper::FontKey& key) const {
-    return SkGoodHash()(key.fUnicode) ^
-           SkGoodHash()(key.fFontStyle) ^
-           SkGoodHash()(key.fLocale);
-}
-
 }  // namespace textlayout
 }  // namespace skia
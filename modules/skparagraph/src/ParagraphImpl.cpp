@@ -120,6 +120,7 @@ void ParagraphImpl::layout(SkScalar rawWidth) {
     // TODO: This rounding is done to match Flutter tests. Must be removed...
     auto floorWidth = SkScalarFloorToScalar(rawWidth);
 
+    bool keepLines = false;
     if ((!SkScalarIsFinite(rawWidth) || fLongestLine <= floorWidth) &&
         fState >= kLineBroken &&
          fLines.size() == 1 && fLines.front().ellipsis() == nullptr) {
@@ -129,7 +130,9 @@ void ParagraphImpl::layout(SkScalar rawWidth) {
         fState = kShaped;
     } else if (fState >= kLineBroken && fOldWidth != floorWidth) {
         // We can use the results from SkShaper but have to do EVERYTHING ELSE again
+        // (except for the lines that do not depend on the width)
         fState = kShaped;
+        keepLines = true;
     } else {
         // Nothing changed case: we can reuse the data from the last layout
     }
@@ -154,6 +157,7 @@ void ParagraphImpl::layout(SkScalar rawWidth) {
                 this->resolveStrut();
                 this->computeEmptyMetrics();
                 this->fLines.clear();
+                this->fLineBreakCheckpoints.clear();
 
                 // Set the important values that are not zero
                 fWidth = floorWidth;
@@ -180,11 +184,22 @@ void ParagraphImpl::layout(SkScalar rawWidth) {
     }
 
     if (fState == kShaped) {
+        auto checkpointIndex = keepLines ? this->findLineBreakCheckpoint(floorWidth) : -1;
         this->resetContext();
         this->resolveStrut();
         this->computeEmptyMetrics();
-        this->fLines.clear();
-        this->breakShapedTextIntoLines(floorWidth);
+        if (checkpointIndex > 0) {
+            // Re-wrap the text starting from the first line that could change
+            auto checkpoint = fLineBreakCheckpoints[checkpointIndex];
+            SkASSERT(checkpoint.fLineIndex < SkToSizeT(fLines.size()));
+            this->fLines.resize_back(checkpoint.fLineIndex);
+            this->fLineBreakCheckpoints.resize_back(checkpointIndex);
+            this->breakShapedTextIntoLines(floorWidth, &checkpoint);
+        } else {
+            this->fLines.clear();
+            this->fLineBreakCheckpoints.clear();
+            this->breakShapedTextIntoLines(floorWidth);
+        }
         fState = kLineBroken;
     }
 
@@ -247,20 +262,20 @@ bool ParagraphImpl::computeCodeUnitProperties() {
         return false;
     }
 
-    // Get bidi regions
+    // Get bidi regions, collect all spaces and some extra information in one go
+    // (and also substitute \t with a space while we are at it)
     auto textDirection = fParagraphStyle.getTextDirection() == TextDirection::kLtr
                               ? SkUnicode::TextDirection::kLTR
                               : SkUnicode::TextDirection::kRTL;
-    if (!fUnicode->getBidiRegions(fText.c_str(), fText.size(), textDirection, &fBidiRegions)) {
-        return false;
-    }
-
-    // Collect all spaces and some extra information
-    // (and also substitute \t with a space while we are at it)
-    if (!fUnicode->computeCodeUnitFlags(&fText[0],
-                                        fText.size(),
-                                        this->paragraphStyle().getReplaceTabCharacters(),
-                                        &fCodeUnitProperties)) {
+    fCodeUnitProperties.clear();
+    fCodeUnitProperties.push_back_n(fText.size() + 1, SkUnicode::kNoCodeUnitFlag);
+    if (!fUnicode->computeCodeUnitProperties(&fText[0],
+                                             fText.size(),
+                                             textDirection,
+                                             this->paragraphStyle().getReplaceTabCharacters(),
+                                             SkSpan(fCodeUnitProperties.data(),
+                                                    fCodeUnitProperties.size()),
+                                             &fBidiRegions)) {
         return false;
     }
 
@@ -532,9 +547,14 @@ bool ParagraphImpl::shapeTextIntoEndlessLine() {
     return result;
 }
 
-void ParagraphImpl::breakShapedTextIntoLines(SkScalar maxWidth) {
+void ParagraphImpl::breakShapedTextIntoLines(SkScalar maxWidth,
+                                             const LineBreakCheckpoint* resumeFrom) {
 
-    if (!fHasLineBreaks &&
+    if (resumeFrom != nullptr) {
+        // Everything before the checkpoint stays as it was
+        fLongestLine = resumeFrom->fLongestLine;
+        fMaxWidthWithTrailingSpaces = resumeFrom->fMaxWidthWithTrailingSpaces;
+    } else if (!fHasLineBreaks &&
         !fHasWhitespacesInside &&
         fPlaceholders.size() == 1 &&
         fRuns.size() == 1 && fRuns[0].fAdvance.fX <= maxWidth) {
@@ -618,7 +638,8 @@ void ParagraphImpl::breakShapedTextIntoLines(SkScalar maxWidth) {
                     line.createEllipsis(maxWidth, this->getEllipsis(), true);
                 }
                 fLongestLine = std::max(fLongestLine, nearlyZero(advance.fX) ? widthWithSpaces : advance.fX);
-            });
+            },
+            resumeFrom);
 
     fHeight = textWrapper.height();
     fWidth = maxWidth;
@@ -629,6 +650,42 @@ void ParagraphImpl::breakShapedTextIntoLines(SkScalar maxWidth) {
     fExceededMaxLines = textWrapper.exceededMaxLines();
 }
 
+// Returns the index of the last checkpoint such that all the lines before it are going to be
+// broken the same way with the new width: every hard line break separated piece of text
+// before it took one line with the old width and still fits into one line with the new one.
+// We only keep the lines that formatting does not touch (left aligned text, no ellipsis).
+int ParagraphImpl::findLineBreakCheckpoint(SkScalar maxWidth) const {
+    if (fLineBreakCheckpoints.size() < 2 ||
+        fParagraphStyle.effective_align() != TextAlign::kLeft ||
+        !fParagraphStyle.unlimited_lines() ||
+        fParagraphStyle.ellipsized()) {
+        return -1;
+    }
+
+    int found = -1;
+    for (int i = 0; i + 1 < fLineBreakCheckpoints.size(); ++i) {
+        auto& current = fLineBreakCheckpoints[i];
+        auto& next = fLineBreakCheckpoints[i + 1];
+        if (next.fLineIndex != current.fLineIndex + 1) {
+            // Soft line breaks always depend on the width
+            break;
+        }
+        SkScalar width = 0;
+        for (auto index = current.fClusterIndex; index < next.fClusterIndex; ++index) {
+            auto& cluster = fClusters[index];
+            if (!cluster.isHardBreak()) {
+                width += cluster.width();
+            }
+        }
+        // Stay away from the rounding that TextWrapper does around the max width
+        if (width >= maxWidth - 0.25f) {
+            break;
+        }
+        found = i + 1;
+    }
+    return found;
+}
+
 void ParagraphImpl::formatLines(SkScalar maxWidth) {
     auto effectiveAlign = fParagraphStyle.effective_align();
     const bool isLeftAligned = effectiveAlign == TextAlign::kLeft
@@ -638,6 +695,7 @@ void ParagraphImpl::formatLines(SkScalar maxWidth) {
         // Special case: clean all text in case of maxWidth == INF & align != left
         // We had to go through shaping though because we need all the measurement numbers
         fLines.clear();
+        fLineBreakCheckpoints.clear();
         return;
     }
 
@@ -941,6 +999,7 @@ void ParagraphImpl::setState(InternalState state) {
 
         case kShaped:
             fLines.clear();
+            fLineBreakCheckpoints.clear();
             [[fallthrough]];
 
         case kLineBroken:
@@ -1037,6 +1096,8 @@ void ParagraphImpl::updateFontSize(size_t from, size_t to, SkScalar fontSize) {
 
 void ParagraphImpl::updateTextAlign(TextAlign textAlign) {
     fParagraphStyle.setTextAlign(textAlign);
+    // The lines are going to be formatted with the new alignment and cannot be reused as they are
+    fLineBreakCheckpoints.clear();
 
     if (fState >= kLineBroken) {
         fState = kLineBroken;
@@ -69,6 +69,19 @@ struct ResolvedFontDescriptor {
     TextIndex fTextStart;
 };
 
+// The line breaking state at the beginning of a line that starts the text or follows
+// a hard line break. Lines before such a line do not depend on anything after it,
+// so the line breaking can be resumed from there when only the width changes.
+struct LineBreakCheckpoint {
+    size_t fLineIndex;
+    ClusterIndex fClusterIndex;
+    SkScalar fHeight;
+    SkScalar fMinIntrinsicWidth;
+    SkScalar fMaxIntrinsicWidth;
+    SkScalar fLongestLine;
+    SkScalar fMaxWidthWithTrailingSpaces;
+};
+
 enum InternalState {
   kUnknown = 0,
   kIndexed = 1,     // Text is indexed
@@ -198,7 +211,9 @@ public:
     void applySpacingAndBuildClusterTable();
     void buildClusterTable();
     bool shapeTextIntoEndlessLine();
-    void breakShapedTextIntoLines(SkScalar maxWidth);
+    void breakShapedTextIntoLines(SkScalar maxWidth,
+                                  const LineBreakCheckpoint* resumeFrom = nullptr);
+    int findLineBreakCheckpoint(SkScalar maxWidth) const;
 
     void updateTextAlign(TextAlign textAlign) override;
     void updateFontSize(size_t from, size_t to, SkScalar fontSize) override;
@@ -272,6 +287,7 @@ private:
     size_t fUnresolvedGlyphs;
 
     skia_private::TArray<TextLine, false> fLines;   // kFormatted   (cached: width, max lines, ellipsis, text align)
+    skia_private::TArray<LineBreakCheckpoint, true> fLineBreakCheckpoints; // kLineBroken
     sk_sp<SkPicture> fPicture;          // kRecorded    (cached: text styles)
 
     skia_private::TArray<ResolvedFontDescriptor> fFontSwitches;
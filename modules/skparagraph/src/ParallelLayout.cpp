@@ -0,0 +1,29 @@
+// Copyright 2023 Google LLC.
+#include "modules/skparagraph/include/ParallelLayout.h"
+
+#include "include/core/SkExecutor.h"
+#include "modules/skparagraph/include/Paragraph.h"
+#include "src/core/SkTaskGroup.h"
+
+namespace skia {
+namespace textlayout {
+
+void LayoutParagraphs(SkSpan<const ParagraphLayoutRequest> requests, SkExecutor* executor) {
+    if (executor == nullptr || requests.size() < 2) {
+        for (const auto& request : requests) {
+            request.fParagraph->layout(request.fWidth);
+        }
+        return;
+    }
+
+    SkTaskGroup taskGroup(*executor);
+    for (const auto& request : requests) {
+        taskGroup.add([request] {
+            request.fParagraph->layout(request.fWidth);
+        });
+    }
+    taskGroup.wait();
+}
+
+}  // namespace textlayout
+}  // namespace skia
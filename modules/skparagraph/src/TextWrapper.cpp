@@ -264,7 +264,8 @@ std::tuple<Cluster*, size_t, SkScalar> TextWrapper::trimStartSpaces(Cluster* end
 // TODO: refactor the code for line ending (with/without ellipsis)
 void TextWrapper::breakTextIntoLines(ParagraphImpl* parent,
                                      SkScalar maxWidth,
-                                     const AddLineToParagraph& addLine) {
+                                     const AddLineToParagraph& addLine,
+                                     const LineBreakCheckpoint* resumeFrom) {
     fHeight = 0;
     fMinIntrinsicWidth = std::numeric_limits<SkScalar>::min();
     fMaxIntrinsicWidth = std::numeric_limits<SkScalar>::min();
@@ -289,8 +290,30 @@ void TextWrapper::breakTextIntoLines(ParagraphImpl* parent,
     auto start = span.begin();
     InternalLineMetrics maxRunMetrics;
     bool needEllipsis = false;
+    if (resumeFrom != nullptr) {
+        // Continue right after a hard line break as if all the lines before it were just added
+        fHeight = resumeFrom->fHeight;
+        fMinIntrinsicWidth = resumeFrom->fMinIntrinsicWidth;
+        fMaxIntrinsicWidth = resumeFrom->fMaxIntrinsicWidth;
+        fLineNumber = resumeFrom->fLineIndex + 1;
+        firstLine = resumeFrom->fLineIndex == 0;
+        fEndLine.clean();
+        fEndLine.startFrom(start + resumeFrom->fClusterIndex, 0);
+    }
+    bool startsParagraph = true;
     while (fEndLine.endCluster() != end) {
 
+        if (startsParagraph) {
+            // Remember where we can resume from if only the width changes
+            parent->fLineBreakCheckpoints.push_back({parent->lines().size(),
+                                                     SkToSizeT(fEndLine.startCluster() - start),
+                                                     fHeight,
+                                                     fMinIntrinsicWidth,
+                                                     fMaxIntrinsicWidth,
+                                                     parent->fLongestLine,
+                                                     parent->fMaxWidthWithTrailingSpaces});
+        }
+
         this->lookAhead(maxWidth, end);
 
         auto lastLine = (hasEllipsis && unlimitedLines) || fLineNumber >= maxLines;
@@ -391,6 +414,7 @@ void TextWrapper::breakTextIntoLines(ParagraphImpl* parent,
         if (fHardLineBreak) {
             softLineMaxIntrinsicWidth = 0;
         }
+        startsParagraph = fHardLineBreak;
         // Start a new line
         fHeight += lineHeight;
         if (!fHardLineBreak || startLine != end) {
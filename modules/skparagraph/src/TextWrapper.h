@@ -10,6 +10,7 @@ namespace skia {
 namespace textlayout {
 
 class ParagraphImpl;
+struct LineBreakCheckpoint;
 
 class TextWrapper {
     class ClusterPos {
@@ -181,7 +182,8 @@ public:
                                                   bool addEllipsis)>;
     void breakTextIntoLines(ParagraphImpl* parent,
                             SkScalar maxWidth,
-                            const AddLineToParagraph& addLine);
+                            const AddLineToParagraph& addLine,
+                            const LineBreakCheckpoint* resumeFrom = nullptr);
 
     SkScalar height() const { return fHeight; }
     SkScalar minIntrinsicWidth() const { return fMinIntrinsicWidth; }
@@ -1,6 +1,7 @@
 // Copyright 2019 Google LLC.
 #include "modules/skparagraph/include/TypefaceFontProvider.h"
 #include <algorithm>
+#include <atomic>
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypeface.h"
@@ -9,6 +10,12 @@
 namespace skia {
 namespace textlayout {
 
+static std::atomic<uint32_t> gRegistrationGeneration{0};
+
+uint32_t TypefaceFontProvider::RegistrationGeneration() {
+    return gRegistrationGeneration.load(std::memory_order_acquire);
+}
+
 int TypefaceFontProvider::onCountFamilies() const { return fRegisteredFamilies.count(); }
 
 void TypefaceFontProvider::onGetFamilyName(int index, SkString* familyName) const {
@@ -47,6 +54,7 @@ size_t TypefaceFontProvider::registerTypeface(sk_sp<SkTypeface> typeface, const
     }
 
     (*found)->appendTypeface(std::move(typeface));
+    gRegistrationGeneration.fetch_add(1, std::memory_order_release);
 
     return 1;
 }
@@ -8,6 +8,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkImageEncoder.h"
@@ -26,6 +27,7 @@
 #include "modules/skparagraph/include/Paragraph.h"
 #include "modules/skparagraph/include/ParagraphCache.h"
 #include "modules/skparagraph/include/ParagraphStyle.h"
+#include "modules/skparagraph/include/ParallelLayout.h"
 #include "modules/skparagraph/include/TextShadow.h"
 #include "modules/skparagraph/include/TextStyle.h"
 #include "modules/skparagraph/include/TypefaceFontProvider.h"
@@ -7590,3 +7592,185 @@ UNIX_ONLY_TEST(SkParagraph_TextEditingFunctionality, reporter) {
     font.getTypeface()->getFamilyName(&fontFamily);
     REPORTER_ASSERT(reporter, fontFamily.equals("Roboto"));
 }
+
+UNIX_ONLY_TEST(SkParagraph_IncrementalRelayout, reporter) {
+    sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
+    if (!fontCollection->fontsFound()) return;
+    const char* text =
+            "Short line\n"
+            "Another short line\n"
+            "This is a much longer line that is going to wrap with the narrow width\n"
+            "Short again\n"
+            "\n"
+            "The last line is long enough to wrap as well when the width gets smaller";
+    const size_t len = strlen(text);
+
+    auto makeParagraph = [&]() {
+        ParagraphStyle paragraph_style;
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection);
+        TextStyle text_style;
+        text_style.setFontFamilies({SkString("Roboto")});
+        text_style.setFontSize(20);
+        text_style.setColor(SK_ColorBLACK);
+        builder.pushStyle(text_style);
+        builder.addText(text, len);
+        builder.pop();
+        return builder.Build();
+    };
+
+    auto compare = [&](Paragraph* incremental, Paragraph* fresh) {
+        REPORTER_ASSERT(reporter, incremental->lineNumber() == fresh->lineNumber());
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(incremental->getHeight(), fresh->getHeight()));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(incremental->getLongestLine(), fresh->getLongestLine()));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(incremental->getMinIntrinsicWidth(), fresh->getMinIntrinsicWidth()));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(incremental->getMaxIntrinsicWidth(), fresh->getMaxIntrinsicWidth()));
+        std::vector<LineMetrics> incrementalMetrics;
+        std::vector<LineMetrics> freshMetrics;
+        incremental->getLineMetrics(incrementalMetrics);
+        fresh->getLineMetrics(freshMetrics);
+        REPORTER_ASSERT(reporter, incrementalMetrics.size() == freshMetrics.size());
+        for (size_t i = 0; i < std::min(incrementalMetrics.size(), freshMetrics.size()); ++i) {
+            REPORTER_ASSERT(reporter, incrementalMetrics[i].fStartIndex == freshMetrics[i].fStartIndex);
+            REPORTER_ASSERT(reporter, incrementalMetrics[i].fEndIndex == freshMetrics[i].fEndIndex);
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(incrementalMetrics[i].fWidth, freshMetrics[i].fWidth));
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(incrementalMetrics[i].fBaseline, freshMetrics[i].fBaseline));
+        }
+    };
+
+    // The paragraph cache is only consulted when a paragraph has to be shaped, so counting the
+    // lookups made for the relaid out paragraph shows whether it was shaped again.
+    auto paragraph = makeParagraph();
+    auto impl = static_cast<ParagraphImpl*>(paragraph.get());
+    int shapings = 0;
+    fontCollection->getParagraphCache()->turnOn(true);
+    fontCollection->getParagraphCache()->setChecker(
+            [&](ParagraphImpl* checked, const char* event, bool) {
+                if (checked == impl && strcmp(event, "addedParagraph") != 0) {
+                    ++shapings;
+                }
+            });
+    paragraph->layout(TestCanvasWidth);
+    REPORTER_ASSERT(reporter, shapings == 1);
+    const size_t runCount = impl->runs().size();
+
+    for (SkScalar width : { 300.0f, 500.0f, 200.0f, (SkScalar)TestCanvasWidth }) {
+        paragraph->layout(width);
+        REPORTER_ASSERT(reporter, shapings == 1, "reshaped at width %g", width);
+        REPORTER_ASSERT(reporter, impl->runs().size() == runCount);
+        auto fresh = makeParagraph();
+        fresh->layout(width);
+        compare(paragraph.get(), fresh.get());
+    }
+    fontCollection->getParagraphCache()->setChecker([](ParagraphImpl*, const char*, bool) {});
+}
+
+UNIX_ONLY_TEST(SkParagraph_ParallelLayout, reporter) {
+    sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
+    if (!fontCollection->fontsFound()) return;
+    const char* texts[] = {
+            "Simple text",
+            "This is a very long sentence to test if the text will properly wrap "
+            "around and go to the next line. Sometimes, short sentence.",
+            "Mixed scripts: \u05E9\u05DC\u05D5\u05DD \u0645\u0631\u062D\u0628\u0627 hello",
+            "Line\nbreaks\ninside",
+    };
+    constexpr int kCopies = 16;
+
+    auto makeParagraph = [&](const char* text) {
+        ParagraphStyle paragraph_style;
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection);
+        TextStyle text_style;
+        text_style.setFontFamilies({SkString("Roboto")});
+        text_style.setFontSize(20);
+        text_style.setColor(SK_ColorBLACK);
+        builder.pushStyle(text_style);
+        builder.addText(text, strlen(text));
+        builder.pop();
+        return builder.Build();
+    };
+
+    std::vector<std::unique_ptr<Paragraph>> paragraphs;
+    std::vector<ParagraphLayoutRequest> requests;
+    for (int i = 0; i < kCopies; ++i) {
+        for (auto text : texts) {
+            paragraphs.emplace_back(makeParagraph(text));
+            requests.push_back({paragraphs.back().get(), 100.0f + 50 * (i % 4)});
+        }
+    }
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    LayoutParagraphs(SkSpan(requests), executor.get());
+
+    for (auto& request : requests) {
+        auto expected = makeParagraph(
+                texts[(&request - requests.data()) % std::size(texts)]);
+        expected->layout(request.fWidth);
+        REPORTER_ASSERT(reporter, request.fParagraph->lineNumber() == expected->lineNumber());
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(request.fParagraph->getHeight(),
+                                                      expected->getHeight()));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(request.fParagraph->getLongestLine(),
+                                                      expected->getLongestLine()));
+    }
+}
+
+UNIX_ONLY_TEST(SkParagraph_FallbackAfterNewFont, reporter) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) return;
+
+    // Resolves every codepoint to one typeface, like a web font registered late
+    class CharacterFontProvider : public TypefaceFontProvider {
+    public:
+        CharacterFontProvider(sk_sp<SkTypeface> typeface) : fTypeface(std::move(typeface)) {}
+        sk_sp<SkTypeface> onMatchFamilyStyleCharacter(const char[], const SkFontStyle&,
+                                                      const char*[], int,
+                                                      SkUnichar) const override {
+            return fTypeface;
+        }
+    private:
+        sk_sp<SkTypeface> fTypeface;
+    };
+
+    sk_sp<FontCollection> fontCollection = sk_make_sp<FontCollection>();
+    fontCollection->setDefaultFontManager(SkFontMgr::RefEmpty());
+    const SkString locale;
+    REPORTER_ASSERT(reporter, !fontCollection->defaultFallback('a', SkFontStyle(), locale));
+
+    // The earlier miss must not hide the new font
+    fontCollection->setDynamicFontManager(sk_make_sp<CharacterFontProvider>(typeface));
+    REPORTER_ASSERT(reporter,
+                    fontCollection->defaultFallback('a', SkFontStyle(), locale) == typeface);
+
+    fontCollection->setDynamicFontManager(nullptr);
+    REPORTER_ASSERT(reporter, !fontCollection->defaultFallback('a', SkFontStyle(), locale));
+}
+
+UNIX_ONLY_TEST(SkParagraph_FallbackAfterRegisteredTypeface, reporter) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) return;
+
+    // Resolves every codepoint to the first registered typeface, if there is one
+    class RegisteredFontProvider : public TypefaceFontProvider {
+    public:
+        sk_sp<SkTypeface> onMatchFamilyStyleCharacter(const char[], const SkFontStyle&,
+                                                      const char*[], int,
+                                                      SkUnichar) const override {
+            if (this->onCountFamilies() == 0) {
+                return nullptr;
+            }
+            SkString familyName;
+            this->onGetFamilyName(0, &familyName);
+            return this->onMatchFamily(familyName.c_str())->createTypeface(0);
+        }
+    };
+
+    auto provider = sk_make_sp<RegisteredFontProvider>();
+    sk_sp<FontCollection> fontCollection = sk_make_sp<FontCollection>();
+    fontCollection->setDynamicFontManager(provider);
+    const SkString locale;
+    REPORTER_ASSERT(reporter, !fontCollection->defaultFallback('a', SkFontStyle(), locale));
+
+    // The earlier miss must not hide a typeface registered into the same provider
+    provider->registerTypeface(typeface, SkString("Roboto"));
+    REPORTER_ASSERT(reporter,
+                    fontCollection->defaultFallback('a', SkFontStyle(), locale) == typeface);
+}
@@ -152,7 +152,14 @@ class SKUNICODE_API SkUnicode {
         virtual bool computeCodeUnitFlags(
                 char16_t utf16[], int utf16Units, bool replaceTabs,
                 skia_private::TArray<SkUnicode::CodeUnitFlags, true>* results) = 0;
-
+        // Computes the bidi regions and all the code unit flags of the text in one call.
+        // The flags are written into the caller's buffer which must hold utf8Units + 1 entries.
+        virtual bool computeCodeUnitProperties(char utf8[],
+                                               int utf8Units,
+                                               TextDirection dir,
+                                               bool replaceTabs,
+                                               SkSpan<SkUnicode::CodeUnitFlags> results,
+                                               std::vector<BidiRegion>* bidiRegions);
         static SkString convertUtf16ToUtf8(const char16_t * utf16, int utf16Units);
         static SkString convertUtf16ToUtf8(const std::u16string& utf16);
         static std::u16string convertUtf8ToUtf16(const char* utf8, int utf8Units);
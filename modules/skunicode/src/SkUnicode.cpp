@@ -6,10 +6,15 @@
  */
 
 #include "modules/skunicode/include/SkUnicode.h"
+#include "modules/skunicode/src/SkUnicode_tables.h"
 
 #include "include/private/SkBitmaskEnum.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
+
+#include <array>
+#include <cstring>
 
 using namespace skia_private;
 
@@ -98,3 +103,127 @@ bool SkUnicode::isControl(SkUnicode::CodeUnitFlags flags) {
 bool SkUnicode::isPartOfWhiteSpaceBreak(SkUnicode::CodeUnitFlags flags) {
     return (flags & SkUnicode::kPartOfWhiteSpaceBreak) == SkUnicode::kPartOfWhiteSpaceBreak;
 }
+
+bool SkUnicode::computeCodeUnitProperties(char utf8[],
+                                          int utf8Units,
+                                          TextDirection dir,
+                                          bool replaceTabs,
+                                          SkSpan<SkUnicode::CodeUnitFlags> results,
+                                          std::vector<BidiRegion>* bidiRegions) {
+    SkASSERT(results.size() == SkToSizeT(utf8Units) + 1);
+    if (!this->getBidiRegions(utf8, utf8Units, dir, bidiRegions)) {
+        return false;
+    }
+    TArray<SkUnicode::CodeUnitFlags, true> flags;
+    if (!this->computeCodeUnitFlags(utf8, utf8Units, replaceTabs, &flags)) {
+        return false;
+    }
+    SkASSERT(SkToSizeT(flags.size()) == results.size());
+    memcpy(results.data(), flags.data(), results.size_bytes());
+    return true;
+}
+
+namespace {
+// Line break and property classes of the ASCII characters the tables know how to handle.
+// Any other character sends the text back to the full (ICU based) implementation.
+enum AsciiClass : uint8_t {
+    kUnsupported_Class,
+    kAlphaNumeric_Class,    // UAX #14 classes AL and NU: no breaks in between
+    kInfixSeparator_Class,  // UAX #14 class IS: . , : ;
+    kSpace_Class,           // UAX #14 class SP
+    kTabulation_Class,      // UAX #14 class BA
+    kLineFeed_Class,        // UAX #14 class LF: a mandatory break after
+};
+
+constexpr std::array<uint8_t, 128> make_ascii_classes() {
+    std::array<uint8_t, 128> classes = {};
+    for (int c = '0'; c <= '9'; ++c) { classes[c] = kAlphaNumeric_Class; }
+    for (int c = 'A'; c <= 'Z'; ++c) { classes[c] = kAlphaNumeric_Class; }
+    for (int c = 'a'; c <= 'z'; ++c) { classes[c] = kAlphaNumeric_Class; }
+    classes['.'] = classes[','] = classes[':'] = classes[';'] = kInfixSeparator_Class;
+    classes[' '] = kSpace_Class;
+    classes['\t'] = kTabulation_Class;
+    classes['\n'] = kLineFeed_Class;
+    return classes;
+}
+
+constexpr std::array<uint8_t, 128> gAsciiClasses = make_ascii_classes();
+}  // namespace
+
+bool SkUnicode_Tables::computeCodeUnitProperties(char utf8[],
+                                                 int utf8Units,
+                                                 SkUnicode::TextDirection dir,
+                                                 bool replaceTabs,
+                                                 SkSpan<SkUnicode::CodeUnitFlags> results,
+                                                 std::vector<SkUnicode::BidiRegion>* bidiRegions) {
+    // Right-to-left paragraphs need the full bidi algorithm even for ASCII (numbers, neutrals)
+    if (dir != SkUnicode::TextDirection::kLTR || results.size() != SkToSizeT(utf8Units) + 1) {
+        return false;
+    }
+
+    // Make sure the tables cover the entire text before touching anything
+    uint8_t prev = kUnsupported_Class;
+    for (int i = 0; i < utf8Units; ++i) {
+        auto c = (uint8_t)utf8[i];
+        if (c >= gAsciiClasses.size() || gAsciiClasses[c] == kUnsupported_Class) {
+            return false;
+        }
+        // Break opportunities before an infix separator that follows a space differ
+        // between the UAX #14 versions; leave them to ICU
+        if (gAsciiClasses[c] == kInfixSeparator_Class &&
+            (prev == kSpace_Class || prev == kTabulation_Class)) {
+            return false;
+        }
+        prev = gAsciiClasses[c];
+    }
+
+    // Every ASCII character (with no CR around) is a grapheme of its own, and the text
+    // is left-to-right all the way through
+    for (auto& flags : results) {
+        flags = SkUnicode::kGraphemeStart;
+    }
+    results[0] |= SkUnicode::kSoftLineBreakBefore;
+    results[utf8Units] |= SkUnicode::kSoftLineBreakBefore;
+    if (utf8Units > 0) {
+        bidiRegions->emplace_back(0, utf8Units, 0);
+    }
+
+    prev = kUnsupported_Class;
+    for (int i = 0; i < utf8Units; ++i) {
+        auto current = gAsciiClasses[(uint8_t)utf8[i]];
+        switch (current) {
+            case kSpace_Class:
+                results[i] |= SkUnicode::kPartOfIntraWordBreak |
+                              SkUnicode::kPartOfWhiteSpaceBreak;
+                break;
+            case kTabulation_Class:
+                results[i] |= SkUnicode::kPartOfIntraWordBreak |
+                              SkUnicode::kPartOfWhiteSpaceBreak;
+                if (replaceTabs) {
+                    results[i] |= SkUnicode::kTabulation;
+                    utf8[i] = ' ';
+                } else {
+                    results[i] |= SkUnicode::kControl;
+                }
+                break;
+            case kLineFeed_Class:
+                results[i] |= SkUnicode::kPartOfIntraWordBreak |
+                              SkUnicode::kPartOfWhiteSpaceBreak |
+                              SkUnicode::kControl;
+                results[i + 1] |= SkUnicode::kHardLineBreakBefore |
+                                  SkUnicode::kSoftLineBreakBefore;
+                break;
+            default:
+                break;
+        }
+        // Break after spaces (LB18) and tabulations (LB31), but not before spaces (LB7),
+        // line feeds (LB6) or a tabulation that follows another one (LB21)
+        if ((prev == kSpace_Class &&
+             (current == kAlphaNumeric_Class || current == kTabulation_Class)) ||
+            (prev == kTabulation_Class && current == kAlphaNumeric_Class)) {
+            results[i] |= SkUnicode::kSoftLineBreakBefore;
+        }
+        prev = current;
+    }
+    return true;
+}
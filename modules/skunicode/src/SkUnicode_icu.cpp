@@ -17,6 +17,7 @@
 #include "modules/skunicode/include/SkUnicode.h"
 #include "modules/skunicode/src/SkUnicode_icu.h"
 #include "modules/skunicode/src/SkUnicode_icu_bidi.h"
+#include "modules/skunicode/src/SkUnicode_tables.h"
 #include "src/base/SkUTF.h"
 #include "src/core/SkTHash.h"
 #include <unicode/umachine.h>
@@ -310,6 +311,51 @@ class SkUnicode_icu : public SkUnicode {
         return property == U_LB_LINE_FEED || property == U_LB_MANDATORY_BREAK;
     }
 
+    static bool extractCodeUnitFlags(char utf8[], int utf8Units, bool replaceTabs,
+                                     SkSpan<SkUnicode::CodeUnitFlags> results) {
+        SkASSERT(results.size() == SkToSizeT(utf8Units) + 1);
+        SkUnicode_icu::extractPositions(utf8, utf8Units, BreakType::kLines, [&](int pos,
+                                                                       int status) {
+            results[pos] |= status == UBRK_LINE_HARD
+                                    ? CodeUnitFlags::kHardLineBreakBefore
+                                    : CodeUnitFlags::kSoftLineBreakBefore;
+        });
+
+        SkUnicode_icu::extractPositions(utf8, utf8Units, BreakType::kGraphemes, [&](int pos,
+                                                                       int status) {
+            results[pos] |= CodeUnitFlags::kGraphemeStart;
+        });
+
+        const char* current = utf8;
+        const char* end = utf8 + utf8Units;
+        while (current < end) {
+            auto before = current - utf8;
+            SkUnichar unichar = SkUTF::NextUTF8(&current, end);
+            if (unichar < 0) unichar = 0xFFFD;
+            auto after = current - utf8;
+            if (replaceTabs && SkUnicode_icu::isTabulation(unichar)) {
+                results[before] |= SkUnicode::kTabulation;
+                if (replaceTabs) {
+                    unichar = ' ';
+                    utf8[before] = ' ';
+                }
+            }
+            for (auto i = before; i < after; ++i) {
+                if (SkUnicode_icu::isSpace(unichar)) {
+                    results[i] |= SkUnicode::kPartOfIntraWordBreak;
+                }
+                if (SkUnicode_icu::isWhitespace(unichar)) {
+                    results[i] |= SkUnicode::kPartOfWhiteSpaceBreak;
+                }
+                if (SkUnicode_icu::isControl(unichar)) {
+                    results[i] |= SkUnicode::kControl;
+                }
+            }
+        }
+
+        return true;
+    }
+
 public:
     ~SkUnicode_icu() override { }
     std::unique_ptr<SkBidiIterator> makeBidiIterator(const uint16_t text[], int count,
@@ -381,47 +427,30 @@ public:
                           TArray<SkUnicode::CodeUnitFlags, true>* results) override {
         results->clear();
         results->push_back_n(utf8Units + 1, CodeUnitFlags::kNoCodeUnitFlag);
+        return SkUnicode_icu::extractCodeUnitFlags(utf8, utf8Units, replaceTabs,
+                                                   SkSpan(results->data(), results->size()));
+    }
 
-        SkUnicode_icu::extractPositions(utf8, utf8Units, BreakType::kLines, [&](int pos,
-                                                                       int status) {
-            (*results)[pos] |= status == UBRK_LINE_HARD
-                                    ? CodeUnitFlags::kHardLineBreakBefore
-                                    : CodeUnitFlags::kSoftLineBreakBefore;
-        });
-
-        SkUnicode_icu::extractPositions(utf8, utf8Units, BreakType::kGraphemes, [&](int pos,
-                                                                       int status) {
-            (*results)[pos] |= CodeUnitFlags::kGraphemeStart;
-        });
-
-        const char* current = utf8;
-        const char* end = utf8 + utf8Units;
-        while (current < end) {
-            auto before = current - utf8;
-            SkUnichar unichar = SkUTF::NextUTF8(&current, end);
-            if (unichar < 0) unichar = 0xFFFD;
-            auto after = current - utf8;
-            if (replaceTabs && SkUnicode_icu::isTabulation(unichar)) {
-                results->at(before) |= SkUnicode::kTabulation;
-                if (replaceTabs) {
-                    unichar = ' ';
-                    utf8[before] = ' ';
-                }
-            }
-            for (auto i = before; i < after; ++i) {
-                if (SkUnicode_icu::isSpace(unichar)) {
-                    results->at(i) |= SkUnicode::kPartOfIntraWordBreak;
-                }
-                if (SkUnicode_icu::isWhitespace(unichar)) {
-                    results->at(i) |= SkUnicode::kPartOfWhiteSpaceBreak;
-                }
-                if (SkUnicode_icu::isControl(unichar)) {
-                    results->at(i) |= SkUnicode::kControl;
-                }
-            }
+    bool computeCodeUnitProperties(char utf8[],
+                                   int utf8Units,
+                                   TextDirection dir,
+                                   bool replaceTabs,
+                                   SkSpan<SkUnicode::CodeUnitFlags> results,
+                                   std::vector<BidiRegion>* bidiRegions) override {
+        // Most of the short strings never need ICU (its iterators setup costs more than
+        // the table lookups for the entire text)
+        if (SkUnicode_Tables::computeCodeUnitProperties(
+                    utf8, utf8Units, dir, replaceTabs, results, bidiRegions)) {
+            return true;
         }
-
-        return true;
+        if (!SkUnicode::extractBidi(utf8, utf8Units, dir, bidiRegions)) {
+            return false;
+        }
+        SkASSERT(results.size() == SkToSizeT(utf8Units) + 1);
+        for (auto& flags : results) {
+            flags = CodeUnitFlags::kNoCodeUnitFlag;
+        }
+        return SkUnicode_icu::extractCodeUnitFlags(utf8, utf8Units, replaceTabs, results);
     }
 
     bool computeCodeUnitFlags(char16_t utf16[], int utf16Units, bool replaceTabs,
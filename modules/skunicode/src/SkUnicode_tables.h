@@ -0,0 +1,28 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkUnicode_tables_DEFINED
+#define SkUnicode_tables_DEFINED
+
+#include "include/core/SkSpan.h"
+#include "modules/skunicode/include/SkUnicode.h"
+
+#include <vector>
+
+class SkUnicode_Tables {
+public:
+    // Table driven version of SkUnicode::computeCodeUnitProperties that does not need ICU.
+    // Only covers left-to-right text made of the most common ASCII characters;
+    // returns false (and leaves the text and the results untouched) for anything else.
+    static bool computeCodeUnitProperties(char utf8[],
+                                          int utf8Units,
+                                          SkUnicode::TextDirection dir,
+                                          bool replaceTabs,
+                                          SkSpan<SkUnicode::CodeUnitFlags> results,
+                                          std::vector<SkUnicode::BidiRegion>* bidiRegions);
+};
+
+#endif  // SkUnicode_tables_DEFINED
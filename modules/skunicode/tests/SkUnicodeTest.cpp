@@ -11,8 +11,10 @@
 #include "include/core/SkString.h"
 #include "include/core/SkTypeface.h"
 #include "modules/skunicode/include/SkUnicode.h"
+#include "modules/skunicode/src/SkUnicode_tables.h"
 #include "tests/Test.h"
 
+#include <algorithm>
 #include <vector>
 
 using namespace skia_private;
@@ -199,3 +201,69 @@ UNIX_ONLY_TEST(SkUnicode_ReorderVisual, reporter) {
     reorder({1}, {0});
     reorder({0, 1, 0, 1}, {0, 1, 2, 3});
 }
+
+UNIX_ONLY_TEST(SkUnicode_ComputeCodeUnitPropertiesFromTables, reporter) {
+    auto icu = SkUnicode::Make();
+    auto check = [&](const char* str, bool replaceTabs) {
+        SkString expectedText(str);
+        TArray<SkUnicode::CodeUnitFlags, true> expected;
+        std::vector<SkUnicode::BidiRegion> expectedRegions;
+        icu->getBidiRegions(expectedText.data(), expectedText.size(),
+                            SkUnicode::TextDirection::kLTR, &expectedRegions);
+        icu->computeCodeUnitFlags(expectedText.data(), expectedText.size(), replaceTabs,
+                                  &expected);
+
+        SkString text(str);
+        std::vector<SkUnicode::CodeUnitFlags> results(text.size() + 1);
+        std::vector<SkUnicode::BidiRegion> regions;
+        auto result = SkUnicode_Tables::computeCodeUnitProperties(
+                text.data(), text.size(), SkUnicode::TextDirection::kLTR, replaceTabs,
+                SkSpan(results), &regions);
+        REPORTER_ASSERT(reporter, result, "%s", str);
+        REPORTER_ASSERT(reporter, text.equals(expectedText), "%s", str);
+        REPORTER_ASSERT(reporter, regions.size() == expectedRegions.size(), "%s", str);
+        for (auto i = 0ul; i < std::min(regions.size(), expectedRegions.size()); ++i) {
+            REPORTER_ASSERT(reporter, regions[i].start == expectedRegions[i].start &&
+                                      regions[i].end == expectedRegions[i].end &&
+                                      regions[i].level == expectedRegions[i].level);
+        }
+        for (auto i = 0ul; i < results.size(); ++i) {
+            REPORTER_ASSERT(reporter, results[i] == expected[i], "%s [%zu]", str, i);
+        }
+        // The batched entry point gives the same answer
+        SkString batchedText(str);
+        std::vector<SkUnicode::CodeUnitFlags> batched(text.size() + 1);
+        regions.clear();
+        result = icu->computeCodeUnitProperties(
+                batchedText.data(), batchedText.size(), SkUnicode::TextDirection::kLTR,
+                replaceTabs, SkSpan(batched), &regions);
+        REPORTER_ASSERT(reporter, result && batched == results, "%s", str);
+    };
+    check("", false);
+    check("Hello", false);
+    check("1\n22 333 4444 55555 666666 7777777", true);
+    check("World domination is such an ugly phrase, I prefer world optimisation.", false);
+    check("  leading and trailing spaces  ", false);
+    check("one\ttwo \tthree\t four\t", false);
+    check("one\ttwo \tthree\t four\t", true);
+    check("a \t b\t\tc", false);
+    check("line\n\nline \nline\n", false);
+    check("1.5 2,5 a.b c:d e;f", false);
+
+    // Anything outside of the tables goes back to ICU untouched
+    for (const char* str : { "a-b", "a (b)", "a .5", "caf\xC3\xA9", "a\r\nb" }) {
+        SkString text(str);
+        std::vector<SkUnicode::CodeUnitFlags> results(text.size() + 1);
+        std::vector<SkUnicode::BidiRegion> regions;
+        REPORTER_ASSERT(reporter, !SkUnicode_Tables::computeCodeUnitProperties(
+                text.data(), text.size(), SkUnicode::TextDirection::kLTR, false,
+                SkSpan(results), &regions), "%s", str);
+        REPORTER_ASSERT(reporter, regions.empty());
+    }
+    SkString rtl("abc");
+    std::vector<SkUnicode::CodeUnitFlags> results(rtl.size() + 1);
+    std::vector<SkUnicode::BidiRegion> regions;
+    REPORTER_ASSERT(reporter, !SkUnicode_Tables::computeCodeUnitProperties(
+            rtl.data(), rtl.size(), SkUnicode::TextDirection::kRTL, false,
+            SkSpan(results), &regions));
+}
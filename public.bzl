@@ -712,6 +712,8 @@ BASE_SRCS_ALL = [
     "src/core/SkYUVAInfo.cpp",
     "src/core/SkYUVAInfoLocation.h",
     "src/core/SkYUVAPixmaps.cpp",
+    "src/core/SkYUVAToRGB.cpp",
+    "src/core/SkYUVAToRGB.h",
     "src/core/SkYUVMath.cpp",
     "src/core/SkYUVMath.h",
     "src/core/SkYUVPlanesCache.cpp",
@@ -1230,6 +1232,8 @@ BASE_SRCS_ALL = [
     "src/gpu/ganesh/tessellate/GrStrokeTessellationShader.h",
     "src/gpu/ganesh/tessellate/GrTessellationShader.cpp",
     "src/gpu/ganesh/tessellate/GrTessellationShader.h",
+    "src/gpu/ganesh/tessellate/PatchCache.cpp",
+    "src/gpu/ganesh/tessellate/PatchCache.h",
     "src/gpu/ganesh/tessellate/PathTessellator.cpp",
     "src/gpu/ganesh/tessellate/PathTessellator.h",
     "src/gpu/ganesh/tessellate/StrokeTessellator.cpp",
@@ -1648,6 +1652,8 @@ BASE_SRCS_ALL = [
     "src/text/gpu/DistanceFieldAdjustTable.cpp",
     "src/text/gpu/DistanceFieldAdjustTable.h",
     "src/text/gpu/Glyph.h",
+    "src/text/gpu/GlyphMaskStore.cpp",
+    "src/text/gpu/GlyphMaskStore.h",
     "src/text/gpu/GlyphVector.cpp",
     "src/text/gpu/GlyphVector.h",
     "src/text/gpu/SDFMaskFilter.cpp",
@@ -2241,6 +2247,7 @@ SKPARAGRAPH_LIB_HDRS = [
     "modules/skparagraph/include/Paragraph.h",
     "modules/skparagraph/include/ParagraphPainter.h",
     "modules/skparagraph/include/ParagraphStyle.h",
+    "modules/skparagraph/include/ParallelLayout.h",
     "modules/skparagraph/include/TextShadow.h",
     "modules/skparagraph/include/TextStyle.h",
     "modules/skparagraph/include/TypefaceFontProvider.h",
@@ -2262,6 +2269,7 @@ SKPARAGRAPH_LIB_SRCS = [
     "modules/skparagraph/src/ParagraphPainterImpl.cpp",
     "modules/skparagraph/src/ParagraphPainterImpl.h",
     "modules/skparagraph/src/ParagraphStyle.cpp",
+    "modules/skparagraph/src/ParallelLayout.cpp",
     "modules/skparagraph/src/Run.cpp",
     "modules/skparagraph/src/Run.h",
     "modules/skparagraph/src/TextLine.cpp",
@@ -2417,6 +2425,7 @@ SKOTTIE_SHAPER_SRCS = [
 # Stubs, pending SkUnicode fission
 SKUNICODE_ICU_BUILTIN_SRCS = [
     "modules/skunicode/src/SkUnicode.cpp",
+    "modules/skunicode/src/SkUnicode_tables.h",
     "modules/skunicode/src/SkUnicode_icu.cpp",
     "modules/skunicode/src/SkUnicode_icu.h",
     "modules/skunicode/src/SkUnicode_icu_bidi.cpp",
@@ -2426,6 +2435,7 @@ SKUNICODE_ICU_BUILTIN_SRCS = [
 
 SKUNICODE_ICU_RUNTIME_SRCS = [
     "modules/skunicode/src/SkUnicode.cpp",
+    "modules/skunicode/src/SkUnicode_tables.h",
     "modules/skunicode/src/SkUnicode_icu.cpp",
     "modules/skunicode/src/SkUnicode_icu.h",
     "modules/skunicode/src/SkUnicode_icu_bidi.cpp",
@@ -2435,6 +2445,7 @@ SKUNICODE_ICU_RUNTIME_SRCS = [
 
 SKUNICODE_CLIENT_SRCS = [
     "modules/skunicode/src/SkUnicode.cpp",
+    "modules/skunicode/src/SkUnicode_tables.h",
     "modules/skunicode/src/SkUnicode_client.cpp",
     "modules/skunicode/src/SkUnicode_icu_bidi.cpp",
     "modules/skunicode/src/SkUnicode_icu_bidi.h",
@@ -375,6 +375,13 @@ SkCodec::Result SkAndroidCodec::getAndroidPixels(const SkImageInfo& info, void*
     return this->getAndroidPixels(info, pixels, rowBytes, nullptr);
 }
 
+SkCodec::DecodeCost SkAndroidCodec::estimateDecodeCost(const SkImageInfo& info,
+        const AndroidOptions* options) const {
+    // The sampled dimensions of info are smaller than the decoded area, which the codec's
+    // estimate already accounts for.
+    return fCodec->estimateDecodeCost(info, options);
+}
+
 bool SkAndroidCodec::getAndroidGainmap(SkGainmapInfo* info,
                                        std::unique_ptr<SkStream>* outGainmapImageStream) {
     if (!fCodec->onGetGainmapInfo(info, outGainmapImageStream)) {
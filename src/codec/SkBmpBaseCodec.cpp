@@ -9,6 +9,7 @@
 #include "include/core/SkStream.h"
 #include "include/private/SkEncodedInfo.h"
 #include "include/private/base/SkMalloc.h"
+#include "src/codec/SkCodecPriv.h"
 
 #include <utility>
 
@@ -19,3 +20,10 @@ SkBmpBaseCodec::SkBmpBaseCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> s
     : INHERITED(std::move(info), std::move(stream), bitsPerPixel, rowOrder)
     , fSrcBuffer(sk_malloc_canfail(this->srcRowBytes()))
 {}
+
+const uint8_t* SkBmpBaseCodec::readSrcRow() {
+    // The swizzlers load 16 and 32 bit pixels as uint16_t and uint32_t.
+    const size_t alignment = this->bitsPerPixel() == 16 ? 2 :
+                             this->bitsPerPixel() == 32 ? 4 : 1;
+    return read_bytes_in_place(this->stream(), this->srcBuffer(), this->srcRowBytes(), alignment);
+}
@@ -37,6 +37,16 @@ protected:
 
     uint8_t* srcBuffer() { return reinterpret_cast<uint8_t*>(fSrcBuffer.get()); }
 
+    /*
+     * Reads the next row of encoded pixels.
+     *
+     * If the stream is held in memory, this returns a pointer to the row in place. Otherwise
+     * the row is copied into srcBuffer().
+     *
+     * @return The row, or nullptr if the stream ended first
+     */
+    const uint8_t* readSrcRow();
+
 private:
     skia_private::UniqueVoidPtr fSrcBuffer;
 
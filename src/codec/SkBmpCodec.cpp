@@ -12,11 +12,13 @@
 #include "include/core/SkStream.h"
 #include "include/private/SkEncodedInfo.h"
 #include "include/private/base/SkAlign.h"
+#include "include/private/base/SkTemplates.h"
 #include "src/codec/SkBmpMaskCodec.h"
 #include "src/codec/SkBmpRLECodec.h"
 #include "src/codec/SkBmpStandardCodec.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkMasks.h"
+#include "src/codec/SkSampler.h"
 
 #include <cstring>
 #include <memory>
@@ -617,6 +619,13 @@ SkBmpCodec::SkBmpCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream,
     , fRowOrder(rowOrder)
     , fSrcRowBytes(SkAlign4(compute_row_bytes(this->dimensions().width(), fBitsPerPixel)))
     , fXformBuffer(nullptr)
+    , fIncrementalDst(nullptr)
+    , fIncrementalRowBytes(0)
+    , fIncrementalSubset(SkIRect::MakeEmpty())
+    , fIncrementalRowsStart(0)
+    , fIncrementalSrcRow(0)
+    , fIncrementalDstRows(0)
+    , fIncrementalResume(false)
 {}
 
 bool SkBmpCodec::onRewind() {
@@ -657,3 +666,111 @@ bool SkBmpCodec::skipRows(int count) {
 bool SkBmpCodec::onSkipScanlines(int count) {
     return this->skipRows(count);
 }
+
+SkCodec::Result SkBmpCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+        size_t dstRowBytes, const SkCodec::Options& options) {
+    // The AND mask of a bmp in an ico follows all of the pixel rows, so SkIcoCodec falls back to
+    // scanline decoding instead. Resuming a decode that ran out of data seeks back to the row it
+    // stopped in, which needs the position of the stream.
+    if (this->inIco() || !this->stream()->hasPosition()) {
+        return kUnimplemented;
+    }
+
+    // The subclasses apply the x extent of the subset. The y extent decides which rows
+    // onIncrementalDecode() decodes.
+    Result result = this->prepareToDecode(dstInfo, options);
+    if (kSuccess != result) {
+        return result;
+    }
+
+    fIncrementalDst = dst;
+    fIncrementalRowBytes = dstRowBytes;
+    fIncrementalSubset = options.fSubset ? *options.fSubset
+                                         : SkIRect::MakeSize(dstInfo.dimensions());
+    fIncrementalSrcRow = 0;
+    fIncrementalDstRows = 0;
+    fIncrementalResume = false;
+
+    // Skip straight to the first encoded row of the subset. Bottom-up bmps store the bottom row
+    // of the subset first.
+    const int rowsBefore = kTopDown_SkScanlineOrder == fRowOrder
+            ? fIncrementalSubset.top()
+            : this->dimensions().height() - fIncrementalSubset.bottom();
+    if (!this->skipRows(rowsBefore)) {
+        return kIncompleteInput;
+    }
+    fIncrementalRowsStart = this->stream()->getPosition();
+    return kSuccess;
+}
+
+SkCodec::Result SkBmpCodec::onIncrementalDecode(int* rowsDecoded) {
+    const int height = fIncrementalSubset.height();
+    SkSampler* sampler = this->getSampler(false);
+    const int sampleY = sampler ? sampler->sampleY() : 1;
+    const int dstHeight = get_scaled_dimension(height, sampleY);
+
+    // A previous call that ran out of data may have stopped partway through a row.
+    if (fIncrementalResume && !this->seekIncrementalRow(fIncrementalSrcRow)) {
+        return kCouldNotRewind;
+    }
+    fIncrementalResume = false;
+
+    const bool partialRow = this->decodeIncrementalRows(height, sampler, dstHeight);
+    if (fIncrementalDstRows != dstHeight) {
+        fIncrementalResume = true;
+        if (rowsDecoded) {
+            *rowsDecoded = fIncrementalDstRows + (partialRow ? 1 : 0);
+        }
+        return kIncompleteInput;
+    }
+    return kSuccess;
+}
+
+bool SkBmpCodec::seekIncrementalRow(int srcRow) {
+    return this->stream()->seek(fIncrementalRowsStart + srcRow * fSrcRowBytes);
+}
+
+bool SkBmpCodec::decodeIncrementalRows(int height, SkSampler* sampler, int dstHeight) {
+    // A row that the previous call stopped partway through has already been filled, so the first
+    // row that this call decodes must not be filled again.
+    Options options = this->options();
+    if (this->decodedPartialRow()) {
+        options.fZeroInitialized = kYes_ZeroInitialized;
+    }
+
+    const SkImageInfo& dstInfo = this->dstInfo();
+    if (dstHeight == height) {
+        // Bottom-up bmps decode from the end of dst, so only top-down rows move the start.
+        const int rows = height - fIncrementalSrcRow;
+        void* dst = fIncrementalDst;
+        if (kTopDown_SkScanlineOrder == fRowOrder) {
+            dst = SkTAddOffset<void>(dst, fIncrementalSrcRow * fIncrementalRowBytes);
+        }
+        const int decoded = this->decodeRows(dstInfo.makeWH(dstInfo.width(), rows), dst,
+                                             fIncrementalRowBytes, options);
+        fIncrementalSrcRow += decoded;
+        fIncrementalDstRows += decoded;
+        return decoded != rows && this->decodedPartialRow();
+    }
+
+    // Decode the rows that are sampled one at a time, and skip the others.
+    const SkImageInfo rowInfo = dstInfo.makeWH(dstInfo.width(), 1);
+    for (; fIncrementalSrcRow < height && fIncrementalDstRows < dstHeight; fIncrementalSrcRow++) {
+        const int row = this->getDstRow(fIncrementalSrcRow, height);
+        const int dstY = get_dst_coord(row, sampler->sampleY());
+        if (!sampler->rowNeeded(row) || dstY >= dstHeight) {
+            if (!this->skipRows(1)) {
+                return false;
+            }
+            continue;
+        }
+
+        void* dstRow = SkTAddOffset<void>(fIncrementalDst, dstY * fIncrementalRowBytes);
+        if (1 != this->decodeRows(rowInfo, dstRow, fIncrementalRowBytes, options)) {
+            return this->decodedPartialRow();
+        }
+        options.fZeroInitialized = this->options().fZeroInitialized;
+        fIncrementalDstRows++;
+    }
+    return false;
+}
@@ -10,6 +10,7 @@
 #include "include/codec/SkCodec.h"
 #include "include/codec/SkEncodedImageFormat.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkTypes.h"
 #include "modules/skcms/skcms.h"
 
@@ -17,6 +18,7 @@
 #include <cstdint>
 #include <memory>
 
+class SkSampler;
 class SkStream;
 struct SkEncodedInfo;
 struct SkImageInfo;
@@ -101,6 +103,11 @@ protected:
     SkCodec::Result prepareToDecode(const SkImageInfo& dstInfo,
             const SkCodec::Options& options);
 
+    /*
+     * Each subclass samples with its own SkSampler. Incremental decodes need it to sample in y.
+     */
+    SkSampler* getSampler(bool createIfNecessary) override = 0;
+
     uint32_t* xformBuffer() const { return fXformBuffer.get(); }
     void resetXformBuffer(int count) { fXformBuffer.reset(new uint32_t[count]); }
 
@@ -146,11 +153,53 @@ private:
 
     bool onSkipScanlines(int count) override;
 
+    /*
+     * Incremental decodes support subsets. The rows before the subset are skipped rather than
+     * decoded, and rows that sampling in y drops are skipped too.
+     */
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+            const SkCodec::Options&) override;
+
+    Result onIncrementalDecode(int* rowsDecoded) override;
+
+    /*
+     * Decodes the rows of the incremental decode's subset that sampling keeps, continuing from
+     * where the previous call stopped.
+     *
+     * @return Whether the decode stopped partway through a destination row
+     */
+    bool decodeIncrementalRows(int height, SkSampler* sampler, int dstHeight);
+
+    /*
+     * Moves the encoded data to the start of the row that is srcRow rows into the subset, after
+     * an incremental decode ran out of data partway through it.
+     */
+    virtual bool seekIncrementalRow(int srcRow);
+
+    /*
+     * Whether the last call to decodeRows() ran out of data after writing part of a row, which
+     * the next call continues instead of starting the row over.
+     */
+    virtual bool decodedPartialRow() const { return false; }
+
     const uint16_t              fBitsPerPixel;
     const SkScanlineOrder       fRowOrder;
     const size_t                fSrcRowBytes;
     std::unique_ptr<uint32_t[]> fXformBuffer;
 
+    // Only used for incremental decodes.
+    void*                       fIncrementalDst;
+    size_t                      fIncrementalRowBytes;
+    SkIRect                     fIncrementalSubset;
+    // Stream position of the first encoded row of the subset.
+    size_t                      fIncrementalRowsStart;
+    // Encoded rows of the subset that have been decoded or skipped, and destination rows
+    // that have been written, by earlier calls to onIncrementalDecode().
+    int                         fIncrementalSrcRow;
+    int                         fIncrementalDstRows;
+    // Whether the last call to onIncrementalDecode() ran out of data.
+    bool                        fIncrementalResume;
+
     using INHERITED = SkCodec;
 };
 
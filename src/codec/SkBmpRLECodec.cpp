@@ -41,8 +41,15 @@ SkBmpRLECodec::SkBmpRLECodec(SkEncodedInfo&& info,
     , fBytesPerColor(bytesPerColor)
     , fOffset(offset)
     , fBytesBuffered(0)
+    , fBufferOffset(0)
     , fCurrRLEByte(0)
     , fSampleX(1)
+    , fSubsetLeft(0)
+    , fSubsetWidth(this->dimensions().width())
+    , fNextRow(0)
+    , fLinesToSkip(0)
+    , fStartX(0)
+    , fPartialRow(false)
 {}
 
 /*
@@ -145,10 +152,36 @@ bool SkBmpRLECodec::initializeStreamBuffer() {
         SkCodecPrintf("Error: could not read RLE image data.\n");
         return false;
     }
+    fBufferOffset = 0;
     fCurrRLEByte = 0;
     return true;
 }
 
+bool SkBmpRLECodec::seekRLE(size_t offset) {
+    SkASSERT(offset >= fBufferOffset + fCurrRLEByte);
+    const size_t bufferEnd = fBufferOffset + fBytesBuffered;
+    if (offset <= bufferEnd) {
+        fCurrRLEByte = offset - fBufferOffset;
+        return true;
+    }
+
+    const size_t bytesToSkip = offset - bufferEnd;
+    if (this->stream()->skip(bytesToSkip) != bytesToSkip) {
+        return false;
+    }
+    fBufferOffset = offset;
+    fCurrRLEByte = 0;
+    fBytesBuffered = this->stream()->read(fStreamBuffer, kBufferSize);
+    return true;
+}
+
+void SkBmpRLECodec::indexRow(int row) {
+    // Rows are only indexed the first time they are reached.
+    if (fRowIndex.empty() || row > fRowIndex.back().fRow) {
+        fRowIndex.push_back({row, fBufferOffset + fCurrRLEByte});
+    }
+}
+
 /*
  * @return the number of bytes remaining in the stream buffer after
  *         attempting to read more bytes from the stream
@@ -166,30 +199,35 @@ size_t SkBmpRLECodec::checkForMoreData() {
     // Adjust the buffer ptr to the start of the unfilled data.
     buffer += remainingBytes;
 
-    // Try to read additional bytes from the stream.  There are fCurrRLEByte
-    // bytes of additional space remaining in the buffer, assuming that we
-    // have already copied remainingBytes to the start of the buffer.
-    size_t additionalBytes = this->stream()->read(buffer, fCurrRLEByte);
+    // Try to read additional bytes from the stream, into the rest of the buffer. The buffer
+    // may not have been full, if the stream had run out of data.
+    size_t additionalBytes = this->stream()->read(buffer, kBufferSize - remainingBytes);
 
     // Update counters and return the number of bytes we currently have
     // available.  We are at the start of the buffer again.
+    fBufferOffset += fCurrRLEByte;
     fCurrRLEByte = 0;
     fBytesBuffered = remainingBytes + additionalBytes;
     return fBytesBuffered;
 }
 
+bool SkBmpRLECodec::isColumnNeeded(uint32_t x, int dstWidth) const {
+    // is_coord_necessary() also rejects the columns past the end of the subset.
+    return x >= (uint32_t)fSubsetLeft && is_coord_necessary(x - fSubsetLeft, fSampleX, dstWidth);
+}
+
 /*
  * Set an RLE pixel using the color table
  */
 void SkBmpRLECodec::setPixel(void* dst, size_t dstRowBytes,
                              const SkImageInfo& dstInfo, uint32_t x, uint32_t y,
                              uint8_t index) {
-    if (dst && is_coord_necessary(x, fSampleX, dstInfo.width())) {
+    if (dst && this->isColumnNeeded(x, dstInfo.width())) {
         // Set the row
         uint32_t row = this->getDstRow(y, dstInfo.height());
 
         // Set the pixel based on destination color type
-        const int dstX = get_dst_coord(x, fSampleX);
+        const int dstX = get_dst_coord(x - fSubsetLeft, fSampleX);
         switch (dstInfo.colorType()) {
             case kRGBA_8888_SkColorType:
             case kBGRA_8888_SkColorType: {
@@ -218,12 +256,12 @@ void SkBmpRLECodec::setRGBPixel(void* dst, size_t dstRowBytes,
                                 const SkImageInfo& dstInfo, uint32_t x,
                                 uint32_t y, uint8_t red, uint8_t green,
                                 uint8_t blue) {
-    if (dst && is_coord_necessary(x, fSampleX, dstInfo.width())) {
+    if (dst && this->isColumnNeeded(x, dstInfo.width())) {
         // Set the row
         uint32_t row = this->getDstRow(y, dstInfo.height());
 
         // Set the pixel based on destination color type
-        const int dstX = get_dst_coord(x, fSampleX);
+        const int dstX = get_dst_coord(x - fSubsetLeft, fSampleX);
         switch (dstInfo.colorType()) {
             case kRGBA_8888_SkColorType: {
                 SkPMColor* dstRow = SkTAddOffset<SkPMColor>(dst, row * (int) dstRowBytes);
@@ -251,16 +289,22 @@ void SkBmpRLECodec::setRGBPixel(void* dst, size_t dstRowBytes,
 
 SkCodec::Result SkBmpRLECodec::onPrepareToDecode(const SkImageInfo& dstInfo,
         const SkCodec::Options& options) {
-    // FIXME: Support subsets for scanline decodes.
+    // Only the columns of a subset are handled here. SkBmpCodec skips the rows outside of it.
     if (options.fSubset) {
-        // Subsets are not supported.
-        return kUnimplemented;
+        fSubsetLeft = options.fSubset->left();
+        fSubsetWidth = options.fSubset->width();
+    } else {
+        fSubsetLeft = 0;
+        fSubsetWidth = this->dimensions().width();
     }
 
     // Reset fSampleX. If it needs to be a value other than 1, it will get modified by
     // the sampler.
     fSampleX = 1;
     fLinesToSkip = 0;
+    fStartX = 0;
+    fPartialRow = false;
+    fNextRow = 0;
 
     SkColorType colorTableColorType = dstInfo.colorType();
     if (this->colorXform()) {
@@ -292,6 +336,8 @@ SkCodec::Result SkBmpRLECodec::onPrepareToDecode(const SkImageInfo& dstInfo,
 int SkBmpRLECodec::decodeRows(const SkImageInfo& info, void* dst, size_t dstRowBytes,
         const Options& opts) {
     int height = info.height();
+    const int startRow = fNextRow;
+    fNextRow += height;
 
     // Account for sampling.
     SkImageInfo dstInfo = info.makeWH(this->fillWidth(), height);
@@ -304,9 +350,11 @@ int SkBmpRLECodec::decodeRows(const SkImageInfo& info, void* dst, size_t dstRowB
 
     // Adjust the height and the dst if the previous call to decodeRows() left us
     // with lines that need to be skipped.
+    const int linesSkipped = fLinesToSkip;
     if (height > fLinesToSkip) {
         height -= fLinesToSkip;
-        if (dst) {
+        // Bottom up rows are written from the end of dst, so only top down rows move dst.
+        if (dst && kTopDown_SkScanlineOrder == this->getScanlineOrder()) {
             dst = SkTAddOffset<void>(dst, fLinesToSkip * dstRowBytes);
         }
         fLinesToSkip = 0;
@@ -329,12 +377,39 @@ int SkBmpRLECodec::decodeRows(const SkImageInfo& info, void* dst, size_t dstRowB
                 sk_bzero(this->xformBuffer(), count * sizeof(uint32_t));
                 decodeDst = this->xformBuffer();
                 decodeRowBytes = dstInfo.width() * sizeof(uint32_t);
+                if (fPartialRow && fPartialXformRow.size() == (size_t) dstInfo.width()) {
+                    // Restore the pixels that the last call decoded into the row it stopped in.
+                    memcpy(SkTAddOffset<void>(decodeDst,
+                                              this->getDstRow(0, height) * decodeRowBytes),
+                           fPartialXformRow.data(), decodeRowBytes);
+                }
             }
         }
     }
 
-    int decodedHeight = this->decodeRLE(decodeInfo, decodeDst, decodeRowBytes);
+    int decodedHeight = this->decodeRLE(decodeInfo, decodeDst, decodeRowBytes,
+                                        startRow + linesSkipped);
+    if (decodedHeight < height) {
+        // The next call continues with the row that this one stopped in.
+        fNextRow = startRow + linesSkipped + decodedHeight;
+    }
     if (this->colorXform() && decodeDst) {
+        if (fPartialRow && decodeDst != dst) {
+            // Keep the xform source of the row that the data ran out in, so that the next call
+            // can finish it, and convert what has been decoded so far.
+            const int partialRow = this->getDstRow(decodedHeight, height);
+            const void* partialSrc = SkTAddOffset<void>(decodeDst, partialRow * decodeRowBytes);
+            fPartialXformRow.resize(dstInfo.width());
+            memcpy(fPartialXformRow.data(), partialSrc, decodeRowBytes);
+            this->applyColorXform(SkTAddOffset<void>(dst, partialRow * dstRowBytes), partialSrc,
+                                  dstInfo.width());
+        }
+        // Bottom up rows are decoded from the end of dst.
+        if (kBottomUp_SkScanlineOrder == this->getScanlineOrder()) {
+            const int firstRow = height - decodedHeight;
+            decodeDst = SkTAddOffset<void>(decodeDst, firstRow * decodeRowBytes);
+            dst = SkTAddOffset<void>(dst, firstRow * dstRowBytes);
+        }
         for (int y = 0; y < decodedHeight; y++) {
             this->applyColorXform(dst, decodeDst, dstInfo.width());
             decodeDst = SkTAddOffset<void>(decodeDst, decodeRowBytes);
@@ -342,10 +417,12 @@ int SkBmpRLECodec::decodeRows(const SkImageInfo& info, void* dst, size_t dstRowB
         }
     }
 
-    return decodedHeight;
+    // The skipped lines were left transparent, which counts as decoded.
+    return linesSkipped + decodedHeight;
 }
 
-int SkBmpRLECodec::decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes) {
+int SkBmpRLECodec::decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                             int startRow) {
     // Use the original width to count the number of pixels in each row.
     const int width = this->dimensions().width();
 
@@ -359,13 +436,25 @@ int SkBmpRLECodec::decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRo
     constexpr uint8_t RLE_DELTA = 2;
 
     // Destination parameters
-    int x = 0;
+    int x = fStartX;
     int y = 0;
+    fStartX = 0;
+    fPartialRow = false;
+
+    // When the data runs out, remember the column so that a later call can continue the row
+    // once more data has arrived. Entries are only consumed once all of their bytes are here.
+    auto stopEarly = [&]() {
+        fStartX = x;
+        fPartialRow = dst && x > 0;
+        return y;
+    };
 
     while (true) {
         // If we have reached a row that is beyond the requested height, we have
         // succeeded.
         if (y >= height) {
+            // A delta may have left us partway into the next row.
+            fStartX = x;
             // It would be better to check for the EOF marker before indicating
             // success, but we may be performing a scanline decode, which
             // would require us to stop before decoding the full height.
@@ -375,7 +464,7 @@ int SkBmpRLECodec::decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRo
         // Every entry takes at least two bytes
         if ((int) fBytesBuffered - fCurrRLEByte < 2) {
             if (this->checkForMoreData() < 2) {
-                return y;
+                return stopEarly();
             }
         }
 
@@ -392,15 +481,19 @@ int SkBmpRLECodec::decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRo
                 case RLE_EOL:
                     x = 0;
                     y++;
+                    this->indexRow(startRow + y);
                     break;
                 case RLE_EOF:
                     return height;
                 case RLE_DELTA: {
-                    // Two bytes are needed to specify delta
+                    // Two bytes are needed to specify delta. Keep the escape in the buffer while
+                    // reading more, in case they are not here yet.
                     if ((int) fBytesBuffered - fCurrRLEByte < 2) {
-                        if (this->checkForMoreData() < 2) {
-                            return y;
+                        fCurrRLEByte -= 2;
+                        if (this->checkForMoreData() < 4) {
+                            return stopEarly();
                         }
+                        fCurrRLEByte += 2;
                     }
                     // Modify x and y
                     const uint8_t dx = fStreamBuffer[fCurrRLEByte++];
@@ -412,6 +505,7 @@ int SkBmpRLECodec::decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRo
                         return y - dy;
                     } else if (y > height) {
                         fLinesToSkip = y - height;
+                        fStartX = x;
                         return height;
                     }
                     break;
@@ -435,14 +529,16 @@ int SkBmpRLECodec::decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRo
                     // 3 (max bytes per pixel) + 1 (aligned) = 766. If
                     // fStreamBuffer was smaller than this,
                     // checkForMoreData would never succeed for some bmps.
-                    static_assert(255 * 3 + 1 < kBufferSize,
+                    static_assert(2 + 255 * 3 + 1 < kBufferSize,
                                   "kBufferSize needs to be larger!");
                     const size_t alignedRowBytes = SkAlign2(rowBytes);
                     if ((int) fBytesBuffered - fCurrRLEByte < alignedRowBytes) {
-                        SkASSERT(alignedRowBytes < kBufferSize);
-                        if (this->checkForMoreData() < alignedRowBytes) {
-                            return y;
+                        SkASSERT(2 + alignedRowBytes < kBufferSize);
+                        fCurrRLEByte -= 2;
+                        if (this->checkForMoreData() < 2 + alignedRowBytes) {
+                            return stopEarly();
                         }
+                        fCurrRLEByte += 2;
                     }
                     // Set numPixels number of pixels
                     while ((numPixels > 0) && (x < width)) {
@@ -499,9 +595,11 @@ int SkBmpRLECodec::decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRo
                 // There are two more required bytes to finish encoding the
                 // color.
                 if ((int) fBytesBuffered - fCurrRLEByte < 2) {
-                    if (this->checkForMoreData() < 2) {
-                        return y;
+                    fCurrRLEByte -= 2;
+                    if (this->checkForMoreData() < 4) {
+                        return stopEarly();
                     }
+                    fCurrRLEByte += 2;
                 }
 
                 // Fill the pixels up to endX with the specified color
@@ -534,11 +632,36 @@ int SkBmpRLECodec::decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRo
 }
 
 bool SkBmpRLECodec::skipRows(int count) {
+    // Jump to the last indexed row at or before the target, if it is past the row that the RLE
+    // data is at now.
+    const int targetRow = fNextRow + count;
+    auto next = std::upper_bound(fRowIndex.begin(), fRowIndex.end(), targetRow,
+                                 [](int row, const RowStart& start) { return row < start.fRow; });
+    if (next != fRowIndex.begin()) {
+        const RowStart& start = *(next - 1);
+        if (start.fRow > fNextRow + fLinesToSkip) {
+            if (!this->seekRLE(start.fOffset)) {
+                return false;
+            }
+            fNextRow = start.fRow;
+            fLinesToSkip = 0;
+            fStartX = 0;
+            fPartialRow = false;
+            count = targetRow - start.fRow;
+        }
+    }
+
     const SkImageInfo rowInfo = SkImageInfo::Make(this->dimensions().width(), count,
                                                   kN32_SkColorType, kUnpremul_SkAlphaType);
     return count == this->decodeRows(rowInfo, nullptr, 0, this->options());
 }
 
+bool SkBmpRLECodec::seekIncrementalRow(int) {
+    // decodeRLE() stops at the start of an RLE entry, and the next call continues from there. A
+    // partial row decoded through fXformBuffer is restored from fPartialXformRow.
+    return true;
+}
+
 // FIXME: Make SkBmpRLECodec have no knowledge of sampling.
 //        Or it should do all sampling natively.
 //        It currently is a hybrid that needs to know what SkScaledCodec is doing.
@@ -577,5 +700,5 @@ int SkBmpRLECodec::setSampleX(int sampleX) {
 }
 
 int SkBmpRLECodec::fillWidth() const {
-    return get_scaled_dimension(this->dimensions().width(), fSampleX);
+    return get_scaled_dimension(fSubsetWidth, fSampleX);
 }
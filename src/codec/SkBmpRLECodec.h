@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 class SkStream;
 enum SkColorType : int;
@@ -72,6 +73,22 @@ private:
 
     bool initializeStreamBuffer();
 
+    /*
+     * Moves the RLE data to offset bytes past the start of the pixel data. The offset must not
+     * be before the current position.
+     */
+    bool seekRLE(size_t offset);
+
+    /*
+     * Records that the RLE data for row starts at the current position.
+     */
+    void indexRow(int row);
+
+    /*
+     * Whether the pixel at column x of the image is in the subset and is kept by sampling.
+     */
+    bool isColumnNeeded(uint32_t x, int dstWidth) const;
+
     /*
      * Before signalling kIncompleteInput, we should attempt to load the
      * stream buffer with additional data.
@@ -99,10 +116,18 @@ private:
      */
     int decodeRows(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
             const Options& opts) override;
-    int decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes);
+    int decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes, int startRow);
 
+    /*
+     * Jumps ahead with the row index if it can, and decodes the rest of the way without
+     * writing pixels.
+     */
     bool skipRows(int count) override;
 
+    bool seekIncrementalRow(int srcRow) override;
+
+    bool decodedPartialRow() const override { return fPartialRow; }
+
     SkSampler* getSampler(bool createIfNecessary) override;
 
     sk_sp<SkColorTable>               fColorTable;
@@ -114,17 +139,46 @@ private:
     inline static constexpr size_t    kBufferSize = 4096;
     uint8_t                           fStreamBuffer[kBufferSize];
     size_t                            fBytesBuffered;
+    // Offset of fStreamBuffer[0] from the start of the pixel data.
+    size_t                            fBufferOffset;
 
     uint32_t                          fCurrRLEByte;
     int                               fSampleX;
     std::unique_ptr<SkSampler>        fSampler;
 
+    // The columns of the subset being decoded.
+    int                               fSubsetLeft;
+    int                               fSubsetWidth;
+
+    // The encoded row that the next call to decodeRows() starts at.
+    int                               fNextRow;
+
+    // Where the RLE data of a row starts, for rows that start on a new line (rather than after a
+    // delta). The RLE data must be parsed from the start to find where a row begins, so the rows
+    // are indexed by each decode, and later decodes skip to the rows they need. The pixel data
+    // does not change, so the index is kept across rewinds.
+    struct RowStart {
+        int    fRow;
+        size_t fOffset;
+    };
+    std::vector<RowStart>             fRowIndex;
+
     // Scanline decodes allow the client to ask for a single scanline at a time.
     // This can be tricky when the RLE encoding instructs the decoder to jump down
     // multiple lines.  This field keeps track of lines that need to be skipped
     // on subsequent calls to decodeRows().
     int                               fLinesToSkip;
 
+    // The column that the jump left off at, for the first row after fLinesToSkip, or that the
+    // RLE data ran out at.
+    int                               fStartX;
+
+    // Whether the RLE data ran out after pixels of the current row had been written.
+    bool                              fPartialRow;
+
+    // The xform source of the partial row, when decodeRows() decodes through fXformBuffer.
+    std::vector<uint32_t>             fPartialXformRow;
+
     using INHERITED = SkBmpCodec;
 };
 #endif  // SkBmpRLECodec_DEFINED
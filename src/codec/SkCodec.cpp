@@ -16,17 +16,20 @@
 #include "include/core/SkData.h"
 #include "include/core/SkImage.h" // IWYU pragma: keep
 #include "include/core/SkMatrix.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkStream.h"
 #include "include/private/base/SkTemplates.h"
 #include "modules/skcms/skcms.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkFrameHolder.h"
 #include "src/codec/SkSampler.h"
+#include "src/codec/SkScanlineResampler.h"
 
 // We always include and compile in these BMP codecs
 #include "src/codec/SkBmpCodec.h"
 #include "src/codec/SkWbmpCodec.h"
 
+#include <algorithm>
 #include <utility>
 
 #ifdef SK_CODEC_DECODES_AVIF
@@ -475,6 +478,108 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
     return result;
 }
 
+SkCodec::Result SkCodec::getResizedPixels(const SkPixmap& dst,
+                                          const SkSamplingOptions& sampling) {
+    if (kUnknown_SkColorType == dst.colorType()) {
+        return kInvalidConversion;
+    }
+    if (nullptr == dst.addr() || dst.dimensions().isEmpty()) {
+        return kInvalidParameters;
+    }
+    if (this->dimensionsSupported(dst.dimensions())) {
+        return this->getPixels(dst);
+    }
+
+    // Let the codec do as much of a downscale as it can while it decodes.
+    SkISize decodeSize = this->dimensions();
+    const float scale = std::max((float)dst.width() / decodeSize.width(),
+                                 (float)dst.height() / decodeSize.height());
+    if (scale < 1) {
+        const SkISize scaledSize = this->getScaledDimensions(scale);
+        if (scaledSize.width() >= dst.width() && scaledSize.height() >= dst.height()) {
+            decodeSize = scaledSize;
+        }
+    }
+    const SkImageInfo decodeInfo = dst.info().makeDimensions(decodeSize);
+
+    if (auto resampler = SkScanlineResampler::Make(decodeSize, dst.info(), sampling)) {
+        const Result result = this->startScanlineDecode(decodeInfo);
+        if (result == kSuccess && this->getScanlineOrder() == kTopDown_SkScanlineOrder) {
+            return resampler->resample(this, dst);
+        }
+        if (result != kSuccess && result != kUnimplemented) {
+            return result;
+        }
+    }
+
+    SkBitmap decoded;
+    if (!decoded.tryAllocPixels(decodeInfo)) {
+        return kInternalError;
+    }
+    const Result result = this->getPixels(decoded.pixmap());
+    switch (result) {
+        case kSuccess:
+        case kIncompleteInput:
+        case kErrorInInput:
+            return decoded.pixmap().scalePixels(dst, sampling) ? result : kInternalError;
+        default:
+            return result;
+    }
+}
+
+// Of the work of decoding a pixel of a sequential image, the share that goes to converting it to
+// the destination (swizzling and color transforming), rather than to decompressing it.
+static constexpr double kConvertShare = 0.25;
+
+static int64_t area(const SkIRect& rect) {
+    return (int64_t) rect.width() * rect.height();
+}
+
+SkCodec::DecodeCost SkCodec::estimateDecodeCost(const SkImageInfo& dstInfo,
+                                                const Options* options) const {
+    const Options defaultOptions;
+    if (!options) {
+        options = &defaultOptions;
+    }
+    const SkIRect srcRect = options->fSubset ? *options->fSubset
+                                             : SkIRect::MakeSize(this->dimensions());
+    DecodeCost cost;
+    if (srcRect.isEmpty()) {
+        return cost;
+    }
+
+    // An animated image first decodes the frames that the requested frame depends on, unless
+    // one of them is already in dst.
+    int64_t srcPixels = 0;
+    FrameInfo frameInfo;
+    if (this->getFrameInfo(options->fFrameIndex, &frameInfo)) {
+        for (int frame = options->fFrameIndex;
+             frame != kNoFrame && frame != options->fPriorFrame;
+             frame = frameInfo.fRequiredFrame) {
+            if (!this->getFrameInfo(frame, &frameInfo)) {
+                break;
+            }
+            SkIRect frameRect = frameInfo.fFrameRect;
+            if (frameRect.intersect(srcRect)) {
+                srcPixels += area(frameRect);
+            }
+        }
+    } else {
+        srcPixels = area(srcRect);
+    }
+
+    // Every decoded pixel is decompressed, but only the ones in dst are converted.
+    const double dstScale = std::min(1.0, (double) area(dstInfo.bounds()) / area(srcRect));
+    cost.fWork = srcPixels * ((1 - kConvertShare) + kConvertShare * dstScale);
+
+    // A row of encoded pixels, and a row for the color transform.
+    const size_t srcRowBits = SkToSizeT(srcRect.width()) * this->getEncodedInfo().bitsPerPixel();
+    cost.fScratchBytes = (srcRowBits + 7) / 8 + SkToSizeT(dstInfo.width()) * sizeof(uint32_t);
+
+    this->onEstimateDecodeCost(dstInfo, srcRect, &cost);
+    return cost;
+}
+
 std::tuple<sk_sp<SkImage>, SkCodec::Result> SkCodec::getImage(const SkImageInfo& info,
                                                               const Options* options) {
     SkBitmap bm;
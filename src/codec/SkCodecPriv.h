@@ -9,12 +9,19 @@
 #define SkCodecPriv_DEFINED
 
 #include "include/codec/SkEncodedOrigin.h"
+#include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkEncodedInfo.h"
+#include "include/private/base/SkTemplates.h"
 #include "src/codec/SkColorTable.h"
 
+#include <algorithm>
+#include <cstring>
+
 #ifdef SK_PRINT_CODEC_MESSAGES
     #define SkCodecPrintf SkDebugf
 #else
@@ -108,6 +115,38 @@ static inline const SkPMColor* get_color_ptr(SkColorTable* colorTable) {
      return nullptr != colorTable ? colorTable->readColors() : nullptr;
 }
 
+// Reads everything that |stream| has available into |data| after its first |size| bytes,
+// growing |data| as needed, and returns the new number of valid bytes. |data| may have
+// capacity beyond the returned size, so that reading a stream in small chunks does not
+// copy the bytes already read more than a few times.
+static inline size_t read_available(SkStream* stream, sk_sp<SkData>* data, size_t size) {
+    constexpr size_t kMinCapacity = 16 * 1024;
+    while (!stream->isAtEnd()) {
+        const size_t capacity = *data ? (*data)->size() : 0;
+        if (size == capacity) {
+            size_t newCapacity = std::max(capacity * 2, kMinCapacity);
+            if (stream->hasLength() && stream->hasPosition() &&
+                stream->getLength() > stream->getPosition()) {
+                newCapacity = std::max(newCapacity,
+                                       size + stream->getLength() - stream->getPosition());
+            }
+            sk_sp<SkData> grown = SkData::MakeUninitialized(newCapacity);
+            if (size) {
+                memcpy(grown->writable_data(), (*data)->data(), size);
+            }
+            *data = std::move(grown);
+        }
+
+        const size_t bytesRead = stream->read(
+                SkTAddOffset<void>((*data)->writable_data(), size), (*data)->size() - size);
+        if (!bytesRead) {
+            break;
+        }
+        size += bytesRead;
+    }
+    return size;
+}
+
 /*
  * Compute row bytes for an image using pixels per byte
  */
@@ -137,6 +176,29 @@ static inline size_t compute_row_bytes(int width, uint32_t bitsPerPixel) {
     }
 }
 
+/*
+ * Reads the next size bytes of the stream.
+ * If the stream is held in memory and the bytes are aligned to alignment, this skips over them and
+ * returns a pointer to them in the stream's memory, without copying. Otherwise it reads them into
+ * buffer, which must hold size bytes, and returns buffer.
+ * Returns nullptr if the stream ends first.
+ */
+static inline const uint8_t* read_bytes_in_place(SkStream* stream, void* buffer, size_t size,
+                                                 size_t alignment) {
+    if (const void* memoryBase = stream->getMemoryBase()) {
+        SkASSERT(stream->hasPosition() && stream->hasLength());
+        const size_t position = stream->getPosition();
+        const uint8_t* bytes = static_cast<const uint8_t*>(memoryBase) + position;
+        if (reinterpret_cast<uintptr_t>(bytes) % alignment == 0) {
+            if (size > stream->getLength() - position || stream->skip(size) != size) {
+                return nullptr;
+            }
+            return bytes;
+        }
+    }
+    return stream->read(buffer, size) == size ? static_cast<const uint8_t*>(buffer) : nullptr;
+}
+
 /*
  * Get a byte from a buffer
  * This method is unsafe, the caller is responsible for performing a check
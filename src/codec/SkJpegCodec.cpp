@@ -28,6 +28,7 @@
 #include "src/codec/SkJpegConstants.h"
 #include "src/codec/SkJpegDecoderMgr.h"
 #include "src/codec/SkJpegPriv.h"
+#include "src/codec/SkJpegSourceMgr.h"
 #include "src/codec/SkParseEncodedOrigin.h"
 #include "src/codec/SkSwizzler.h"
 
@@ -343,13 +344,31 @@ std::unique_ptr<SkCodec> SkJpegCodec::MakeFromStream(std::unique_ptr<SkStream> s
     return nullptr;
 }
 
+/*
+ * Return the size of the coefficient buffer that libjpeg-turbo decodes all of the scans of a
+ * progressive image into, or zero if the image is not progressive.
+ */
+static size_t progressive_coef_bytes(const jpeg_decompress_struct* dinfo) {
+    if (!dinfo->progressive_mode) {
+        return 0;
+    }
+    size_t bytes = 0;
+    for (int i = 0; i < dinfo->num_components; i++) {
+        const jpeg_component_info& component = dinfo->comp_info[i];
+        bytes += SkToSizeT(component.width_in_blocks) * component.height_in_blocks *
+                 DCTSIZE2 * sizeof(JCOEF);
+    }
+    return bytes;
+}
+
 SkJpegCodec::SkJpegCodec(SkEncodedInfo&& info,
                          std::unique_ptr<SkStream> stream,
                          JpegDecoderMgr* decoderMgr,
                          SkEncodedOrigin origin)
         : INHERITED(std::move(info), skcms_PixelFormat_RGBA_8888, std::move(stream), origin)
         , fDecoderMgr(decoderMgr)
-        , fReadyState(decoderMgr->dinfo()->global_state) {}
+        , fReadyState(decoderMgr->dinfo()->global_state)
+        , fProgressiveCoefBytes(progressive_coef_bytes(decoderMgr->dinfo())) {}
 SkJpegCodec::~SkJpegCodec() = default;
 
 /*
@@ -413,6 +432,48 @@ SkISize SkJpegCodec::onGetScaledDimensions(float desiredScale) const {
     return SkISize::Make(dinfo.output_width, dinfo.output_height);
 }
 
+// Of the work of decoding a pixel of a sequential JPEG (see SkCodec::DecodeCost), the shares
+// that go to entropy decoding it, and to the IDCT, upsampling and color conversion. The rest
+// converts it to the destination.
+static constexpr double kEntropyWork = 0.3;
+static constexpr double kTransformWork = 0.45;
+
+void SkJpegCodec::onEstimateDecodeCost(const SkImageInfo& dstInfo,
+                                       const SkIRect& srcRect,
+                                       DecodeCost* cost) const {
+    const int64_t srcPixels = (int64_t) srcRect.width() * srcRect.height();
+    if (fProgressiveCoefBytes) {
+        // Every scan of the whole image is entropy decoded into the coefficient buffer before
+        // any rows are output, which roughly doubles the work of a pixel.
+        constexpr double kProgressiveWork = 1.0;
+        const int64_t imagePixels =
+                (int64_t) this->dimensions().width() * this->dimensions().height();
+        cost->fWork += kProgressiveWork * imagePixels;
+        cost->fScratchBytes += fProgressiveCoefBytes;
+    } else {
+        // Huffman decoding cannot seek, so the rows above the subset, and the columns to either
+        // side of it, are entropy decoded too.
+        const int64_t entropyPixels = (int64_t) this->dimensions().width() * srcRect.bottom();
+        cost->fWork += kEntropyWork * (entropyPixels - srcPixels);
+    }
+
+    // When dst is smaller than srcRect, the decode (or SkSampledCodec) asks for the smallest
+    // scaled IDCT that still covers dst, and the IDCT, upsampling and color conversion then only
+    // produce that many pixels. Only entropy decoding is done at full size.
+    const SkISize full = this->dimensions();
+    double outputScale = 1;
+    for (int num = 1; num < 8; num++) {
+        const SkISize scaled = this->getScaledDimensions(num / 8.0f);
+        const double sx = (double) scaled.width() / full.width();
+        const double sy = (double) scaled.height() / full.height();
+        if (sx * srcRect.width() >= dstInfo.width() && sy * srcRect.height() >= dstInfo.height()) {
+            outputScale = sx * sy;
+            break;
+        }
+    }
+    cost->fWork -= kTransformWork * (1 - outputScale) * srcPixels;
+}
+
 bool SkJpegCodec::onRewind() {
     JpegDecoderMgr* decoderMgr = nullptr;
     if (kSuccess != ReadHeader(this->stream(), nullptr, &decoderMgr, nullptr)) {
@@ -538,10 +599,13 @@ bool SkJpegCodec::onDimensionsSupported(const SkISize& size) {
 }
 
 int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count,
-                          const Options& opts) {
+                          const Options& opts, bool* hadError) {
     // Set the jump location for libjpeg-turbo errors
     skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
     if (setjmp(jmp)) {
+        if (hadError) {
+            *hadError = true;
+        }
         return 0;
     }
 
@@ -838,6 +902,112 @@ bool SkJpegCodec::onSkipScanlines(int count) {
     return (uint32_t) count == jpeg_skip_scanlines(fDecoderMgr->dinfo(), count);
 }
 
+SkCodec::Result SkJpegCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+        size_t rowBytes, const Options& options) {
+    // Only whole images are decoded incrementally.
+    if (options.fSubset) {
+        return kUnimplemented;
+    }
+
+    // Set the jump location for libjpeg errors
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+    }
+
+    // jpeg_start_decompress() may suspend, so it waits for onIncrementalDecode(). Calculate the
+    // output dimensions that it will use, so that the swizzler can be set up now. SkSampledCodec
+    // calls getSampler() before it decodes any rows.
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    jpeg_calc_output_dimensions(dinfo);
+
+    if (needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+                                            this->getEncodedInfo().profile(), this->colorXform())) {
+        this->initializeSwizzler(dstInfo, options, true);
+    }
+
+    if (!this->allocateStorage(dstInfo)) {
+        return kInternalError;
+    }
+
+    fDecoderMgr->getSourceMgr()->startSuspending();
+    fIncrementalDst = dst;
+    fIncrementalRowBytes = rowBytes;
+    fIncrementalSrcRow = 0;
+    fIncrementalDstRow = 0;
+    fIncrementalStartedDecompress = false;
+    return kSuccess;
+}
+
+SkCodec::Result SkJpegCodec::onIncrementalDecode(int* rowsDecoded) {
+    SkJpegSourceMgr* sourceMgr = fDecoderMgr->getSourceMgr();
+    jpeg_source_mgr* src = fDecoderMgr->dinfo()->src;
+
+    // Decode until libjpeg runs out of bytes, then add the ones that have arrived since.
+    while (true) {
+        const Result result = this->decodeAvailableRows();
+        if (kIncompleteInput != result) {
+            return result;
+        }
+        if (!sourceMgr->readAvailableBytes(src->next_input_byte, src->bytes_in_buffer)) {
+            break;
+        }
+    }
+
+    if (rowsDecoded) {
+        *rowsDecoded = fIncrementalDstRow;
+    }
+    return kIncompleteInput;
+}
+
+/*
+ * Decodes rows until the image is finished, or libjpeg suspends for more data. In the latter case
+ * this returns kIncompleteInput, and can be called again once more data has been read.
+ */
+SkCodec::Result SkJpegCodec::decodeAvailableRows() {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+
+    // Set the jump location for libjpeg errors
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+    }
+
+    if (!fIncrementalStartedDecompress) {
+        // This reads every scan of a progressive image before it returns true.
+        if (!jpeg_start_decompress(dinfo)) {
+            return kIncompleteInput;
+        }
+        fIncrementalStartedDecompress = true;
+    }
+
+    while (fIncrementalSrcRow < this->dstInfo().height()) {
+        bool hadError = false;
+        int rows;
+        if (!fSwizzler || fSwizzler->rowNeeded(fIncrementalSrcRow)) {
+            void* dst = SkTAddOffset<void>(fIncrementalDst,
+                                           fIncrementalDstRow * fIncrementalRowBytes);
+            rows = this->readRows(this->dstInfo(), dst, fIncrementalRowBytes, 1, this->options(),
+                                  &hadError);
+            fIncrementalDstRow += rows;
+        } else {
+            // The rows that are sampled away still need to be decoded.
+            JSAMPLE* decodeDst = (JSAMPLE*) fSwizzleSrcRow;
+            rows = jpeg_read_scanlines(dinfo, &decodeDst, 1);
+        }
+
+        if (hadError) {
+            return kInvalidInput;
+        }
+        if (0 == rows) {
+            return kIncompleteInput;
+        }
+        fIncrementalSrcRow++;
+    }
+
+    return kSuccess;
+}
+
 static bool is_yuv_supported(const jpeg_decompress_struct* dinfo,
                              const SkJpegCodec& codec,
                              const SkYUVAPixmapInfo::SupportedDataTypes* supportedDataTypes,
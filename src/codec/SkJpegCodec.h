@@ -77,6 +77,10 @@ protected:
     bool onGetGainmapInfo(SkGainmapInfo* info,
                           std::unique_ptr<SkStream>* gainmapImageStream) override;
 
+    void onEstimateDecodeCost(const SkImageInfo& dstInfo,
+                              const SkIRect& srcRect,
+                              DecodeCost*) const override;
+
 private:
     /*
      * Allows SkRawCodec to communicate the color profile from the exif data.
@@ -129,7 +133,18 @@ private:
     void initializeSwizzler(const SkImageInfo& dstInfo, const Options& options,
                             bool needsCMYKToRGB);
     bool SK_WARN_UNUSED_RESULT allocateStorage(const SkImageInfo& dstInfo);
-    int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
+    // Returns the number of rows read. If libjpeg fails, sets |hadError| when it is not null.
+    int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&,
+                 bool* hadError = nullptr);
+
+    /*
+     * Incremental decoding. libjpeg suspends when it runs out of data, and resumes from the bytes
+     * that it has not consumed once more have been read.
+     */
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+            const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
+    Result decodeAvailableRows();
 
     /*
      * Scanline decoding.
@@ -146,6 +161,9 @@ private:
     // This allows us to safely call onGetScaledDimensions() at any time.
     const int                          fReadyState;
 
+    // Bytes of the coefficient buffer that libjpeg-turbo allocates for the whole image when it
+    // is progressive, or zero if it is not. Saved from the header, like fReadyState.
+    const size_t                       fProgressiveCoefBytes;
 
     skia_private::AutoTMalloc<uint8_t>             fStorage;
     uint8_t* fSwizzleSrcRow = nullptr;
@@ -158,6 +176,15 @@ private:
 
     std::unique_ptr<SkSwizzler>        fSwizzler;
 
+    // The destination and progress of an incremental decode. Rows are counted in the output of
+    // libjpeg (fIncrementalSrcRow) and in the destination (fIncrementalDstRow), which differ when
+    // the swizzler samples rows.
+    void*                              fIncrementalDst = nullptr;
+    size_t                             fIncrementalRowBytes = 0;
+    int                                fIncrementalSrcRow = 0;
+    int                                fIncrementalDstRow = 0;
+    bool                               fIncrementalStartedDecompress = false;
+
     friend class SkRawCodec;
 
     using INHERITED = SkCodec;
@@ -136,6 +136,10 @@ void JpegDecoderMgr::SourceMgr::SkipInputData(j_decompress_ptr dinfo, long num_b
 boolean JpegDecoderMgr::SourceMgr::FillInputBuffer(j_decompress_ptr dinfo) {
     JpegDecoderMgr::SourceMgr* src = (JpegDecoderMgr::SourceMgr*)dinfo->src;
     if (!src->fSourceMgr->fillInputBuffer(src->next_input_byte, src->bytes_in_buffer)) {
+        if (src->fSourceMgr->isSuspending()) {
+            // libjpeg resumes from the bytes that are left in the buffer.
+            return false;
+        }
         SkCodecPrintf("Failure to fill input buffer.\n");
         src->next_input_byte = nullptr;
         src->bytes_in_buffer = 0;
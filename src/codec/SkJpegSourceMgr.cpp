@@ -20,6 +20,10 @@
 #include "src/codec/SkJpegSegmentScan.h"
 #endif  // SK_CODEC_DECODES_JPEG_GAINMAPS
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // SkStream helpers.
 
@@ -47,6 +51,26 @@ private:
     const size_t fPosition;
 };
 
+/*
+ * Move the |unconsumedBytes| bytes at |nextInputByte|, which libjpeg has not consumed yet, to the
+ * front of |buffer|. If that would leave less than |readSize| bytes free, |buffer| is first
+ * replaced with one at least twice as large. Returns the start of |buffer|.
+ */
+static uint8_t* move_unconsumed_bytes(sk_sp<SkData>* buffer,
+                                      const uint8_t* nextInputByte,
+                                      size_t unconsumedBytes,
+                                      size_t readSize) {
+    if ((*buffer)->size() - unconsumedBytes < readSize) {
+        sk_sp<SkData> larger = SkData::MakeUninitialized(
+                std::max(2 * (*buffer)->size(), unconsumedBytes + readSize));
+        memcpy(larger->writable_data(), nextInputByte, unconsumedBytes);
+        *buffer = std::move(larger);
+    } else if (unconsumedBytes > 0) {
+        memmove((*buffer)->writable_data(), nextInputByte, unconsumedBytes);
+    }
+    return static_cast<uint8_t*>((*buffer)->writable_data());
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // SkJpegMemorySourceMgr
 
@@ -76,6 +100,10 @@ public:
         bytesInBuffer -= bytesToSkip;
         return true;
     }
+    bool readAvailableBytes(const uint8_t*& nextInputByte, size_t& bytesInBuffer) override {
+        // The whole JPEG data was in the buffer from the start.
+        return false;
+    }
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
     const std::vector<SkJpegSegment>& getAllSegments() override {
         if (fScanner) {
@@ -124,7 +152,8 @@ public:
 
 class SkJpegBufferedSourceMgr : public SkJpegSourceMgr {
 public:
-    SkJpegBufferedSourceMgr(SkStream* stream, size_t bufferSize) : SkJpegSourceMgr(stream) {
+    SkJpegBufferedSourceMgr(SkStream* stream, size_t bufferSize)
+            : SkJpegSourceMgr(stream), fReadSize(bufferSize) {
         fBuffer = SkData::MakeUninitialized(bufferSize);
     }
     ~SkJpegBufferedSourceMgr() override {}
@@ -134,6 +163,11 @@ public:
         bytesInBuffer = 0;
     }
     bool fillInputBuffer(const uint8_t*& nextInputByte, size_t& bytesInBuffer) override {
+        if (fSuspending) {
+            // libjpeg will back up to bytes that are still in fBuffer, so it is only refilled
+            // between calls into libjpeg, by readAvailableBytes.
+            return false;
+        }
         size_t bytesRead = fStream->read(fBuffer->writable_data(), fBuffer->size());
         if (bytesRead == 0) {
             // Fail if we read zero bytes (libjpeg will accept any non-zero number of bytes).
@@ -155,6 +189,14 @@ public:
         }
         bytesToSkip -= bytesInBuffer;
 
+        // Skip the rest of the bytes as they arrive.
+        if (fSuspending) {
+            fBytesToSkip = bytesToSkip;
+            nextInputByte += bytesInBuffer;
+            bytesInBuffer = 0;
+            return true;
+        }
+
         // Fail if we skip past the end of the stream.
         if (fStream->skip(bytesToSkip) != bytesToSkip) {
             SkCodecPrintf("Failed to skip through buffered stream.\n");
@@ -165,6 +207,26 @@ public:
         nextInputByte = fBuffer->bytes();
         return true;
     }
+    bool readAvailableBytes(const uint8_t*& nextInputByte, size_t& bytesInBuffer) override {
+        SkASSERT(fSuspending);
+        size_t bytesSkipped = 0;
+        while (fBytesToSkip > 0) {
+            size_t skipped = fStream->skip(fBytesToSkip);
+            if (skipped == 0) {
+                return bytesSkipped > 0;
+            }
+            fBytesToSkip -= skipped;
+            bytesSkipped += skipped;
+        }
+
+        // Keep the bytes that libjpeg has not consumed at the front of fBuffer, and read the new
+        // bytes in after them.
+        uint8_t* buffer = move_unconsumed_bytes(&fBuffer, nextInputByte, bytesInBuffer, fReadSize);
+        size_t bytesRead = fStream->read(buffer + bytesInBuffer, fBuffer->size() - bytesInBuffer);
+        nextInputByte = buffer;
+        bytesInBuffer += bytesRead;
+        return bytesSkipped > 0 || bytesRead > 0;
+    }
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
     const std::vector<SkJpegSegment>& getAllSegments() override {
         if (fScanner) {
@@ -245,6 +307,12 @@ public:
 
 private:
     sk_sp<SkData> fBuffer;
+
+    // The number of bytes to read from the stream at a time.
+    const size_t fReadSize;
+
+    // While suspending, the number of bytes that libjpeg skipped past the end of the stream.
+    size_t fBytesToSkip = 0;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -259,7 +327,8 @@ private:
  */
 class SkJpegUnseekableSourceMgr : public SkJpegSourceMgr {
 public:
-    SkJpegUnseekableSourceMgr(SkStream* stream, size_t bufferSize) : SkJpegSourceMgr(stream) {
+    SkJpegUnseekableSourceMgr(SkStream* stream, size_t bufferSize)
+            : SkJpegSourceMgr(stream), fReadSize(bufferSize) {
         fBuffer = SkData::MakeUninitialized(bufferSize);
         fScanner = std::make_unique<SkJpegSegmentScanner>(kJpegMarkerEndOfImage);
     }
@@ -270,6 +339,11 @@ public:
         bytesInBuffer = 0;
     }
     bool fillInputBuffer(const uint8_t*& nextInputByte, size_t& bytesInBuffer) override {
+        if (fSuspending) {
+            // As in SkJpegBufferedSourceMgr, fBuffer must hold on to the bytes that libjpeg will
+            // back up to.
+            return false;
+        }
         if (!readToBufferAndScan(fBuffer->size())) {
             SkCodecPrintf("Failure filling unseekable input buffer.\n");
             return false;
@@ -289,6 +363,14 @@ public:
         }
         bytesToSkip -= bytesInBuffer;
 
+        // Skip the rest of the bytes as they arrive.
+        if (fSuspending) {
+            fBytesToSkip = bytesToSkip;
+            nextInputByte += bytesInBuffer;
+            bytesInBuffer = 0;
+            return true;
+        }
+
         // Read the remaining bytes to skip into fBuffer and feed them into fScanner.
         while (bytesToSkip > 0) {
             if (!readToBufferAndScan(std::min(bytesToSkip, fBuffer->size()))) {
@@ -303,6 +385,34 @@ public:
         nextInputByte = fBuffer->bytes();
         return true;
     }
+    bool readAvailableBytes(const uint8_t*& nextInputByte, size_t& bytesInBuffer) override {
+        SkASSERT(fSuspending);
+        // The skipped bytes still need to be scanned, so they are read through fBuffer. Nothing
+        // in fBuffer is unconsumed while there are bytes left to skip.
+        bool readBytes = false;
+        while (fBytesToSkip > 0) {
+            if (!readToBufferAndScan(std::min(fBytesToSkip, fBuffer->size()))) {
+                return readBytes;
+            }
+            fBytesToSkip -= fLastReadSize;
+            readBytes = true;
+        }
+
+        // The unconsumed bytes are always the last ones read. Move them to the front of fBuffer,
+        // and read and scan the new bytes after them.
+        SkASSERT(bytesInBuffer <= fLastReadSize);
+        fLastReadOffset += fLastReadSize - bytesInBuffer;
+        fLastReadSize = bytesInBuffer;
+        uint8_t* buffer = move_unconsumed_bytes(&fBuffer, nextInputByte, bytesInBuffer,
+                                                fReadSize);
+        size_t bytesRead = fStream->read(buffer + fLastReadSize, fBuffer->size() - fLastReadSize);
+        fScanner->onBytes(buffer + fLastReadSize, bytesRead);
+        fLastReadSize += bytesRead;
+
+        nextInputByte = buffer;
+        bytesInBuffer = fLastReadSize;
+        return readBytes || bytesRead > 0;
+    }
     const std::vector<SkJpegSegment>& getAllSegments() override {
         while (!fScanner->isDone() && !fScanner->hadError()) {
             if (!readToBufferAndScan(fBuffer->size())) {
@@ -417,6 +527,12 @@ private:
     // The offset into the stream (total number of bytes read) at the time of our most recent read
     // into fBuffer.
     size_t fLastReadOffset = 0;
+
+    // The number of bytes to read from the stream at a time.
+    const size_t fReadSize;
+
+    // While suspending, the number of bytes that libjpeg skipped past the end of the stream.
+    size_t fBytesToSkip = 0;
 };
 #endif  // SK_CODEC_DECODES_JPEG_GAINMAPS
 
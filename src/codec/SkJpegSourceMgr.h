@@ -48,6 +48,17 @@ public:
                                 const uint8_t*& nextInputByte,
                                 size_t& bytesInBuffer) = 0;
 
+    // Switch to libjpeg's suspending mode, for incremental decoding. In this mode fillInputBuffer
+    // returns false rather than reading, and libjpeg backs up to the last unit it finished and
+    // returns early. The bytes that libjpeg has not consumed stay in the buffer.
+    void startSuspending() { fSuspending = true; }
+    bool isSuspending() const { return fSuspending; }
+
+    // While suspending, append the bytes that the stream has received since the last read to the
+    // ones that libjpeg has not consumed. Must only be called between calls into libjpeg. Returns
+    // false if the stream had no new bytes.
+    virtual bool readAvailableBytes(const uint8_t*& nextInputByte, size_t& bytesInBuffer) = 0;
+
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
     // Parse this stream all the way through its EndOfImage marker and return the list of segments.
     // Return false if there is an error or if no EndOfImage marker is found.
@@ -67,6 +78,7 @@ public:
 protected:
     SkJpegSourceMgr(SkStream* stream);
     SkStream* const fStream;  // unowned
+    bool fSuspending = false;
 
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
     // The segment scanner is lazily creatd only when needed.
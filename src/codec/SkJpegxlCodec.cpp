@@ -19,9 +19,9 @@
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
+#include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkFrameHolder.h"
 #include "src/core/SkOpts.h"
-#include "src/core/SkStreamPriv.h"
 
 #include "jxl/codestream_header.h"
 #include "jxl/decode.h"
@@ -61,12 +61,22 @@ public:
     JxlBasicInfo fInfo;
     bool fSeenAllFrames = false;
     std::vector<Frame> fFrames;
-    int fLastProcessedFrame = SkCodec::kNoFrame;
     void* fDst;
     size_t fPixelShift;
     size_t fRowBytes;
     SkColorType fDstColorType;
 
+    // Whether fDecoder is partway through a decode, which onIncrementalDecode() resumes.
+    bool fDecoding = false;
+    // Whether fDecoder holds a pointer into the codec's data. Only the bytes from fInputOffset
+    // on were handed to it; the ones before that have been consumed.
+    bool fInputSet = false;
+    size_t fInputOffset = 0;
+    JxlPixelFormat fFormat;
+    // libjxl hands out pixels by group, so count them to find the rows that are complete.
+    std::vector<int> fRowPixels;
+    int fRowsDecoded = 0;
+
 protected:
     const SkFrame* onGetFrame(int i) const override {
         SkASSERT(i >= 0 && static_cast<size_t>(i) < fFrames.size());
@@ -77,23 +87,41 @@ protected:
 SkJpegxlCodec::SkJpegxlCodec(std::unique_ptr<SkJpegxlCodecPriv> codec,
                              SkEncodedInfo&& info,
                              std::unique_ptr<SkStream> stream,
-                             sk_sp<SkData> data)
+                             std::unique_ptr<SkStream> incoming,
+                             sk_sp<SkData> data,
+                             size_t dataSize)
         : INHERITED(std::move(info), skcms_PixelFormat_RGBA_16161616LE, std::move(stream))
         , fCodec(std::move(codec))
-        , fData(std::move(data)) {}
+        , fData(std::move(data))
+        , fDataSize(dataSize)
+        , fIncomingStream(std::move(incoming)) {}
+
+SkJpegxlCodec::~SkJpegxlCodec() = default;
 
 std::unique_ptr<SkCodec> SkJpegxlCodec::MakeFromStream(std::unique_ptr<SkStream> stream,
                                                        Result* result) {
     *result = kInternalError;
     // Either wrap or copy stream data.
     sk_sp<SkData> data = nullptr;
+    size_t dataSize = 0;
+    std::unique_ptr<SkStream> incoming;
     if (stream->getMemoryBase()) {
         data = SkData::MakeWithoutCopy(stream->getMemoryBase(), stream->getLength());
+        dataSize = data->size();
     } else {
-        data = SkCopyStreamToData(stream.get());
+        // Copy what the stream has now. If more is still to come, the codec holds onto the
+        // stream and appends the rest to the same buffer as it arrives.
+        dataSize = read_available(stream.get(), &data, 0);
+        if (!stream->isAtEnd()) {
+            incoming = std::move(stream);
+        }
         // Data is copied; stream can be released now.
         stream.reset(nullptr);
     }
+    if (!dataSize) {
+        *result = kIncompleteInput;
+        return nullptr;
+    }
 
     auto priv = std::make_unique<SkJpegxlCodecPriv>();
     JxlDecoder* dec = priv->fDecoder.get();
@@ -106,7 +134,7 @@ std::unique_ptr<SkCodec> SkJpegxlCodec::MakeFromStream(std::unique_ptr<SkStream>
         return nullptr;
     }
 
-    status = JxlDecoderSetInput(dec, data->bytes(), data->size());
+    status = JxlDecoderSetInput(dec, data->bytes(), dataSize);
     if (status != JXL_DEC_SUCCESS) {
         // Fresh instance must accept first chunk of input.
         SkDEBUGFAIL("libjxl returned unexpected status");
@@ -180,18 +208,67 @@ std::unique_ptr<SkCodec> SkJpegxlCodec::MakeFromStream(std::unique_ptr<SkStream>
         profile = SkEncodedInfo::ICCProfile::Make(std::move(icc));
     }
 
+    // Decodes start over from the beginning of the data.
+    JxlDecoderReleaseInput(dec);
+
     int bitsPerChannel = 16;
 
     *result = kSuccess;
     SkEncodedInfo encodedInfo =
             SkEncodedInfo::Make(width, height, color, alpha, bitsPerChannel, std::move(profile));
 
-    return std::unique_ptr<SkCodec>(new SkJpegxlCodec(
-            std::move(priv), std::move(encodedInfo), std::move(stream), std::move(data)));
+    return std::unique_ptr<SkCodec>(new SkJpegxlCodec(std::move(priv),
+                                                      std::move(encodedInfo),
+                                                      std::move(stream),
+                                                      std::move(incoming),
+                                                      std::move(data),
+                                                      dataSize));
+}
+
+void SkJpegxlCodec::releaseInput() {
+    auto& codec = *fCodec.get();
+    if (codec.fInputSet) {
+        // libjxl expects the bytes that it has not consumed yet at the start of the next input.
+        codec.fInputOffset = fDataSize - JxlDecoderReleaseInput(codec.fDecoder.get());
+        codec.fInputSet = false;
+    }
+}
+
+void SkJpegxlCodec::readIncomingData() {
+    if (!fIncomingStream) {
+        return;
+    }
+
+    // Appending may move the bytes to a larger buffer, which the decoder must not point into.
+    this->releaseInput();
+    fDataSize = read_available(fIncomingStream.get(), &fData, fDataSize);
+    if (fIncomingStream->isAtEnd()) {
+        fIncomingStream.reset();
+    }
 }
 
 SkCodec::Result SkJpegxlCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
                                            const Options& options, int* rowsDecodedPtr) {
+    Result result = this->startDecode(dstInfo, dst, rowBytes, options);
+    if (kSuccess != result) {
+        return result;
+    }
+
+    int rowsDecoded = 0;
+    result = this->onIncrementalDecode(&rowsDecoded);
+    if (kIncompleteInput == result) {
+        *rowsDecodedPtr = rowsDecoded;
+    }
+    return result;
+}
+
+SkCodec::Result SkJpegxlCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                        size_t rowBytes, const Options& options) {
+    return this->startDecode(dstInfo, dst, rowBytes, options);
+}
+
+SkCodec::Result SkJpegxlCodec::startDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                           const Options& options) {
     // TODO(eustas): implement
     if (options.fSubset) {
         return kUnimplemented;
@@ -200,44 +277,25 @@ SkCodec::Result SkJpegxlCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst
     const int index = options.fFrameIndex;
     SkASSERT(0 == index || static_cast<size_t>(index) < codec.fFrames.size());
     auto* dec = codec.fDecoder.get();
-    JxlDecoderStatus status;
-
-    if ((codec.fLastProcessedFrame >= index) || (codec.fLastProcessedFrame = SkCodec::kNoFrame)) {
-        codec.fLastProcessedFrame = SkCodec::kNoFrame;
-        JxlDecoderRewind(dec);
-        status = JxlDecoderSubscribeEvents(dec, JXL_DEC_FRAME | JXL_DEC_FULL_IMAGE);
-        if (status != JXL_DEC_SUCCESS) {
-            // Fresh decoder instance (after rewind) must accept subscription request.
-            SkDEBUGFAIL("libjxl returned unexpected status");
-            return kInternalError;
-        }
-        status = JxlDecoderSetInput(dec, fData->bytes(), fData->size());
-        if (status != JXL_DEC_SUCCESS) {
-            // Fresh decoder instance (after rewind) must accept first data chunk.
-            SkDEBUGFAIL("libjxl returned unexpected status");
-            return kInternalError;
-        }
-        SkASSERT(codec.fLastProcessedFrame + 1 == 0);
-    }
 
-    int nextFrame = codec.fLastProcessedFrame + 1;
-    if (nextFrame < index) {
-        JxlDecoderSkipFrames(dec, index - nextFrame);
-    }
-
-    // Decode till the frame start.
-    status = JxlDecoderProcessInput(dec);
-    // TODO(eustas): actually, frame is not completely processed; for streaming / partial decoding
-    //               we should also add a flag that "last processed frame" is still incomplete, and
-    //               flip that flag when frame decoding is over.
-    codec.fLastProcessedFrame = index;
-    if (status != JXL_DEC_FRAME) {
-        // TODO(eustas): check status: it might be either corrupted or incomplete input.
+    this->releaseInput();
+    JxlDecoderRewind(dec);
+    codec.fInputOffset = 0;
+    JxlDecoderStatus status = JxlDecoderSubscribeEvents(dec, JXL_DEC_FRAME | JXL_DEC_FULL_IMAGE);
+    if (status != JXL_DEC_SUCCESS) {
+        // Fresh decoder instance (after rewind) must accept subscription request.
+        SkDEBUGFAIL("libjxl returned unexpected status");
         return kInternalError;
     }
+    if (index > 0) {
+        JxlDecoderSkipFrames(dec, index);
+    }
 
     codec.fDst = dst;
     codec.fRowBytes = rowBytes;
+    codec.fPixelShift = dstInfo.shiftPerPixel();
+    codec.fRowPixels.assign(dstInfo.height(), 0);
+    codec.fRowsDecoded = 0;
 
     // TODO(eustas): consider grayscale.
     uint32_t numColorChannels = 3;
@@ -258,32 +316,73 @@ SkCodec::Result SkJpegxlCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst
     if (colorXform()) halfFloatOutput = true;
     auto dataType = halfFloatOutput ? JXL_TYPE_FLOAT16 : JXL_TYPE_UINT8;
 
-    JxlPixelFormat format =
-        {numColorChannels + numAlphaChannels, dataType, endianness, /* align = */ 0};
-    status = JxlDecoderSetImageOutCallback(dec, &format, SkJpegxlCodec::imageOutCallback, this);
-    if (status != JXL_DEC_SUCCESS) {
-        // Current event is JXL_DEC_FRAME -> decoder must accept callback.
-        SkDEBUGFAIL("libjxl returned unexpected status");
-        return kInternalError;
+    codec.fFormat = {numColorChannels + numAlphaChannels, dataType, endianness, /* align = */ 0};
+    codec.fDecoding = true;
+    return kSuccess;
+}
+
+SkCodec::Result SkJpegxlCodec::onIncrementalDecode(int* rowsDecodedPtr) {
+    auto& codec = *fCodec.get();
+    if (!codec.fDecoding) {
+        return kSuccess;
     }
+    auto* dec = codec.fDecoder.get();
 
-    // Decode till the frame start.
-    status = JxlDecoderProcessInput(dec);
-    if (status != JXL_DEC_FULL_IMAGE) {
-        // TODO(eustas): check status: it might be either corrupted or incomplete input.
-        return kInternalError;
+    // Only the bytes that arrived since the last call are new to the decoder; the ones it has
+    // consumed are not handed to it again.
+    this->readIncomingData();
+    if (!codec.fInputSet) {
+        JxlDecoderStatus status = JxlDecoderSetInput(dec, fData->bytes() + codec.fInputOffset,
+                                                     fDataSize - codec.fInputOffset);
+        if (status != JXL_DEC_SUCCESS) {
+            // Input was released, so the decoder must accept the next chunk.
+            SkDEBUGFAIL("libjxl returned unexpected status");
+            return kInternalError;
+        }
+        codec.fInputSet = true;
     }
-    // TODO(eustas): currently it is supposed that complete input is accessible;
-    //               when streaming support is added JXL_DEC_NEED_MORE_INPUT would also
-    //               become a legal outcome; amount of decoded scanlines should be calculated
-    //               based on callback invocations / render-pipeline API.
-    *rowsDecodedPtr = dstInfo.height();
 
-    return kSuccess;
+    while (true) {
+        JxlDecoderStatus status = JxlDecoderProcessInput(dec);
+        switch (status) {
+            case JXL_DEC_FRAME:
+                status = JxlDecoderSetImageOutCallback(
+                        dec, &codec.fFormat, SkJpegxlCodec::imageOutCallback, this);
+                if (status != JXL_DEC_SUCCESS) {
+                    // Current event is JXL_DEC_FRAME -> decoder must accept callback.
+                    SkDEBUGFAIL("libjxl returned unexpected status");
+                    return kInternalError;
+                }
+                break;
+            case JXL_DEC_FULL_IMAGE:
+                codec.fDecoding = false;
+                this->releaseInput();
+                return kSuccess;
+            case JXL_DEC_NEED_MORE_INPUT: {
+                const int height = SkToInt(codec.fRowPixels.size());
+                const int width = this->dimensions().width();
+                while (codec.fRowsDecoded < height &&
+                       codec.fRowPixels[codec.fRowsDecoded] >= width) {
+                    codec.fRowsDecoded++;
+                }
+                if (rowsDecodedPtr) {
+                    *rowsDecodedPtr = codec.fRowsDecoded;
+                }
+                return kIncompleteInput;
+            }
+            default:
+                codec.fDecoding = false;
+                this->releaseInput();
+                return kInvalidInput;
+        }
+    }
 }
 
 bool SkJpegxlCodec::onRewind() {
+    // All of the bytes read so far are in fData, so the stream is not needed.
+    this->releaseInput();
     JxlDecoderRewind(fCodec->fDecoder.get());
+    fCodec->fDecoding = false;
     return true;
 }
 
@@ -320,6 +419,7 @@ void SkJpegxlCodec::imageOutCallback(void* opaque, size_t x, size_t y,
     auto& codec = *instance->fCodec.get();
     size_t offset = y * codec.fRowBytes + (x << codec.fPixelShift);
     void* dst = SkTAddOffset<void>(codec.fDst, offset);
+    codec.fRowPixels[y] += SkToInt(num_pixels);
     if (instance->colorXform()) {
         instance->applyColorXform(dst, pixels, num_pixels);
         return;
@@ -358,7 +458,7 @@ bool SkJpegxlCodec::scanFrames() {
         return true;
     }
 
-    status = JxlDecoderSetInput(dec, fData->bytes(), fData->size());
+    status = JxlDecoderSetInput(dec, fData->bytes(), fDataSize);
     if (status != JXL_DEC_SUCCESS) {
         // Fresh instance must accept first input chunk.
         SkDEBUGFAIL("libjxl returned unexpected status");
@@ -400,6 +500,8 @@ int SkJpegxlCodec::onGetFrameCount() {
     }
 
     if (!fCodec->fSeenAllFrames) {
+        // Frames that have arrived since the last call show up as soon as their headers do.
+        this->readIncomingData();
         fCodec->fSeenAllFrames = scanFrames();
     }
 
@@ -443,13 +545,6 @@ const SkFrameHolder* SkJpegxlCodec::getFrameHolder() const {
 // SkCodec::Result SkJpegxlCodec::onStartScanlineDecode(
 //     const SkImageInfo& /*dstInfo*/, const Options& /*options*/) { return kUnimplemented; }
 
-// TODO(eustas): implement
-// SkCodec::Result SkJpegxlCodec::onStartIncrementalDecode(
-//     const SkImageInfo& /*dstInfo*/, void*, size_t, const Options&) { return kUnimplemented; }
-
-// TODO(eustas): implement
-// SkCodec::Result SkJpegxlCodec::onIncrementalDecode(int*) { return kUnimplemented; }
-
 // TODO(eustas): implement
 // bool SkJpegxlCodec::onSkipScanlines(int /*countLines*/) { return false; }
 
@@ -38,6 +38,8 @@ public:
      */
     static std::unique_ptr<SkCodec> MakeFromStream(std::unique_ptr<SkStream>, Result*);
 
+    ~SkJpegxlCodec() override;
+
 protected:
     /* TODO(eustas): implement when downscaling is supported. */
     /* SkISize onGetScaledDimensions(float desiredScale) const override; */
@@ -52,6 +54,10 @@ protected:
     Result onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
                        const Options& options, int* rowsDecodedPtr) override;
 
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                    const Options& options) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
+
     /* TODO(eustas): add support for transcoded JPEG images? */
     /* bool onQueryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes&,
                             SkYUVAPixmapInfo*) const override; */
@@ -81,16 +87,31 @@ private:
 
     // Result onStartScanlineDecode(
     //    const SkImageInfo& /*dstInfo*/, const Options& /*options*/) override;
-    // Result onStartIncrementalDecode(
-    //     const SkImageInfo& /*dstInfo*/, void*, size_t, const Options&) override;
-    // Result onIncrementalDecode(int*) override;
     // bool onSkipScanlines(int /*countLines*/) override;
     // int onGetScanlines(void* /*dst*/, int /*countLines*/, size_t /*rowBytes*/) override;
     // SkSampler* getSampler(bool /*createIfNecessary*/) override;
 
+    // Sets up the decoder to decode into dst. Shared by getPixels(), which decodes whatever
+    // data is available in one step, and startIncrementalDecode().
+    Result startDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, const Options&);
+
+    // Takes back the input that the decoder has not consumed yet, so that fData may change.
+    void releaseInput();
+
+    // Appends whatever fIncomingStream has made available since the last call to fData.
+    void readIncomingData();
+
     // Opaque codec implementation for lightweight header file.
     std::unique_ptr<SkJpegxlCodecPriv> fCodec;
+
+    // Only the first fDataSize bytes are valid. The rest is room for the bytes that
+    // fIncomingStream has not delivered yet.
     sk_sp<SkData> fData;
+    size_t        fDataSize;
+
+    // Set when the image was not in memory and the stream may still deliver more of it.
+    // All of the bytes read so far are in fData, so resuming a decode never rewinds.
+    std::unique_ptr<SkStream> fIncomingStream;
 
     bool scanFrames();
     static void imageOutCallback(
@@ -99,7 +120,9 @@ private:
     SkJpegxlCodec(std::unique_ptr<SkJpegxlCodecPriv> codec,
                   SkEncodedInfo&& info,
                   std::unique_ptr<SkStream> stream,
-                  sk_sp<SkData> data);
+                  std::unique_ptr<SkStream> incoming,
+                  sk_sp<SkData> data,
+                  size_t dataSize);
 
     using INHERITED = SkScalingCodec;
 };
@@ -13,8 +13,49 @@
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRect.h"
 #include "include/private/SkColorData.h"
+#include "src/base/SkVx.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkMasks.h"
+#include "src/core/SkOpts.h"
+
+#include <utility>
+
+/*
+ *
+ * Convert the first multiple of 8 pixels of a 16-bit row to 8888 at once, when
+ * we are not sampling. Returns the number of pixels converted.
+ *
+ */
+static int swizzle_mask16_to_8888_simd(uint32_t* dst, const uint16_t* src, int width,
+                                       const SkMasks* masks, uint32_t sampleX,
+                                       bool swapRB, bool opaque) {
+    if (1 != sampleX) {
+        return 0;
+    }
+
+    using U32 = skvx::Vec<8, uint32_t>;
+    auto convert_to_8 = [](U32 pixels, const SkMasks::MaskInfo& info) {
+        // (c * ceil(255 * 2^16 / (2^n - 1)) + 2^15) >> 16 matches the rounding of
+        // SkMasks' n-bit to 8-bit table for every n in [1, 8].
+        const uint32_t max = (1u << info.size) - 1;
+        const uint32_t scale = info.size ? ((255u << 16) + max - 1) / max : 0;
+        return (((pixels & info.mask) >> info.shift) * scale + (1 << 15)) >> 16;
+    };
+
+    int i = 0;
+    for (; i + 8 <= width; i += 8) {
+        U32 p = skvx::cast<uint32_t>(skvx::Vec<8, uint16_t>::Load(src + i));
+        U32 r = convert_to_8(p, masks->red()),
+            g = convert_to_8(p, masks->green()),
+            b = convert_to_8(p, masks->blue()),
+            a = opaque ? U32(0xFF) : convert_to_8(p, masks->alpha());
+        if (swapRB) {
+            std::swap(r, b);
+        }
+        (r | g << 8 | b << 16 | a << 24).store(dst + i);
+    }
+    return i;
+}
 
 static void swizzle_mask16_to_rgba_opaque(
         void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
@@ -23,7 +64,10 @@ static void swizzle_mask16_to_rgba_opaque(
     // Use the masks to decode to the destination
     uint16_t* srcPtr = ((uint16_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    const int simdWidth = swizzle_mask16_to_8888_simd(dstPtr, srcPtr, width, masks, sampleX,
+                                                      /*swapRB=*/false, /*opaque=*/true);
+    srcPtr += simdWidth;
+    for (int i = simdWidth; i < width; i++) {
         uint16_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -40,7 +84,10 @@ static void swizzle_mask16_to_bgra_opaque(
     // Use the masks to decode to the destination
     uint16_t* srcPtr = ((uint16_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    const int simdWidth = swizzle_mask16_to_8888_simd(dstPtr, srcPtr, width, masks, sampleX,
+                                                      /*swapRB=*/true, /*opaque=*/true);
+    srcPtr += simdWidth;
+    for (int i = simdWidth; i < width; i++) {
         uint16_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -57,7 +104,10 @@ static void swizzle_mask16_to_rgba_unpremul(
     // Use the masks to decode to the destination
     uint16_t* srcPtr = ((uint16_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    const int simdWidth = swizzle_mask16_to_8888_simd(dstPtr, srcPtr, width, masks, sampleX,
+                                                      /*swapRB=*/false, /*opaque=*/false);
+    srcPtr += simdWidth;
+    for (int i = simdWidth; i < width; i++) {
         uint16_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -75,7 +125,10 @@ static void swizzle_mask16_to_bgra_unpremul(
     // Use the masks to decode to the destination
     uint16_t* srcPtr = ((uint16_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    const int simdWidth = swizzle_mask16_to_8888_simd(dstPtr, srcPtr, width, masks, sampleX,
+                                                      /*swapRB=*/true, /*opaque=*/false);
+    srcPtr += simdWidth;
+    for (int i = simdWidth; i < width; i++) {
         uint16_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -93,7 +146,11 @@ static void swizzle_mask16_to_rgba_premul(
     // Use the masks to decode to the destination
     uint16_t* srcPtr = ((uint16_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    const int simdWidth = swizzle_mask16_to_8888_simd(dstPtr, srcPtr, width, masks, sampleX,
+                                                      /*swapRB=*/false, /*opaque=*/false);
+    SkOpts::RGBA_to_rgbA(dstPtr, dstPtr, simdWidth);
+    srcPtr += simdWidth;
+    for (int i = simdWidth; i < width; i++) {
         uint16_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -111,7 +168,11 @@ static void swizzle_mask16_to_bgra_premul(
     // Use the masks to decode to the destination
     uint16_t* srcPtr = ((uint16_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    const int simdWidth = swizzle_mask16_to_8888_simd(dstPtr, srcPtr, width, masks, sampleX,
+                                                      /*swapRB=*/true, /*opaque=*/false);
+    SkOpts::RGBA_to_rgbA(dstPtr, dstPtr, simdWidth);
+    srcPtr += simdWidth;
+    for (int i = simdWidth; i < width; i++) {
         uint16_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
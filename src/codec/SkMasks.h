@@ -51,6 +51,12 @@ public:
         return fAlpha.mask;
      }
 
+    // Getters for the mask infos, so that many pixels can be converted at once
+    const MaskInfo& red() const { return fRed; }
+    const MaskInfo& green() const { return fGreen; }
+    const MaskInfo& blue() const { return fBlue; }
+    const MaskInfo& alpha() const { return fAlpha; }
+
 private:
     const MaskInfo fRed;
     const MaskInfo fGreen;
@@ -12,6 +12,7 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkSize.h"
@@ -26,6 +27,7 @@
 #include "src/codec/SkPngPriv.h"
 #include "src/codec/SkSwizzler.h"
 #include "src/core/SkOpts.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <csetjmp>
 #include <algorithm>
@@ -460,6 +462,7 @@ void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
             const size_t colorXformBytes = dstInfo.width() * bytesPerPixel;
             fStorage.reset(colorXformBytes);
             fColorXformSrcRow = fStorage.get();
+            fColorXformSrcRowBytes = colorXformBytes;
             break;
         }
     }
@@ -481,6 +484,10 @@ static skcms_PixelFormat png_select_xform_format(const SkEncodedInfo& info) {
 }
 
 void SkPngCodec::applyXformRow(void* dst, const void* src) {
+    this->applyXformRow(dst, src, fColorXformSrcRow);
+}
+
+void SkPngCodec::applyXformRow(void* dst, const void* src, void* colorXformSrcRow) const {
     switch (fXformMode) {
         case kSwizzleOnly_XformMode:
             fSwizzler->swizzle(dst, (const uint8_t*) src);
@@ -489,12 +496,43 @@ void SkPngCodec::applyXformRow(void* dst, const void* src) {
             this->applyColorXform(dst, src, fXformWidth);
             break;
         case kSwizzleColor_XformMode:
-            fSwizzler->swizzle(fColorXformSrcRow, (const uint8_t*) src);
-            this->applyColorXform(dst, fColorXformSrcRow, fXformWidth);
+            fSwizzler->swizzle(colorXformSrcRow, (const uint8_t*) src);
+            this->applyColorXform(dst, colorXformSrcRow, fXformWidth);
             break;
     }
 }
 
+// Splitting the rows between threads is only worth it when each thread gets at least this many.
+static constexpr int kMinRowsPerTask = 16;
+
+void SkPngCodec::applyXformRows(void* dst, size_t dstRowBytes, const void* src,
+                                size_t srcRowBytes, int count, SkExecutor* executor) {
+    const int taskCount = executor ? count / kMinRowsPerTask : 1;
+    if (taskCount > 1) {
+        SkTaskGroup tasks(*executor);
+        tasks.batch(taskCount, [&](int task) {
+            const int first = count * task / taskCount;
+            const int last = count * (task + 1) / taskCount;
+            this->applyXformRows(SkTAddOffset<void>(dst, first * dstRowBytes), dstRowBytes,
+                                 SkTAddOffset<const void>(src, first * srcRowBytes), srcRowBytes,
+                                 last - first, nullptr);
+        });
+        tasks.wait();
+        return;
+    }
+
+    // fColorXformSrcRow may be in use by another thread.
+    AutoTMalloc<uint8_t> colorXformSrcRow;
+    if (fXformMode == kSwizzleColor_XformMode) {
+        colorXformSrcRow.reset(fColorXformSrcRowBytes);
+    }
+    for (int i = 0; i < count; i++) {
+        this->applyXformRow(dst, src, colorXformSrcRow.get());
+        dst = SkTAddOffset<void>(dst, dstRowBytes);
+        src = SkTAddOffset<const void>(src, srcRowBytes);
+    }
+}
+
 static SkCodec::Result log_and_return_error(bool success) {
     if (success) return SkCodec::kIncompleteInput;
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
@@ -513,6 +551,9 @@ public:
         , fRowBytes(0)
         , fFirstRow(0)
         , fLastRow(0)
+        , fPngRowBytes(0)
+        , fBatchIndex(0)
+        , fRowsInBatch(0)
     {}
 
     static void AllRowsCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum, int /*pass*/) {
@@ -533,6 +574,17 @@ private:
     int                         fLastRow;
     int                         fRowsNeeded;
 
+    // When decoding all rows with an executor, the rows from libpng are copied into batches
+    // that are converted to the dst on the executor, while libpng inflates and unfilters the
+    // rows after them. Unfiltering a row needs the row above it, so it stays on this thread.
+    static constexpr int        kRowsPerBatch = 16;
+    static constexpr int        kBatchesInFlight = 4;
+    std::unique_ptr<SkTaskGroup> fBatchTasks;
+    AutoTMalloc<png_byte>       fBatchStorage;
+    size_t                      fPngRowBytes;
+    int                         fBatchIndex;
+    int                         fRowsInBatch;
+
     using INHERITED = SkPngCodec;
 
     static SkPngNormalDecoder* GetDecoder(png_structp png_ptr) {
@@ -549,7 +601,23 @@ private:
         fFirstRow = 0;
         fLastRow = height - 1;
 
+        SkExecutor* executor = this->options().fExecutor;
+        if (executor && height >= 2 * kRowsPerBatch) {
+            fPngRowBytes = png_get_rowbytes(this->png_ptr(), this->info_ptr());
+            fBatchStorage.reset(kBatchesInFlight * kRowsPerBatch * fPngRowBytes);
+            fBatchTasks = std::make_unique<SkTaskGroup>(*executor);
+            fBatchIndex = 0;
+            fRowsInBatch = 0;
+        }
+
         const bool success = this->processData();
+        if (fBatchTasks) {
+            // Write the rows of the last batch, or the rows before an error.
+            this->flushBatch();
+            fBatchTasks->wait();
+            fBatchTasks.reset();
+            fBatchStorage.reset(0);
+        }
         if (success && fRowsWrittenToOutput == height) {
             return kSuccess;
         }
@@ -564,10 +632,37 @@ private:
     void allRowsCallback(png_bytep row, int rowNum) {
         SkASSERT(rowNum == fRowsWrittenToOutput);
         fRowsWrittenToOutput++;
+        if (fBatchTasks) {
+            memcpy(this->batch(fBatchIndex) + fRowsInBatch * fPngRowBytes, row, fPngRowBytes);
+            if (++fRowsInBatch == kRowsPerBatch) {
+                this->flushBatch();
+            }
+            return;
+        }
         this->applyXformRow(fDst, row);
         fDst = SkTAddOffset<void>(fDst, fRowBytes);
     }
 
+    png_bytep batch(int index) {
+        return fBatchStorage.get() + index * kRowsPerBatch * fPngRowBytes;
+    }
+
+    void flushBatch() {
+        if (!fRowsInBatch) {
+            return;
+        }
+        fBatchTasks->add([this, dst = fDst, src = this->batch(fBatchIndex), count = fRowsInBatch] {
+            this->applyXformRows(dst, fRowBytes, src, fPngRowBytes, count, nullptr);
+        });
+        fDst = SkTAddOffset<void>(fDst, fRowsInBatch * fRowBytes);
+        fRowsInBatch = 0;
+        if (++fBatchIndex == kBatchesInFlight) {
+            // Every batch is in use. Wait for them before reusing their storage.
+            fBatchTasks->wait();
+            fBatchIndex = 0;
+        }
+    }
+
     void setRange(int firstRow, int lastRow, void* dst, size_t rowBytes) override {
         png_set_progressive_read_fn(this->png_ptr(), this, nullptr, RowCallback, nullptr);
         fFirstRow = firstRow;
@@ -696,13 +791,9 @@ private:
         fLinesDecoded = 0;
 
         const bool success = this->processData();
-        png_bytep srcRow = fInterlaceBuffer.get();
         // FIXME: When resuming, this may rewrite rows that did not change.
-        for (int rowNum = 0; rowNum < fLinesDecoded; rowNum++) {
-            this->applyXformRow(dst, srcRow);
-            dst = SkTAddOffset<void>(dst, rowBytes);
-            srcRow = SkTAddOffset<png_byte>(srcRow, fPng_rowbytes);
-        }
+        this->applyXformRows(dst, rowBytes, fInterlaceBuffer.get(), fPng_rowbytes, fLinesDecoded,
+                             this->options().fExecutor);
         if (success && fInterlacedComplete) {
             return kSuccess;
         }
@@ -744,17 +835,14 @@ private:
 
         // Offset srcRow by get_start_coord rows. We do not need to account for fFirstRow,
         // since the first row in fInterlaceBuffer corresponds to fFirstRow.
-        int srcRow = get_start_coord(sampleY);
-        void* dst = fDst;
-        int rowsWrittenToOutput = 0;
-        while (rowsWrittenToOutput < rowsNeeded && srcRow < fLinesDecoded) {
-            png_bytep src = SkTAddOffset<png_byte>(fInterlaceBuffer.get(), fPng_rowbytes * srcRow);
-            this->applyXformRow(dst, src);
-            dst = SkTAddOffset<void>(dst, fRowBytes);
-
-            rowsWrittenToOutput++;
-            srcRow += sampleY;
-        }
+        const int srcRow = get_start_coord(sampleY);
+        const int rowsWrittenToOutput = srcRow < fLinesDecoded
+                ? std::min(rowsNeeded, (fLinesDecoded - srcRow + sampleY - 1) / sampleY)
+                : 0;
+        this->applyXformRows(fDst, fRowBytes,
+                             SkTAddOffset<png_byte>(fInterlaceBuffer.get(), fPng_rowbytes * srcRow),
+                             fPng_rowbytes * sampleY, rowsWrittenToOutput,
+                             this->options().fExecutor);
 
         if (success && fInterlacedComplete) {
             return kSuccess;
@@ -766,6 +854,21 @@ private:
         return log_and_return_error(success);
     }
 
+    void onEstimateDecodeCost(const SkImageInfo&,
+                              const SkIRect& srcRect,
+                              DecodeCost* cost) const override {
+        // libpng combines each row into the interlace buffer once for each pass that has
+        // pixels in it, which averages to 15/8 times per row. The buffer holds every row of the
+        // subset at full width.
+        constexpr double kCombineWork = 0.25;
+        cost->fWork += kCombineWork * srcRect.width() * srcRect.height();
+
+        const size_t rowBytes =
+                (SkToSizeT(this->dimensions().width()) * this->getEncodedInfo().bitsPerPixel()
+                 + 7) / 8;
+        cost->fScratchBytes += rowBytes * srcRect.height();
+    }
+
     void setUpInterlaceBuffer(int height) {
         fPng_rowbytes = png_get_rowbytes(this->png_ptr(), this->info_ptr());
         fInterlaceBuffer.reset(fPng_rowbytes * height);
@@ -1006,6 +1109,7 @@ SkPngCodec::SkPngCodec(SkEncodedInfo&& encodedInfo, std::unique_ptr<SkStream> st
     , fPng_ptr(png_ptr)
     , fInfo_ptr(info_ptr)
     , fColorXformSrcRow(nullptr)
+    , fColorXformSrcRowBytes(0)
     , fBitDepth(bitDepth)
     , fIdatLength(0)
     , fDecodedIdat(false)
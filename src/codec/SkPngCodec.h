@@ -17,6 +17,7 @@
 #include <memory>
 
 class SkColorTable;
+class SkExecutor;
 class SkPngChunkReader;
 class SkSampler;
 class SkStream;
@@ -62,6 +63,14 @@ protected:
     SkSampler* getSampler(bool createIfNecessary) override;
     void applyXformRow(void* dst, const void* src);
 
+    /**
+     *  Apply applyXformRow() to count rows. Unlike applyXformRow(), this may be called from
+     *  several threads at once. If executor is not null and there are enough rows, they are
+     *  split between its threads, and this returns once they are all written.
+     */
+    void applyXformRows(void* dst, size_t dstRowBytes, const void* src, size_t srcRowBytes,
+                        int count, SkExecutor* executor);
+
     voidp png_ptr() { return fPng_ptr; }
     voidp info_ptr() { return fInfo_ptr; }
 
@@ -91,6 +100,7 @@ protected:
     std::unique_ptr<SkSwizzler> fSwizzler;
     skia_private::AutoTMalloc<uint8_t>      fStorage;
     void*                       fColorXformSrcRow;
+    size_t                      fColorXformSrcRowBytes;
     const int                   fBitDepth;
 
 private:
@@ -111,6 +121,7 @@ private:
     SkCodec::Result initializeXforms(const SkImageInfo& dstInfo, const Options&);
     void initializeSwizzler(const SkImageInfo& dstInfo, const Options&, bool skipFormatConversion);
     void allocateStorage(const SkImageInfo& dstInfo);
+    void applyXformRow(void* dst, const void* src, void* colorXformSrcRow) const;
     void destroyReadStruct();
 
     virtual Result decodeAllRows(void* dst, size_t rowBytes, int* rowsDecoded) = 0;
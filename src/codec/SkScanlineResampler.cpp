@@ -0,0 +1,226 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkScanlineResampler.h"
+
+#include "include/core/SkColorType.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkVx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace skia_private;
+
+namespace {
+
+using Filter = SkScanlineResampler::Filter;
+constexpr int kWeightShift = SkScanlineResampler::kWeightShift;
+constexpr int kWeightOne = 1 << kWeightShift;
+
+bool is_nearest(const SkSamplingOptions& sampling) {
+    return !sampling.useCubic && sampling.filter == SkFilterMode::kNearest;
+}
+
+// Radius of the reconstruction filter in source pixels, before stretching it for a downscale.
+float kernel_radius(const SkSamplingOptions& sampling) {
+    return sampling.useCubic ? 2.f : 1.f;
+}
+
+float eval_kernel(const SkSamplingOptions& sampling, float t) {
+    t = std::abs(t);
+    if (!sampling.useCubic) {
+        // Linear (and mipmapped, which the stretched kernel stands in for) is a tent.
+        return std::max(0.f, 1.f - t);
+    }
+    const float B = sampling.cubic.B;
+    const float C = sampling.cubic.C;
+    if (t < 1) {
+        return ((12 - 9*B - 6*C)*t*t*t + (-18 + 12*B + 6*C)*t*t + (6 - 2*B)) / 6;
+    }
+    if (t < 2) {
+        return ((-B - 6*C)*t*t*t + (6*B + 30*C)*t*t + (-12*B - 48*C)*t + (8*B + 24*C)) / 6;
+    }
+    return 0;
+}
+
+void add_contribution(Filter* filter, int start, int count, const int* weights) {
+    filter->fContributions.push_back({start, count, (int)filter->fWeights.size()});
+    filter->fWeights.insert(filter->fWeights.end(), weights, weights + count);
+    filter->fMaxCount = std::max(filter->fMaxCount, count);
+}
+
+Filter make_filter(int srcSize, int dstSize, const SkSamplingOptions& sampling) {
+    Filter filter;
+    filter.fSrcSize = srcSize;
+    filter.fContributions.reserve(dstSize);
+
+    const float scale = (float)srcSize / dstSize;
+    // When downscaling, stretch the kernel so that every source pixel contributes.
+    const float filterScale = std::max(1.f, scale);
+    const float radius = kernel_radius(sampling) * filterScale;
+
+    std::vector<float> weights;
+    std::vector<int> fixedWeights;
+    for (int x = 0; x < dstSize; ++x) {
+        const float center = (x + 0.5f) * scale;
+        const int nearest = std::min((int)center, srcSize - 1);
+        if (is_nearest(sampling)) {
+            add_contribution(&filter, nearest, 1, &kWeightOne);
+            continue;
+        }
+
+        // Source pixel i is centered at i + 0.5.
+        const int start = std::max(0, (int)std::floor(center - 0.5f - radius));
+        const int end = std::min(srcSize, (int)std::ceil(center - 0.5f + radius) + 1);
+        weights.clear();
+        float sum = 0;
+        for (int i = start; i < end; ++i) {
+            const float w = eval_kernel(sampling, (i + 0.5f - center) / filterScale);
+            weights.push_back(w);
+            sum += w;
+        }
+        if (sum <= 0) {
+            // Only possible for unusual cubics. Keep the range, which must only move
+            // forward from one sample to the next, but sample the nearest pixel.
+            std::fill(weights.begin(), weights.end(), 0.f);
+            weights[nearest - start] = sum = 1;
+        }
+
+        // Normalize to fixed point, giving any rounding error to the largest weight so the
+        // weights sum to exactly one.
+        fixedWeights.clear();
+        int fixedSum = 0;
+        int largest = 0;
+        for (int i = 0; i < (int)weights.size(); ++i) {
+            const int w = SkTPin((int)std::lround(weights[i] / sum * kWeightOne),
+                                 (int)INT16_MIN, (int)INT16_MAX);
+            fixedWeights.push_back(w);
+            fixedSum += w;
+            if (w > fixedWeights[largest]) {
+                largest = i;
+            }
+        }
+        fixedWeights[largest] += kWeightOne - fixedSum;
+
+        add_contribution(&filter, start, end - start, fixedWeights.data());
+    }
+    return filter;
+}
+
+uint32_t pack(skvx::int4 sum) {
+    skvx::int4 v = (sum + (1 << (kWeightShift - 1))) >> kWeightShift;
+    v = skvx::pin(v, skvx::int4(0), skvx::int4(255));
+    // Negative lobes can leave a premultiplied color larger than its alpha, which is in the
+    // last byte of both RGBA and BGRA.
+    v = skvx::min(v, skvx::int4(v[3]));
+    uint32_t pixel;
+    skvx::cast<uint8_t>(v).store(&pixel);
+    return pixel;
+}
+
+skvx::int4 load(const uint32_t* pixel) {
+    return skvx::cast<int32_t>(skvx::byte4::Load(pixel));
+}
+
+void filter_row(const Filter& filter, const uint32_t* src, uint32_t* dst) {
+    for (const Filter::Contribution& c : filter.fContributions) {
+        const int16_t* weights = filter.fWeights.data() + c.fWeightOffset;
+        const uint32_t* s = src + c.fStart;
+        skvx::int4 sum = 0;
+        for (int i = 0; i < c.fCount; ++i) {
+            sum += load(s + i) * weights[i];
+        }
+        *dst++ = pack(sum);
+    }
+}
+
+void filter_column(const Filter::Contribution& c,
+                   const int16_t* weights,
+                   const uint32_t* const* rows,
+                   int width,
+                   uint32_t* dst) {
+    for (int x = 0; x < width; ++x) {
+        skvx::int4 sum = 0;
+        for (int i = 0; i < c.fCount; ++i) {
+            sum += load(rows[i] + x) * weights[i];
+        }
+        dst[x] = pack(sum);
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<SkScanlineResampler> SkScanlineResampler::Make(SkISize srcDimensions,
+                                                               const SkImageInfo& dstInfo,
+                                                               const SkSamplingOptions& sampling) {
+    switch (dstInfo.colorType()) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+            break;
+        default:
+            return nullptr;
+    }
+    // Filtering unpremultiplied colors would bleed the colors of transparent pixels.
+    if (dstInfo.alphaType() == kUnpremul_SkAlphaType) {
+        return nullptr;
+    }
+    if (srcDimensions.isEmpty() || dstInfo.isEmpty()) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<SkScanlineResampler>(new SkScanlineResampler(
+            make_filter(srcDimensions.width(), dstInfo.width(), sampling),
+            make_filter(srcDimensions.height(), dstInfo.height(), sampling)));
+}
+
+SkScanlineResampler::SkScanlineResampler(Filter&& horizontal, Filter&& vertical)
+        : fHorizontal(std::move(horizontal))
+        , fVertical(std::move(vertical)) {}
+
+SkCodec::Result SkScanlineResampler::resample(SkCodec* codec, const SkPixmap& dst) {
+    SkASSERT(dst.width() == (int)fHorizontal.fContributions.size());
+    SkASSERT(dst.height() == (int)fVertical.fContributions.size());
+    SkASSERT(codec->getScanlineOrder() == SkCodec::kTopDown_SkScanlineOrder);
+
+    const int srcWidth = fHorizontal.fSrcSize;
+    const int dstWidth = dst.width();
+    const int ringCount = fVertical.fMaxCount;
+    AutoTMalloc<uint32_t> srcRow(srcWidth);
+    AutoTMalloc<uint32_t> ring(SkToSizeT(ringCount) * dstWidth);
+    AutoTMalloc<const uint32_t*> rows(ringCount);
+    auto ringRow = [&](int srcY) { return ring.get() + SkToSizeT(srcY % ringCount) * dstWidth; };
+
+    bool incomplete = false;
+    int nextSrcY = 0;
+    for (int y = 0; y < dst.height(); ++y) {
+        const Filter::Contribution& c = fVertical.fContributions[y];
+        // Both ends of the contributions only move down, so any row before this one's start
+        // is not needed by the remaining destination rows either, and the rows this one needs
+        // that were already decoded are still in the ring.
+        SkASSERT(c.fStart + ringCount >= nextSrcY);
+        if (c.fStart > nextSrcY) {
+            incomplete |= !codec->skipScanlines(c.fStart - nextSrcY);
+            nextSrcY = c.fStart;
+        }
+        for (; nextSrcY < c.fStart + c.fCount; ++nextSrcY) {
+            incomplete |= codec->getScanlines(srcRow.get(), 1, srcWidth * sizeof(uint32_t)) != 1;
+            filter_row(fHorizontal, srcRow.get(), ringRow(nextSrcY));
+        }
+
+        for (int i = 0; i < c.fCount; ++i) {
+            rows[i] = ringRow(c.fStart + i);
+        }
+        filter_column(c, fVertical.fWeights.data() + c.fWeightOffset, rows.get(), dstWidth,
+                      dst.writable_addr32(0, y));
+    }
+    return incomplete ? SkCodec::kIncompleteInput : SkCodec::kSuccess;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkScanlineResampler_DEFINED
+#define SkScanlineResampler_DEFINED
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkSize.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SkPixmap;
+struct SkImageInfo;
+struct SkSamplingOptions;
+
+/**
+ *  Resizes an image while it is being decoded by an SkCodec's scanline decoder.
+ *
+ *  Each decoded row (already swizzled and color transformed by the codec into the
+ *  destination's color type and color space) is filtered horizontally to the
+ *  destination width and stored in a ring buffer that holds only as many rows as the
+ *  vertical filter reaches. Destination rows are written as soon as the rows they
+ *  depend on are in the ring, and source rows that no destination row depends on are
+ *  skipped rather than decoded. Peak memory is one source row and the ring buffer,
+ *  instead of a full resolution intermediate.
+ */
+class SkScanlineResampler {
+public:
+    /**
+     *  Returns a resampler from srcDimensions to dstInfo's dimensions, or nullptr if
+     *  dstInfo is not a color type and alpha type the resampler can filter. The filter
+     *  works on 8888 pixels that are premultiplied or opaque.
+     */
+    static std::unique_ptr<SkScanlineResampler> Make(SkISize srcDimensions,
+                                                     const SkImageInfo& dstInfo,
+                                                     const SkSamplingOptions&);
+
+    /**
+     *  Pulls the scanlines from codec and writes the resized image to dst.
+     *
+     *  The codec must have started a top down scanline decode of srcDimensions in dst's
+     *  color type, alpha type and color space.
+     *
+     *  @return kSuccess, or kIncompleteInput if the codec ran out of rows. In that case
+     *      the missing rows were filled by the codec before filtering.
+     */
+    SkCodec::Result resample(SkCodec*, const SkPixmap& dst);
+
+    /**
+     *  Number of horizontally filtered rows held in the ring buffer.
+     */
+    int ringRowCount() const { return fVertical.fMaxCount; }
+
+    // A 1D filter from fSrcSize to fContributions.size() samples. Each destination
+    // sample is a weighted sum of fCount contiguous source samples starting at fStart.
+    struct Filter {
+        struct Contribution {
+            int fStart;
+            int fCount;
+            int fWeightOffset;
+        };
+
+        int fSrcSize = 0;
+        int fMaxCount = 0;
+        std::vector<Contribution> fContributions;
+        // Fixed point weights with kWeightShift fractional bits. Each contribution's
+        // weights sum to 1 << kWeightShift.
+        std::vector<int16_t> fWeights;
+    };
+
+    static constexpr int kWeightShift = 14;
+
+private:
+    SkScanlineResampler(Filter&& horizontal, Filter&& vertical);
+
+    const Filter fHorizontal;
+    const Filter fVertical;
+};
+
+#endif  // SkScanlineResampler_DEFINED
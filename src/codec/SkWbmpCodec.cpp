@@ -97,8 +97,9 @@ bool SkWbmpCodec::onRewind() {
     return read_header(this->stream(), nullptr);
 }
 
-bool SkWbmpCodec::readRow(uint8_t* row) {
-    return this->stream()->read(row, fSrcRowBytes) == fSrcRowBytes;
+const uint8_t* SkWbmpCodec::readRow(uint8_t* buffer) {
+    // The swizzler reads the 1-bit pixels a byte at a time.
+    return read_bytes_in_place(this->stream(), buffer, fSrcRowBytes, 1);
 }
 
 SkWbmpCodec::SkWbmpCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream)
@@ -138,11 +139,12 @@ SkCodec::Result SkWbmpCodec::onGetPixels(const SkImageInfo& info,
     AutoTMalloc<uint8_t> src(fSrcRowBytes);
     void* dstRow = dst;
     for (int y = 0; y < size.height(); ++y) {
-        if (!this->readRow(src.get())) {
+        const uint8_t* srcRow = this->readRow(src.get());
+        if (!srcRow) {
             *rowsDecoded = y;
             return kIncompleteInput;
         }
-        swizzler->swizzle(dstRow, src.get());
+        swizzler->swizzle(dstRow, srcRow);
         dstRow = SkTAddOffset<void>(dstRow, rowBytes);
     }
     return kSuccess;
@@ -171,10 +173,11 @@ std::unique_ptr<SkCodec> SkWbmpCodec::MakeFromStream(std::unique_ptr<SkStream> s
 int SkWbmpCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
     void* dstRow = dst;
     for (int y = 0; y < count; ++y) {
-        if (!this->readRow(fSrcBuffer.get())) {
+        const uint8_t* srcRow = this->readRow(fSrcBuffer.get());
+        if (!srcRow) {
             return y;
         }
-        fSwizzler->swizzle(dstRow, fSrcBuffer.get());
+        fSwizzler->swizzle(dstRow, srcRow);
         dstRow = SkTAddOffset<void>(dstRow, dstRowBytes);
     }
     return count;
@@ -187,11 +190,8 @@ bool SkWbmpCodec::onSkipScanlines(int count) {
 
 SkCodec::Result SkWbmpCodec::onStartScanlineDecode(const SkImageInfo& dstInfo,
         const Options& options) {
-    if (options.fSubset) {
-        // Subsets are not supported.
-        return kUnimplemented;
-    }
-
+    // The swizzler handles the columns of a subset, and the rows before it are skipped with
+    // onSkipScanlines().
     fSwizzler = SkSwizzler::Make(this->getEncodedInfo(), nullptr, dstInfo, options);
     SkASSERT(fSwizzler);
 
@@ -51,8 +51,12 @@ private:
 
     /*
      * Read a src row from the encoded stream
+     *
+     * @param buffer Holds the row, unless the stream is in memory. Then the row is
+     *               returned in place.
+     * @return The row, or nullptr if the stream ended first
      */
-    bool readRow(uint8_t* row);
+    const uint8_t* readRow(uint8_t* buffer);
 
     SkWbmpCodec(SkEncodedInfo&&, std::unique_ptr<SkStream>);
 
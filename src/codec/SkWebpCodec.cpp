@@ -22,16 +22,17 @@
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
+#include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkParseEncodedOrigin.h"
 #include "src/codec/SkSampler.h"
 #include "src/core/SkRasterPipeline.h"
 #include "src/core/SkRasterPipelineOpContexts.h"
 #include "src/core/SkRasterPipelineOpList.h"
-#include "src/core/SkStreamPriv.h"
 
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <utility>
 
 // A WebP decoder on top of (subset of) libwebp
@@ -60,20 +61,32 @@ std::unique_ptr<SkCodec> SkWebpCodec::MakeFromStream(std::unique_ptr<SkStream> s
                                                      Result* result) {
     // Webp demux needs a contiguous data buffer.
     sk_sp<SkData> data = nullptr;
+    size_t dataSize = 0;
+    std::unique_ptr<SkStream> incoming;
     if (stream->getMemoryBase()) {
         // It is safe to make without copy because we'll hold onto the stream.
         data = SkData::MakeWithoutCopy(stream->getMemoryBase(), stream->getLength());
+        dataSize = data->size();
     } else {
-        data = SkCopyStreamToData(stream.get());
+        // Copy what the stream has now. If more is still to come, the codec holds onto the
+        // stream and appends the rest to the same buffer as it arrives.
+        dataSize = read_available(stream.get(), &data, 0);
+        if (!stream->isAtEnd()) {
+            incoming = std::move(stream);
+        }
 
         // If we are forced to copy the stream to a data, we can go ahead and delete the stream.
         stream.reset(nullptr);
     }
+    if (!dataSize) {
+        *result = kIncompleteInput;
+        return nullptr;
+    }
 
     // It's a little strange that the |demux| will outlive |webpData|, though it needs the
     // pointer in |webpData| to remain valid.  This works because the pointer remains valid
     // until the SkData is freed.
-    WebPData webpData = { data->bytes(), data->size() };
+    WebPData webpData = { data->bytes(), dataSize };
     WebPDemuxState state;
     SkAutoTCallVProc<WebPDemuxer, WebPDemuxDelete> demux(WebPDemuxPartial(&webpData, &state));
     switch (state) {
@@ -188,7 +201,8 @@ std::unique_ptr<SkCodec> SkWebpCodec::MakeFromStream(std::unique_ptr<SkStream> s
     *result = kSuccess;
     SkEncodedInfo info = SkEncodedInfo::Make(width, height, color, alpha, 8, std::move(profile));
     return std::unique_ptr<SkCodec>(new SkWebpCodec(std::move(info), std::move(stream),
-                                                    demux.release(), std::move(data), origin));
+                                                    std::move(incoming), demux.release(),
+                                                    std::move(data), dataSize, origin));
 }
 
 static WEBP_CSP_MODE webp_decode_mode(SkColorType dstCT, bool premultiply) {
@@ -244,6 +258,9 @@ int SkWebpCodec::onGetRepetitionCount() {
 }
 
 int SkWebpCodec::onGetFrameCount() {
+    // More frames may have arrived since the last call.
+    this->readIncomingData();
+
     auto flags = WebPDemuxGetI(fDemux.get(), WEBP_FF_FORMAT_FLAGS);
     if (!(flags & ANIMATION_FLAG)) {
         return 1;
@@ -359,22 +376,113 @@ static void blend_line(SkColorType dstCT, void* dst,
     p.run(0,0, width,1);
 }
 
+struct SkWebpCodec::IncrementalDecode {
+    ~IncrementalDecode() {
+        // The decoder writes to fConfig.output, so it must be deleted first.
+        fDecoder.reset();
+        WebPFreeDecBuffer(&fConfig.output);
+    }
+
+    WebPDecoderConfig fConfig;
+    // Null if there is nothing left to decode.
+    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> fDecoder;
+    int fFrameIndex = 0;
+
+    // Where libwebp decodes to. Either the client's memory or, if the rows need to be
+    // transformed into another color type or blended, a temporary image.
+    SkBitmap fWebpDst;
+    SkImageInfo fDstInfo;
+    // The client's memory, offset to the top left of the frame.
+    void* fDst = nullptr;
+    size_t fRowBytes = 0;
+    int fDstY = 0;
+    int fScaledWidth = 0;
+    int fScaledHeight = 0;
+    bool fHasAlpha = false;
+    bool fBlendWithPrevFrame = false;
+
+    // Rows of the frame that libwebp has finished and that have been written to fDst.
+    int fRowsDecoded = 0;
+};
+
+SkWebpCodec::~SkWebpCodec() = default;
+
+void SkWebpCodec::readIncomingData() {
+    if (!fIncomingStream) {
+        return;
+    }
+
+    const size_t oldSize = fDataSize;
+    fDataSize = read_available(fIncomingStream.get(), &fData, fDataSize);
+    if (fIncomingStream->isAtEnd()) {
+        fIncomingStream.reset();
+    }
+    if (fDataSize == oldSize) {
+        return;
+    }
+
+    // The old demuxer may point to memory that read_available() freed, so always replace it.
+    // Parsing the container only looks at the chunk headers, not the image data.
+    WebPData webpData = { fData->bytes(), fDataSize };
+    WebPDemuxState state;
+    WebPDemuxer* demux = WebPDemuxPartial(&webpData, &state);
+    if (!demux || WEBP_DEMUX_PARSE_ERROR == state) {
+        // The new bytes are corrupt. Treat them as missing, and stop reading.
+        WebPDemuxDelete(demux);
+        fDataSize = oldSize;
+        fIncomingStream.reset();
+        webpData.size = fDataSize;
+        demux = WebPDemuxPartial(&webpData, &state);
+    }
+    fDemux.reset(demux);
+}
+
 SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
                                          const Options& options, int* rowsDecodedPtr) {
+    Result result = this->startDecode(dstInfo, dst, rowBytes, options);
+    if (kSuccess != result) {
+        return result;
+    }
+
+    int rowsDecoded = 0;
+    result = this->onIncrementalDecode(&rowsDecoded);
+    if (kIncompleteInput == result) {
+        if (fIncrementalDecode->fRowsDecoded <= 0) {
+            result = kInvalidInput;
+        } else {
+            *rowsDecodedPtr = rowsDecoded;
+        }
+    }
+    fIncrementalDecode.reset();
+    return result;
+}
+
+SkCodec::Result SkWebpCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                      size_t rowBytes, const Options& options) {
+    // Unlike getPixels(), startIncrementalDecode() takes a subset in the coordinates of the
+    // whole destination. Only whole frames are decoded incrementally.
+    if (options.fSubset) {
+        return kUnimplemented;
+    }
+    return this->startDecode(dstInfo, dst, rowBytes, options);
+}
+
+SkCodec::Result SkWebpCodec::startDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                         const Options& options) {
+    fIncrementalDecode.reset();
+
     const int index = options.fFrameIndex;
     SkASSERT(0 == index || index < fFrameHolder.size());
     SkASSERT(0 == index || !options.fSubset);
 
-    WebPDecoderConfig config;
+    auto decode = std::make_unique<IncrementalDecode>();
+    WebPDecoderConfig& config = decode->fConfig;
     if (0 == WebPInitDecoderConfig(&config)) {
         // ABI mismatch.
         // FIXME: New enum for this?
         return kInvalidInput;
     }
 
-    // Free any memory associated with the buffer. Must be called last, so we declare it first.
-    SkAutoTCallVProc<WebPDecBuffer, WebPFreeDecBuffer> autoFree(&(config.output));
-
     WebPIterator frame;
     SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
     // If this succeeded in onGetFrameCount(), it should succeed again here.
@@ -402,6 +510,7 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
         SkASSERT(this->getValidSubset(&subset) && subset == *options.fSubset);
 
         if (!SkIRect::Intersects(subset, frameRect)) {
+            fIncrementalDecode = std::move(decode);
             return kSuccess;
         }
 
@@ -447,6 +556,7 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
             dstY = scaleY * dstY;
             scaledHeight = scaleY * scaledHeight;
             if (0 == scaledWidth || 0 == scaledHeight) {
+                fIncrementalDecode = std::move(decode);
                 return kSuccess;
             }
         } else {
@@ -477,11 +587,11 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
         webpInfo = webpInfo.makeColorType(kBGRA_8888_SkColorType);
     }
 
-    SkBitmap webpDst;
+    SkBitmap& webpDst = decode->fWebpDst;
     if ((this->colorXform() && !is_8888(dstInfo.colorType())) || blendWithPrevFrame) {
-        // We will decode the entire image and then perform the color transform.  libwebp
-        // does not provide a row-by-row API.  This is a shame particularly when we do not want
-        // 8888, since we will need to create another image sized buffer.
+        // libwebp decodes to this image, and the rows are transformed or blended into dst as
+        // they are finished.  This is a shame particularly when we do not want 8888, since we
+        // need another image sized buffer.
         webpDst.allocPixels(webpInfo);
     } else {
         // libwebp can decode directly into the output memory.
@@ -496,41 +606,88 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     config.output.u.RGBA.stride = static_cast<int>(webpDst.rowBytes());
     config.output.u.RGBA.size = webpDst.computeByteSize();
 
-    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> idec(WebPIDecode(nullptr, 0, &config));
-    if (!idec) {
+    // No data yet. Each call to onIncrementalDecode() passes libwebp the frame's bytes from the
+    // start, and libwebp only decodes the ones that it has not seen.
+    decode->fDecoder.reset(WebPIDecode(nullptr, 0, &config));
+    if (!decode->fDecoder) {
         return kInvalidInput;
     }
 
+    decode->fFrameIndex = index;
+    decode->fDstInfo = dstInfo;
+    decode->fDst = SkTAddOffset<void>(dst, dstInfo.bytesPerPixel() * dstX + rowBytes * dstY);
+    decode->fRowBytes = rowBytes;
+    decode->fDstY = dstY;
+    decode->fScaledWidth = scaledWidth;
+    decode->fScaledHeight = scaledHeight;
+    decode->fHasAlpha = frame.has_alpha;
+    decode->fBlendWithPrevFrame = blendWithPrevFrame;
+    fIncrementalDecode = std::move(decode);
+    return kSuccess;
+}
+
+SkCodec::Result SkWebpCodec::onIncrementalDecode(int* rowsDecodedPtr) {
+    IncrementalDecode* decode = fIncrementalDecode.get();
+    SkASSERT(decode);
+    if (!decode->fDecoder) {
+        return kSuccess;
+    }
+
+    this->readIncomingData();
+
+    // The frame's bytes may have moved to a larger buffer, which WebPIUpdate() allows.
+    WebPIterator frame;
+    SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
+    SkAssertResult(WebPDemuxGetFrame(fDemux, decode->fFrameIndex + 1, &frame));
+
     int rowsDecoded = 0;
     SkCodec::Result result;
-    switch (WebPIUpdate(idec, frame.fragment.bytes, frame.fragment.size)) {
+    switch (WebPIUpdate(decode->fDecoder, frame.fragment.bytes, frame.fragment.size)) {
         case VP8_STATUS_OK:
-            rowsDecoded = scaledHeight;
+            rowsDecoded = decode->fScaledHeight;
             result = kSuccess;
             break;
         case VP8_STATUS_SUSPENDED:
-            if (!WebPIDecGetRGB(idec, &rowsDecoded, nullptr, nullptr, nullptr)
-                    || rowsDecoded <= 0) {
-                return kInvalidInput;
+            // This fails until libwebp has read the frame's headers.
+            if (!WebPIDecGetRGB(decode->fDecoder, &rowsDecoded, nullptr, nullptr, nullptr)) {
+                rowsDecoded = 0;
             }
-            *rowsDecodedPtr = rowsDecoded + dstY;
             result = kIncompleteInput;
             break;
         default:
             return kInvalidInput;
     }
 
-    const size_t dstBpp = dstInfo.bytesPerPixel();
-    dst = SkTAddOffset<void>(dst, dstBpp * dstX + rowBytes * dstY);
-    const size_t srcRowBytes = config.output.u.RGBA.stride;
+    this->processDecodedRows(rowsDecoded);
+    if (kSuccess == result) {
+        decode->fDecoder.reset();
+    } else if (rowsDecodedPtr) {
+        *rowsDecodedPtr = decode->fDstY + rowsDecoded;
+    }
+    return result;
+}
+
+void SkWebpCodec::processDecodedRows(int rowsDecoded) {
+    IncrementalDecode* decode = fIncrementalDecode.get();
+    const int startRow = decode->fRowsDecoded;
+    decode->fRowsDecoded = std::max(rowsDecoded, startRow);
+    if (rowsDecoded <= startRow || (!this->colorXform() && !decode->fBlendWithPrevFrame)) {
+        return;
+    }
+
+    const SkImageInfo& dstInfo = decode->fDstInfo;
+    const size_t rowBytes = decode->fRowBytes;
+    const size_t srcRowBytes = decode->fConfig.output.u.RGBA.stride;
+    const int scaledWidth = decode->fScaledWidth;
+    void* dst = SkTAddOffset<void>(decode->fDst, rowBytes * startRow);
+    const uint8_t* src = decode->fConfig.output.u.RGBA.rgba + srcRowBytes * startRow;
 
     const auto dstCT = dstInfo.colorType();
     if (this->colorXform()) {
-        uint32_t* xformSrc = (uint32_t*) config.output.u.RGBA.rgba;
         SkBitmap tmp;
         void* xformDst;
 
-        if (blendWithPrevFrame) {
+        if (decode->fBlendWithPrevFrame) {
             // Xform into temporary bitmap big enough for one row.
             tmp.allocPixels(dstInfo.makeWH(scaledWidth, 1));
             xformDst = tmp.getPixels();
@@ -538,37 +695,36 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
             xformDst = dst;
         }
 
-        for (int y = 0; y < rowsDecoded; y++) {
-            this->applyColorXform(xformDst, xformSrc, scaledWidth);
-            if (blendWithPrevFrame) {
+        for (int y = startRow; y < rowsDecoded; y++) {
+            this->applyColorXform(xformDst, src, scaledWidth);
+            if (decode->fBlendWithPrevFrame) {
                 blend_line(dstCT, dst, dstCT, xformDst,
-                        dstInfo.alphaType(), frame.has_alpha, scaledWidth);
+                        dstInfo.alphaType(), decode->fHasAlpha, scaledWidth);
                 dst = SkTAddOffset<void>(dst, rowBytes);
             } else {
                 xformDst = SkTAddOffset<void>(xformDst, rowBytes);
             }
-            xformSrc = SkTAddOffset<uint32_t>(xformSrc, srcRowBytes);
+            src = SkTAddOffset<const uint8_t>(src, srcRowBytes);
         }
-    } else if (blendWithPrevFrame) {
-        const uint8_t* src = config.output.u.RGBA.rgba;
-
-        for (int y = 0; y < rowsDecoded; y++) {
-            blend_line(dstCT, dst, webpDst.colorType(), src,
-                    dstInfo.alphaType(), frame.has_alpha, scaledWidth);
+    } else {
+        for (int y = startRow; y < rowsDecoded; y++) {
+            blend_line(dstCT, dst, decode->fWebpDst.colorType(), src,
+                    dstInfo.alphaType(), decode->fHasAlpha, scaledWidth);
             src = SkTAddOffset<const uint8_t>(src, srcRowBytes);
             dst = SkTAddOffset<void>(dst, rowBytes);
         }
     }
-
-    return result;
 }
 
 SkWebpCodec::SkWebpCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream,
-                         WebPDemuxer* demux, sk_sp<SkData> data, SkEncodedOrigin origin)
+                         std::unique_ptr<SkStream> incoming, WebPDemuxer* demux,
+                         sk_sp<SkData> data, size_t dataSize, SkEncodedOrigin origin)
     : INHERITED(std::move(info), skcms_PixelFormat_BGRA_8888, std::move(stream),
                 origin)
     , fDemux(demux)
     , fData(std::move(data))
+    , fDataSize(dataSize)
+    , fIncomingStream(std::move(incoming))
     , fFailed(false)
 {
     const auto& eInfo = this->getEncodedInfo();
@@ -37,8 +37,14 @@ public:
     // Assumes IsWebp was called and returned true.
     static std::unique_ptr<SkCodec> MakeFromStream(std::unique_ptr<SkStream>, Result*);
     static bool IsWebp(const void*, size_t);
+
+    ~SkWebpCodec() override;
+
 protected:
     Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, int*) override;
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* pixels, size_t rowBytes,
+                                    const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
     SkEncodedImageFormat onGetEncodedFormat() const override { return SkEncodedImageFormat::kWEBP; }
 
     bool onGetValidSubset(SkIRect* /* desiredSubset */) const override;
@@ -52,14 +58,38 @@ protected:
     }
 
 private:
-    SkWebpCodec(SkEncodedInfo&&, std::unique_ptr<SkStream>, WebPDemuxer*, sk_sp<SkData>,
-                SkEncodedOrigin);
+    SkWebpCodec(SkEncodedInfo&&, std::unique_ptr<SkStream>, std::unique_ptr<SkStream> incoming,
+                WebPDemuxer*, sk_sp<SkData>, size_t dataSize, SkEncodedOrigin);
+
+    // Sets up fIncrementalDecode to decode into dst. Shared by getPixels(), which decodes
+    // whatever data is available in one step, and startIncrementalDecode().
+    Result startDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, const Options&);
+
+    // Appends whatever fIncomingStream has made available since the last call to fData, and
+    // reparses the container if anything was read.
+    void readIncomingData();
+
+    // Applies the color transform and blending that libwebp could not do to the rows that
+    // libwebp has finished since the last call.
+    void processDecodedRows(int rowsDecoded);
 
     SkAutoTCallVProc<WebPDemuxer, WebPDemuxDelete> fDemux;
 
     // fDemux has a pointer into this data.
     // This should not be freed until the decode is completed.
+    // Only the first fDataSize bytes are valid. The rest is room for the bytes that
+    // fIncomingStream has not delivered yet.
     sk_sp<SkData> fData;
+    size_t        fDataSize;
+
+    // Set when the image was not in memory and the stream may still deliver more of it.
+    // All of the bytes read so far are in fData, so resuming a decode never rewinds.
+    std::unique_ptr<SkStream> fIncomingStream;
+
+    // The libwebp decoder for the current incremental decode, which only consumes the
+    // bytes that it has not seen before each time it is resumed.
+    struct IncrementalDecode;
+    std::unique_ptr<IncrementalDecode> fIncrementalDecode;
 
     class Frame : public SkFrame {
     public:
@@ -95,7 +95,14 @@ namespace SkOpts {
                            RGB_to_BGR1,     // i.e. swap RB and insert an opaque alpha
                            gray_to_RGB1,    // i.e. expand to color channels + an opaque alpha
                            grayA_to_RGBA,   // i.e. expand to color channels
-                           grayA_to_rgbA;   // i.e. expand to color channels and premultiply
+                           grayA_to_rgbA,   // i.e. expand to color channels and premultiply
+                           RGBA16_to_RGBA,  // i.e. keep the high byte of big-endian components
+                           RGBA16_to_BGRA,  // i.e. keep the high bytes and swap RB
+                           RGB16_to_RGB1,   // i.e. keep the high bytes and insert an opaque alpha
+                           RGB16_to_BGR1;   // i.e. keep the high bytes, swap RB and insert alpha
+
+    // Look up 8-bit indices in a 256 entry color table.
+    extern void (*index8_to_8888)(uint32_t*, const uint8_t*, int, const uint32_t ctable[]);
 
     extern void (*memset16)(uint16_t[], uint16_t, int);
     extern void (*memset32)(uint32_t[], uint32_t, int);
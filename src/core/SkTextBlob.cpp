@@ -9,9 +9,11 @@
 
 #include "include/core/SkRSXform.h"
 #include "include/core/SkTypeface.h"
+#include "include/private/base/SkTDArray.h"
 #include "src/base/SkSafeMath.h"
 #include "src/core/SkFontPriv.h"
 #include "src/core/SkPaintPriv.h"
+#include "src/core/SkPicturePriv.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
@@ -20,6 +22,7 @@
 #include "src/text/GlyphRun.h"
 
 #include <atomic>
+#include <cmath>
 #include <limits>
 #include <new>
 
@@ -172,12 +175,115 @@ union PositioningAndExtended {
     struct {
         uint8_t  positioning;
         uint8_t  extended;
-        uint16_t padding;
+        uint16_t compact;   // CompactFlags; always zero before kCompactTextBlobRuns
     };
 };
 
 static_assert(sizeof(PositioningAndExtended) == sizeof(int32_t), "");
 
+enum CompactFlags : uint16_t {
+    kCompactGlyphs_Flag    = 1 << 0, // glyph ids are stored as varints
+    kCompactPositions_Flag = 1 << 1, // horizontal positions are delta-encoded 26.6 varints
+
+    kAllCompact_Flags      = kCompactGlyphs_Flag | kCompactPositions_Flag,
+};
+
+// Most rasterizers (and so most shapers) position glyphs in 26.6 fixed point.
+// Positions that are exactly representable this way are stored as such, everything else
+// is stored as is: the encoding is always lossless.
+static constexpr float kCompactPositionScale = 64.0f;
+
+void write_varint(SkTDArray<uint8_t>* storage, uint32_t value) {
+    while (value >= 0x80) {
+        storage->push_back(SkToU8((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    storage->push_back(SkToU8(value));
+}
+
+bool read_varint(const uint8_t** ptr, const uint8_t* end, uint32_t* value) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+        if (*ptr == end) {
+            return false;
+        }
+        uint8_t byte = *(*ptr)++;
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t zigzag_encode(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+int32_t zigzag_decode(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// Returns true if the varint encoding is smaller than the plain one.
+bool encode_glyphs(SkSpan<const uint16_t> glyphs, SkTDArray<uint8_t>* encoded) {
+    for (uint16_t glyph : glyphs) {
+        write_varint(encoded, glyph);
+    }
+    return encoded->size_bytes() < glyphs.size_bytes();
+}
+
+bool decode_glyphs(const uint8_t* data, size_t size, SkSpan<uint16_t> glyphs) {
+    const uint8_t* end = data + size;
+    for (uint16_t& glyph : glyphs) {
+        uint32_t value;
+        if (!read_varint(&data, end, &value) || !SkTFitsIn<uint16_t>(value)) {
+            return false;
+        }
+        glyph = SkToU16(value);
+    }
+    return data == end;
+}
+
+// Returns true if all the positions are exact 26.6 values and the encoding is smaller
+// than the plain one. Negative zeros aren't exact 26.6 values, as their sign would be lost.
+bool encode_positions(SkSpan<const SkScalar> positions, SkTDArray<uint8_t>* encoded) {
+    // Keep the fixed point values (and their differences) exact in both float and int32_t
+    static constexpr float kMaxScaled = 1 << 24;
+    int32_t previous = 0;
+    for (SkScalar position : positions) {
+        float scaled = position * kCompactPositionScale;
+        if (!(scaled >= -kMaxScaled && scaled <= kMaxScaled)) {
+            return false;
+        }
+        int32_t fixed = (int32_t)scaled;
+        // -0 compares equal to 0 but would decode as +0
+        if ((float)fixed != scaled || (fixed == 0 && std::signbit(scaled))) {
+            return false;
+        }
+        write_varint(encoded, zigzag_encode(fixed - previous));
+        previous = fixed;
+    }
+    return encoded->size_bytes() < positions.size_bytes();
+}
+
+bool decode_positions(const uint8_t* data, size_t size, SkSpan<SkScalar> positions) {
+    const uint8_t* end = data + size;
+    int64_t fixed = 0;
+    for (SkScalar& position : positions) {
+        uint32_t value;
+        if (!read_varint(&data, end, &value)) {
+            return false;
+        }
+        fixed += zigzag_decode(value);
+        if (fixed < INT32_MIN || fixed > INT32_MAX) {
+            return false;
+        }
+        position = (float)fixed * (1 / kCompactPositionScale);
+    }
+    return data == end;
+}
+
 } // namespace
 
 enum SkTextBlob::GlyphPositioning : uint8_t {
@@ -666,6 +772,17 @@ void SkTextBlobPriv::Flatten(const SkTextBlob& blob, SkWriteBuffer& buffer) {
         pe.positioning = it.positioning();
         SkASSERT((int32_t)it.positioning() == pe.intValue);  // backwards compat.
 
+        const size_t posCount = it.glyphCount() * SkTextBlob::ScalarsPerGlyph(
+                                        SkTo<SkTextBlob::GlyphPositioning>(it.positioning()));
+        SkTDArray<uint8_t> compactGlyphs, compactPositions;
+        if (encode_glyphs({it.glyphs(), it.glyphCount()}, &compactGlyphs)) {
+            pe.compact |= kCompactGlyphs_Flag;
+        }
+        if (it.positioning() == SkTextBlobRunIterator::kHorizontal_Positioning &&
+            encode_positions({it.pos(), posCount}, &compactPositions)) {
+            pe.compact |= kCompactPositions_Flag;
+        }
+
         uint32_t textSize = it.textSize();
         pe.extended = textSize > 0;
         buffer.write32(pe.intValue);
@@ -676,11 +793,16 @@ void SkTextBlobPriv::Flatten(const SkTextBlob& blob, SkWriteBuffer& buffer) {
 
         SkFontPriv::Flatten(it.font(), buffer);
 
-        buffer.writeByteArray(it.glyphs(), it.glyphCount() * sizeof(uint16_t));
-        buffer.writeByteArray(it.pos(),
-                              it.glyphCount() * sizeof(SkScalar) *
-                              SkTextBlob::ScalarsPerGlyph(
-                                  SkTo<SkTextBlob::GlyphPositioning>(it.positioning())));
+        if (pe.compact & kCompactGlyphs_Flag) {
+            buffer.writeByteArray(compactGlyphs.data(), compactGlyphs.size_bytes());
+        } else {
+            buffer.writeByteArray(it.glyphs(), it.glyphCount() * sizeof(uint16_t));
+        }
+        if (pe.compact & kCompactPositions_Flag) {
+            buffer.writeByteArray(compactPositions.data(), compactPositions.size_bytes());
+        } else {
+            buffer.writeByteArray(it.pos(), posCount * sizeof(SkScalar));
+        }
         if (pe.extended) {
             buffer.writeByteArray(it.clusters(), sizeof(uint32_t) * it.glyphCount());
             buffer.writeByteArray(it.text(), it.textSize());
@@ -708,10 +830,20 @@ sk_sp<SkTextBlob> SkTextBlobPriv::MakeFromBuffer(SkReadBuffer& reader) {
 
         PositioningAndExtended pe;
         pe.intValue = reader.read32();
+        if (reader.isVersionLT(SkPicturePriv::kCompactTextBlobRuns)) {
+            // These bits were padding then, so older runs are never compact.
+            pe.compact = 0;
+        }
         const auto pos = SkTo<SkTextBlob::GlyphPositioning>(pe.positioning);
         if (glyphCount <= 0 || pos > SkTextBlob::kRSXform_Positioning) {
             return nullptr;
         }
+        if ((pe.compact & ~kAllCompact_Flags) ||
+            ((pe.compact & kCompactPositions_Flag) && pos != SkTextBlob::kHorizontal_Positioning)) {
+            return nullptr;
+        }
+        const bool compactGlyphs = pe.compact & kCompactGlyphs_Flag;
+        const bool compactPositions = pe.compact & kCompactPositions_Flag;
         int textSize = pe.extended ? reader.read32() : 0;
         if (textSize < 0) {
             return nullptr;
@@ -729,8 +861,11 @@ sk_sp<SkTextBlob> SkTextBlobPriv::MakeFromBuffer(SkReadBuffer& reader) {
                              safe.mul(glyphCount, safe.mul(sizeof(SkScalar),
                              SkTextBlob::ScalarsPerGlyph(pos))),
                      clusterSize = pe.extended ? safe.mul(glyphCount, sizeof(uint32_t)) : 0;
+        // Compact glyphs and positions take at least a byte each
+        const size_t minGlyphSize = compactGlyphs ? glyphCount : glyphSize,
+                     minPosSize = compactPositions ? glyphCount : posSize;
         const size_t totalSize =
-                safe.add(safe.add(glyphSize, posSize), safe.add(clusterSize, textSize));
+                safe.add(safe.add(minGlyphSize, minPosSize), safe.add(clusterSize, textSize));
 
         if (!reader.isValid() || !safe || totalSize > reader.available()) {
             return nullptr;
@@ -760,10 +895,24 @@ sk_sp<SkTextBlob> SkTextBlobPriv::MakeFromBuffer(SkReadBuffer& reader) {
             return nullptr;
         }
 
-        if (!reader.readByteArray(buf->glyphs, glyphSize) ||
-            !reader.readByteArray(buf->pos, posSize)) {
+        if (compactGlyphs) {
+            size_t size;
+            auto data = static_cast<const uint8_t*>(reader.skipByteArray(&size));
+            if (!data || !decode_glyphs(data, size, {buf->glyphs, (size_t)glyphCount})) {
+                return nullptr;
+            }
+        } else if (!reader.readByteArray(buf->glyphs, glyphSize)) {
             return nullptr;
+        }
+        if (compactPositions) {
+            size_t size;
+            auto data = static_cast<const uint8_t*>(reader.skipByteArray(&size));
+            if (!data || !decode_positions(data, size, {buf->pos, (size_t)glyphCount})) {
+                return nullptr;
             }
+        } else if (!reader.readByteArray(buf->pos, posSize)) {
+            return nullptr;
+        }
 
         if (pe.extended) {
             if (!reader.readByteArray(buf->clusters, clusterSize) ||
@@ -0,0 +1,325 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkYUVAToRGB.h"
+
+#include "include/core/SkColorType.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkYUVAInfo.h"
+#include "include/core/SkYUVAPixmaps.h"
+#include "include/private/base/SkTPin.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkYUVAInfoLocation.h"
+#include "src/core/SkYUVMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+using namespace skia_private;
+
+namespace {
+
+constexpr int kShift = 16;
+
+// One row of the YUV to RGB matrix, scaled for 8-bit channels, in fixed point with kShift
+// fractional bits. fBias includes the rounding.
+struct MatrixRow {
+    int32_t fY, fU, fV, fBias;
+};
+
+MatrixRow make_row(const float m[5]) {
+    constexpr float kOne = 1 << kShift;
+    return {(int32_t)std::lround(m[0] * kOne),
+            (int32_t)std::lround(m[1] * kOne),
+            (int32_t)std::lround(m[2] * kOne),
+            (int32_t)std::lround(m[4] * 255 * kOne) + (1 << (kShift - 1))};
+}
+
+// Bytes per pixel of a plane, or 0 if its channels are not all 8-bit unorm in RGBA order.
+int plane_bpp(SkColorType ct) {
+    switch (ct) {
+        case kAlpha_8_SkColorType:
+        case kGray_8_SkColorType:     return 1;
+        case kR8G8_unorm_SkColorType: return 2;
+        case kRGB_888x_SkColorType:
+        case kRGBA_8888_SkColorType:  return 4;
+        default:                      return 0;
+    }
+}
+
+// One of the Y, U, V or A channels, in one of the planes.
+struct Channel {
+    const SkPixmap* fPlane = nullptr;
+    int fBpp = 0;
+    int fOffset = 0;
+
+    // Returns row y of the channel, first copying it to storage if the plane interleaves it
+    // with other channels.
+    const uint8_t* row(int y, uint8_t* storage) const {
+        const uint8_t* src = static_cast<const uint8_t*>(fPlane->addr(0, y));
+        if (fBpp == 1) {
+            return src;
+        }
+
+        const int count = fPlane->width();
+        int x = 0;
+        if (fBpp == 2) {
+            for (; x + 16 <= count; x += 16) {
+                skvx::byte16 c[2];
+                skvx::strided_load2(src + 2*x, c[0], c[1]);
+                c[fOffset].store(storage + x);
+            }
+        } else {
+            SkASSERT(fBpp == 4);
+            for (; x + 16 <= count; x += 16) {
+                skvx::byte16 c[4];
+                skvx::strided_load4(src + 4*x, c[0], c[1], c[2], c[3]);
+                c[fOffset].store(storage + x);
+            }
+        }
+        for (; x < count; ++x) {
+            storage[x] = src[x*fBpp + fOffset];
+        }
+        return storage;
+    }
+};
+
+// Sums the chroma rows that contribute to an output row, the nearer one weighted 3:1. When
+// chroma is not vertically subsampled, near and far are the same row, so that the sums are
+// always four times the vertically interpolated chroma.
+void vertical_sum(const uint8_t* near, const uint8_t* far, int count, uint16_t* sums) {
+    using U16 = skvx::Vec<8, uint16_t>;
+    int x = 0;
+    for (; x + 8 <= count; x += 8) {
+        U16 sum = skvx::cast<uint16_t>(skvx::byte8::Load(near + x)) * 3 +
+                  skvx::cast<uint16_t>(skvx::byte8::Load(far + x));
+        sum.store(sums + x);
+    }
+    for (; x < count; ++x) {
+        sums[x] = near[x] * 3 + far[x];
+    }
+}
+
+// Rounds the vertical sums back down to chroma values, for chroma that is not horizontally
+// subsampled.
+void narrow(const uint16_t* sums, int count, uint16_t bias, uint8_t* dst) {
+    using U16 = skvx::Vec<8, uint16_t>;
+    int x = 0;
+    for (; x + 8 <= count; x += 8) {
+        skvx::cast<uint8_t>((U16::Load(sums + x) + bias) >> 2).store(dst + x);
+    }
+    for (; x < count; ++x) {
+        dst[x] = (sums[x] + bias) >> 2;
+    }
+}
+
+// Doubles the width of a row of vertical sums, weighting the nearer column 3:1 and rounding back
+// down to chroma values. The biases match libjpeg's h2v1 and h2v2 upsamplers.
+void upsample_2x(const uint16_t* sums, int count, int width,
+                 uint16_t evenBias, uint16_t oddBias, uint8_t* dst) {
+    auto even = [&](int i) {
+        return (uint8_t)((3*sums[i] + sums[std::max(i - 1, 0)] + evenBias) >> 4);
+    };
+    auto odd = [&](int i) {
+        return (uint8_t)((3*sums[i] + sums[std::min(i + 1, count - 1)] + oddBias) >> 4);
+    };
+
+    // The first and last columns clamp their neighbors.
+    int i = 0;
+    if (count > 0) {
+        dst[0] = even(0);
+        if (width > 1) {
+            dst[1] = odd(0);
+        }
+        i = 1;
+    }
+
+    using U16 = skvx::Vec<8, uint16_t>;
+    for (; i + 9 <= count && 2*i + 16 <= width; i += 8) {
+        const U16 near = U16::Load(sums + i) * 3;
+        const U16 e = (near + U16::Load(sums + i - 1) + evenBias) >> 4;
+        const U16 o = (near + U16::Load(sums + i + 1) + oddBias) >> 4;
+        skvx::cast<uint8_t>(skvx::shuffle<0,8,1,9,2,10,3,11,4,12,5,13,6,14,7,15>(
+                skvx::join(e, o))).store(dst + 2*i);
+    }
+
+    for (; i < count; ++i) {
+        dst[2*i] = even(i);
+        if (2*i + 1 < width) {
+            dst[2*i + 1] = odd(i);
+        }
+    }
+}
+
+skvx::Vec<8, uint32_t> yuva_to_8888(skvx::byte8 Y, skvx::byte8 U, skvx::byte8 V, skvx::byte8 A,
+                                    const MatrixRow k[3], bool premul, bool bgra) {
+    const skvx::int8 y = skvx::cast<int32_t>(Y),
+                     u = skvx::cast<int32_t>(U),
+                     v = skvx::cast<int32_t>(V);
+    auto channel = [&](const MatrixRow& m) {
+        skvx::int8 c = (y*m.fY + u*m.fU + v*m.fV + m.fBias) >> kShift;
+        return skvx::cast<uint16_t>(skvx::pin(c, skvx::int8(0), skvx::int8(255)));
+    };
+    auto r = channel(k[0]),
+         g = channel(k[1]),
+         b = channel(k[2]);
+    const auto a = skvx::cast<uint16_t>(A);
+    if (premul) {
+        r = skvx::cast<uint16_t>(skvx::div255(r * a));
+        g = skvx::cast<uint16_t>(skvx::div255(g * a));
+        b = skvx::cast<uint16_t>(skvx::div255(b * a));
+    }
+    if (bgra) {
+        std::swap(r, b);
+    }
+    return skvx::cast<uint32_t>(r)       |
+           skvx::cast<uint32_t>(g) <<  8 |
+           skvx::cast<uint32_t>(b) << 16 |
+           skvx::cast<uint32_t>(a) << 24;
+}
+
+// Converts a row of full resolution channels. a may be null for opaque pixels.
+void yuva_row_to_8888(const uint8_t* y, const uint8_t* u, const uint8_t* v, const uint8_t* a,
+                      int count, const MatrixRow k[3], bool premul, bool bgra, uint32_t* dst) {
+    const skvx::byte8 opaque(0xFF);
+    int x = 0;
+    for (; x + 8 <= count; x += 8) {
+        yuva_to_8888(skvx::byte8::Load(y + x),
+                     skvx::byte8::Load(u + x),
+                     skvx::byte8::Load(v + x),
+                     a ? skvx::byte8::Load(a + x) : opaque,
+                     k, premul, bgra).store(dst + x);
+    }
+
+    if (const int tail = count - x) {
+        uint8_t Y[8] = {}, U[8] = {}, V[8] = {}, A[8] = {};
+        memcpy(Y, y + x, tail);
+        memcpy(U, u + x, tail);
+        memcpy(V, v + x, tail);
+        if (a) {
+            memcpy(A, a + x, tail);
+        }
+        uint32_t pixels[8];
+        yuva_to_8888(skvx::byte8::Load(Y),
+                     skvx::byte8::Load(U),
+                     skvx::byte8::Load(V),
+                     a ? skvx::byte8::Load(A) : opaque,
+                     k, premul, bgra).store(pixels);
+        memcpy(dst + x, pixels, tail * sizeof(uint32_t));
+    }
+}
+
+}  // namespace
+
+bool SkYUVAToRGB(const SkYUVAPixmaps& src, const SkPixmap& dst) {
+    if (!src.isValid() || src.dataType() != SkYUVAPixmaps::DataType::kUnorm8) {
+        return false;
+    }
+    const SkYUVAInfo& info = src.yuvaInfo();
+    if (info.origin() != kTopLeft_SkEncodedOrigin ||
+        info.sitingX() != SkYUVAInfo::Siting::kCentered ||
+        info.sitingY() != SkYUVAInfo::Siting::kCentered ||
+        dst.dimensions() != info.dimensions()) {
+        return false;
+    }
+    bool bgra;
+    switch (dst.colorType()) {
+        case kRGBA_8888_SkColorType: bgra = false; break;
+        case kBGRA_8888_SkColorType: bgra = true;  break;
+        default:                     return false;
+    }
+
+    const SkYUVAInfo::YUVALocations locations = src.toYUVALocations();
+    Channel channels[SkYUVAInfo::kYUVAChannelCount];
+    for (int i = 0; i < SkYUVAInfo::kYUVAChannelCount; ++i) {
+        if (locations[i].fPlane < 0) {
+            // Only alpha is optional.
+            continue;
+        }
+        const SkPixmap& plane = src.plane(locations[i].fPlane);
+        const int bpp = plane_bpp(plane.colorType());
+        if (!bpp) {
+            return false;
+        }
+        channels[i] = {&plane, bpp, bpp == 1 ? 0 : static_cast<int>(locations[i].fChannel)};
+    }
+    const Channel& yChannel = channels[SkYUVAInfo::kY];
+    const Channel& aChannel = channels[SkYUVAInfo::kA];
+    const Channel* uvChannels[2] = {&channels[SkYUVAInfo::kU], &channels[SkYUVAInfo::kV]};
+    const bool hasAlpha = aChannel.fPlane && dst.alphaType() != kOpaque_SkAlphaType;
+    const bool premul = hasAlpha && dst.alphaType() == kPremul_SkAlphaType;
+
+    // U and V are always subsampled the same way.
+    auto [ssx, ssy] = SkYUVAInfo::PlaneSubsamplingFactors(
+            info.planeConfig(), info.subsampling(), locations[SkYUVAInfo::kU].fPlane);
+    if (ssx > 2 || ssy > 2) {
+        return false;
+    }
+
+    float m[20];
+    SkColorMatrix_YUV2RGB(info.yuvColorSpace(), m);
+    const MatrixRow k[3] = {make_row(m), make_row(m + 5), make_row(m + 10)};
+
+    const int width = dst.width();
+    const int chromaWidth = uvChannels[0]->fPlane->width();
+    const int chromaHeight = uvChannels[0]->fPlane->height();
+    SkASSERT(chromaWidth == (width + ssx - 1) / ssx);
+
+    // Y and A rows, the near and far rows of U and V, and upsampled U and V rows.
+    AutoTMalloc<uint8_t> storage(SkToSizeT(4 * width + 4 * chromaWidth));
+    uint8_t* yStorage = storage.get();
+    uint8_t* aStorage = yStorage + width;
+    uint8_t* upsampled[2] = {aStorage + width, aStorage + 2 * width};
+    uint8_t* nearStorage = upsampled[1] + width;
+    uint8_t* farStorage = nearStorage + chromaWidth;
+    AutoTMalloc<uint16_t> sums(chromaWidth);
+
+    for (int y = 0; y < dst.height(); ++y) {
+        const uint8_t* yRow = yChannel.row(y, yStorage);
+        const uint8_t* aRow = hasAlpha ? aChannel.row(y, aStorage) : nullptr;
+
+        // A vertically subsampled output row is between its chroma row and the next chroma row
+        // above or below it, depending on which half of the chroma row it is in.
+        const int near = y / ssy;
+        const bool upper = ssy == 2 && !(y & 1);
+        const int far = ssy == 2 ? SkTPin(upper ? near - 1 : near + 1, 0, chromaHeight - 1)
+                                 : near;
+
+        const uint8_t* uvRows[2];
+        for (int c = 0; c < 2; ++c) {
+            const uint8_t* nearRow = uvChannels[c]->row(near, nearStorage);
+            if (ssx == 1 && ssy == 1) {
+                if (nearRow == nearStorage) {
+                    // The next channel reuses nearStorage.
+                    memcpy(upsampled[c], nearRow, width);
+                    nearRow = upsampled[c];
+                }
+                uvRows[c] = nearRow;
+                continue;
+            }
+
+            const uint8_t* farRow = far == near ? nearRow : uvChannels[c]->row(far, farStorage);
+            vertical_sum(nearRow, farRow, chromaWidth, sums.get());
+            if (ssx == 2) {
+                upsample_2x(sums.get(), chromaWidth, width, ssy == 2 ? 8 : 4, ssy == 2 ? 7 : 8,
+                            upsampled[c]);
+            } else {
+                narrow(sums.get(), chromaWidth, upper ? 1 : 2, upsampled[c]);
+            }
+            uvRows[c] = upsampled[c];
+        }
+
+        yuva_row_to_8888(yRow, uvRows[0], uvRows[1], aRow, width, k, premul, bgra,
+                         dst.writable_addr32(0, y));
+    }
+    return true;
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkYUVAToRGB_DEFINED
+#define SkYUVAToRGB_DEFINED
+
+class SkPixmap;
+class SkYUVAPixmaps;
+
+/**
+ *  Converts 8-bit YUVA planes to the 8888 pixels in dst, one row at a time.
+ *
+ *  Subsampled chroma is upsampled with the triangle filter that libjpeg uses for its "fancy"
+ *  upsampling (the nearer chroma sample weighted 3:1, which matches centered siting), and the
+ *  colors are converted with the SkYUVMath matrix for the planes' SkYUVColorSpace. Alpha is
+ *  premultiplied if dst is premultiplied, and ignored if dst is opaque.
+ *
+ *  Returns false without writing to dst if the conversion is not supported. That is, unless the
+ *  planes hold 8-bit unorm channels, the subsampling is 4:4:4, 4:2:2, 4:2:0 or 4:4:0, the origin
+ *  is the top left, and dst is RGBA or BGRA 8888 with the same dimensions as the planes.
+ *  dst's color space is not used; the pixels are in the color space of the planes.
+ */
+bool SkYUVAToRGB(const SkYUVAPixmaps& src, const SkPixmap& dst);
+
+#endif  // SkYUVAToRGB_DEFINED
@@ -12,8 +12,10 @@
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkYUVAInfo.h"
@@ -25,15 +27,19 @@
 #include "src/base/SkMSAN.h"
 #include "src/codec/SkJpegConstants.h"
 #include "src/codec/SkJpegPriv.h"
+#include "src/core/SkConvertPixels.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/encode/SkImageEncoderFns.h"
 #include "src/encode/SkImageEncoderPriv.h"
 #include "src/encode/SkJPEGWriteUtility.h"
 
+#include <algorithm>
 #include <csetjmp>
 #include <cstdint>
 #include <cstring>
 #include <memory>
 #include <utility>
+#include <vector>
 
 class SkColorSpace;
 
@@ -61,6 +67,13 @@ public:
 
     transform_scanline_proc proc() const { return fProc; }
 
+    // If set, rows are converted to this with SkConvertPixels instead of with proc().
+    const SkImageInfo& convertInfo() const { return fConvertInfo; }
+    bool convertsPixels() const { return fConvertInfo.colorType() != kUnknown_SkColorType; }
+
+    // The number of rows converted at once by SkConvertPixels.
+    static constexpr int kConvertRows = 16;
+
     ~SkJpegEncoderMgr() {
         jpeg_destroy_compress(&fCInfo);
     }
@@ -77,6 +90,7 @@ private:
     skjpeg_error_mgr        fErrMgr;
     skjpeg_destination_mgr  fDstMgr;
     transform_scanline_proc fProc;
+    SkImageInfo             fConvertInfo;
 };
 
 bool SkJpegEncoderMgr::setParams(const SkImageInfo& srcInfo, const SkJpegEncoder::Options& options)
@@ -133,7 +147,20 @@ bool SkJpegEncoderMgr::setParams(const SkImageInfo& srcInfo, const SkJpegEncoder
             numComponents = 4;
             break;
         default:
-            return false;
+            if (SkColorTypeIsAlphaOnly(srcInfo.colorType())) {
+                return false;
+            }
+
+            // Any other color type (e.g. 1010102, F16Norm or F32) is converted to 8888 by
+            // SkConvertPixels' pipeline, a band of rows at a time.
+            fConvertInfo = srcInfo.makeColorType(kRGBA_8888_SkColorType);
+            if (kUnpremul_SkAlphaType == srcInfo.alphaType() &&
+                    options.fAlphaOption == SkJpegEncoder::AlphaOption::kBlendOnBlack) {
+                fConvertInfo = fConvertInfo.makeAlphaType(kPremul_SkAlphaType);
+            }
+            jpegColorType = JCS_EXT_RGBA;
+            numComponents = 4;
+            break;
     }
 
     fCInfo.image_width = srcInfo.width();
@@ -273,7 +300,8 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst,
                                                const SkPixmap* src,
                                                const SkYUVAPixmaps* srcYUVA,
                                                const SkColorSpace* srcYUVAColorSpace,
-                                               const Options& options) {
+                                               const Options& options,
+                                               int restartInterval) {
     // Exactly one of |src| or |srcYUVA| should be specified.
     if (srcYUVA) {
         SkASSERT(!src);
@@ -305,6 +333,11 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst,
     }
 
     jpeg_set_quality(encoderMgr->cinfo(), options.fQuality, TRUE);
+    if (restartInterval > 0) {
+        // Stripes that are joined by EncodeStripes() must all use the same Huffman tables.
+        encoderMgr->cinfo()->optimize_coding = FALSE;
+        encoderMgr->cinfo()->restart_interval = restartInterval;
+    }
     jpeg_start_compress(encoderMgr->cinfo(), TRUE);
 
     // Write XMP metadata. This will only write the standard XMP segment.
@@ -343,9 +376,16 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst,
     return std::unique_ptr<SkJpegEncoder>(new SkJpegEncoder(std::move(encoderMgr), *src));
 }
 
+static size_t storage_bytes(SkJpegEncoderMgr* encoderMgr, const SkPixmap& src) {
+    const size_t rowBytes = encoderMgr->cinfo()->input_components * src.width();
+    if (encoderMgr->convertsPixels()) {
+        return rowBytes * SkJpegEncoderMgr::kConvertRows;
+    }
+    return encoderMgr->proc() ? rowBytes : 0;
+}
+
 SkJpegEncoder::SkJpegEncoder(std::unique_ptr<SkJpegEncoderMgr> encoderMgr, const SkPixmap& src)
-        : INHERITED(src,
-                    encoderMgr->proc() ? encoderMgr->cinfo()->input_components * src.width() : 0)
+        : INHERITED(src, storage_bytes(encoderMgr.get(), src))
         , fEncoderMgr(std::move(encoderMgr)) {}
 
 SkJpegEncoder::SkJpegEncoder(std::unique_ptr<SkJpegEncoderMgr> encoderMgr, const SkYUVAPixmaps* src)
@@ -368,6 +408,23 @@ bool SkJpegEncoder::onEncodeRows(int numRows) {
             JSAMPLE* jpegSrcRow = fStorage.get();
             jpeg_write_scanlines(fEncoderMgr->cinfo(), &jpegSrcRow, 1);
         }
+    } else if (fEncoderMgr->convertsPixels()) {
+        const size_t jpegSrcBytes = fEncoderMgr->cinfo()->input_components * fSrc.width();
+        JSAMPLE* jpegSrcRows[SkJpegEncoderMgr::kConvertRows];
+        for (int i = 0; i < numRows;) {
+            const int rows = std::min(SkJpegEncoderMgr::kConvertRows, numRows - i);
+            if (!SkConvertPixels(fEncoderMgr->convertInfo().makeWH(fSrc.width(), rows),
+                                 fStorage.get(), jpegSrcBytes,
+                                 fSrc.info().makeWH(fSrc.width(), rows),
+                                 fSrc.addr(0, fCurrRow + i), fSrc.rowBytes())) {
+                return false;
+            }
+            for (int j = 0; j < rows; j++) {
+                jpegSrcRows[j] = fStorage.get() + j * jpegSrcBytes;
+            }
+            jpeg_write_scanlines(fEncoderMgr->cinfo(), jpegSrcRows, rows);
+            i += rows;
+        }
     } else {
         const size_t srcBytes = SkColorTypeBytesPerPixel(fSrc.colorType()) * fSrc.width();
         const size_t jpegSrcBytes = fEncoderMgr->cinfo()->input_components * fSrc.width();
@@ -404,10 +461,136 @@ bool SkJpegEncoder::onEncodeRows(int numRows) {
 }
 
 bool SkJpegEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    if (options.fExecutor) {
+        return EncodeStripes(dst, src, options);
+    }
     auto encoder = SkJpegEncoder::Make(dst, src, options);
     return encoder.get() && encoder->encodeRows(src.height());
 }
 
+// Finds the baseline frame header and the end of the scan header of a jpeg written by
+// libjpeg, which is where its entropy coded data begins.  Returns false if either is missing.
+static bool find_frame_and_scan(const SkData* jpeg, size_t* sofOffset, size_t* scanDataOffset) {
+    static constexpr uint8_t kJpegMarkerBaselineStartOfFrame = 0xC0;
+
+    const uint8_t* bytes = jpeg->bytes();
+    *sofOffset = 0;
+    size_t offset = kJpegMarkerCodeSize;  // Skip the start of image marker.
+    while (offset + kJpegMarkerCodeSize + kJpegSegmentParameterLengthSize <= jpeg->size()) {
+        if (bytes[offset] != 0xFF) {
+            return false;
+        }
+        const uint8_t marker = bytes[offset + 1];
+        const size_t length = (bytes[offset + 2] << 8) | bytes[offset + 3];
+        if (marker == kJpegMarkerBaselineStartOfFrame) {
+            *sofOffset = offset;
+        }
+        offset += kJpegMarkerCodeSize + length;
+        if (marker == kJpegMarkerStartOfScan) {
+            *scanDataOffset = offset;
+            return *sofOffset && offset + kJpegMarkerCodeSize <= jpeg->size();
+        }
+    }
+    return false;
+}
+
+bool SkJpegEncoder::EncodeStripes(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    if (!dst || !SkPixmapIsValid(src)) {
+        return false;
+    }
+
+    // An MCU is 16x16 pixels for 4:2:0, 16x8 for 4:2:2 and 8x8 for 4:4:4 and gray.
+    const bool isGray = src.colorType() == kGray_8_SkColorType ||
+                        src.colorType() == kAlpha_8_SkColorType ||
+                        src.colorType() == kR8_unorm_SkColorType;
+    const int mcuWidth = !isGray && options.fDownsample != Downsample::k444 ? 16 : 8;
+    const int mcuHeight = !isGray && options.fDownsample == Downsample::k420 ? 16 : 8;
+    const int mcusPerRow = (src.width() + mcuWidth - 1) / mcuWidth;
+    const int mcuRows = (src.height() + mcuHeight - 1) / mcuHeight;
+
+    // Aim for enough stripes to keep a few threads busy.  A stripe is one restart interval,
+    // which is limited to 65535 MCUs.
+    constexpr int kTargetStripeCount = 8;
+    const int mcuRowsPerStripe = std::min((mcuRows + kTargetStripeCount - 1) / kTargetStripeCount,
+                                          65535 / mcusPerRow);
+    const int stripeCount = (mcuRows + mcuRowsPerStripe - 1) / mcuRowsPerStripe;
+    if (mcuRowsPerStripe < 1 || stripeCount < 2) {
+        Options serialOptions = options;
+        serialOptions.fExecutor = nullptr;
+        return Encode(dst, src, serialOptions);
+    }
+
+    // Each stripe is encoded as a jpeg of its own, with the same tables and a restart interval
+    // that covers the whole stripe.  Only the first needs the metadata.
+    const int stripeHeight = mcuRowsPerStripe * mcuHeight;
+    std::vector<sk_sp<SkData>> stripes(stripeCount);
+    SkTaskGroup(*options.fExecutor).batch(stripeCount, [&](int i) {
+        const int top = i * stripeHeight;
+        SkPixmap stripe;
+        if (!src.extractSubset(&stripe,
+                               SkIRect::MakeXYWH(0, top, src.width(),
+                                                 std::min(stripeHeight, src.height() - top)))) {
+            return;
+        }
+        Options stripeOptions = options;
+        stripeOptions.fExecutor = nullptr;
+        if (i > 0) {
+            stripe.setColorSpace(nullptr);
+            stripeOptions.xmpMetadata = nullptr;
+            stripeOptions.fICCProfile = nullptr;
+        }
+        SkDynamicMemoryWStream stream;
+        auto encoder = Make(&stream, &stripe, nullptr, nullptr, stripeOptions,
+                            mcusPerRow * mcuRowsPerStripe);
+        if (encoder && encoder->encodeRows(stripe.height())) {
+            stripes[i] = stream.detachAsData();
+        }
+    });
+
+    // Join the first stripe's headers, with the frame height fixed up, to the entropy coded
+    // data of every stripe, separating the stripes with restart markers.
+    std::vector<size_t> scanDataOffsets(stripeCount);
+    size_t sofOffset = 0;
+    for (int i = 0; i < stripeCount; i++) {
+        size_t stripeSofOffset;
+        if (!stripes[i] ||
+            !find_frame_and_scan(stripes[i].get(), &stripeSofOffset, &scanDataOffsets[i])) {
+            return false;
+        }
+        if (i == 0) {
+            sofOffset = stripeSofOffset;
+        }
+    }
+
+    // The frame header's height follows its marker, length and sample precision.
+    const size_t heightOffset = sofOffset + kJpegMarkerCodeSize +
+                                kJpegSegmentParameterLengthSize + 1;
+    const uint8_t height[] = {(uint8_t)(src.height() >> 8), (uint8_t)(src.height() & 0xFF)};
+    if (!dst->write(stripes[0]->bytes(), heightOffset) ||
+        !dst->write(height, sizeof(height)) ||
+        !dst->write(stripes[0]->bytes() + heightOffset + sizeof(height),
+                    scanDataOffsets[0] - heightOffset - sizeof(height))) {
+        return false;
+    }
+
+    for (int i = 0; i < stripeCount; i++) {
+        if (i > 0) {
+            // RST0 through RST7, in turn.
+            const uint8_t restart[] = {0xFF, (uint8_t)(0xD0 + (i - 1) % 8)};
+            if (!dst->write(restart, sizeof(restart))) {
+                return false;
+            }
+        }
+        // Everything up to the end of image marker is entropy coded data.
+        const size_t end = stripes[i]->size() - kJpegMarkerCodeSize;
+        if (!dst->write(stripes[i]->bytes() + scanDataOffsets[i], end - scanDataOffsets[i])) {
+            return false;
+        }
+    }
+    const uint8_t endOfImage[] = {0xFF, kJpegMarkerEndOfImage};
+    return dst->write(endOfImage, sizeof(endOfImage));
+}
+
 bool SkJpegEncoder::Encode(SkWStream* dst,
                            const SkYUVAPixmaps& src,
                            const SkColorSpace* srcColorSpace,
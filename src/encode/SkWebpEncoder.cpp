@@ -10,7 +10,6 @@
 #ifdef SK_ENCODE_WEBP
 
 #include "include/core/SkAlphaType.h"
-#include "include/core/SkBitmap.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
@@ -20,13 +19,17 @@
 #include "include/core/SkStream.h"
 #include "include/encode/SkEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
+#include "include/core/SkRect.h"
 #include "include/private/base/SkTemplates.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageInfoPriv.h"
 #include "src/encode/SkImageEncoderFns.h"
 #include "src/encode/SkImageEncoderPriv.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 
 // A WebP encoder only, on top of (subset of) libwebp
@@ -49,7 +52,165 @@ static int stream_writer(const uint8_t* data, size_t data_size,
   return stream->write(data, data_size) ? 1 : 0;
 }
 
-using WebPPictureImportProc = int (*) (WebPPicture* picture, const uint8_t* pixels, int stride);
+// libwebp's fixed point RGB to YUV conversion (VP8RGBToY, VP8RGBToU and VP8RGBToV).
+static constexpr int kYuvFix = 16;
+static constexpr int kYuvHalf = 1 << (kYuvFix - 1);
+
+// Sums adjacent pairs of lanes.
+template <int N>
+static skvx::Vec<N/2, int32_t> pair_sum(const skvx::Vec<N, int32_t>& v) {
+    int32_t lanes[N];
+    v.store(lanes);
+    skvx::Vec<N/2, int32_t> even, odd;
+    skvx::strided_load2(lanes, even, odd);
+    return even + odd;
+}
+
+// Converts N (even) RGBA pixels from each of two rows to N luma (and alpha) samples per row
+// and N/2 chroma samples for the 2x2 blocks.  Like libwebp, the chroma of a partially
+// transparent block is weighted by alpha.  The alpha planes are null if the image is opaque.
+template <int N>
+static void rgba_to_yuva(const uint8_t* rgba0, const uint8_t* rgba1,
+                         uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v,
+                         uint8_t* a0, uint8_t* a1) {
+    using I32 = skvx::Vec<N, int32_t>;
+    using U8 = skvx::Vec<N, uint8_t>;
+
+    U8 r8[2], g8[2], b8[2], a8[2];
+    skvx::strided_load4(rgba0, r8[0], g8[0], b8[0], a8[0]);
+    skvx::strided_load4(rgba1, r8[1], g8[1], b8[1], a8[1]);
+    I32 r[2], g[2], b[2];
+    for (int i = 0; i < 2; ++i) {
+        r[i] = skvx::cast<int32_t>(r8[i]);
+        g[i] = skvx::cast<int32_t>(g8[i]);
+        b[i] = skvx::cast<int32_t>(b8[i]);
+        const I32 luma = (16839 * r[i] + 33059 * g[i] + 6420 * b[i] +
+                          (kYuvHalf + (16 << kYuvFix))) >> kYuvFix;
+        skvx::cast<uint8_t>(luma).store(i ? y1 : y0);
+    }
+
+    auto rs = pair_sum(r[0] + r[1]),
+         gs = pair_sum(g[0] + g[1]),
+         bs = pair_sum(b[0] + b[1]);
+    if (a0) {
+        a8[0].store(a0);
+        a8[1].store(a1);
+
+        const I32 a[2] = { skvx::cast<int32_t>(a8[0]), skvx::cast<int32_t>(a8[1]) };
+        const auto as = pair_sum(a[0] + a[1]);
+        const auto partial = (as != 0) & (as != 4 * 255);
+        if (any(partial)) {
+            const auto scale = 4.0f / skvx::cast<float>(skvx::max(as, 1));
+            auto weighted = [&](const I32 c[2], const skvx::Vec<N/2, int32_t>& sum) {
+                const auto w = skvx::cast<float>(pair_sum(c[0] * a[0] + c[1] * a[1])) * scale;
+                return skvx::if_then_else(partial, skvx::cast<int32_t>(w + 0.5f), sum);
+            };
+            rs = weighted(r, rs);
+            gs = weighted(g, gs);
+            bs = weighted(b, bs);
+        }
+    }
+
+    constexpr int kUVShift = kYuvFix + 2;
+    constexpr int kUVBias = (kYuvHalf << 2) + (128 << kUVShift);
+    const auto us = (-9719 * rs - 19081 * gs + 28800 * bs + kUVBias) >> kUVShift,
+               vs = ( 28800 * rs - 24116 * gs -  4684 * bs + kUVBias) >> kUVShift;
+    skvx::cast<uint8_t>(skvx::pin(us, skvx::Vec<N/2, int32_t>(0),
+                                      skvx::Vec<N/2, int32_t>(255))).store(u);
+    skvx::cast<uint8_t>(skvx::pin(vs, skvx::Vec<N/2, int32_t>(0),
+                                      skvx::Vec<N/2, int32_t>(255))).store(v);
+}
+
+// Converts a pair of RGBA rows to YUV(A) 4:2:0 rows.  For an odd width, the last chroma
+// sample uses the last pixel of each row twice.
+static void rgba_rows_to_yuva(const uint8_t* rgba0, const uint8_t* rgba1, int width,
+                              uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v,
+                              uint8_t* a0, uint8_t* a1) {
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        rgba_to_yuva<8>(rgba0 + 4*x, rgba1 + 4*x, y0 + x, y1 + x, u + x/2, v + x/2,
+                        a0 ? a0 + x : nullptr, a1 ? a1 + x : nullptr);
+    }
+    for (; x + 2 <= width; x += 2) {
+        rgba_to_yuva<2>(rgba0 + 4*x, rgba1 + 4*x, y0 + x, y1 + x, u + x/2, v + x/2,
+                        a0 ? a0 + x : nullptr, a1 ? a1 + x : nullptr);
+    }
+    if (x < width) {
+        uint8_t px0[8], px1[8];
+        memcpy(px0, rgba0 + 4*x, 4);
+        memcpy(px0 + 4, rgba0 + 4*x, 4);
+        memcpy(px1, rgba1 + 4*x, 4);
+        memcpy(px1 + 4, rgba1 + 4*x, 4);
+        uint8_t ys[2][2], as[2][2];
+        rgba_to_yuva<2>(px0, px1, ys[0], ys[1], u + x/2, v + x/2,
+                        a0 ? as[0] : nullptr, a1 ? as[1] : nullptr);
+        y0[x] = ys[0][0];
+        y1[x] = ys[1][0];
+        if (a0) {
+            a0[x] = as[0][0];
+            a1[x] = as[1][0];
+        }
+    }
+}
+
+// Allocates |pic|'s YUV(A) planes and converts |pixmap| into them a band of rows at a time,
+// so the only full size buffers are the ones libwebp encodes from.
+static bool import_yuva(WebPPicture* pic, const SkPixmap& pixmap) {
+    const bool hasAlpha = !pixmap.isOpaque();
+    pic->use_argb = 0;
+    pic->colorspace = hasAlpha ? WEBP_YUV420A : WEBP_YUV420;
+    if (!WebPPictureAlloc(pic)) {
+        return false;
+    }
+
+    // Must be even, so that each pair of rows that shares chroma is in the same band.
+    constexpr int kBandRows = 16;
+    const int width = pixmap.width();
+    const int height = pixmap.height();
+    const SkImageInfo bandInfo = pixmap.info()
+                                         .makeColorType(kRGBA_8888_SkColorType)
+                                         .makeAlphaType(kUnpremul_SkAlphaType);
+    const size_t bandRowBytes = bandInfo.minRowBytes();
+    skia_private::AutoTMalloc<uint8_t> band(bandRowBytes * std::min(kBandRows, height));
+
+    for (int top = 0; top < height; top += kBandRows) {
+        const int rows = std::min(kBandRows, height - top);
+        SkPixmap src;
+        if (!pixmap.extractSubset(&src, SkIRect::MakeXYWH(0, top, width, rows)) ||
+            !src.readPixels(bandInfo.makeWH(width, rows), band.get(), bandRowBytes)) {
+            return false;
+        }
+
+        for (int row = 0; row < rows; row += 2) {
+            // An odd last row is converted as if it were repeated.
+            const int y = top + row;
+            const int next = row + 1 < rows ? 1 : 0;
+            const uint8_t* rgba0 = band.get() + row * bandRowBytes;
+            uint8_t* y0 = pic->y + y * pic->y_stride;
+            uint8_t* a0 = hasAlpha ? pic->a + y * pic->a_stride : nullptr;
+            rgba_rows_to_yuva(rgba0, rgba0 + next * bandRowBytes, width,
+                              y0, y0 + next * pic->y_stride,
+                              pic->u + (y / 2) * pic->uv_stride,
+                              pic->v + (y / 2) * pic->uv_stride,
+                              a0, a0 ? a0 + next * pic->a_stride : nullptr);
+        }
+    }
+    return true;
+}
+
+// Allocates |pic|'s ARGB buffer and converts |pixmap| straight into it.
+static bool import_argb(WebPPicture* pic, const SkPixmap& pixmap) {
+    pic->use_argb = 1;
+    if (!WebPPictureAlloc(pic)) {
+        return false;
+    }
+
+    // libwebp's ARGB is a native 0xAARRGGBB, which is BGRA in memory.
+    const SkImageInfo info = pixmap.info()
+                                     .makeColorType(kBGRA_8888_SkColorType)
+                                     .makeAlphaType(kUnpremul_SkAlphaType);
+    return pixmap.readPixels(info, pic->argb, pic->argb_stride * sizeof(uint32_t));
+}
 
 static bool preprocess_webp_picture(WebPPicture* pic,
                                     WebPConfig* webp_config,
@@ -72,57 +233,25 @@ static bool preprocess_webp_picture(WebPPicture* pic,
     pic->width = pixmap.width();
     pic->height = pixmap.height();
 
+    webp_config->thread_level = opts.fThreadLevel;
+
     // Set compression, method, and pixel format.
     // libwebp recommends using BGRA for lossless and YUV for lossy.
     // The choices of |webp_config.method| currently just match Chrome's defaults.  We
     // could potentially expose this decision to the client.
+    // Rather than making an RGBA copy of |pixmap| for libwebp to import, we convert it
+    // straight into the picture's buffers.
     if (SkWebpEncoder::Compression::kLossy == opts.fCompression) {
         webp_config->lossless = 0;
 #ifndef SK_WEBP_ENCODER_USE_DEFAULT_METHOD
         webp_config->method = 3;
 #endif
-        pic->use_argb = 0;
+        return import_yuva(pic, pixmap);
     } else {
         webp_config->lossless = 1;
         webp_config->method = 0;
-        pic->use_argb = 1;
+        return import_argb(pic, pixmap);
     }
-
-    {
-        const SkColorType ct = pixmap.colorType();
-        const bool premul = pixmap.alphaType() == kPremul_SkAlphaType;
-
-        SkBitmap tmpBm;
-        WebPPictureImportProc importProc = nullptr;
-        const SkPixmap* src = &pixmap;
-        if (ct == kRGB_888x_SkColorType) {
-            importProc = WebPPictureImportRGBX;
-        } else if (!premul && ct == kRGBA_8888_SkColorType) {
-            importProc = WebPPictureImportRGBA;
-        }
-#ifdef WebPPictureImportBGRA
-        else if (!premul && ct == kBGRA_8888_SkColorType) {
-            importProc = WebPPictureImportBGRA;
-        }
-#endif
-        else {
-            importProc = WebPPictureImportRGBA;
-            auto info = pixmap.info()
-                                .makeColorType(kRGBA_8888_SkColorType)
-                                .makeAlphaType(kUnpremul_SkAlphaType);
-            if (!tmpBm.tryAllocPixels(info) ||
-                !pixmap.readPixels(tmpBm.info(), tmpBm.getPixels(), tmpBm.rowBytes())) {
-                return false;
-            }
-            src = &tmpBm.pixmap();
-        }
-
-        if (!importProc(pic, reinterpret_cast<const uint8_t*>(src->addr()), src->rowBytes())) {
-            return false;
-        }
-    }
-
-    return true;
 }
 
 bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Options& opts) {
@@ -16,6 +16,7 @@
 #include "include/gpu/GrRecordingContext.h"
 #include "src/base/SkTInternalLList.h"
 #include "src/core/SkDeferredDisplayListPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/gpu/ganesh/GrBufferTransferRenderTask.h"
 #include "src/gpu/ganesh/GrBufferUpdateRenderTask.h"
 #include "src/gpu/ganesh/GrClientMappedBufferManager.h"
@@ -242,6 +243,19 @@ bool GrDrawingManager::executeRenderTasks(GrOpFlushState* flushState) {
 
     bool anyRenderTasksExecuted = false;
 
+    // Get the CPU heavy part of preparing the ops done concurrently first, if we were asked to.
+    const GrContextOptions& options = fContext->priv().options();
+    if (options.fThreadedOpPrepare && options.fExecutor) {
+        TRACE_EVENT0("skia.gpu", "Threaded op prepare");
+        SkTaskGroup taskGroup(*options.fExecutor);
+        for (const auto& renderTask : fDAG) {
+            if (renderTask && renderTask->isInstantiated()) {
+                renderTask->prepareCpuData(&taskGroup, fContext);
+            }
+        }
+        taskGroup.wait();
+    }
+
     for (const auto& renderTask : fDAG) {
         if (!renderTask || !renderTask->isInstantiated()) {
              continue;
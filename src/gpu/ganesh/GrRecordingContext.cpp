@@ -182,6 +182,7 @@ void GrRecordingContext::dumpJSON(SkJSONWriter* writer) const {
 #if GR_GPU_STATS
     writer->appendS32("path_masks_generated", this->stats()->numPathMasksGenerated());
     writer->appendS32("path_mask_cache_hits", this->stats()->numPathMaskCacheHits());
+    writer->appendS32("threaded_op_prepares", this->stats()->numThreadedOpPrepares());
 #endif
 
     writer->endObject();
@@ -197,6 +198,7 @@ void GrRecordingContext::dumpJSON(SkJSONWriter*) const { }
 void GrRecordingContext::Stats::dump(SkString* out) const {
     out->appendf("Num Path Masks Generated: %d\n", fNumPathMasksGenerated);
     out->appendf("Num Path Mask Cache Hits: %d\n", fNumPathMaskCacheHits);
+    out->appendf("Num Threaded Op Prepares: %d\n", fNumThreadedOpPrepares);
 }
 
 void GrRecordingContext::Stats::dumpKeyValuePairs(TArray<SkString>* keys,
@@ -206,6 +208,9 @@ void GrRecordingContext::Stats::dumpKeyValuePairs(TArray<SkString>* keys,
 
     keys->push_back(SkString("path_mask_cache_hits"));
     values->push_back(fNumPathMaskCacheHits);
+
+    keys->push_back(SkString("threaded_op_prepares"));
+    values->push_back(fNumThreadedOpPrepares);
 }
 
 void GrRecordingContext::DMSAAStats::dumpKeyValuePairs(TArray<SkString>* keys,
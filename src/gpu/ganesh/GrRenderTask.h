@@ -19,6 +19,7 @@ class GrMockRenderTask;
 class GrOpFlushState;
 class GrResourceAllocator;
 class GrTextureResolveRenderTask;
+class SkTaskGroup;
 namespace skgpu {
 namespace ganesh {
 class OpsTask;
@@ -37,7 +38,12 @@ public:
 
     void prePrepare(GrRecordingContext* context) { this->onPrePrepare(context); }
 
-    // These two methods are only invoked at flush time
+    // These three methods are only invoked at flush time. prepareCpuData() adds the CPU work of
+    // preparing this task that may run on any thread to the task group, which the caller must wait
+    // on before calling prepare().
+    void prepareCpuData(SkTaskGroup* taskGroup, GrRecordingContext* context) {
+        this->onPrepareCpuData(taskGroup, context);
+    }
     void prepare(GrOpFlushState* flushState);
     bool execute(GrOpFlushState* flushState) { return this->onExecute(flushState); }
 
@@ -263,6 +269,8 @@ private:
 
     virtual void onMakeSkippable() {}
     virtual void onPrePrepare(GrRecordingContext*) {} // Only OpsTask currently overrides this
+    // Only OpsTask currently overrides this
+    virtual void onPrepareCpuData(SkTaskGroup*, GrRecordingContext*) {}
     virtual void onPrepare(GrOpFlushState*) {} // OpsTask and GrDDLTask override this
     virtual bool onExecute(GrOpFlushState* flushState) = 0;
 
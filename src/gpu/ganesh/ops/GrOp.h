@@ -178,6 +178,22 @@ public:
                            colorLoadOp);
     }
 
+    /**
+     * Ops that return true have CPU work (e.g., triangulation) that prepareCpuData() can do ahead
+     * of prepare(), on another thread and concurrently with other ops.
+     */
+    virtual bool hasCpuDataToPrepare() const { return false; }
+
+    /**
+     * Does the work advertised by hasCpuDataToPrepare(). This may only touch the op itself and the
+     * thread safe parts of the context (e.g., its GrThreadSafeCache). prepare() is still called
+     * afterwards on the flushing thread.
+     */
+    void prepareCpuData(GrRecordingContext* context) {
+        TRACE_EVENT0_ALWAYS("skia.gpu", TRACE_STR_STATIC(name()));
+        this->onPrepareCpuData(context);
+    }
+
     /**
      * Called prior to executing. The op should perform any resource creation or data transfers
      * necessary before execute() is called.
@@ -313,6 +329,7 @@ private:
                               const GrDstProxyView&,
                               GrXferBarrierFlags renderPassXferBarriers,
                               GrLoadOp colorLoadOp) = 0;
+    virtual void onPrepareCpuData(GrRecordingContext*) {}
     virtual void onPrepare(GrOpFlushState*) = 0;
     // If this op is chained then chainBounds is the union of the bounds of all ops in the chain.
     // Otherwise, this op's bounds.
@@ -8,8 +8,10 @@
 #include "src/gpu/ganesh/ops/OpsTask.h"
 
 #include "include/gpu/GrRecordingContext.h"
+#include "include/private/base/SkTPin.h"
 #include "src/base/SkScopeExit.h"
 #include "src/core/SkRectPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTraceEvent.h"
 #include "src/gpu/ganesh/GrAttachment.h"
 #include "src/gpu/ganesh/GrAuditTrail.h"
@@ -26,6 +28,8 @@
 #include "src/gpu/ganesh/GrTexture.h"
 #include "src/gpu/ganesh/geometry/GrRect.h"
 
+#include <algorithm>
+
 using namespace skia_private;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -35,6 +39,9 @@ namespace {
 // Experimentally we have found that most combining occurs within the first 10 comparisons.
 static const int kMaxOpMergeDistance = 10;
 static const int kMaxOpChainDistance = 10;
+// How many chains of a grid cell the OpChainIndex looks at before it conservatively treats the
+// next one as a painter's order violation.
+static const int kMaxOpChainIndexScan = 64;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -389,6 +396,106 @@ inline void OpsTask::OpChain::validate() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+OpsTask::OpChainIndex::OpChainIndex(const SkRect& targetBounds)
+        : fTargetBounds(targetBounds)
+        , fCellScale{kGridSize / std::max(targetBounds.width(), 1.f),
+                     kGridSize / std::max(targetBounds.height(), 1.f)} {}
+
+// Ops may draw outside of the target; those bounds land in the cells along the edges. Clamping
+// keeps the mapping monotonic so overlapping bounds always share at least one cell.
+SkIRect OpsTask::OpChainIndex::cellRange(const SkRect& bounds) const {
+    auto toCell = [](float v, float origin, float scale) {
+        return (int)SkTPin((v - origin) * scale, 0.f, (float)(kGridSize - 1));
+    };
+    return SkIRect::MakeLTRB(toCell(bounds.fLeft, fTargetBounds.fLeft, fCellScale.fX),
+                             toCell(bounds.fTop, fTargetBounds.fTop, fCellScale.fY),
+                             toCell(bounds.fRight, fTargetBounds.fLeft, fCellScale.fX),
+                             toCell(bounds.fBottom, fTargetBounds.fTop, fCellScale.fY));
+}
+
+void OpsTask::OpChainIndex::addChain(int chainIndex, uint32_t classID, const SkRect& bounds) {
+    SkIRect range = this->cellRange(bounds);
+    for (int y = range.fTop; y <= range.fBottom; ++y) {
+        for (int x = range.fLeft; x <= range.fRight; ++x) {
+            TArray<int>& cell = this->cell(x, y);
+            SkASSERT(cell.empty() || cell.back() < chainIndex);
+            cell.push_back(chainIndex);
+        }
+    }
+    TArray<int>& chains = fChainsByClass[classID];
+    SkASSERT(chains.empty() || chains.back() < chainIndex);
+    chains.push_back(chainIndex);
+}
+
+void OpsTask::OpChainIndex::updateBounds(int chainIndex,
+                                         const SkRect& oldBounds,
+                                         const SkRect& newBounds) {
+    SkIRect oldRange = this->cellRange(oldBounds);
+    SkIRect newRange = this->cellRange(newBounds);
+    if (oldRange == newRange) {
+        return;
+    }
+    for (int y = newRange.fTop; y <= newRange.fBottom; ++y) {
+        for (int x = newRange.fLeft; x <= newRange.fRight; ++x) {
+            if (x >= oldRange.fLeft && x <= oldRange.fRight &&
+                y >= oldRange.fTop && y <= oldRange.fBottom) {
+                continue;
+            }
+            // Newer chains may already be in the cell; keep it sorted.
+            TArray<int>& cell = this->cell(x, y);
+            cell.push_back(chainIndex);
+            std::rotate(std::upper_bound(cell.begin(), cell.end() - 1, chainIndex),
+                        cell.end() - 1,
+                        cell.end());
+        }
+    }
+}
+
+int OpsTask::OpChainIndex::lastOverlapping(const SkRect& bounds,
+                                           SkSpan<const OpChain> chains) const {
+    int last = -1;
+    SkIRect range = this->cellRange(bounds);
+    for (int y = range.fTop; y <= range.fBottom; ++y) {
+        for (int x = range.fLeft; x <= range.fRight; ++x) {
+            const TArray<int>& cell = this->cell(x, y);
+            int scanned = 0;
+            for (int i = cell.size() - 1; i >= 0 && cell[i] > last; --i) {
+                if (++scanned > kMaxOpChainIndexScan ||
+                    !can_reorder(chains[cell[i]].bounds(), bounds)) {
+                    last = cell[i];
+                    break;
+                }
+            }
+        }
+    }
+    return last;
+}
+
+int OpsTask::OpChainIndex::firstOverlappingAfter(int chainIndex,
+                                                 const SkRect& bounds,
+                                                 SkSpan<const OpChain> chains) const {
+    int first = chains.size();
+    SkIRect range = this->cellRange(bounds);
+    for (int y = range.fTop; y <= range.fBottom; ++y) {
+        for (int x = range.fLeft; x <= range.fRight; ++x) {
+            const TArray<int>& cell = this->cell(x, y);
+            int scanned = 0;
+            for (auto iter = std::upper_bound(cell.begin(), cell.end(), chainIndex);
+                 iter != cell.end() && *iter < first;
+                 ++iter) {
+                if (++scanned > kMaxOpChainIndexScan ||
+                    !can_reorder(chains[*iter].bounds(), bounds)) {
+                    first = *iter;
+                    break;
+                }
+            }
+        }
+    }
+    return first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 OpsTask::OpsTask(GrDrawingManager* drawingMgr,
                  GrSurfaceProxyView view,
                  GrAuditTrail* auditTrail,
@@ -408,6 +515,7 @@ void OpsTask::deleteOps() {
         chain.deleteOps();
     }
     fOpChains.clear();
+    fOpChainIndex.reset();
 }
 
 OpsTask::~OpsTask() {
@@ -493,6 +601,30 @@ void OpsTask::onPrePrepare(GrRecordingContext* context) {
     }
 }
 
+void OpsTask::onPrepareCpuData(SkTaskGroup* taskGroup, GrRecordingContext* context) {
+    SkASSERT(this->isClosed());
+    // Same early out as onPrepare()
+    if (this->isColorNoOp() ||
+        (fClippedContentBounds.isEmpty() && fColorLoadOp != GrLoadOp::kDiscard)) {
+        return;
+    }
+
+    for (const auto& chain : fOpChains) {
+        if (!chain.shouldExecute()) {
+            continue;
+        }
+        // The head prepares on behalf of the entire chain, but each op has its own CPU data.
+        for (GrOp* op = chain.head(); op; op = op->nextInChain()) {
+            if (op->hasCpuDataToPrepare()) {
+                taskGroup->add([op, context] { op->prepareCpuData(context); });
+                // Counted here, on the flushing thread, since the stats aren't thread safe. The
+                // caller waits for every job in the task group before preparing.
+                context->priv().stats()->incNumThreadedOpPrepares();
+            }
+        }
+    }
+}
+
 void OpsTask::onPrepare(GrOpFlushState* flushState) {
     SkASSERT(this->target(0)->peekRenderTarget());
     SkASSERT(this->isClosed());
@@ -983,7 +1115,33 @@ void OpsTask::recordOp(
     GrOP_INFO(SkTabString(op->dumpInfo(), 1).c_str());
     GrOP_INFO("\tOutcome:\n");
     int maxCandidates = std::min(kMaxOpChainDistance, fOpChains.size());
-    if (maxCandidates) {
+    if (fOpChainIndex) {
+        // Only the chains of the op's class may take it, and none of them older than the last
+        // chain the op overlaps (which can take it too, as it is the last chain we'd try).
+        int lastOverlapping = fOpChainIndex->lastOverlapping(op->bounds(), fOpChains);
+        if (const TArray<int>* candidates = fOpChainIndex->chainsOfClass(op->classID())) {
+            int attempts = 0;
+            for (int c = candidates->size() - 1;
+                 c >= 0 && (*candidates)[c] >= lastOverlapping;
+                 --c) {
+                int candidateIndex = (*candidates)[c];
+                OpChain& candidate = fOpChains[candidateIndex];
+                SkRect oldBounds = candidate.bounds();
+                op = candidate.appendOp(std::move(op), processorAnalysis, dstProxyView, clip,
+                                        caps, fArenas->arenaAlloc(), fAuditTrail);
+                if (!op) {
+                    fOpChainIndex->updateBounds(candidateIndex, oldBounds, candidate.bounds());
+                    return;
+                }
+                if (++attempts == kMaxOpChainDistance) {
+                    GrOP_INFO("\t\tBackward: Reached max candidates of the op class %d\n",
+                              attempts);
+                    break;
+                }
+            }
+        }
+        GrOP_INFO("\t\tBackward: Last overlapping chain %d\n", lastOverlapping);
+    } else if (maxCandidates) {
         int i = 0;
         while (true) {
             OpChain& candidate = fOpChains.fromBack(i);
@@ -1011,6 +1169,17 @@ void OpsTask::recordOp(
         SkDEBUGCODE(fNumClips++;)
     }
     fOpChains.emplace_back(std::move(op), processorAnalysis, clip, dstProxyView);
+
+    if (fOpChainIndex) {
+        fOpChainIndex->addChain(fOpChains.size() - 1, fOpChains.back().head()->classID(),
+                                fOpChains.back().bounds());
+    } else if (fOpChains.size() > kMaxOpChainDistance) {
+        // From now on the linear searches can't reach every chain anymore.
+        fOpChainIndex = std::make_unique<OpChainIndex>(proxy->getBoundsRect());
+        for (int i = 0; i < fOpChains.size(); ++i) {
+            fOpChainIndex->addChain(i, fOpChains[i].head()->classID(), fOpChains[i].bounds());
+        }
+    }
 }
 
 void OpsTask::forwardCombine(const GrCaps& caps) {
@@ -1019,6 +1188,31 @@ void OpsTask::forwardCombine(const GrCaps& caps) {
 
     for (int i = 0; i < fOpChains.size() - 1; ++i) {
         OpChain& chain = fOpChains[i];
+        if (fOpChainIndex) {
+            // Try the chains of the same class up to (and including) the first chain that
+            // overlaps this one.
+            int firstOverlapping = fOpChainIndex->firstOverlappingAfter(i, chain.bounds(),
+                                                                        fOpChains);
+            const TArray<int>* candidates = fOpChainIndex->chainsOfClass(chain.head()->classID());
+            SkASSERT(candidates);
+            int attempts = 0;
+            for (auto c = std::upper_bound(candidates->begin(), candidates->end(), i);
+                 c != candidates->end() && *c <= firstOverlapping;
+                 ++c) {
+                OpChain& candidate = fOpChains[*c];
+                SkRect oldBounds = candidate.bounds();
+                if (candidate.prependChain(&chain, caps, fArenas->arenaAlloc(), fAuditTrail)) {
+                    fOpChainIndex->updateBounds(*c, oldBounds, candidate.bounds());
+                    break;
+                }
+                if (++attempts == kMaxOpChainDistance) {
+                    GrOP_INFO("\t\t%d: chain (%s opID: %u) -> Reached max candidates\n",
+                              i, chain.head()->name(), chain.head()->uniqueID());
+                    break;
+                }
+            }
+            continue;
+        }
         int maxCandidateIdx = std::min(i + kMaxOpChainDistance, fOpChains.size() - 1);
         int j = i + 1;
         while (true) {
@@ -1047,6 +1241,8 @@ void OpsTask::forwardCombine(const GrCaps& caps) {
 GrRenderTask::ExpectedOutcome OpsTask::onMakeClosed(GrRecordingContext* rContext,
                                                     SkIRect* targetUpdateBounds) {
     this->forwardCombine(*rContext->priv().caps());
+    // No more ops are coming in.
+    fOpChainIndex.reset();
     if (!this->isColorNoOp()) {
         GrSurfaceProxy* proxy = this->target(0);
         // Use the entire backing store bounds since the GPU doesn't clip automatically to the
@@ -21,6 +21,7 @@
 #include "src/base/SkTLazy.h"
 #include "src/core/SkClipStack.h"
 #include "src/core/SkStringUtils.h"
+#include "src/core/SkTHash.h"
 #include "src/gpu/ganesh/GrAppliedClip.h"
 #include "src/gpu/ganesh/GrDstProxyView.h"
 #include "src/gpu/ganesh/GrGeometryProcessor.h"
@@ -28,6 +29,9 @@
 #include "src/gpu/ganesh/GrRenderTask.h"
 #include "src/gpu/ganesh/ops/GrOp.h"
 
+#include <array>
+#include <memory>
+
 class GrAuditTrail;
 class GrCaps;
 class GrClearOp;
@@ -57,6 +61,7 @@ public:
     void endFlush(GrDrawingManager*) override;
 
     void onPrePrepare(GrRecordingContext*) override;
+    void onPrepareCpuData(SkTaskGroup*, GrRecordingContext*) override;
     /**
      * Together these two functions flush all queued up draws to GrCommandBuffer. The return value
      * of onExecute() indicates whether any commands were actually issued to the GPU.
@@ -250,6 +255,47 @@ private:
         static_assert(::sk_is_trivially_relocatable<decltype(fBounds)>::value);
     };
 
+    // Spatial index over the bounds of the op chains (a uniform grid covering the target) along
+    // with the chains of each op class. It lets recordOp() and forwardCombine() find the nearest
+    // chain that would cause a painter's order violation without visiting every chain in between,
+    // and then only try the chains of the right class, so merges can reach much further away.
+    // Chain bounds only ever grow; the index must be told about it with updateBounds().
+    class OpChainIndex {
+    public:
+        explicit OpChainIndex(const SkRect& targetBounds);
+
+        void addChain(int chainIndex, uint32_t classID, const SkRect& bounds);
+        void updateBounds(int chainIndex, const SkRect& oldBounds, const SkRect& newBounds);
+
+        // Index of the last chain overlapping 'bounds', or -1 if there is none.
+        int lastOverlapping(const SkRect& bounds, SkSpan<const OpChain>) const;
+        // Index of the first chain after 'chainIndex' overlapping 'bounds', or the number of
+        // chains if there is none.
+        int firstOverlappingAfter(int chainIndex, const SkRect& bounds,
+                                  SkSpan<const OpChain>) const;
+
+        // Indices of the chains of the given op class in increasing order (null if none).
+        const skia_private::TArray<int>* chainsOfClass(uint32_t classID) const {
+            return fChainsByClass.find(classID);
+        }
+
+    private:
+        // Number of cells along each side of the grid.
+        static constexpr int kGridSize = 16;
+
+        SkIRect cellRange(const SkRect&) const;
+        skia_private::TArray<int>& cell(int x, int y) { return fCells[y * kGridSize + x]; }
+        const skia_private::TArray<int>& cell(int x, int y) const {
+            return fCells[y * kGridSize + x];
+        }
+
+        SkRect fTargetBounds;
+        SkVector fCellScale;
+        // Each cell holds the (sorted) indices of the chains whose bounds touch it.
+        std::array<skia_private::TArray<int>, kGridSize * kGridSize> fCells;
+        skia_private::THashMap<uint32_t, skia_private::TArray<int>> fChainsByClass;
+    };
+
     void onMakeSkippable() override;
 
     bool onIsUsed(GrSurfaceProxy*) const override;
@@ -289,6 +335,8 @@ private:
 
     // For ops/opsTask we have mean: 5 stdDev: 28
     skia_private::STArray<25, OpChain> fOpChains;
+    // Only built once the task has enough chains for the linear searches to fall short.
+    std::unique_ptr<OpChainIndex> fOpChainIndex;
 
     sk_sp<GrArenas> fArenas;
     SkDEBUGCODE(int fNumClips;)
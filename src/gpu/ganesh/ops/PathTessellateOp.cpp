@@ -12,6 +12,7 @@
 #include "src/gpu/ganesh/GrOpFlushState.h"
 #include "src/gpu/ganesh/GrRecordingContextPriv.h"
 #include "src/gpu/ganesh/tessellate/GrPathTessellationShader.h"
+#include "src/gpu/ganesh/tessellate/PatchCache.h"
 
 namespace skgpu::ganesh {
 
@@ -34,10 +35,23 @@ GrProcessorSet::Analysis PathTessellateOp::finalize(const GrCaps& caps,
                                          clampType,
                                          &this->headDraw().fColor);
     if (!analysis.usesLocalCoords()) {
-        // Since we don't need local coords, we can transform on CPU instead of in the shader. This
-        // gives us better batching potential.
-        this->headDraw().fPathMatrix = fShaderMatrix;
-        fShaderMatrix = SkMatrix::I();
+        if (PatchCache::ShouldCache(this->headDraw().fPath, fTotalCombinedPathVerbCnt) &&
+            !fShaderMatrix.hasPerspective()) {
+            // Transform by the scale/skew on CPU but leave the translation to the shader. The
+            // patches will then be the same, and found in the PatchCache, on frames where only the
+            // translation changes. Only ops with the same translation will batch.
+            SkMatrix pathMatrix = fShaderMatrix;
+            pathMatrix.setTranslateX(0);
+            pathMatrix.setTranslateY(0);
+            fShaderMatrix = SkMatrix::Translate(fShaderMatrix.getTranslateX(),
+                                                fShaderMatrix.getTranslateY());
+            this->headDraw().fPathMatrix = pathMatrix;
+        } else {
+            // Since we don't need local coords, we can transform on CPU instead of in the shader.
+            // This gives us better batching potential.
+            this->headDraw().fPathMatrix = fShaderMatrix;
+            fShaderMatrix = SkMatrix::I();
+        }
     }
     return analysis;
 }
@@ -108,10 +122,10 @@ void PathTessellateOp::onPrepare(GrOpFlushState* flushState) {
                                  &flushState->caps()}, flushState->detachAppliedClip());
         SkASSERT(fTessellator);
     }
-    fTessellator->prepare(flushState,
-                          fShaderMatrix,
-                          *fPathDrawList,
-                          fTotalCombinedPathVerbCnt);
+    fTessellator->prepareWithPatchCache(flushState,
+                                        fShaderMatrix,
+                                        *fPathDrawList,
+                                        fTotalCombinedPathVerbCnt);
 }
 
 void PathTessellateOp::onExecute(GrOpFlushState* flushState, const SkRect& chainBounds) {
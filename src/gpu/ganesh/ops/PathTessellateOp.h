@@ -72,7 +72,7 @@ private:
     SkMatrix fShaderMatrix;
 
     // Decided during prepareTessellator.
-    PathTessellator* fTessellator = nullptr;
+    PathWedgeTessellator* fTessellator = nullptr;
     const GrProgramInfo* fTessellationProgram = nullptr;
 
     friend class GrOp;  // For ctor.
@@ -219,10 +219,10 @@ void StrokeTessellateOp::onPrepare(GrOpFlushState* flushState) {
                                     &flushState->caps()}, flushState->detachAppliedClip());
     }
     SkASSERT(fTessellator);
-    fTessellator->prepare(flushState,
-                          fViewMatrix,
-                          &fPathStrokeList,
-                          fTotalCombinedVerbCnt);
+    fTessellator->prepareWithPatchCache(flushState,
+                                        fViewMatrix,
+                                        &fPathStrokeList,
+                                        fTotalCombinedVerbCnt);
 }
 
 void StrokeTessellateOp::onExecute(GrOpFlushState* flushState, const SkRect& chainBounds) {
@@ -353,8 +353,23 @@ private:
     }
 
     void createAAMesh(GrMeshDrawTarget* target) {
-        SkASSERT(!fVertexData);
         SkASSERT(fAntiAlias);
+        if (fVertexData) {
+            // Already triangulated by onPrepareCpuData; it only needs copying to the GPU.
+            sk_sp<const GrBuffer> vertexBuffer;
+            int firstVertex;
+            void* verts = target->makeVertexSpace(fVertexData->vertexSize(),
+                                                  fVertexData->numVertices(),
+                                                  &vertexBuffer,
+                                                  &firstVertex);
+            if (!verts) {
+                return;
+            }
+            memcpy(verts, fVertexData->vertices(), fVertexData->size());
+            fMesh = CreateMesh(target, std::move(vertexBuffer), firstVertex,
+                               fVertexData->numVertices());
+            return;
+        }
         SkPath path = this->getPath();
         if (path.isEmpty()) {
             return;
@@ -447,6 +462,40 @@ private:
             return;
         }
 
+        this->triangulateNonAAOnCpu(rContext);
+    }
+
+    bool hasCpuDataToPrepare() const override { return !fVertexData; }
+
+    void onPrepareCpuData(GrRecordingContext* rContext) override {
+        TRACE_EVENT0("skia.gpu", TRACE_FUNC);
+
+        if (!fAntiAlias) {
+            this->triangulateNonAAOnCpu(rContext);
+            return;
+        }
+
+        // Unlike the non-AA case, the AA triangulation isn't cached; it only gets moved off of the
+        // flushing thread.
+        SkPath path = this->getPath();
+        if (path.isEmpty()) {
+            return;
+        }
+        SkRect clipBounds = SkRect::Make(fDevClipBounds);
+        path.transform(fViewMatrix);
+        GrCpuVertexAllocator allocator;
+        int vertexCount = GrAATriangulator::PathToAATriangles(path, GrPathUtils::kDefaultTolerance,
+                                                              clipBounds, &allocator);
+        if (vertexCount == 0) {
+            return;
+        }
+        fVertexData = allocator.detachVertexData();
+    }
+
+    // Triangulates into CPU memory, sharing the results through the GrThreadSafeCache. This is
+    // safe to call from any thread.
+    void triangulateNonAAOnCpu(GrRecordingContext* rContext) {
+        SkASSERT(!fAntiAlias);
         auto threadSafeViewCache = rContext->priv().threadSafeCache();
 
         skgpu::UniqueKey key;
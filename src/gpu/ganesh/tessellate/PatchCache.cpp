@@ -0,0 +1,101 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/gpu/ganesh/tessellate/PatchCache.h"
+
+#include "include/core/SkData.h"
+#include "src/core/SkMessageBus.h"
+#include "src/gpu/ganesh/GrGpuBuffer.h"
+#include "src/gpu/ganesh/GrMeshDrawTarget.h"
+#include "src/gpu/ganesh/GrResourceProvider.h"
+#include "src/gpu/ganesh/GrThreadSafeCache.h"
+
+namespace skgpu::ganesh {
+
+namespace {
+
+// When a path's genID changes, invalidate the cached patches that were written from it.
+class PatchKeyInvalidator : public SkIDChangeListener {
+public:
+    PatchKeyInvalidator(const skgpu::UniqueKey& key, uint32_t contextUniqueID)
+            : fMsg(key, contextUniqueID, /* inThreadSafeCache */ true) {}
+
+private:
+    skgpu::UniqueKeyInvalidatedMessage fMsg;
+
+    void changed() override {
+        SkMessageBus<skgpu::UniqueKeyInvalidatedMessage, uint32_t>::Post(fMsg);
+    }
+};
+
+bool prefer_incumbent(SkData* /* incumbent */, SkData* /* challenger */) {
+    // The patches for a given key are always the same, so there is no reason to replace them.
+    return false;
+}
+
+}  // namespace
+
+bool PatchCache::Find(GrMeshDrawTarget* target,
+                      const skgpu::UniqueKey& key,
+                      GrVertexChunkArray* chunks,
+                      int* vertexCount) {
+    auto [vertexData, data] = target->threadSafeCache()->findVertsWithData(key);
+    if (!vertexData || !data) {
+        return false;
+    }
+    if (!vertexData->gpuBuffer()) {
+        if (!vertexData->vertices()) {
+            return false;
+        }
+        sk_sp<GrGpuBuffer> buffer = target->resourceProvider()->createBuffer(
+                vertexData->vertices(),
+                vertexData->size(),
+                GrGpuBufferType::kVertex,
+                kStatic_GrAccessPattern);
+        if (!buffer) {
+            return false;
+        }
+        vertexData->setGpuBuffer(std::move(buffer));
+    }
+
+    SkASSERT(data->size() == sizeof(int));
+    memcpy(vertexCount, data->data(), sizeof(int));
+    chunks->push_back({vertexData->refGpuBuffer(), vertexData->numVertices(), 0});
+    return true;
+}
+
+sk_sp<SkIDChangeListener> PatchCache::Add(GrMeshDrawTarget* target,
+                                          skgpu::UniqueKey* key,
+                                          const CpuPatchBuffer& patches,
+                                          int vertexCount,
+                                          GrVertexChunkArray* chunks) {
+    if (!patches.count()) {
+        return nullptr;
+    }
+    sk_sp<GrGpuBuffer> buffer = target->resourceProvider()->createBuffer(patches.data(),
+                                                                         patches.size(),
+                                                                         GrGpuBufferType::kVertex,
+                                                                         kStatic_GrAccessPattern);
+    if (!buffer) {
+        return nullptr;
+    }
+    chunks->push_back({buffer, patches.count(), 0});
+
+    auto vertexData = GrThreadSafeCache::MakeVertexData(std::move(buffer),
+                                                        patches.count(),
+                                                        patches.stride());
+    key->setCustomData(SkData::MakeWithCopy(&vertexCount, sizeof(vertexCount)));
+    auto [cachedData, cachedCustomData] =
+            target->threadSafeCache()->addVertsWithData(*key, vertexData, prefer_incumbent);
+    if (cachedData != vertexData) {
+        // Another op added the same patches first. The paths already have its listeners.
+        return nullptr;
+    }
+    return sk_make_sp<PatchKeyInvalidator>(*key, target->contextUniqueID());
+}
+
+}  // namespace skgpu::ganesh
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef PatchCache_DEFINED
+#define PatchCache_DEFINED
+
+#include "include/core/SkPath.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/SkIDChangeListener.h"
+#include "include/private/base/SkMalloc.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/gpu/BufferWriter.h"
+#include "src/gpu/ResourceKey.h"
+#include "src/gpu/ganesh/GrVertexChunkArray.h"
+#include "src/gpu/tessellate/LinearTolerances.h"
+
+#include <algorithm>
+
+class GrMeshDrawTarget;
+
+namespace skgpu::ganesh {
+
+// Growable CPU storage for patches that are written once and then uploaded to a static buffer.
+class CpuPatchBuffer {
+public:
+    CpuPatchBuffer(size_t stride, int initialPatchCount)
+            : fStride(stride)
+            , fCapacity(std::max(initialPatchCount, 1))
+            , fPatches(sk_malloc_throw(fCapacity, fStride)) {}
+
+    ~CpuPatchBuffer() { sk_free(fPatches); }
+
+    CpuPatchBuffer(const CpuPatchBuffer&) = delete;
+    CpuPatchBuffer& operator=(const CpuPatchBuffer&) = delete;
+
+    VertexWriter append() {
+        if (fCount == fCapacity) {
+            fCapacity *= 2;
+            fPatches = sk_realloc_throw(fPatches, fCapacity, fStride);
+        }
+        return {SkTAddOffset<void>(fPatches, fCount++ * fStride), fStride};
+    }
+
+    size_t stride() const { return fStride; }
+    int count() const { return fCount; }
+    size_t size() const { return fCount * fStride; }
+    const void* data() const { return fPatches; }
+
+private:
+    const size_t fStride;
+    int fCount = 0;
+    int fCapacity;
+    void* fPatches;
+};
+
+// An adapter around CpuPatchBuffer that fits the API requirements of skgpu::tess::PatchWriter's
+// PatchAllocator template parameter.
+class CpuPatchAllocator {
+public:
+    // 'stride' is provided by PatchWriter and must match the stride of 'patches'.
+    // 'worstCaseTolerances' is used to accumulate the LinearTolerances from each append().
+    CpuPatchAllocator(size_t stride,
+                      tess::LinearTolerances* worstCaseTolerances,
+                      CpuPatchBuffer* patches)
+            : fWorstCaseTolerances(worstCaseTolerances)
+            , fPatches(patches) {
+        SkASSERT(stride == patches->stride());
+    }
+
+    VertexWriter append(const tess::LinearTolerances& tolerances) {
+        fWorstCaseTolerances->accumulate(tolerances);
+        return fPatches->append();
+    }
+
+private:
+    tess::LinearTolerances* fWorstCaseTolerances;
+    CpuPatchBuffer*         fPatches;
+};
+
+// Caches the patch instances written by the PathWedgeTessellator and the StrokeTessellator in the
+// GrThreadSafeCache. The patches only depend on the paths, their path matrices, the patch attribs
+// and the scale/skew part of the shader matrix (through Wang's formula), so when the tessellators'
+// keys are built from just those, a draw whose view matrix only changes by a translation from one
+// frame to the next reuses the static patch buffer instead of tessellating again.
+class PatchCache {
+public:
+    // Paths with fewer verbs are cheaper to tessellate each frame than to keep in the cache.
+    static constexpr int kMinVerbsToCache = 32;
+
+    // Returns whether a draw of 'path' with 'totalCombinedVerbCnt' verbs may be found in the cache.
+    static bool ShouldCache(const SkPath& path, int totalCombinedVerbCnt) {
+#if !defined(SK_ENABLE_OPTIMIZE_SIZE)
+        return !path.isVolatile() && totalCombinedVerbCnt >= kMinVerbsToCache;
+#else
+        return false;
+#endif
+    }
+
+    // Looks for the patches stored under 'key'. On success, appends the static patch buffer to
+    // 'chunks' and returns the fixed vertex count that the patches must be drawn with in
+    // 'vertexCount'.
+    static bool Find(GrMeshDrawTarget*,
+                     const skgpu::UniqueKey& key,
+                     GrVertexChunkArray* chunks,
+                     int* vertexCount);
+
+    // Uploads 'patches' to a static buffer, appends it to 'chunks', and stores it in the cache
+    // under 'key' along with 'vertexCount'. Returns a listener that must be added to every path
+    // that the patches were written from, or null if the patches were not added to the cache.
+    static sk_sp<SkIDChangeListener> Add(GrMeshDrawTarget*,
+                                         skgpu::UniqueKey* key,
+                                         const CpuPatchBuffer& patches,
+                                         int vertexCount,
+                                         GrVertexChunkArray* chunks);
+};
+
+}  // namespace skgpu::ganesh
+
+#endif  // PatchCache_DEFINED
@@ -11,6 +11,7 @@
 #include "src/gpu/ganesh/GrMeshDrawTarget.h"
 #include "src/gpu/ganesh/GrOpFlushState.h"
 #include "src/gpu/ganesh/GrResourceProvider.h"
+#include "src/gpu/ganesh/tessellate/PatchCache.h"
 #include "src/gpu/ganesh/tessellate/VertexChunkPatchAllocator.h"
 #include "src/gpu/tessellate/AffineMatrix.h"
 #include "src/gpu/tessellate/FixedCountBufferUtils.h"
@@ -73,13 +74,15 @@ void write_curve_patches(CurveWriter&& patchWriter,
     }
 }
 
-using WedgeWriter = PatchWriter<VertexChunkPatchAllocator,
+template <typename PatchAllocator>
+using WedgeWriter = PatchWriter<PatchAllocator,
                                 Required<PatchAttribs::kFanPoint>,
                                 Optional<PatchAttribs::kColor>,
                                 Optional<PatchAttribs::kWideColorIfEnabled>,
                                 Optional<PatchAttribs::kExplicitCurveType>>;
 
-void write_wedge_patches(WedgeWriter&& patchWriter,
+template <typename PatchAllocator>
+void write_wedge_patches(WedgeWriter<PatchAllocator>&& patchWriter,
                          const SkMatrix& shaderMatrix,
                          const PathTessellator::PathDrawList& pathDrawList) {
     patchWriter.setShaderTransform(wangs_formula::VectorXform{shaderMatrix});
@@ -148,6 +151,53 @@ void write_wedge_patches(WedgeWriter&& patchWriter,
     }
 }
 
+#if !defined(SK_ENABLE_OPTIMIZE_SIZE)
+// The wedge patches are written in the coordinate space of each draw's path matrix, and only depend
+// on the scale/skew part of the shader matrix. Returns false if the draws can't be cached.
+bool make_wedge_patches_key(skgpu::UniqueKey* key,
+                            PatchAttribs attribs,
+                            const SkMatrix& shaderMatrix,
+                            const PathTessellator::PathDrawList& pathDrawList) {
+    if (shaderMatrix.hasPerspective()) {
+        return false;
+    }
+    int drawCount = 0;
+    for (auto [pathMatrix, path, color] : pathDrawList) {
+        if (path.isVolatile() || pathMatrix.hasPerspective()) {
+            return false;
+        }
+        ++drawCount;
+    }
+
+    const bool hasColor = attribs & PatchAttribs::kColor;
+    // The genID and the affine path matrix, plus the color if it's written into the patches.
+    const int drawKeySize = 7 + (hasColor ? 4 : 0);
+
+    static const skgpu::UniqueKey::Domain kDomain = skgpu::UniqueKey::GenerateDomain();
+    skgpu::UniqueKey::Builder builder(key, kDomain, 5 + drawCount * drawKeySize,
+                                      "Tessellated Wedges");
+    builder[0] = (uint32_t)attribs;
+    const float shaderScaleSkew[4] = {shaderMatrix.getScaleX(), shaderMatrix.getSkewX(),
+                                      shaderMatrix.getSkewY(), shaderMatrix.getScaleY()};
+    memcpy(&builder[1], shaderScaleSkew, sizeof(shaderScaleSkew));
+    int i = 5;
+    for (auto [pathMatrix, path, color] : pathDrawList) {
+        builder[i++] = path.getGenerationID();
+        const float affine[6] = {pathMatrix.getScaleX(), pathMatrix.getSkewX(),
+                                 pathMatrix.getTranslateX(), pathMatrix.getSkewY(),
+                                 pathMatrix.getScaleY(), pathMatrix.getTranslateY()};
+        memcpy(&builder[i], affine, sizeof(affine));
+        i += 6;
+        if (hasColor) {
+            memcpy(&builder[i], color.vec(), 4 * sizeof(float));
+            i += 4;
+        }
+    }
+    SkASSERT(i == 5 + drawCount * drawKeySize);
+    return true;
+}
+#endif
+
 }  // namespace
 
 SKGPU_DECLARE_STATIC_UNIQUE_KEY(gFixedCountCurveVertexBufferKey);
@@ -247,13 +297,47 @@ void PathWedgeTessellator::prepare(GrMeshDrawTarget* target,
                                    int totalCombinedPathVerbCnt) {
     if (int patchPreallocCount = FixedCountWedges::PreallocCount(totalCombinedPathVerbCnt)) {
         LinearTolerances worstCase;
-        WedgeWriter writer{fAttribs, &worstCase, target, &fVertexChunkArray, patchPreallocCount};
+        WedgeWriter<VertexChunkPatchAllocator> writer{fAttribs, &worstCase, target,
+                                                      &fVertexChunkArray, patchPreallocCount};
         write_wedge_patches(std::move(writer), shaderMatrix, pathDrawList);
         fMaxVertexCount = FixedCountWedges::VertexCount(worstCase);
     }
 
-    GrResourceProvider* rp = target->resourceProvider();
+    this->prepareFixedCountBuffers(target->resourceProvider());
+}
+
+void PathWedgeTessellator::prepareWithPatchCache(GrMeshDrawTarget* target,
+                                                 const SkMatrix& shaderMatrix,
+                                                 const PathDrawList& pathDrawList,
+                                                 int totalCombinedPathVerbCnt) {
+#if !defined(SK_ENABLE_OPTIMIZE_SIZE)
+    skgpu::UniqueKey key;
+    if (totalCombinedPathVerbCnt >= PatchCache::kMinVerbsToCache &&
+        make_wedge_patches_key(&key, fAttribs, shaderMatrix, pathDrawList)) {
+        if (!PatchCache::Find(target, key, &fVertexChunkArray, &fMaxVertexCount)) {
+            CpuPatchBuffer patches(PatchStride(fAttribs),
+                                   FixedCountWedges::PreallocCount(totalCombinedPathVerbCnt));
+            LinearTolerances worstCase;
+            {
+                WedgeWriter<CpuPatchAllocator> writer{fAttribs, &worstCase, &patches};
+                write_wedge_patches(std::move(writer), shaderMatrix, pathDrawList);
+            }
+            fMaxVertexCount = FixedCountWedges::VertexCount(worstCase);
+            if (sk_sp<SkIDChangeListener> listener = PatchCache::Add(
+                        target, &key, patches, fMaxVertexCount, &fVertexChunkArray)) {
+                for (auto [pathMatrix, path, color] : pathDrawList) {
+                    SkPathPriv::AddGenIDChangeListener(path, listener);
+                }
+            }
+        }
+        this->prepareFixedCountBuffers(target->resourceProvider());
+        return;
+    }
+#endif
+    this->prepare(target, shaderMatrix, pathDrawList, totalCombinedPathVerbCnt);
+}
 
+void PathWedgeTessellator::prepareFixedCountBuffers(GrResourceProvider* rp) {
     SKGPU_DEFINE_STATIC_UNIQUE_KEY(gFixedCountWedgesVertexBufferKey);
 
     fFixedVertexBuffer = rp->findOrMakeStaticBuffer(GrGpuBufferType::kVertex,
@@ -17,6 +17,7 @@
 
 class GrMeshDrawTarget;
 class GrOpFlushState;
+class GrResourceProvider;
 class SkPath;
 
 namespace skgpu::ganesh {
@@ -145,7 +146,18 @@ public:
                  const PathDrawList& pathDrawList,
                  int totalCombinedPathVerbCnt) final;
 
+    // Like prepare(), but reuses the patches from the PatchCache if the same paths have already
+    // been tessellated with the same path matrices and shader matrix scale/skew, and adds them to
+    // the cache otherwise. Falls back to prepare() if the draws can't be cached.
+    void prepareWithPatchCache(GrMeshDrawTarget* target,
+                               const SkMatrix& shaderMatrix,
+                               const PathDrawList& pathDrawList,
+                               int totalCombinedPathVerbCnt);
+
     void draw(GrOpFlushState*) const final;
+
+private:
+    void prepareFixedCountBuffers(GrResourceProvider*);
 };
 
 }  // namespace skgpu::ganesh
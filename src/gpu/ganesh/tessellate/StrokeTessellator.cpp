@@ -13,6 +13,7 @@
 #include "src/gpu/ganesh/GrMeshDrawTarget.h"
 #include "src/gpu/ganesh/GrOpFlushState.h"
 #include "src/gpu/ganesh/GrResourceProvider.h"
+#include "src/gpu/ganesh/tessellate/PatchCache.h"
 #include "src/gpu/ganesh/tessellate/VertexChunkPatchAllocator.h"
 #include "src/gpu/tessellate/PatchWriter.h"
 #include "src/gpu/tessellate/StrokeIterator.h"
@@ -24,7 +25,8 @@ namespace {
 
 using namespace skgpu::tess;
 
-using StrokeWriter = PatchWriter<VertexChunkPatchAllocator,
+template <typename PatchAllocator>
+using StrokeWriter = PatchWriter<PatchAllocator,
                                  Required<PatchAttribs::kJoinControlPoint>,
                                  Optional<PatchAttribs::kStrokeParams>,
                                  Optional<PatchAttribs::kColor>,
@@ -33,7 +35,8 @@ using StrokeWriter = PatchWriter<VertexChunkPatchAllocator,
                                  ReplicateLineEndPoints,
                                  TrackJoinControlPoints>;
 
-void write_fixed_count_patches(StrokeWriter&& patchWriter,
+template <typename PatchAllocator>
+void write_fixed_count_patches(StrokeWriter<PatchAllocator>&& patchWriter,
                                const SkMatrix& shaderMatrix,
                                StrokeTessellator::PathStrokeList* pathStrokeList) {
     // The vector xform approximates how the control points are transformed by the shader to
@@ -143,6 +146,56 @@ void write_fixed_count_patches(StrokeWriter&& patchWriter,
     }
 }
 
+#if !defined(SK_ENABLE_OPTIMIZE_SIZE)
+// The stroke patches are written in path space, and only depend on the scale/skew part of the
+// shader matrix. Returns false if the strokes can't be cached.
+bool make_stroke_patches_key(skgpu::UniqueKey* key,
+                             PatchAttribs attribs,
+                             const SkMatrix& shaderMatrix,
+                             const StrokeTessellator::PathStrokeList* pathStrokeList) {
+    if (shaderMatrix.hasPerspective()) {
+        return false;
+    }
+    int strokeCount = 0;
+    for (auto* pathStroke = pathStrokeList; pathStroke; pathStroke = pathStroke->fNext) {
+        if (pathStroke->fPath.isVolatile()) {
+            return false;
+        }
+        ++strokeCount;
+    }
+
+    const bool hasColor = attribs & PatchAttribs::kColor;
+    // The genID, width, miter limit, and style/cap/join, plus the color if it's written into the
+    // patches.
+    const int strokeKeySize = 4 + (hasColor ? 4 : 0);
+
+    static const skgpu::UniqueKey::Domain kDomain = skgpu::UniqueKey::GenerateDomain();
+    skgpu::UniqueKey::Builder builder(key, kDomain, 5 + strokeCount * strokeKeySize,
+                                      "Tessellated Strokes");
+    builder[0] = (uint32_t)attribs;
+    const float shaderScaleSkew[4] = {shaderMatrix.getScaleX(), shaderMatrix.getSkewX(),
+                                      shaderMatrix.getSkewY(), shaderMatrix.getScaleY()};
+    memcpy(&builder[1], shaderScaleSkew, sizeof(shaderScaleSkew));
+    int i = 5;
+    for (auto* pathStroke = pathStrokeList; pathStroke; pathStroke = pathStroke->fNext) {
+        const SkStrokeRec& stroke = pathStroke->fStroke;
+        builder[i++] = pathStroke->fPath.getGenerationID();
+        const float params[2] = {stroke.getWidth(), stroke.getMiter()};
+        memcpy(&builder[i], params, sizeof(params));
+        i += 2;
+        builder[i++] = (uint32_t)stroke.getStyle() << 16 |
+                       (uint32_t)stroke.getCap() << 8 |
+                       (uint32_t)stroke.getJoin();
+        if (hasColor) {
+            memcpy(&builder[i], pathStroke->fColor.vec(), 4 * sizeof(float));
+            i += 4;
+        }
+    }
+    SkASSERT(i == 5 + strokeCount * strokeKeySize);
+    return true;
+}
+#endif
+
 }  // namespace
 
 
@@ -154,11 +207,47 @@ void StrokeTessellator::prepare(GrMeshDrawTarget* target,
                                 int totalCombinedStrokeVerbCnt) {
     LinearTolerances worstCase;
     const int preallocCount = FixedCountStrokes::PreallocCount(totalCombinedStrokeVerbCnt);
-    StrokeWriter patchWriter{fAttribs, &worstCase,  target, &fVertexChunkArray, preallocCount};
+    StrokeWriter<VertexChunkPatchAllocator> patchWriter{fAttribs, &worstCase, target,
+                                                        &fVertexChunkArray, preallocCount};
 
     write_fixed_count_patches(std::move(patchWriter), shaderMatrix, pathStrokeList);
     fVertexCount = FixedCountStrokes::VertexCount(worstCase);
 
+    this->prepareVertexIDFallbackBuffer(target);
+}
+
+void StrokeTessellator::prepareWithPatchCache(GrMeshDrawTarget* target,
+                                              const SkMatrix& shaderMatrix,
+                                              PathStrokeList* pathStrokeList,
+                                              int totalCombinedStrokeVerbCnt) {
+#if !defined(SK_ENABLE_OPTIMIZE_SIZE)
+    skgpu::UniqueKey key;
+    if (totalCombinedStrokeVerbCnt >= PatchCache::kMinVerbsToCache &&
+        make_stroke_patches_key(&key, fAttribs, shaderMatrix, pathStrokeList)) {
+        if (!PatchCache::Find(target, key, &fVertexChunkArray, &fVertexCount)) {
+            CpuPatchBuffer patches(PatchStride(fAttribs),
+                                   FixedCountStrokes::PreallocCount(totalCombinedStrokeVerbCnt));
+            LinearTolerances worstCase;
+            {
+                StrokeWriter<CpuPatchAllocator> patchWriter{fAttribs, &worstCase, &patches};
+                write_fixed_count_patches(std::move(patchWriter), shaderMatrix, pathStrokeList);
+            }
+            fVertexCount = FixedCountStrokes::VertexCount(worstCase);
+            if (sk_sp<SkIDChangeListener> listener = PatchCache::Add(
+                        target, &key, patches, fVertexCount, &fVertexChunkArray)) {
+                for (auto* pathStroke = pathStrokeList; pathStroke; pathStroke = pathStroke->fNext) {
+                    SkPathPriv::AddGenIDChangeListener(pathStroke->fPath, listener);
+                }
+            }
+        }
+        this->prepareVertexIDFallbackBuffer(target);
+        return;
+    }
+#endif
+    this->prepare(target, shaderMatrix, pathStrokeList, totalCombinedStrokeVerbCnt);
+}
+
+void StrokeTessellator::prepareVertexIDFallbackBuffer(GrMeshDrawTarget* target) {
     if (!target->caps().shaderCaps()->fVertexIDSupport) {
         // Our shader won't be able to use sk_VertexID. Bind a fallback vertex buffer with the IDs
         // in it instead.
@@ -48,11 +48,21 @@ public:
                  PathStrokeList*,
                  int totalCombinedStrokeVerbCnt);
 
+    // Like prepare(), but reuses the patches from the PatchCache if the same strokes have already
+    // been tessellated with the same shader matrix scale/skew, and adds them to the cache
+    // otherwise. Falls back to prepare() if the strokes can't be cached.
+    void prepareWithPatchCache(GrMeshDrawTarget*,
+                               const SkMatrix& shaderMatrix,
+                               PathStrokeList*,
+                               int totalCombinedStrokeVerbCnt);
+
     // Issues draw calls for the tessellated stroke. The caller is responsible for creating and
     // binding a pipeline that uses this class's shader() before calling draw().
     void draw(GrOpFlushState*) const;
 
 protected:
+    void prepareVertexIDFallbackBuffer(GrMeshDrawTarget*);
+
     const PatchAttribs fAttribs;
 
     GrVertexChunkArray fVertexChunkArray;
@@ -17,7 +17,7 @@ namespace sktext::gpu {
 class Glyph;
 }
 class GrResourceProvider;
-class SkGlyph;
+class SkBulkGlyphMetricsAndImages;
 class GrTextStrike;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -53,8 +53,11 @@ public:
 
     bool hasGlyph(skgpu::MaskFormat, sktext::gpu::Glyph*);
 
-    GrDrawOpAtlas::ErrorCode addGlyphToAtlas(const SkGlyph&,
-                                             sktext::gpu::Glyph*,
+    // Uploads the mask of 'glyph' from the process-wide GlyphMaskStore, rasterizing it with
+    // 'glyphs' only if the store does not have it.
+    GrDrawOpAtlas::ErrorCode addGlyphToAtlas(SkBulkGlyphMetricsAndImages* glyphs,
+                                             sktext::gpu::Glyph* glyph,
+                                             skgpu::MaskFormat glyphFormat,
                                              int srcPadding,
                                              GrResourceProvider*,
                                              GrDeferredUploadTarget*);
@@ -30,6 +30,7 @@ void Caps::finishInitialization(const ContextOptions& options) {
     } else {
         fShaderErrorHandler = DefaultShaderErrorHandler();
     }
+    fPersistentPipelineStorage = options.fPersistentPipelineStorage;
 
 #if GRAPHITE_TEST_UTILS
     fMaxTextureAtlasSize = options.fMaxTextureAtlasSize;
@@ -10,6 +10,7 @@
 
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
+#include "include/gpu/graphite/ContextOptions.h"
 #include "include/private/base/SkAlign.h"
 #include "src/core/SkEnumBitMask.h"
 #include "src/gpu/ResourceKey.h"
@@ -17,6 +18,8 @@
 #include "src/gpu/graphite/ResourceTypes.h"
 #include "src/text/gpu/SDFTControl.h"
 
+#include <string>
+
 class SkCapabilities;
 
 namespace SkSL { struct ShaderCaps; }
@@ -26,7 +29,6 @@ namespace skgpu { class ShaderErrorHandler; }
 namespace skgpu::graphite {
 
 enum class BufferType : int;
-struct ContextOptions;
 class ComputePipelineDesc;
 class GraphicsPipelineDesc;
 class GraphiteResourceKey;
@@ -163,6 +165,9 @@ public:
     // Returns whether a draw buffer can be mapped.
     bool drawBufferCanBeMapped() const { return fDrawBufferCanBeMapped; }
 
+    // Returns whether ComputeTasks can be recorded alongside draws, e.g. to compute path coverage.
+    bool computeSupport() const { return fComputeSupport; }
+
     // Returns the skgpu::Swizzle to use when sampling or reading back from a texture with the
     // passed in SkColorType and TextureInfo.
     skgpu::Swizzle getReadSwizzle(SkColorType, const TextureInfo&) const;
@@ -173,6 +178,14 @@ public:
 
     skgpu::ShaderErrorHandler* shaderErrorHandler() const { return fShaderErrorHandler; }
 
+    ContextOptions::PersistentPipelineStorage* persistentPipelineStorage() const {
+        return fPersistentPipelineStorage;
+    }
+
+    // Identifies the GPU and driver that shaders are compiled for, e.g. so that persisted shaders
+    // aren't reused after a driver update. Empty if the backend doesn't report one.
+    const std::string& deviceIdentity() const { return fDeviceIdentity; }
+
     float minDistanceFieldFontSize() const { return fMinDistanceFieldFontSize; }
     float glyphsAsPathsFontSize() const { return fGlyphsAsPathsFontSize; }
 
@@ -242,9 +255,12 @@ protected:
     bool fStorageBufferSupport = false;
     bool fStorageBufferPreferred = false;
     bool fDrawBufferCanBeMapped = true;
+    bool fComputeSupport = false;
 
     ResourceBindingRequirements fResourceBindingReqs;
 
+    std::string fDeviceIdentity;
+
     //////////////////////////////////////////////////////////////////////////////////////////
     // Client-provided Caps
 
@@ -253,6 +269,7 @@ protected:
      * via SkDebugf and assert.
      */
     ShaderErrorHandler* fShaderErrorHandler = nullptr;
+    ContextOptions::PersistentPipelineStorage* fPersistentPipelineStorage = nullptr;
 
 #if GRAPHITE_TEST_UTILS
     int  fMaxTextureAtlasSize = 2048;
@@ -26,6 +26,7 @@ class ShaderCodeDictionary;
 class ContextPriv {
 public:
     const Caps* caps() const { return fContext->fSharedContext->caps(); }
+    const SharedContext* sharedContext() const { return fContext->fSharedContext.get(); }
 
     const ShaderCodeDictionary* shaderCodeDictionary() const {
         return fContext->fSharedContext->shaderCodeDictionary();
@@ -27,6 +27,8 @@
 #include "src/gpu/graphite/SharedContext.h"
 #include "src/gpu/graphite/TextureProxy.h"
 #include "src/gpu/graphite/TextureUtils.h"
+#include "src/gpu/graphite/compute/ComputePathCoverage.h"
+#include "src/gpu/graphite/compute/DispatchGroup.h"
 #include "src/gpu/graphite/geom/BoundsManager.h"
 #include "src/gpu/graphite/geom/Geometry.h"
 #include "src/gpu/graphite/geom/IntersectionTree.h"
@@ -286,6 +288,7 @@ Device::Device(Recorder* recorder, sk_sp<DrawContext> dc, bool addInitialClear)
                                                           kGridCellSize,
                                                           kMaxBruteForceN))
         , fDisjointStencilSet(std::make_unique<IntersectionTreeSet>())
+        , fOcclusionGrid(std::make_unique<OcclusionGrid>(fDC->imageInfo().dimensions()))
         , fCachedLocalToDevice(SkM44())
         , fCurrentDepth(DrawOrder::kClearDepth)
         , fSDFTControl(recorder->priv().caps()->getSDFTControl(false))
@@ -929,6 +932,18 @@ void Device::drawGeometry(const Transform& localToDevice,
         return;
     }
 
+    // The coverage mask renderer only handles the fill, and draws a different Geometry than the
+    // original shape once the compute work that produces the mask has been recorded.
+    Geometry fillGeometry = geometry;
+    if (renderer == fRecorder->priv().rendererProvider()->coverageMask()) {
+        fillGeometry = this->computeCoverageMask(localToDevice, geometry, clip, order);
+        if (fillGeometry.isEmpty()) {
+            fillGeometry = geometry;
+            renderer = fRecorder->priv().rendererProvider()->stencilTessellatedCurvesAndTris(
+                    geometry.shape().fillType());
+        }
+    }
+
 #if defined(SK_DEBUG)
     // Renderers and their component RenderSteps have flexibility in defining their
     // DepthStencilSettings. However, the clipping and ordering managed between Device and ClipStack
@@ -990,16 +1005,27 @@ void Device::drawGeometry(const Transform& localToDevice,
     }
     if (styleType == SkStrokeRec::kFill_Style ||
         styleType == SkStrokeRec::kStrokeAndFill_Style) {
-        fDC->recordDraw(renderer, localToDevice, geometry, clip, order, &shading, nullptr);
+        fDC->recordDraw(renderer, localToDevice, fillGeometry, clip, order, &shading, nullptr);
+    }
+
+    // A filled rect with an opaque paint that isn't affected by any depth-based clip overwrites
+    // everything beneath its interior, so it can cull earlier draws when flushing. The coverage
+    // AA along its edges doesn't matter since only cells fully inside the rect are tracked.
+    const bool fullyOpaque = !paint_depends_on_dst(shading) &&
+                             clipOrder == DrawOrder::kNoIntersection &&
+                             styleType == SkStrokeRec::kFill_Style &&
+                             geometry.isShape() &&
+                             geometry.shape().isRect() &&
+                             !geometry.shape().inverted() &&
+                             localToDevice.type() <= Transform::Type::kRectStaysRect;
+    if (fullyOpaque) {
+        Rect occluder = localToDevice.mapRect(geometry.shape().rect())
+                                     .makeIntersect(clip.drawBounds());
+        if (!occluder.isEmptyNegativeOrNaN()) {
+            fOcclusionGrid->recordOccluder(occluder, order.depth());
+        }
     }
 
-    // TODO: If 'fullyOpaque' is true, it might be useful to store the draw bounds and Z in a
-    // special occluders list for filtering the DrawList/DrawPass when flushing.
-    // const bool fullyOpaque = !dependsOnDst &&
-    //                          clipOrder == DrawOrder::kNoIntersection &&
-    //                          shape.isRect() &&
-    //                          localToDevice.type() <= Transform::Type::kRectStaysRect;
-
     // Post-draw book keeping (bounds manager, depth tracking, etc.)
     fColorDepthBoundsManager->recordDraw(clip.drawBounds(), order.paintOrder());
     fCurrentDepth = order.depth();
@@ -1111,12 +1137,39 @@ const Renderer* Device::chooseRenderer(const Geometry& geometry,
 
         if (preferWedges) {
             return renderers->stencilTessellatedWedges(shape.fillType());
+        } else if (!requireMSAA && renderers->coverageMask()) {
+            // Large, complex fills skip the stencil passes when their coverage can be computed
+            // ahead of the render pass. drawGeometry() falls back to the stencil renderer if the
+            // mask can't be made.
+            return renderers->coverageMask();
         } else {
             return renderers->stencilTessellatedCurvesAndTris(shape.fillType());
         }
     }
 }
 
+Geometry Device::computeCoverageMask(const Transform& localToDevice,
+                                     const Geometry& geometry,
+                                     const Clip& clip,
+                                     DrawOrder order) {
+    const ComputePathCoverage* pathCoverage =
+            fRecorder->priv().rendererProvider()->computePathCoverage();
+    SkASSERT(pathCoverage);
+
+    DispatchGroup::Builder builder(fRecorder);
+    SkIRect area;
+    sk_sp<TextureProxy> mask = pathCoverage->appendSteps(
+            fRecorder,
+            &builder,
+            DrawParams(localToDevice, geometry, clip, order, /*stroke=*/nullptr),
+            &area);
+    if (!mask) {
+        return Geometry();
+    }
+    fDC->recordDispatchGroup(builder.finalize());
+    return Geometry(CoverageMask(std::move(mask), area));
+}
+
 void Device::flushPendingWorkToRecorder() {
     SkASSERT(fRecorder);
 
@@ -1134,6 +1187,12 @@ void Device::flushPendingWorkToRecorder() {
         fRecorder->priv().add(std::move(uploadTask));
     }
 
+    // Any compute work produces textures that are sampled by the pending draws.
+    auto computeTask = fDC->snapComputeTask(fRecorder);
+    if (computeTask) {
+        fRecorder->priv().add(std::move(computeTask));
+    }
+
 #ifdef SK_ENABLE_PIET_GPU
     auto pietTask = fDC->snapPietRenderTask(fRecorder);
     if (pietTask) {
@@ -1142,6 +1201,7 @@ void Device::flushPendingWorkToRecorder() {
 #endif
 
     fClip.recordDeferredClipDraws();
+    fDC->cullOccludedDraws(fOcclusionGrid.get());
     auto drawTask = fDC->snapRenderPassTask(fRecorder);
     if (drawTask) {
         fRecorder->priv().add(std::move(drawTask));
@@ -1151,6 +1211,7 @@ void Device::flushPendingWorkToRecorder() {
     // an immutable DrawPass.
     fColorDepthBoundsManager->reset();
     fDisjointStencilSet->reset();
+    fOcclusionGrid->reset();
     fCurrentDepth = DrawOrder::kClearDepth;
     // NOTE: fDrawsOverlap is not reset here because that is a persistent property of everything
     // drawn into the Device, and not just the currently accumulating pass.
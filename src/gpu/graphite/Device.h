@@ -33,6 +33,7 @@ class Clip;
 class Context;
 class DrawContext;
 class Geometry;
+class OcclusionGrid;
 class PaintParams;
 class Recorder;
 class Renderer;
@@ -230,6 +231,11 @@ private:
                                    const SkStrokeRec&,
                                    bool requireMSAA) const;
 
+    // Records the compute work that computes the coverage of filling 'geometry' and returns a
+    // CoverageMask geometry to draw with RendererProvider::coverageMask(). Returns an empty
+    // Geometry if the coverage could not be computed, in which case nothing is recorded.
+    Geometry computeCoverageMask(const Transform&, const Geometry&, const Clip&, DrawOrder);
+
     bool needsFlushBeforeDraw(int numNewDraws) const;
 
     Recorder* fRecorder;
@@ -242,6 +248,8 @@ private:
     std::unique_ptr<BoundsManager> fColorDepthBoundsManager;
     // Tracks disjoint stencil indices for all recordered draws
     std::unique_ptr<IntersectionTreeSet> fDisjointStencilSet;
+    // Tracks the areas covered by opaque draws so hidden draws can be culled at flush time
+    std::unique_ptr<OcclusionGrid> fOcclusionGrid;
 
     // Lazily updated Transform constructed from localToDevice()'s SkM44
     Transform fCachedLocalToDevice;
@@ -16,9 +16,11 @@
 #include "src/gpu/graphite/Buffer.h"
 #include "src/gpu/graphite/Caps.h"
 #include "src/gpu/graphite/CommandBuffer.h"
+#include "src/gpu/graphite/ComputeTask.h"
 #include "src/gpu/graphite/ContextPriv.h"
 #include "src/gpu/graphite/DrawList.h"
 #include "src/gpu/graphite/DrawPass.h"
+#include "src/gpu/graphite/PipelineKeyCollector.h"
 #include "src/gpu/graphite/RecorderPriv.h"
 #include "src/gpu/graphite/RenderPassTask.h"
 #include "src/gpu/graphite/ResourceTypes.h"
@@ -26,6 +28,7 @@
 #include "src/gpu/graphite/TextureProxy.h"
 #include "src/gpu/graphite/TextureProxyView.h"
 #include "src/gpu/graphite/UploadTask.h"
+#include "src/gpu/graphite/compute/DispatchGroup.h"
 #include "src/gpu/graphite/geom/BoundsManager.h"
 #include "src/gpu/graphite/geom/Geometry.h"
 #include "src/gpu/graphite/text/AtlasManager.h"
@@ -126,6 +129,11 @@ bool DrawContext::recordUpload(Recorder* recorder,
                                          std::move(condContext));
 }
 
+void DrawContext::recordDispatchGroup(std::unique_ptr<DispatchGroup> group) {
+    SkASSERT(group);
+    fPendingDispatchGroups.push_back(std::move(group));
+}
+
 #ifdef SK_ENABLE_PIET_GPU
 bool DrawContext::recordPietSceneRender(Recorder*,
                                         sk_sp<TextureProxy> targetProxy,
@@ -229,6 +237,17 @@ sk_sp<Task> DrawContext::snapRenderPassTask(Recorder* recorder) {
                                                drawPass->clearColor(),
                                                drawPass->requiresMSAA(),
                                                writeSwizzle);
+
+    if (PipelineKeyCollector* collector = recorder->priv().pipelineKeyCollector()) {
+        for (const GraphicsPipelineDesc& pipelineDesc : drawPass->pipelineDescs()) {
+            collector->add(recorder->priv().shaderCodeDictionary(),
+                           recorder->priv().rendererProvider(),
+                           pipelineDesc,
+                           this->colorInfo().colorType(),
+                           drawPass->depthStencilFlags(),
+                           drawPass->requiresMSAA());
+        }
+    }
     sk_sp<TextureProxy> targetProxy = sk_ref_sp(fDrawPasses[0]->target());
     return RenderPassTask::Make(std::move(fDrawPasses), desc, std::move(targetProxy));
 }
@@ -245,6 +264,15 @@ sk_sp<Task> DrawContext::snapUploadTask(Recorder* recorder) {
     return uploadTask;
 }
 
+sk_sp<Task> DrawContext::snapComputeTask(Recorder*) {
+    if (fPendingDispatchGroups.empty()) {
+        return nullptr;
+    }
+    sk_sp<Task> computeTask = ComputeTask::Make(std::move(fPendingDispatchGroups));
+    fPendingDispatchGroups.clear();
+    return computeTask;
+}
+
 #ifdef SK_ENABLE_PIET_GPU
 sk_sp<Task> DrawContext::snapPietRenderTask(Recorder* recorder) {
     if (fPendingPietRenders.empty()) {
@@ -14,6 +14,7 @@
 #include "include/private/base/SkTArray.h"
 
 #include "src/gpu/graphite/AttachmentTypes.h"
+#include "src/gpu/graphite/ComputeTask.h"
 #include "src/gpu/graphite/DrawList.h"
 #include "src/gpu/graphite/DrawOrder.h"
 #include "src/gpu/graphite/DrawTypes.h"
@@ -67,6 +68,11 @@ public:
 
     int pendingDrawCount() const { return fPendingDraws->drawCount(); }
 
+    // Drops the pending draws that are hidden by the opaque draws tracked in 'occluders'
+    void cullOccludedDraws(OcclusionGrid* occluders) {
+        fPendingDraws->cullOccludedDraws(occluders);
+    }
+
     void clear(const SkColor4f& clearColor);
 
     void recordDraw(const Renderer* renderer,
@@ -86,6 +92,10 @@ public:
                       const SkIRect& dstRect,
                       std::unique_ptr<ConditionalUploadContext>);
 
+    // Records a DispatchGroup whose outputs are sampled by draws recorded into this DrawContext, so
+    // it must run before the render pass that contains them.
+    void recordDispatchGroup(std::unique_ptr<DispatchGroup>);
+
 #ifdef SK_ENABLE_PIET_GPU
     bool recordPietSceneRender(Recorder* recorder,
                                sk_sp<TextureProxy> targetProxy,
@@ -95,9 +105,9 @@ public:
     // Ends the current DrawList being accumulated by the SDC, converting it into an optimized and
     // immutable DrawPass. The DrawPass will be ordered after any other snapped DrawPasses or
     // appended DrawPasses from a child SDC. A new DrawList is started to record subsequent drawing
-    // operations.
+    // operations. Callers that track occluders should filter the DrawList with
+    // 'cullOccludedDraws' first.
     //
-    // TBD - Should this take a special occluder list to filter the DrawList?
     // TBD - should this also return the task so the caller can point to it with its own
     // dependencies? Or will that be mostly automatic based on draws and proxy refs?
     void snapDrawPass(Recorder*);
@@ -122,6 +132,12 @@ public:
     // TODO: see if we can merge transfers into this
     sk_sp<Task> snapUploadTask(Recorder*);
 
+    // Moves the accumulated DispatchGroups into a ComputeTask. The caller must add it to the
+    // Recording before the task returned by 'snapRenderPassTask'.
+    //
+    // Returns null if there are no pending dispatch groups.
+    sk_sp<Task> snapComputeTask(Recorder*);
+
 #ifdef SK_ENABLE_PIET_GPU
     sk_sp<Task> snapPietRenderTask(Recorder*);
 #endif
@@ -155,6 +171,9 @@ private:
     // can be appended to, or have its commands rewritten if they are inlined into a parent DC.
     std::unique_ptr<UploadList> fPendingUploads;
 
+    // Stores the compute work that produces textures sampled by the pending draws.
+    ComputeTask::DispatchGroupList fPendingDispatchGroups;
+
 #ifdef SK_ENABLE_PIET_GPU
     std::vector<PietRenderInstance> fPendingPietRenders;
 #endif
@@ -9,6 +9,7 @@
 
 #include "src/gpu/BufferWriter.h"
 #include "src/gpu/graphite/Renderer.h"
+#include "src/gpu/graphite/geom/BoundsManager.h"
 #include "src/gpu/graphite/geom/Shape.h"
 
 namespace skgpu::graphite {
@@ -41,4 +42,23 @@ void DrawList::recordDraw(const Renderer* renderer,
     fRenderStepCount += renderer->numRenderSteps();
 }
 
+void DrawList::cullOccludedDraws(OcclusionGrid* occluders) {
+    SkASSERT(occluders);
+    if (!occluders->hasOccluders()) {
+        return;
+    }
+
+    for (Draw& draw : fDraws.items()) {
+        if (draw.fCulled || !draw.fPaintParams.has_value()) {
+            continue;
+        }
+        if (occluders->isOccluded(draw.fDrawParams.clip().drawBounds(),
+                                  draw.fDrawParams.order().depth())) {
+            draw.fCulled = true;
+            fRenderStepCount -= draw.fRenderer->numRenderSteps();
+            fCulledDrawCount++;
+        }
+    }
+}
+
 } // namespace skgpu::graphite
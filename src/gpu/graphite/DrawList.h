@@ -22,6 +22,7 @@
 
 namespace skgpu::graphite {
 
+class OcclusionGrid;
 class Renderer;
 
 /**
@@ -76,8 +77,14 @@ public:
                     const PaintParams* paint,
                     const StrokeStyle* stroke);
 
+    // Marks the draws that are hidden by later opaque draws tracked in 'occluders' so that they
+    // are skipped when the list is converted to a DrawPass. Depth-only draws are never culled
+    // since they can affect the depth test of draws outside the occluders.
+    void cullOccludedDraws(OcclusionGrid* occluders);
+
     int drawCount() const { return fDraws.count(); }
     int renderStepCount() const { return fRenderStepCount; }
+    int culledDrawCount() const { return fCulledDrawCount; }
 
 private:
     friend class DrawPass;
@@ -86,6 +93,7 @@ private:
         const Renderer* fRenderer; // Owned by SharedContext of Recorder that recorded the draw
         DrawParams fDrawParams; // The DrawParam's transform is owned by fTransforms of the DrawList
         std::optional<PaintParams> fPaintParams; // Not present implies depth-only draw
+        bool fCulled = false; // Set when the draw is fully occluded by later opaque draws
 
         Draw(const Renderer* renderer, const Transform& transform, const Geometry& geometry,
              const Clip& clip, DrawOrder order, const PaintParams* paint,
@@ -101,8 +109,9 @@ private:
     SkTBlockList<Transform, 16> fTransforms;
     SkTBlockList<Draw, 16>      fDraws;
 
-    // Running total of RenderSteps for all draws, assuming nothing is culled
-    int fRenderStepCount;
+    // Running total of RenderSteps for all draws that have not been culled
+    int fRenderStepCount = 0;
+    int fCulledDrawCount = 0;
 };
 
 } // namespace skgpu::graphite
@@ -37,6 +37,7 @@
 #include "src/base/SkTBlockList.h"
 
 #include <algorithm>
+#include <array>
 #include <unordered_map>
 
 using namespace skia_private;
@@ -361,7 +362,18 @@ public:
         return TextureBindingsField::get(fUniformKey);
     }
 
+    // Sorts 'keys' into the same order as std::sort would. Large key sets use an LSD radix sort
+    // over the 128 bits of the key, skipping any byte that has the same value in every key (e.g.,
+    // the high bits of the painter's order or the unused stencil index are frequently zero).
+    static void Sort(std::vector<SortKey>* keys);
+
 private:
+    uint8_t byte(int i) const {
+        SkASSERT(i >= 0 && i < 16);
+        return i < 8 ? static_cast<uint8_t>(fUniformKey >> (8 * i))
+                     : static_cast<uint8_t>(fPipelineKey >> (8 * (i - 8)));
+    }
+
     // Fields are ordered from most-significant to least when sorting by 128-bit value.
     // NOTE: We don't use C++ bit fields because field ordering is implementation defined and we
     // need to sort consistently.
@@ -374,9 +386,13 @@ private:
     // The uniform/texture index fields need 1 extra bit to encode "no-data". Values that are
     // greater than or equal to 2^(bits-1) represent "no-data", while values between
     // [0, 2^(bits-1)-1] can access data arrays without extra logic.
-    using GeometryUniformField = Bitfield<22, 42>; // bits >= 1+log2(max steps * max draw count)
-    using ShadingUniformField  = Bitfield<21, 21>; // bits >= 1+log2(max steps * max draw count)
-    using TextureBindingsField = Bitfield<21, 0>;  // bits >= 1+log2(max steps * max draw count)
+    //
+    // Within a run of keys that share a pipeline, the texture bindings are the most significant
+    // so that each distinct binding is bound only once. Geometry uniforms tend to be unique per
+    // draw and would otherwise scatter the texture (and shading) bindings across the run.
+    using TextureBindingsField = Bitfield<21, 43>; // bits >= 1+log2(max steps * max draw count)
+    using ShadingUniformField  = Bitfield<21, 22>; // bits >= 1+log2(max steps * max draw count)
+    using GeometryUniformField = Bitfield<22, 0>;  // bits >= 1+log2(max steps * max draw count)
     uint64_t fUniformKey;
 
     // Backpointer to the draw that produced the sort key
@@ -395,6 +411,54 @@ private:
                           1 + SkNextLog2_portable(Renderer::kMaxRenderSteps * DrawList::kMaxDraws));
 };
 
+void DrawPass::SortKey::Sort(std::vector<SortKey>* keys) {
+    // Below this the histogram setup of the radix sort costs more than comparison sorting does.
+    static constexpr size_t kMinRadixSortCount = 256;
+    static constexpr int kNumBytes = 2 * sizeof(uint64_t);
+
+    const size_t count = keys->size();
+    if (count < kMinRadixSortCount) {
+        std::sort(keys->begin(), keys->end());
+        return;
+    }
+
+    // Gather the histograms of every byte in a single pass over the keys
+    std::array<std::array<uint32_t, 256>, kNumBytes> histograms = {};
+    for (const SortKey& key : *keys) {
+        for (int b = 0; b < kNumBytes; ++b) {
+            histograms[b][key.byte(b)]++;
+        }
+    }
+
+    std::vector<SortKey> scratch(count, keys->front());
+    SortKey* src = keys->data();
+    SortKey* dst = scratch.data();
+    // Least significant byte first; every scatter is stable so the earlier passes' ordering is
+    // preserved between keys with equal values in the current byte.
+    for (int b = 0; b < kNumBytes; ++b) {
+        std::array<uint32_t, 256>& histogram = histograms[b];
+        if (histogram[src->byte(b)] == count) {
+            continue; // All keys share this byte so it can't change their order
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t& bucket : histogram) {
+            uint32_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            dst[histogram[src[i].byte(b)]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != keys->data()) {
+        std::copy(src, src + count, keys->data());
+    }
+    SkASSERT(std::is_sorted(keys->begin(), keys->end()));
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 DrawPass::DrawPass(sk_sp<TextureProxy> target,
@@ -465,6 +529,10 @@ std::unique_ptr<DrawPass> DrawPass::Make(Recorder* recorder,
     std::vector<SortKey> keys;
     keys.reserve(draws->renderStepCount());
     for (const DrawList::Draw& draw : draws->fDraws.items()) {
+        if (draw.fCulled) {
+            continue;
+        }
+
         // If we have two different descriptors, such that the uniforms from the PaintParams can be
         // bound independently of those used by the rest of the RenderStep, then we can upload now
         // and remember the location for re-use on any RenderStep that does shading.
@@ -514,14 +582,15 @@ std::unique_ptr<DrawPass> DrawPass::Make(Recorder* recorder,
     geometrySsboTracker.writeUniforms(bufferMgr);
     shadingSsboTracker.writeUniforms(bufferMgr);
 
-    // TODO: Explore sorting algorithms; in all likelihood this will be mostly sorted already, so
-    // algorithms that approach O(n) in that condition may be favorable. Alternatively, could
-    // explore radix sort that is always O(n). Brief testing suggested std::sort was faster than
-    // std::stable_sort and SkTQSort on my [ml]'s Windows desktop. Also worth considering in-place
-    // vs. algorithms that require an extra O(n) storage.
     // TODO: It's not strictly necessary, but would a stable sort be useful or just end up hiding
-    // bugs in the DrawOrder determination code?
-    std::sort(keys.begin(), keys.end());
+    // bugs in the DrawOrder determination code? (The radix sort is stable but small passes still
+    // use std::sort.)
+    SortKey::Sort(&keys);
+
+    Recorder::DrawPassStats* stats = recorder->priv().drawPassStats();
+    stats->fNumDrawPasses++;
+    stats->fNumDrawSteps += SkToInt(keys.size());
+    stats->fNumCulledDraws += draws->culledDrawCount();
 
     // Used to record vertex/instance data, buffer binds, and draw calls
     DrawWriter drawWriter(&drawPass->fCommandList, bufferMgr);
@@ -562,6 +631,10 @@ std::unique_ptr<DrawPass> DrawPass::Make(Recorder* recorder,
             drawWriter.newDynamicState();
         }
 
+        stats->fPipelineChanges += pipelineChange;
+        stats->fUniformChanges  += geomBindingChange || shadingBindingChange;
+        stats->fTextureChanges  += textureBindingsChange;
+
         // Make state changes before accumulating new draw data
         if (pipelineChange) {
             drawPass->fCommandList.bindGraphicsPipeline(key.pipelineIndex());
@@ -74,6 +74,11 @@ public:
 
     SkEnumBitMask<DepthStencilFlags> depthStencilFlags() const { return fDepthStencilFlags; }
 
+    // Only valid until prepareResources() has turned these into full pipelines.
+    SkSpan<const GraphicsPipelineDesc> pipelineDescs() const {
+        return {fPipelineDescs.data(), fPipelineDescs.size()};
+    }
+
     size_t vertexBufferSize()  const { return 0; }
     size_t uniformBufferSize() const { return 0; }
 
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/gpu/graphite/PipelineCacheUtils.h"
+
+#include "include/core/SkMilestone.h"
+#include "include/gpu/graphite/ContextOptions.h"
+#include "src/core/SkReadBuffer.h"
+#include "src/core/SkTraceEvent.h"
+#include "src/core/SkWriteBuffer.h"
+#include "src/gpu/graphite/AttachmentTypes.h"
+#include "src/gpu/graphite/BuiltInCodeSnippetID.h"
+#include "src/gpu/graphite/Caps.h"
+#include "src/gpu/graphite/GraphicsPipelineDesc.h"
+#include "src/gpu/graphite/PaintParamsKey.h"
+#include "src/gpu/graphite/Renderer.h"
+#include "src/gpu/graphite/RendererProvider.h"
+#include "src/gpu/graphite/ShaderCodeDictionary.h"
+#include "src/gpu/graphite/SharedContext.h"
+#include "src/sksl/SkSLUtil.h"
+
+namespace skgpu::graphite::PipelineCacheUtils {
+
+// If the shader generation or the packed format changes in a way that isn't captured by the
+// snippet IDs or SK_MILESTONE, kCurrentVersion must be incremented to invalidate stored entries.
+static constexpr int kCurrentVersion = 2;
+
+int GetCurrentVersion() { return kCurrentVersion; }
+
+namespace {
+
+bool has_only_stable_snippets(const ShaderCodeDictionary* dict,
+                              const PaintParamsKey::BlockReader& reader) {
+    if (reader.codeSnippetId() >= kBuiltInCodeSnippetIDCount) {
+        return false;
+    }
+    for (int i = 0; i < reader.numChildren(); ++i) {
+        if (!has_only_stable_snippets(dict, reader.child(dict, i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Writes the ShaderCaps that change the code SkSL generates for the backend, so that stored shaders
+// aren't reused when e.g. a driver workaround is turned on or off.
+void write_shader_caps(SkWriteBuffer& writer, const SkSL::ShaderCaps& caps) {
+    writer.writeInt(static_cast<int>(caps.fGLSLGeneration));
+    writer.writeInt(static_cast<int>(caps.fAdvBlendEqInteraction));
+    const bool flags[] = {
+        caps.fShaderDerivativeSupport,
+        caps.fExplicitTextureLodSupport,
+        caps.fIntegerSupport,
+        caps.fNonsquareMatrixSupport,
+        caps.fInverseHyperbolicSupport,
+        caps.fFBFetchSupport,
+        caps.fFBFetchNeedsCustomOutput,
+        caps.fUsesPrecisionModifiers,
+        caps.fFlatInterpolationSupport,
+        caps.fNoPerspectiveInterpolationSupport,
+        caps.fSampleMaskSupport,
+        caps.fExternalTextureSupport,
+        caps.fFloatIs32Bits,
+        caps.fInfinitySupport,
+        caps.fBuiltinFMASupport,
+        caps.fBuiltinDeterminantSupport,
+        caps.fCanUseMinAndAbsTogether,
+        caps.fCanUseFractForNegativeValues,
+        caps.fMustForceNegatedAtanParamToFloat,
+        caps.fMustForceNegatedLdexpParamToMultiply,
+        caps.fAtan2ImplementedAsAtanYOverX,
+        caps.fMustDoOpBetweenFloorAndAbs,
+        caps.fMustGuardDivisionEvenAfterExplicitZeroCheck,
+        caps.fCanUseFragCoord,
+        caps.fIncompleteShortIntPrecision,
+        caps.fAddAndTrueToLoopCondition,
+        caps.fUnfoldShortCircuitAsTernary,
+        caps.fEmulateAbsIntFunction,
+        caps.fRewriteDoWhileLoops,
+        caps.fRewriteSwitchStatements,
+        caps.fRemovePowWithConstantExponent,
+        caps.fNoDefaultPrecisionForExternalSamplers,
+        caps.fRewriteMatrixVectorMultiply,
+        caps.fRewriteMatrixComparisons,
+        caps.fRemoveConstFromFunctionParameters,
+        caps.fColorSpaceMathNeedsFloat,
+        caps.fPerlinNoiseRoundingFix,
+    };
+    for (bool flag : flags) {
+        writer.writeBool(flag);
+    }
+    writer.writeString(caps.fVersionDeclString);
+    writer.writeString(caps.fFBFetchColorName ? caps.fFBFetchColorName : "");
+}
+
+} // anonymous namespace
+
+bool HasOnlyStableSnippets(const ShaderCodeDictionary* dict, const PaintParamsKey& key) {
+    for (int offset = 0; offset < key.sizeInBytes();) {
+        PaintParamsKey::BlockReader reader = key.reader(dict, offset);
+        if (!has_only_stable_snippets(dict, reader)) {
+            return false;
+        }
+        offset += reader.blockSize();
+    }
+    return true;
+}
+
+sk_sp<SkData> MakePipelineKey(const SharedContext* sharedContext,
+                              SkFourByteTag shaderType,
+                              const GraphicsPipelineDesc& pipelineDesc,
+                              const RenderPassDesc& renderPassDesc) {
+    const ShaderCodeDictionary* dict = sharedContext->shaderCodeDictionary();
+    const Caps* caps = sharedContext->caps();
+
+    const RenderStep* step = sharedContext->rendererProvider()->lookup(pipelineDesc.renderStepID());
+    if (!step) {
+        return nullptr;
+    }
+
+    // Steps that don't perform shading (e.g. depth-only draws) have no PaintParamsKey.
+    SkSpan<const uint8_t> paintKeyData;
+    if (pipelineDesc.paintParamsID().isValid()) {
+        const ShaderCodeDictionary::Entry* entry = dict->lookup(pipelineDesc.paintParamsID());
+        if (!entry || !HasOnlyStableSnippets(dict, entry->paintParamsKey())) {
+            return nullptr;
+        }
+        paintKeyData = entry->paintParamsKey().asSpan();
+    }
+
+    const ResourceBindingRequirements& bindingReqs = caps->resourceBindingRequirements();
+    const bool useShadingSsboIndex = caps->storageBufferPreferred() && step->performsShading();
+
+    SkBinaryWriteBuffer writer;
+    writer.writeInt(kCurrentVersion);
+    writer.writeInt(SK_MILESTONE);
+    writer.writeUInt(shaderType);
+    // Shaders compiled for one GPU or driver version may not be valid for another.
+    writer.writeString(caps->deviceIdentity());
+    write_shader_caps(writer, *caps->shaderCaps());
+    // RenderStep IDs are assigned in a fixed order by the RendererProvider, but the name guards
+    // against that order changing between builds of the same milestone.
+    writer.writeString(step->name());
+    writer.writeUInt(pipelineDesc.renderStepID());
+    writer.writeInt(static_cast<int>(bindingReqs.fUniformBufferLayout));
+    writer.writeInt(static_cast<int>(bindingReqs.fStorageBufferLayout));
+    writer.writeBool(bindingReqs.fSeparateTextureAndSamplerBinding);
+    writer.writeBool(bindingReqs.fDistinctIndexRanges);
+    writer.writeBool(useShadingSsboIndex);
+    writer.writeUInt(renderPassDesc.fWriteSwizzle.asKey());
+    writer.writeByteArray(paintKeyData.data(), paintKeyData.size());
+    return writer.snapshotAsData();
+}
+
+sk_sp<SkData> PackCachedShaders(SkFourByteTag shaderType, const CachedShaders& shaders) {
+    SkBinaryWriteBuffer writer;
+    writer.writeInt(kCurrentVersion);
+    writer.writeUInt(shaderType);
+    writer.writeByteArray(shaders.fVertexShader.c_str(), shaders.fVertexShader.size());
+    writer.writeByteArray(shaders.fFragmentShader.c_str(), shaders.fFragmentShader.size());
+    writer.writeInt(static_cast<int>(shaders.fBlendInfo.fEquation));
+    writer.writeInt(static_cast<int>(shaders.fBlendInfo.fSrcBlend));
+    writer.writeInt(static_cast<int>(shaders.fBlendInfo.fDstBlend));
+    writer.writePad32(&shaders.fBlendInfo.fBlendConstant, sizeof(SkPMColor4f));
+    writer.writeBool(shaders.fBlendInfo.fWritesColor);
+    writer.writeInt(shaders.fNumTexturesAndSamplers);
+    return writer.snapshotAsData();
+}
+
+bool UnpackCachedShaders(const SkData& data, SkFourByteTag shaderType, CachedShaders* shaders) {
+    SkReadBuffer reader(data.data(), data.size());
+    int version = reader.readInt();
+    SkFourByteTag typeTag = reader.readUInt();
+    if (!reader.validate(version == kCurrentVersion && typeTag == shaderType)) {
+        return false;
+    }
+
+    CachedShaders result;
+    size_t len = 0;
+    const char* buf = static_cast<const char*>(reader.skipByteArray(&len));
+    if (buf) {
+        result.fVertexShader.assign(buf, len);
+    }
+    buf = static_cast<const char*>(reader.skipByteArray(&len));
+    if (buf) {
+        result.fFragmentShader.assign(buf, len);
+    }
+
+    int equation = reader.readInt();
+    int srcBlend = reader.readInt();
+    int dstBlend = reader.readInt();
+    reader.validate(equation >= 0 && equation < kBlendEquationCnt &&
+                    srcBlend >= 0 && srcBlend <= static_cast<int>(BlendCoeff::kLast) &&
+                    dstBlend >= 0 && dstBlend <= static_cast<int>(BlendCoeff::kLast));
+    result.fBlendInfo.fEquation = static_cast<BlendEquation>(equation);
+    result.fBlendInfo.fSrcBlend = static_cast<BlendCoeff>(srcBlend);
+    result.fBlendInfo.fDstBlend = static_cast<BlendCoeff>(dstBlend);
+    reader.readPad32(&result.fBlendInfo.fBlendConstant, sizeof(SkPMColor4f));
+    result.fBlendInfo.fWritesColor = reader.readBool();
+    result.fNumTexturesAndSamplers = reader.readInt();
+    reader.validate(result.fNumTexturesAndSamplers >= 0 && !result.fVertexShader.empty());
+
+    if (!reader.isValid()) {
+        return false;
+    }
+    *shaders = std::move(result);
+    return true;
+}
+
+bool FindOrCompileShaders(const SharedContext* sharedContext,
+                          SkFourByteTag shaderType,
+                          const GraphicsPipelineDesc& pipelineDesc,
+                          const RenderPassDesc& renderPassDesc,
+                          const std::function<bool(CachedShaders*)>& compile,
+                          CachedShaders* shaders) {
+    ContextOptions::PersistentPipelineStorage* storage =
+            sharedContext->caps()->persistentPipelineStorage();
+
+    sk_sp<SkData> key;
+    if (storage) {
+        key = MakePipelineKey(sharedContext, shaderType, pipelineDesc, renderPassDesc);
+    }
+    return FindOrCompileShaders(storage, key.get(), shaderType, compile, shaders);
+}
+
+bool FindOrCompileShaders(ContextOptions::PersistentPipelineStorage* storage,
+                          const SkData* key,
+                          SkFourByteTag shaderType,
+                          const std::function<bool(CachedShaders*)>& compile,
+                          CachedShaders* shaders) {
+    if (!storage) {
+        key = nullptr;
+    }
+    if (key) {
+        TRACE_EVENT0("skia.shaders", "PipelineCacheUtils::load");
+        sk_sp<SkData> cached = storage->load(*key);
+        if (cached && UnpackCachedShaders(*cached, shaderType, shaders)) {
+            return true;
+        }
+    }
+
+    if (!compile(shaders)) {
+        return false;
+    }
+
+    if (key) {
+        TRACE_EVENT0("skia.shaders", "PipelineCacheUtils::store");
+        storage->store(*key, *PackCachedShaders(shaderType, *shaders));
+    }
+    return true;
+}
+
+} // namespace skgpu::graphite::PipelineCacheUtils
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef skgpu_graphite_PipelineCacheUtils_DEFINED
+#define skgpu_graphite_PipelineCacheUtils_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkTypes.h"
+#include "include/gpu/graphite/ContextOptions.h"
+#include "src/gpu/Blend.h"
+
+#include <functional>
+#include <string>
+
+namespace skgpu::graphite {
+
+class GraphicsPipelineDesc;
+class PaintParamsKey;
+class ShaderCodeDictionary;
+class SharedContext;
+struct RenderPassDesc;
+
+// The ContextOptions::PersistentPipelineStorage holds opaque blobs as far as clients are concerned.
+// These helpers define the keys and the format of the stored data for graphics pipelines, and are
+// shared by the backends that compile their shaders from SkSL.
+namespace PipelineCacheUtils {
+
+// Everything a backend needs to create a graphics pipeline that would otherwise come from
+// generating and compiling the pipeline's SkSL.
+struct CachedShaders {
+    std::string fVertexShader;    // backend shader code, e.g. MSL text or SPIR-V binary
+    std::string fFragmentShader;  // empty if the pipeline has no fragment stage
+    BlendInfo   fBlendInfo;
+    int         fNumTexturesAndSamplers = 0;
+};
+
+int GetCurrentVersion();
+
+// User-defined snippets and runtime effects get their IDs assigned on first use, so the same ID
+// can name a different snippet in another process. Returns false if 'key' uses any of them.
+bool HasOnlyStableSnippets(const ShaderCodeDictionary*, const PaintParamsKey& key);
+
+// Returns the key for persisting the shaders of 'pipelineDesc'. The key only holds values that are
+// stable across sessions: the RenderStep, the code snippets of the PaintParamsKey, the parts of
+// the RenderPassDesc that change the generated code, and the Caps' device identity and
+// ShaderCaps. Returns null if the pipeline can't be persisted, e.g. if it uses runtime effects
+// whose snippet IDs are only valid in this process.
+sk_sp<SkData> MakePipelineKey(const SharedContext*,
+                              SkFourByteTag shaderType,
+                              const GraphicsPipelineDesc&,
+                              const RenderPassDesc&);
+
+sk_sp<SkData> PackCachedShaders(SkFourByteTag shaderType, const CachedShaders&);
+
+bool UnpackCachedShaders(const SkData&, SkFourByteTag shaderType, CachedShaders*);
+
+// Fills out 'shaders' from the Context's persistent pipeline storage if it holds them, otherwise
+// calls 'compile' and stores its successful result. Returns false if 'compile' failed.
+bool FindOrCompileShaders(const SharedContext*,
+                          SkFourByteTag shaderType,
+                          const GraphicsPipelineDesc&,
+                          const RenderPassDesc&,
+                          const std::function<bool(CachedShaders*)>& compile,
+                          CachedShaders* shaders);
+
+// As above, but with the storage and the key from MakePipelineKey() given directly. Either may be
+// null, in which case 'compile' is always called and nothing is stored.
+bool FindOrCompileShaders(ContextOptions::PersistentPipelineStorage*,
+                          const SkData* key,
+                          SkFourByteTag shaderType,
+                          const std::function<bool(CachedShaders*)>& compile,
+                          CachedShaders* shaders);
+
+}  // namespace PipelineCacheUtils
+
+}  // namespace skgpu::graphite
+
+#endif  // skgpu_graphite_PipelineCacheUtils_DEFINED
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/gpu/graphite/PipelineKeyCollector.h"
+
+#include "include/core/SkMilestone.h"
+#include "include/core/SkString.h"
+#include "include/private/base/SkTo.h"
+#include "src/core/SkReadBuffer.h"
+#include "src/core/SkWriteBuffer.h"
+#include "src/gpu/graphite/GraphicsPipelineDesc.h"
+#include "src/gpu/graphite/PipelineCacheUtils.h"
+#include "src/gpu/graphite/Renderer.h"
+#include "src/gpu/graphite/RendererProvider.h"
+#include "src/gpu/graphite/ShaderCodeDictionary.h"
+
+namespace skgpu::graphite {
+
+// Snippet IDs and RenderStep names are only stable within a milestone, which is checked
+// separately. kVersion covers changes to the layout written here.
+static constexpr int kVersion = 2;
+
+PipelineKeyCollector::PipelineKeyCollector() = default;
+PipelineKeyCollector::~PipelineKeyCollector() = default;
+
+void PipelineKeyCollector::add(const ShaderCodeDictionary* dict,
+                               const RendererProvider* rendererProvider,
+                               const GraphicsPipelineDesc& pipelineDesc,
+                               SkColorType colorType,
+                               SkEnumBitMask<DepthStencilFlags> depthStencilFlags,
+                               bool requiresMSAA) {
+    const RenderStep* step = rendererProvider->lookup(pipelineDesc.renderStepID());
+    SkSpan<const uint8_t> paintKeyData;
+    if (pipelineDesc.paintParamsID().isValid()) {
+        const ShaderCodeDictionary::Entry* entry = dict->lookup(pipelineDesc.paintParamsID());
+        if (entry && !PipelineCacheUtils::HasOnlyStableSnippets(dict, entry->paintParamsKey())) {
+            entry = nullptr;
+        }
+        if (!entry) {
+            SkAutoMutexExclusive lock(fMutex);
+            fNumSkipped++;
+            return;
+        }
+        paintKeyData = entry->paintParamsKey().asSpan();
+    }
+    SkASSERT(step);
+
+    SkBinaryWriteBuffer writer;
+    writer.writeString(step->name());
+    writer.writeByteArray(paintKeyData.data(), paintKeyData.size());
+    writer.writeInt(static_cast<int>(colorType));
+    // SkEnumBitMask only converts to bool, so write each attachment separately.
+    writer.writeBool(SkToBool(depthStencilFlags & DepthStencilFlags::kDepth));
+    writer.writeBool(SkToBool(depthStencilFlags & DepthStencilFlags::kStencil));
+    writer.writeBool(requiresMSAA);
+
+    std::string encoded(writer.bytesWritten(), '\0');
+    writer.writeToMemory(encoded.data());
+
+    SkAutoMutexExclusive lock(fMutex);
+    if (fSeen.insert(encoded).second) {
+        fEntries.push_back(std::move(encoded));
+    }
+}
+
+int PipelineKeyCollector::numPipelines() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return static_cast<int>(fEntries.size());
+}
+
+int PipelineKeyCollector::numSkippedPipelines() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fNumSkipped;
+}
+
+sk_sp<SkData> PipelineKeyCollector::serialize() const {
+    SkAutoMutexExclusive lock(fMutex);
+
+    SkBinaryWriteBuffer writer;
+    writer.writeInt(kVersion);
+    writer.writeInt(SK_MILESTONE);
+    writer.writeInt(static_cast<int>(fEntries.size()));
+    for (const std::string& entry : fEntries) {
+        writer.writeByteArray(entry.data(), entry.size());
+    }
+    return writer.snapshotAsData();
+}
+
+static bool read_entry(const void* data, size_t size, PipelineKeyCollector::Entry* entry) {
+    SkReadBuffer reader(data, size);
+
+    SkString stepName;
+    reader.readString(&stepName);
+    entry->fRenderStepName.assign(stepName.c_str(), stepName.size());
+
+    size_t keySize = 0;
+    const uint8_t* key = static_cast<const uint8_t*>(reader.skipByteArray(&keySize));
+    entry->fPaintParamsKey.assign(key, key + (key ? keySize : 0));
+
+    int colorType = reader.readInt();
+    bool hasDepth = reader.readBool();
+    bool hasStencil = reader.readBool();
+    entry->fRequiresMSAA = reader.readBool();
+    if (!reader.validate(colorType > kUnknown_SkColorType &&
+                         colorType <= kLastEnum_SkColorType)) {
+        return false;
+    }
+    entry->fColorType = static_cast<SkColorType>(colorType);
+    entry->fDepthStencilFlags = DepthStencilFlags::kNone;
+    if (hasDepth) {
+        entry->fDepthStencilFlags |= DepthStencilFlags::kDepth;
+    }
+    if (hasStencil) {
+        entry->fDepthStencilFlags |= DepthStencilFlags::kStencil;
+    }
+    return reader.isValid() && !entry->fRenderStepName.empty();
+}
+
+bool PipelineKeyCollector::Deserialize(const SkData& data, std::vector<Entry>* entries) {
+    SkReadBuffer reader(data.data(), data.size());
+    int version = reader.readInt();
+    int milestone = reader.readInt();
+    int count = reader.readInt();
+    if (!reader.validate(version == kVersion && milestone == SK_MILESTONE && count >= 0)) {
+        return false;
+    }
+
+    std::vector<Entry> result;
+    for (int i = 0; i < count; ++i) {
+        size_t size = 0;
+        const void* entryData = reader.skipByteArray(&size);
+        Entry entry;
+        if (!entryData || !read_entry(entryData, size, &entry)) {
+            return false;
+        }
+        result.push_back(std::move(entry));
+    }
+    if (!reader.isValid()) {
+        return false;
+    }
+    *entries = std::move(result);
+    return true;
+}
+
+} // namespace skgpu::graphite
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef skgpu_graphite_PipelineKeyCollector_DEFINED
+#define skgpu_graphite_PipelineKeyCollector_DEFINED
+
+#include "include/core/SkColorType.h"
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/base/SkMutex.h"
+#include "src/core/SkEnumBitMask.h"
+#include "src/gpu/graphite/ResourceTypes.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace skgpu::graphite {
+
+class GraphicsPipelineDesc;
+class RendererProvider;
+class ShaderCodeDictionary;
+
+/**
+ * Gathers the pipelines requested by Recorders it was set on through
+ * RecorderPriv::setPipelineKeyCollector(). Each distinct pipeline is stored once, described only by
+ * values that are stable across processes, so that the serialized list can be handed to
+ * Precompile() at the start of a later session.
+ *
+ * Pipelines that use runtime effects can't be described this way and are only counted.
+ *
+ * A collector can be shared by Recorders on different threads.
+ */
+class PipelineKeyCollector {
+public:
+    PipelineKeyCollector();
+    ~PipelineKeyCollector();
+
+    struct Entry {
+        std::string fRenderStepName;
+        std::vector<uint8_t> fPaintParamsKey;  // empty for steps that don't perform shading
+        SkColorType fColorType = kUnknown_SkColorType;
+        SkEnumBitMask<DepthStencilFlags> fDepthStencilFlags = DepthStencilFlags::kNone;
+        bool fRequiresMSAA = false;
+    };
+
+    void add(const ShaderCodeDictionary*,
+             const RendererProvider*,
+             const GraphicsPipelineDesc&,
+             SkColorType,
+             SkEnumBitMask<DepthStencilFlags>,
+             bool requiresMSAA);
+
+    int numPipelines() const;
+    int numSkippedPipelines() const;
+
+    sk_sp<SkData> serialize() const;
+
+    // Returns false if 'data' wasn't produced by serialize() of a compatible Skia build.
+    static bool Deserialize(const SkData& data, std::vector<Entry>* entries);
+
+private:
+    mutable SkMutex fMutex;
+    // Each distinct pipeline's encoded Entry, in the order they were first seen
+    std::vector<std::string> fEntries SK_GUARDED_BY(fMutex);
+    std::unordered_set<std::string> fSeen SK_GUARDED_BY(fMutex);
+    int fNumSkipped SK_GUARDED_BY(fMutex) = 0;
+};
+
+} // namespace skgpu::graphite
+
+#endif // skgpu_graphite_PipelineKeyCollector_DEFINED
@@ -9,6 +9,7 @@
 
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkData.h"
 #include "src/gpu/graphite/AttachmentTypes.h"
 #include "src/gpu/graphite/Caps.h"
 #include "src/gpu/graphite/ContextPriv.h"
@@ -17,12 +18,18 @@
 #include "src/gpu/graphite/KeyContext.h"
 #include "src/gpu/graphite/Log.h"
 #include "src/gpu/graphite/PaintOptionsPriv.h"
+#include "src/gpu/graphite/PaintParamsKey.h"
+#include "src/gpu/graphite/PipelineKeyCollector.h"
 #include "src/gpu/graphite/Renderer.h"
 #include "src/gpu/graphite/RendererProvider.h"
 #include "src/gpu/graphite/ResourceProvider.h"
 #include "src/gpu/graphite/RuntimeEffectDictionary.h"
+#include "src/gpu/graphite/ShaderCodeDictionary.h"
 #include "src/gpu/graphite/UniquePaintParamsID.h"
 
+#include <string>
+#include <unordered_map>
+
 namespace {
 
 using namespace skgpu::graphite;
@@ -66,6 +73,70 @@ void compile(const RendererProvider* rendererProvider,
     }
 }
 
+// Checks that the block at 'offset' and all of its children are well formed and only use
+// built-in snippets, advancing 'offset' past the block.
+bool validate_block(const ShaderCodeDictionary* dict, SkSpan<const uint8_t> data, size_t* offset) {
+    if (*offset + sizeof(PaintParamsKey::Header) > data.size()) {
+        return false;
+    }
+    PaintParamsKey::Header header;
+    memcpy(&header, &data[*offset], sizeof(PaintParamsKey::Header));
+
+    const size_t end = *offset + header.blockSize;
+    if (header.codeSnippetID < 0 || header.codeSnippetID >= kBuiltInCodeSnippetIDCount ||
+        header.blockSize < sizeof(PaintParamsKey::Header) || end > data.size()) {
+        return false;
+    }
+    const ShaderSnippet* snippet = dict->getEntry(header.codeSnippetID);
+    if (!snippet) {
+        return false;
+    }
+
+    *offset += sizeof(PaintParamsKey::Header);
+    for (int i = 0; i < snippet->fNumChildren; ++i) {
+        if (*offset >= end || !validate_block(dict, data.first(end), offset)) {
+            return false;
+        }
+    }
+    return *offset == end;
+}
+
+// Re-adds a validated block and its children to 'builder'.
+void add_block(const ShaderCodeDictionary* dict,
+               SkSpan<const uint8_t> data,
+               size_t* offset,
+               PaintParamsKeyBuilder* builder) {
+    PaintParamsKey::Header header;
+    memcpy(&header, &data[*offset], sizeof(PaintParamsKey::Header));
+    *offset += sizeof(PaintParamsKey::Header);
+
+    builder->beginBlock(header.codeSnippetID);
+    for (int i = 0; i < dict->getEntry(header.codeSnippetID)->fNumChildren; ++i) {
+        add_block(dict, data, offset, builder);
+    }
+    builder->endBlock();
+}
+
+// The serialized key bytes come from outside of this process so they are rebuilt through a
+// PaintParamsKeyBuilder, after validation, rather than being trusted as is.
+UniquePaintParamsID find_or_create_paint_id(ShaderCodeDictionary* dict,
+                                            SkSpan<const uint8_t> keyData,
+                                            PaintParamsKeyBuilder* builder) {
+    if (keyData.empty()) {
+        return UniquePaintParamsID::InvalidID();
+    }
+    for (size_t offset = 0; offset < keyData.size();) {
+        if (!validate_block(dict, keyData, &offset)) {
+            return UniquePaintParamsID::InvalidID();
+        }
+    }
+    for (size_t offset = 0; offset < keyData.size();) {
+        add_block(dict, keyData, &offset, builder);
+    }
+    const ShaderCodeDictionary::Entry* entry = dict->findOrCreate(builder);
+    return entry ? entry->uniqueID() : UniquePaintParamsID::InvalidID();
+}
+
 } // anonymous namespace
 
 namespace skgpu::graphite {
@@ -151,4 +222,77 @@ void Precompile(Context* context, const PaintOptions& options, DrawTypeFlags dra
     }
 }
 
+bool Precompile(Context* context, const SkData& pipelineKeys) {
+    std::vector<PipelineKeyCollector::Entry> entries;
+    if (!PipelineKeyCollector::Deserialize(pipelineKeys, &entries)) {
+        SKGPU_LOG_W("Pipeline key list is malformed or from an incompatible build.");
+        return false;
+    }
+
+    ShaderCodeDictionary* dict = context->priv().shaderCodeDictionary();
+    const Caps* caps = context->priv().caps();
+    ResourceProvider* resourceProvider = context->priv().resourceProvider();
+
+    // RenderStep IDs depend on the order in which the RendererProvider creates them, so the list
+    // refers to the steps by name.
+    std::unordered_map<std::string, const RenderStep*> steps;
+    for (const Renderer* r : context->priv().rendererProvider()->renderers()) {
+        for (const RenderStep* s : r->steps()) {
+            steps.emplace(s->name(), s);
+        }
+    }
+
+    // The collected keys never reference runtime effects
+    auto rtEffectDict = std::make_unique<RuntimeEffectDictionary>();
+    PaintParamsKeyBuilder builder(dict);
+
+    for (const PipelineKeyCollector::Entry& entry : entries) {
+        auto step = steps.find(entry.fRenderStepName);
+        if (step == steps.end()) {
+            SKGPU_LOG_W("Unknown RenderStep %s in pipeline key list.",
+                        entry.fRenderStepName.c_str());
+            continue;
+        }
+
+        UniquePaintParamsID paintID = UniquePaintParamsID::InvalidID();
+        if (step->second->performsShading()) {
+            paintID = find_or_create_paint_id(dict,
+                                              SkSpan(entry.fPaintParamsKey),
+                                              &builder);
+            if (!paintID.isValid()) {
+                SKGPU_LOG_W("Invalid PaintParamsKey in pipeline key list.");
+                continue;
+            }
+        }
+
+        TextureInfo info = caps->getDefaultSampledTextureInfo(entry.fColorType,
+                                                              Mipmapped::kNo,
+                                                              Protected::kNo,
+                                                              Renderable::kYes);
+        if (!info.isValid()) {
+            continue;
+        }
+
+        // As above, the LoadOp, StoreOp and clearColor don't influence the pipeline.
+        RenderPassDesc renderPassDesc = RenderPassDesc::Make(
+                caps,
+                info,
+                LoadOp::kClear,
+                StoreOp::kStore,
+                entry.fDepthStencilFlags,
+                /* clearColor= */ { .0f, .0f, .0f, .0f },
+                entry.fRequiresMSAA,
+                caps->getWriteSwizzle(entry.fColorType, info));
+
+        auto pipeline = resourceProvider->findOrCreateGraphicsPipeline(
+                rtEffectDict.get(),
+                GraphicsPipelineDesc(step->second, paintID),
+                renderPassDesc);
+        if (!pipeline) {
+            SKGPU_LOG_W("Failed to create GraphicsPipeline in precompile!");
+        }
+    }
+    return true;
+}
+
 } // namespace skgpu::graphite
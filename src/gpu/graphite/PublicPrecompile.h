@@ -10,6 +10,8 @@
 
 #include "include/gpu/graphite/GraphiteTypes.h"
 
+class SkData;
+
 // TODO: this header should be moved to include/gpu/graphite once the precompilation API
 // is made public
 namespace skgpu::graphite {
@@ -29,6 +31,17 @@ class PaintOptions;
  */
 void Precompile(Context*, const PaintOptions&, DrawTypeFlags = kMostCommon);
 
+/**
+ * Precompiles the pipelines in a list produced by PipelineKeyCollector::serialize(), e.g. by
+ * replaying representative content through a Recorder in key collection mode. Unlike the
+ * PaintOptions variant, only the pipelines that were actually used are compiled.
+ *
+ *   @param context        the Context to which the actual draws will be submitted
+ *   @param pipelineKeys   the serialized list of pipelines
+ *   @return false if the list is malformed or was collected with an incompatible Skia build
+ */
+bool Precompile(Context*, const SkData& pipelineKeys);
+
 } // namespace skgpu::graphite
 
 #endif // skgpu_graphite_PublicPrecompile_DEFINED
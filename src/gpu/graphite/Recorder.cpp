@@ -156,7 +156,10 @@ std::unique_ptr<Recording> Recorder::snap() {
     // TODO: fulfill all promise images in the TextureDataCache here
     // TODO: create all the samplers needed in the TextureDataCache here
 
-    if (!fGraph->prepareResources(fResourceProvider.get(), fRuntimeEffectDict.get())) {
+    // In key collection mode the pipelines were reported when the DrawPasses were snapped, so the
+    // work is dropped here before any pipelines are compiled or resources are instantiated.
+    if (fPipelineKeyCollector ||
+        !fGraph->prepareResources(fResourceProvider.get(), fRuntimeEffectDict.get())) {
         // Leaving 'fTrackedDevices' alone since they were flushed earlier and could still be
         // attached to extant SkSurfaces.
         fDrawBufferManager.reset(new DrawBufferManager(fResourceProvider.get(),
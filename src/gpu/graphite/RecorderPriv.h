@@ -47,6 +47,14 @@ public:
         return fRecorder->fSharedContext->rendererProvider();
     }
 
+    // When set, the Recorder runs in key collection mode: every pipeline its draws would need is
+    // reported to the collector instead of being compiled, and snap() never returns a Recording.
+    // Must be set before anything is recorded, and the collector must outlive the Recorder.
+    void setPipelineKeyCollector(PipelineKeyCollector* collector) {
+        fRecorder->fPipelineKeyCollector = collector;
+    }
+    PipelineKeyCollector* pipelineKeyCollector() { return fRecorder->fPipelineKeyCollector; }
+
     UniformDataCache* uniformDataCache() { return fRecorder->fUniformDataCache.get(); }
     TextureDataCache* textureDataCache() { return fRecorder->fTextureDataCache.get(); }
     DrawBufferManager* drawBufferManager() { return fRecorder->fDrawBufferManager.get(); }
@@ -63,6 +71,8 @@ public:
                                                  const SkBitmap&,
                                                  Mipmapped = skgpu::Mipmapped::kNo);
 
+    Recorder::DrawPassStats* drawPassStats() { return &fRecorder->fDrawPassStats; }
+
 #if GRAPHITE_TEST_UTILS
     // used by the Context that created this Recorder to set a back pointer
     void setContext(Context*);
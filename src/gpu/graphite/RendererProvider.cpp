@@ -10,10 +10,12 @@
 #include "include/core/SkPathTypes.h"
 #include "include/core/SkVertices.h"
 #include "src/gpu/graphite/Caps.h"
+#include "src/gpu/graphite/compute/ComputePathCoverage.h"
 #include "src/gpu/graphite/render/AnalyticRRectRenderStep.h"
 #include "src/gpu/graphite/render/BitmapTextRenderStep.h"
 #include "src/gpu/graphite/render/CommonDepthStencilSettings.h"
 #include "src/gpu/graphite/render/CoverBoundsRenderStep.h"
+#include "src/gpu/graphite/render/CoverageMaskRenderStep.h"
 #include "src/gpu/graphite/render/MiddleOutFanRenderStep.h"
 #include "src/gpu/graphite/render/SDFTextRenderStep.h"
 #include "src/gpu/graphite/render/TessellateCurvesRenderStep.h"
@@ -68,6 +70,11 @@ RendererProvider::RendererProvider(const Caps* caps, StaticBufferManager* buffer
             }
         }
     }
+    if (caps->computeSupport()) {
+        fCoverageMask = makeFromStep(std::make_unique<CoverageMaskRenderStep>(),
+                                     DrawTypeFlags::kShape);
+        fComputePathCoverage = std::make_unique<ComputePathCoverage>();
+    }
 
     // The tessellating path renderers that use stencil can share the cover steps.
     auto coverFill = std::make_unique<CoverBoundsRenderStep>(false);
@@ -125,6 +132,8 @@ RendererProvider::RendererProvider(const Caps* caps, StaticBufferManager* buffer
     }
 }
 
+RendererProvider::~RendererProvider() = default;
+
 const RenderStep* RendererProvider::lookup(uint32_t uniqueID) const {
     for (auto&& rs : fRenderSteps) {
         if (rs->uniqueID() == uniqueID) {
@@ -12,11 +12,13 @@
 #include "include/core/SkVertices.h"
 #include "src/gpu/graphite/Renderer.h"
 
+#include <memory>
 #include <vector>
 
 namespace skgpu::graphite {
 
 class Caps;
+class ComputePathCoverage;
 class StaticBufferManager;
 
 /**
@@ -29,6 +31,8 @@ class StaticBufferManager;
  */
 class RendererProvider {
 public:
+    ~RendererProvider();
+
     // TODO: Add configuration options to disable "optimization" renderers in favor of the more
     // general case, or renderers that won't be used by the application. When that's added, these
     // functions could return null.
@@ -43,6 +47,13 @@ public:
     const Renderer* convexTessellatedWedges() const { return &fConvexTessellatedWedges; }
     const Renderer* tessellatedStrokes() const { return &fTessellatedStrokes; }
 
+    // Fills whose coverage is computed into a CoverageMask by 'computePathCoverage()' ahead of the
+    // render pass. Both return null if the Caps do not support compute.
+    const Renderer* coverageMask() const {
+        return fCoverageMask.numRenderSteps() > 0 ? &fCoverageMask : nullptr;
+    }
+    const ComputePathCoverage* computePathCoverage() const { return fComputePathCoverage.get(); }
+
     // Atlas'ed text rendering
     const Renderer* bitmapText() const { return &fBitmapText; }
     const Renderer* sdfText(bool useLCDText) const { return &fSDFText[useLCDText]; }
@@ -98,8 +109,13 @@ private:
 
     Renderer fVertices[kVerticesCount];
 
+    Renderer fCoverageMask;
+
     // Aggregate of all enabled Renderers for convenient iteration when pre-compiling
     std::vector<const Renderer*> fRenderers;
+
+    // Holds the ComputeSteps whose output is drawn by fCoverageMask.
+    std::unique_ptr<ComputePathCoverage> fComputePathCoverage;
 };
 
 }  // namespace skgpu::graphite
@@ -0,0 +1,863 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/gpu/graphite/compute/ComputePathCoverage.h"
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkStrokeRec.h"
+#include "include/gpu/graphite/Recorder.h"
+#include "include/private/SkSLString.h"
+#include "src/core/SkGeometry.h"
+#include "src/gpu/graphite/BufferManager.h"
+#include "src/gpu/graphite/Caps.h"
+#include "src/gpu/graphite/DrawParams.h"
+#include "src/gpu/graphite/RecorderPriv.h"
+#include "src/gpu/graphite/TextureProxy.h"
+#include "src/gpu/tessellate/Tessellation.h"
+#include "src/gpu/tessellate/WangsFormula.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+
+namespace skgpu::graphite {
+namespace {
+
+using Config = ComputePathCoverage::Config;
+using Line = ComputePathCoverage::Line;
+using ResourceDesc = ComputeStep::ResourceDesc;
+
+constexpr int kTileSize = ComputePathCoverage::kTileSize;
+
+// Local dispatch sizes of the steps.
+constexpr uint32_t kLinesPerWorkgroup = 64;
+constexpr uint32_t kRowsPerWorkgroup = 64;
+constexpr uint32_t kPixelsPerWorkgroupSide = 16;
+
+// Lines whose horizontal extent within a pixel row is smaller than this are treated as vertical
+// when computing their area contribution, to avoid dividing by a tiny number.
+constexpr float kNearVertical = 1.f / 1024;
+
+// Lines are clipped to these horizontal bounds (relative to the coverage area) before being handed
+// to the steps. Anything to the left of the area only contributes its winding, which is preserved
+// by a vertical line at kLeftEdge; anything to the right contributes nothing.
+constexpr float kLeftEdge = -1.f;
+constexpr float kRightEdgeOutset = 1.f;
+
+uint32_t div_round_up(uint32_t n, uint32_t d) { return (n + d - 1) / d; }
+
+// The following functions match the SkSL functions of the same name in kCommonSkSL.
+
+// Returns the part of 'l' between y = top and y = bottom, keeping its direction. If there is no
+// such part the returned line is horizontal.
+Line clip_to_band(const Line& l, float top, float bottom) {
+    float t0 = std::max(std::min(l.fY0, l.fY1), top);
+    float t1 = std::min(std::max(l.fY0, l.fY1), bottom);
+    if (t0 >= t1) {
+        return {0, 0, 0, 0};
+    }
+    float dy = l.fY1 - l.fY0;
+    float xa = l.fX0 + (l.fX1 - l.fX0) * ((t0 - l.fY0) / dy);
+    float xb = l.fX0 + (l.fX1 - l.fX0) * ((t1 - l.fY0) / dy);
+    return dy > 0 ? Line{xa, t0, xb, t1} : Line{xb, t1, xa, t0};
+}
+
+// The integral of the covered fraction of a unit pixel to the right of an edge at 'u'.
+float area_integral(float u) {
+    return u <= 0 ? u : (u >= 1 ? 0.5f : u - 0.5f * u * u);
+}
+
+// The signed area that 'l' contributes to the pixel at (px, py), in units of winding.
+float pixel_contribution(const Line& l, float px, float py) {
+    Line s = clip_to_band(l, py, py + 1);
+    float dy = s.fY1 - s.fY0;
+    if (dy == 0) {
+        return 0;
+    }
+    float u0 = s.fX0 - px;
+    float u1 = s.fX1 - px;
+    if (std::abs(u1 - u0) < kNearVertical) {
+        return dy * std::clamp(1 - 0.5f * (u0 + u1), 0.f, 1.f);
+    }
+    return dy * (area_integral(u1) - area_integral(u0)) / (u1 - u0);
+}
+
+uint32_t coverage_byte(float winding, uint32_t flags) {
+    float a = std::abs(winding);
+    if (flags & ComputePathCoverage::kEvenOddFlag) {
+        a = 1 - std::abs(1 - std::fmod(a, 2.f));
+    }
+    a = std::min(a, 1.f);
+    if (flags & ComputePathCoverage::kInverseFlag) {
+        a = 1 - a;
+    }
+    return static_cast<uint32_t>(a * 255 + 0.5f);
+}
+
+int32_t backdrop_delta(float dy) {
+    return static_cast<int32_t>(std::floor(dy * ComputePathCoverage::kBackdropScale + 0.5f));
+}
+
+// Visits the tiles touched by 'l', calling tileFn(ty, tx) for each, and backdropFn(ty, tx, r,
+// delta) for each pixel row whose winding the line changes for all tiles from tx onwards. This
+// is the loop structure shared by the Count and Fill steps.
+template <typename TileFn, typename BackdropFn>
+void walk_line(const Line& l, const Config& config, TileFn&& tileFn, BackdropFn&& backdropFn) {
+    const int wTiles = config.fWidthInTiles;
+    const int hTiles = config.fHeightInTiles;
+    int row0 = std::max((int)std::floor(std::min(l.fY0, l.fY1) / kTileSize), 0);
+    int row1 = std::min((int)std::ceil(std::max(l.fY0, l.fY1) / kTileSize) - 1, hTiles - 1);
+    for (int ty = row0; ty <= row1; ++ty) {
+        Line s = clip_to_band(l, (float)(ty * kTileSize), (float)((ty + 1) * kTileSize));
+        if (s.fY0 == s.fY1) {
+            continue;
+        }
+        int tx0 = std::max((int)std::floor(std::min(s.fX0, s.fX1) / kTileSize), 0);
+        int tx1 = std::min((int)std::floor(std::max(s.fX0, s.fX1) / kTileSize), wTiles - 1);
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            tileFn(ty, tx);
+        }
+        int backdropTile = std::max(tx1 + 1, 0);
+        if (backdropTile < wTiles) {
+            for (int r = 0; r < kTileSize; ++r) {
+                float top = (float)(ty * kTileSize + r);
+                Line p = clip_to_band(s, top, top + 1);
+                float dy = p.fY1 - p.fY0;
+                if (dy != 0) {
+                    backdropFn(ty, backdropTile, r, backdrop_delta(dy));
+                }
+            }
+        }
+    }
+}
+
+// An upper bound on the number of tiles that 'l' touches, without binning it.
+uint64_t segment_bound(const Line& l, const Config& config) {
+    int row0 = (int)std::floor(std::min(l.fY0, l.fY1) / kTileSize);
+    int row1 = (int)std::floor(std::max(l.fY0, l.fY1) / kTileSize);
+    uint64_t rows = row1 - row0 + 1;
+    // Each row touches at most (its horizontal extent / kTileSize) + 2 tiles.
+    uint64_t bound = (uint64_t)std::ceil(std::abs(l.fX1 - l.fX0) / kTileSize) + 2 * rows;
+    return std::min(bound, rows * config.fWidthInTiles);
+}
+
+// Clips 'l' to the coverage area as described for kLeftEdge, passing the resulting non-horizontal
+// lines to 'emit'.
+template <typename EmitFn>
+void clip_line(SkPoint p0, SkPoint p1, int width, int height, EmitFn&& emit) {
+    if (!SkScalarsAreFinite(p0.fX, p0.fY) || !SkScalarsAreFinite(p1.fX, p1.fY)) {
+        return;
+    }
+    Line l = clip_to_band({p0.fX, p0.fY, p1.fX, p1.fY}, 0, (float)height);
+    if (l.fY0 == l.fY1) {
+        return;
+    }
+    const float left = kLeftEdge;
+    const float right = width + kRightEdgeOutset;
+
+    // Split the line where it crosses the left and right edges.
+    float ts[4] = {0, 1, 1, 1};
+    int count = 1;
+    float dx = l.fX1 - l.fX0;
+    if (dx != 0) {
+        for (float edge : {left, right}) {
+            float t = (edge - l.fX0) / dx;
+            if (t > 0 && t < 1) {
+                ts[count++] = t;
+            }
+        }
+    }
+    ts[count++] = 1;
+    std::sort(ts, ts + count);
+
+    for (int i = 0; i + 1 < count; ++i) {
+        float ta = ts[i], tb = ts[i + 1];
+        Line piece = {l.fX0 + dx * ta, l.fY0 + (l.fY1 - l.fY0) * ta,
+                      l.fX0 + dx * tb, l.fY0 + (l.fY1 - l.fY0) * tb};
+        if (i + 2 == count) {
+            // Use the exact endpoint for the last piece so that contours stay closed.
+            piece.fX1 = l.fX1;
+            piece.fY1 = l.fY1;
+        }
+        if (piece.fY0 == piece.fY1) {
+            continue;
+        }
+        float midX = 0.5f * (piece.fX0 + piece.fX1);
+        if (midX > right) {
+            continue;
+        }
+        if (midX < left) {
+            piece.fX0 = piece.fX1 = left;
+        } else {
+            piece.fX0 = std::clamp(piece.fX0, left, right);
+            piece.fX1 = std::clamp(piece.fX1, left, right);
+        }
+        emit(piece);
+    }
+}
+
+// Flattens 'path' into the lines the steps operate on, passing each to 'emit'.
+template <typename EmitFn>
+Config flatten_path(const SkPath& path, int width, int height, EmitFn&& emit) {
+    Config config;
+    config.fWidthInTiles = div_round_up(width, kTileSize);
+    config.fHeightInTiles = div_round_up(height, kTileSize);
+    config.fLineCount = 0;
+    config.fFillFlags = 0;
+    if (path.isInverseFillType()) {
+        config.fFillFlags |= ComputePathCoverage::kInverseFlag;
+    }
+    if (path.getFillType() == SkPathFillType::kEvenOdd ||
+        path.getFillType() == SkPathFillType::kInverseEvenOdd) {
+        config.fFillFlags |= ComputePathCoverage::kEvenOddFlag;
+    }
+    config.fWidth = width;
+    config.fHeight = height;
+
+    uint64_t segmentBound = 0;
+    auto addLine = [&](SkPoint p0, SkPoint p1) {
+        clip_line(p0, p1, width, height, [&](const Line& l) {
+            segmentBound += segment_bound(l, config);
+            ++config.fLineCount;
+            emit(l);
+        });
+    };
+    auto addCurve = [&](float n, SkPoint start, SkPoint end, auto&& eval) {
+        int segments = std::clamp((int)std::ceil(n), 1, (int)tess::kMaxSegmentsPerCurve);
+        SkPoint prev = start;
+        for (int i = 1; i < segments; ++i) {
+            SkPoint p = eval((float)i / segments);
+            addLine(prev, p);
+            prev = p;
+        }
+        addLine(prev, end);
+    };
+
+    SkPath::Iter iter(path, /*forceClose=*/true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kLine_Verb:
+                addLine(pts[0], pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                addCurve(wangs_formula::quadratic(tess::kPrecision, pts), pts[0], pts[2],
+                         [&](float t) { return SkEvalQuadAt(pts, t); });
+                break;
+            case SkPath::kConic_Verb: {
+                SkConic conic(pts, iter.conicWeight());
+                addCurve(wangs_formula::conic(tess::kPrecision, pts, iter.conicWeight()),
+                         pts[0],
+                         pts[2],
+                         [&](float t) { return conic.evalAt(t); });
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                addCurve(wangs_formula::cubic(tess::kPrecision, pts), pts[0], pts[3],
+                         [&](float t) {
+                             SkPoint p;
+                             SkEvalCubicAt(pts, t, &p, nullptr, nullptr);
+                             return p;
+                         });
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Keep the segments buffer non-empty, and its byte size representable.
+    config.fSegmentCapacity = (uint32_t)std::clamp<uint64_t>(segmentBound, 1, UINT32_MAX / 4);
+    return config;
+}
+
+// Resource declarations for each slot, in the layout described by ComputePathCoverage::Slot.
+constexpr const char* kSlotDeclarations[ComputePathCoverage::kSlotCount] = {
+    // kLinesSlot
+    "layout(set=0, binding=%d) readonly buffer LinesBuffer {\n"
+    "    uint4 gridInfo;  // width in tiles, height in tiles, line count, fill flags\n"
+    "    uint4 sizeInfo;  // width, height, segment capacity, unused\n"
+    "    float4 lines[];\n"
+    "};\n",
+    // kTileCountsSlot
+    "layout(set=0, binding=%d) buffer TileCountsBuffer { atomicUint tileCounts[]; };\n",
+    // kBackdropSlot
+    "layout(set=0, binding=%d) buffer BackdropBuffer { atomicUint backdrop[]; };\n",
+    // kTileOffsetsSlot
+    "layout(set=0, binding=%d) buffer TileOffsetsBuffer { uint tileOffsets[]; };\n",
+    // kRowBasesSlot
+    "layout(set=0, binding=%d) buffer RowBasesBuffer { uint rowBases[]; };\n",
+    // kCursorsSlot
+    "layout(set=0, binding=%d) buffer CursorsBuffer { atomicUint cursors[]; };\n",
+    // kSegmentsSlot
+    "layout(set=0, binding=%d) buffer SegmentsBuffer { uint segments[]; };\n",
+    // kCoverageSlot
+    "layout(binding=%d) writeonly texture2D coverage;\n",
+};
+
+// Helpers shared by all the steps. These match the C++ functions of the same name above.
+constexpr const char* kCommonSkSL = R"(
+    float4 clip_to_band(float4 l, float top, float bottom) {
+        float t0 = max(min(l.y, l.w), top);
+        float t1 = min(max(l.y, l.w), bottom);
+        if (t0 >= t1) {
+            return float4(0);
+        }
+        float dy = l.w - l.y;
+        float xa = l.x + (l.z - l.x) * ((t0 - l.y) / dy);
+        float xb = l.x + (l.z - l.x) * ((t1 - l.y) / dy);
+        return dy > 0 ? float4(xa, t0, xb, t1) : float4(xb, t1, xa, t0);
+    }
+
+    float area_integral(float u) {
+        return u <= 0 ? u : (u >= 1 ? 0.5 : u - 0.5 * u * u);
+    }
+
+    float pixel_contribution(float4 l, float px, float py) {
+        float4 s = clip_to_band(l, py, py + 1);
+        float dy = s.w - s.y;
+        if (dy == 0) {
+            return 0;
+        }
+        float u0 = s.x - px;
+        float u1 = s.z - px;
+        if (abs(u1 - u0) < NEAR_VERTICAL) {
+            return dy * saturate(1 - 0.5 * (u0 + u1));
+        }
+        return dy * (area_integral(u1) - area_integral(u0)) / (u1 - u0);
+    }
+
+    uint coverage_byte(float winding, uint flags) {
+        float a = abs(winding);
+        if ((flags & EVEN_ODD_FLAG) != 0) {
+            a = 1 - abs(1 - mod(a, 2));
+        }
+        a = min(a, 1);
+        if ((flags & INVERSE_FLAG) != 0) {
+            a = 1 - a;
+        }
+        return uint(a * 255 + 0.5);
+    }
+
+    int backdrop_delta(float dy) {
+        return int(floor(dy * BACKDROP_SCALE + 0.5));
+    }
+)";
+
+constexpr const char* kCountMainSkSL = R"(
+    void main() {
+        uint lineIdx = sk_GlobalInvocationID.x;
+        if (lineIdx >= gridInfo.z) {
+            return;
+        }
+        int wTiles = int(gridInfo.x);
+        int hTiles = int(gridInfo.y);
+        float4 l = lines[lineIdx];
+        int row0 = max(int(floor(min(l.y, l.w) / TILE_SIZE)), 0);
+        int row1 = min(int(ceil(max(l.y, l.w) / TILE_SIZE)) - 1, hTiles - 1);
+        for (int ty = row0; ty <= row1; ++ty) {
+            float4 s = clip_to_band(l, float(ty * TILE_SIZE), float((ty + 1) * TILE_SIZE));
+            if (s.y == s.w) {
+                continue;
+            }
+            int tx0 = max(int(floor(min(s.x, s.z) / TILE_SIZE)), 0);
+            int tx1 = min(int(floor(max(s.x, s.z) / TILE_SIZE)), wTiles - 1);
+            for (int tx = tx0; tx <= tx1; ++tx) {
+                atomicAdd(tileCounts[ty * wTiles + tx], 1);
+            }
+            int backdropTile = max(tx1 + 1, 0);
+            if (backdropTile < wTiles) {
+                for (int r = 0; r < TILE_SIZE; ++r) {
+                    float top = float(ty * TILE_SIZE + r);
+                    float4 p = clip_to_band(s, top, top + 1);
+                    float dy = p.w - p.y;
+                    if (dy != 0) {
+                        // Negative deltas wrap around; the sums are reinterpreted as signed.
+                        atomicAdd(backdrop[(ty * wTiles + backdropTile) * TILE_SIZE + r],
+                                  uint(backdrop_delta(dy)));
+                    }
+                }
+            }
+        }
+    }
+)";
+
+constexpr const char* kRowScanMainSkSL = R"(
+    void main() {
+        int ty = int(sk_GlobalInvocationID.x);
+        if (ty >= int(gridInfo.y)) {
+            return;
+        }
+        int wTiles = int(gridInfo.x);
+        uint runningCount = 0;
+        int4 winding = int4(0);
+        for (int tx = 0; tx < wTiles; ++tx) {
+            int tile = ty * wTiles + tx;
+            tileOffsets[tile] = runningCount;
+            runningCount += atomicLoad(tileCounts[tile]);
+            for (int r = 0; r < TILE_SIZE; ++r) {
+                winding[r] += int(atomicLoad(backdrop[tile * TILE_SIZE + r]));
+                atomicStore(backdrop[tile * TILE_SIZE + r], uint(winding[r]));
+            }
+        }
+        // The row's total is turned into its base offset by the RowBase step.
+        rowBases[ty] = runningCount;
+    }
+)";
+
+constexpr const char* kRowBaseMainSkSL = R"(
+    void main() {
+        if (sk_GlobalInvocationID.x != 0) {
+            return;
+        }
+        int hTiles = int(gridInfo.y);
+        uint total = 0;
+        for (int ty = 0; ty < hTiles; ++ty) {
+            uint rowCount = rowBases[ty];
+            rowBases[ty] = total;
+            total += rowCount;
+        }
+        rowBases[hTiles] = total;
+    }
+)";
+
+constexpr const char* kFillMainSkSL = R"(
+    void main() {
+        uint lineIdx = sk_GlobalInvocationID.x;
+        if (lineIdx >= gridInfo.z) {
+            return;
+        }
+        int wTiles = int(gridInfo.x);
+        int hTiles = int(gridInfo.y);
+        float4 l = lines[lineIdx];
+        int row0 = max(int(floor(min(l.y, l.w) / TILE_SIZE)), 0);
+        int row1 = min(int(ceil(max(l.y, l.w) / TILE_SIZE)) - 1, hTiles - 1);
+        for (int ty = row0; ty <= row1; ++ty) {
+            float4 s = clip_to_band(l, float(ty * TILE_SIZE), float((ty + 1) * TILE_SIZE));
+            if (s.y == s.w) {
+                continue;
+            }
+            int tx0 = max(int(floor(min(s.x, s.z) / TILE_SIZE)), 0);
+            int tx1 = min(int(floor(max(s.x, s.z) / TILE_SIZE)), wTiles - 1);
+            for (int tx = tx0; tx <= tx1; ++tx) {
+                int tile = ty * wTiles + tx;
+                uint slot = rowBases[ty] + tileOffsets[tile] + atomicAdd(cursors[tile], 1);
+                if (slot < sizeInfo.z) {
+                    segments[slot] = lineIdx;
+                }
+            }
+        }
+    }
+)";
+
+constexpr const char* kRasterizeMainSkSL = R"(
+    void main() {
+        int px = int(sk_GlobalInvocationID.x);
+        int py = int(sk_GlobalInvocationID.y);
+        if (px >= int(sizeInfo.x) || py >= int(sizeInfo.y)) {
+            return;
+        }
+        int ty = py / TILE_SIZE;
+        int tile = ty * int(gridInfo.x) + px / TILE_SIZE;
+        float winding = float(int(atomicLoad(backdrop[tile * TILE_SIZE + py % TILE_SIZE]))) /
+                        BACKDROP_SCALE;
+        uint start = rowBases[ty] + tileOffsets[tile];
+        uint end = min(start + atomicLoad(tileCounts[tile]), sizeInfo.z);
+        for (uint i = start; i < end; ++i) {
+            winding += pixel_contribution(lines[segments[i]], float(px), float(py));
+        }
+        write(coverage, uint2(px, py), half4(half(coverage_byte(winding, gridInfo.w)) / 255));
+    }
+)";
+
+constexpr ResourceDesc shared_slot(ComputePathCoverage::Slot slot,
+                                   ComputeStep::ResourceType type) {
+    return {type, ComputeStep::DataFlow::kShared, ComputeStep::ResourcePolicy::kNone, slot};
+}
+
+// The resources of every step are shared slots that appendSteps() assigns before appending the
+// first step, so the Builder never asks the steps to size or initialize them.
+constexpr ResourceDesc kLines = shared_slot(ComputePathCoverage::kLinesSlot,
+                                            ComputeStep::ResourceType::kStorageBuffer);
+constexpr ResourceDesc kTileCounts = shared_slot(ComputePathCoverage::kTileCountsSlot,
+                                                 ComputeStep::ResourceType::kStorageBuffer);
+constexpr ResourceDesc kBackdrop = shared_slot(ComputePathCoverage::kBackdropSlot,
+                                               ComputeStep::ResourceType::kStorageBuffer);
+constexpr ResourceDesc kTileOffsets = shared_slot(ComputePathCoverage::kTileOffsetsSlot,
+                                                  ComputeStep::ResourceType::kStorageBuffer);
+constexpr ResourceDesc kRowBases = shared_slot(ComputePathCoverage::kRowBasesSlot,
+                                               ComputeStep::ResourceType::kStorageBuffer);
+constexpr ResourceDesc kCursors = shared_slot(ComputePathCoverage::kCursorsSlot,
+                                              ComputeStep::ResourceType::kStorageBuffer);
+constexpr ResourceDesc kSegments = shared_slot(ComputePathCoverage::kSegmentsSlot,
+                                               ComputeStep::ResourceType::kStorageBuffer);
+constexpr ResourceDesc kCoverage = shared_slot(ComputePathCoverage::kCoverageSlot,
+                                               ComputeStep::ResourceType::kStorageTexture);
+
+enum class Dispatch {
+    kPerLine,
+    kPerTileRow,
+    kSingle,
+    kPerPixel,
+};
+
+class PathCoverageStep final : public ComputeStep {
+public:
+    PathCoverageStep(std::string_view name,
+                     Dispatch dispatch,
+                     std::initializer_list<ResourceDesc> resources,
+                     const char* mainSkSL)
+            : ComputeStep(name, local_size(dispatch), SkSpan(resources.begin(), resources.size()))
+            , fMainSkSL(mainSkSL) {}
+
+    std::string computeSkSL(const ResourceBindingRequirements&,
+                            int nextBindingIndex) const override {
+        // Buffers and textures are bound from separate index ranges, matching how
+        // DispatchGroup::Builder assigns them.
+        int bufferIndex = nextBindingIndex;
+        int textureIndex = 0;
+        std::string sksl;
+        for (const ResourceDesc& r : this->resources()) {
+            int index = r.fType == ResourceType::kStorageTexture ? textureIndex++ : bufferIndex++;
+            SkSL::String::appendf(&sksl, kSlotDeclarations[r.fSlot], index);
+        }
+        SkSL::String::appendf(&sksl,
+                              "const int TILE_SIZE = %d;\n"
+                              "const float BACKDROP_SCALE = %d;\n"
+                              "const float NEAR_VERTICAL = %.9g;\n"
+                              "const uint EVEN_ODD_FLAG = %u;\n"
+                              "const uint INVERSE_FLAG = %u;\n",
+                              kTileSize,
+                              ComputePathCoverage::kBackdropScale,
+                              kNearVertical,
+                              ComputePathCoverage::kEvenOddFlag,
+                              ComputePathCoverage::kInverseFlag);
+        sksl += kCommonSkSL;
+        sksl += fMainSkSL;
+        return sksl;
+    }
+
+private:
+    static WorkgroupSize local_size(Dispatch dispatch) {
+        switch (dispatch) {
+            case Dispatch::kPerLine:    return {kLinesPerWorkgroup, 1, 1};
+            case Dispatch::kPerTileRow: return {kRowsPerWorkgroup, 1, 1};
+            case Dispatch::kSingle:     return {1, 1, 1};
+            case Dispatch::kPerPixel:   return {kPixelsPerWorkgroupSide,
+                                                kPixelsPerWorkgroupSide,
+                                                1};
+        }
+        SkUNREACHABLE;
+    }
+
+    const char* fMainSkSL;
+};
+
+WorkgroupSize global_size(Dispatch dispatch, const Config& config) {
+    switch (dispatch) {
+        case Dispatch::kPerLine:
+            return {div_round_up(std::max(config.fLineCount, 1u), kLinesPerWorkgroup), 1, 1};
+        case Dispatch::kPerTileRow:
+            return {div_round_up(config.fHeightInTiles, kRowsPerWorkgroup), 1, 1};
+        case Dispatch::kSingle:
+            return {1, 1, 1};
+        case Dispatch::kPerPixel:
+            return {div_round_up(config.fWidth, kPixelsPerWorkgroupSide),
+                    div_round_up(config.fHeight, kPixelsPerWorkgroupSide),
+                    1};
+    }
+    SkUNREACHABLE;
+}
+
+}  // namespace
+
+ComputePathCoverage::ComputePathCoverage()
+        : fCountStep(std::make_unique<PathCoverageStep>(
+                  "PathCoverageCount",
+                  Dispatch::kPerLine,
+                  std::initializer_list<ResourceDesc>{kLines, kTileCounts, kBackdrop},
+                  kCountMainSkSL))
+        , fRowScanStep(std::make_unique<PathCoverageStep>(
+                  "PathCoverageRowScan",
+                  Dispatch::kPerTileRow,
+                  std::initializer_list<ResourceDesc>{
+                          kLines, kTileCounts, kBackdrop, kTileOffsets, kRowBases},
+                  kRowScanMainSkSL))
+        , fRowBaseStep(std::make_unique<PathCoverageStep>(
+                  "PathCoverageRowBase",
+                  Dispatch::kSingle,
+                  std::initializer_list<ResourceDesc>{kLines, kRowBases},
+                  kRowBaseMainSkSL))
+        , fFillStep(std::make_unique<PathCoverageStep>(
+                  "PathCoverageFill",
+                  Dispatch::kPerLine,
+                  std::initializer_list<ResourceDesc>{
+                          kLines, kTileOffsets, kRowBases, kCursors, kSegments},
+                  kFillMainSkSL))
+        , fRasterizeStep(std::make_unique<PathCoverageStep>(
+                  "PathCoverageRasterize",
+                  Dispatch::kPerPixel,
+                  std::initializer_list<ResourceDesc>{kLines,
+                                                      kTileCounts,
+                                                      kBackdrop,
+                                                      kTileOffsets,
+                                                      kRowBases,
+                                                      kSegments,
+                                                      kCoverage},
+                  kRasterizeMainSkSL)) {}
+
+ComputePathCoverage::~ComputePathCoverage() = default;
+
+SkPath ComputePathCoverage::DevicePath(const DrawParams& draw, SkIRect* area) {
+    SkASSERT(area);
+    area->setEmpty();
+    if (!draw.geometry().isShape()) {
+        return SkPath();
+    }
+
+    SkPath path = draw.geometry().shape().asPath();
+    const SkMatrix localToDevice = draw.transform().matrix().asM33();
+    if (draw.isStroke()) {
+        const StrokeStyle& stroke = draw.strokeStyle();
+        SkStrokeRec rec(SkStrokeRec::kFill_InitStyle);
+        path.setFillType(SkPathFillType::kWinding);
+        if (stroke.halfWidth() > 0) {
+            rec.setStrokeStyle(stroke.width());
+            rec.setStrokeParams(stroke.cap(), stroke.join(), stroke.miterLimit());
+            rec.applyToPath(&path, path);
+            path.transform(localToDevice);
+        } else {
+            // Hairlines are one pixel wide in device space.
+            path.transform(localToDevice);
+            rec.setStrokeStyle(1.f);
+            rec.setStrokeParams(stroke.cap(), stroke.join(), stroke.miterLimit());
+            rec.applyToPath(&path, path);
+        }
+    } else {
+        path.transform(localToDevice);
+    }
+
+    SkIRect bounds = draw.clip().drawBounds().makeRoundOut().asSkIRect();
+    if (!path.isInverseFillType() && !bounds.intersect(path.getBounds().roundOut())) {
+        return SkPath();
+    }
+    if (!area->intersect(bounds, draw.clip().scissor())) {
+        area->setEmpty();
+        return SkPath();
+    }
+    path.offset(-area->fLeft, -area->fTop);
+    return path;
+}
+
+sk_sp<TextureProxy> ComputePathCoverage::appendSteps(Recorder* recorder,
+                                                     DispatchGroup::Builder* builder,
+                                                     const DrawParams& draw,
+                                                     SkIRect* area) const {
+    SkIRect localArea;
+    area = area ? area : &localArea;
+    SkPath path = DevicePath(draw, area);
+    if (area->isEmpty()) {
+        return nullptr;
+    }
+
+    std::vector<Line> lines;
+    const Config config = Flatten(path, area->width(), area->height(), &lines);
+    const size_t tiles = (size_t)config.fWidthInTiles * config.fHeightInTiles;
+
+    // All of the buffers are mapped and zeroed on the CPU (kClear does not guarantee it) except
+    // for the ones that the steps fully overwrite before reading.
+    DrawBufferManager* bufferMgr = recorder->priv().drawBufferManager();
+    auto assignMapped = [&](Slot slot, size_t size) -> void* {
+        auto [ptr, info] = bufferMgr->getMappedStorage(size);
+        if (ptr) {
+            memset(ptr, 0, size);
+            builder->assignSharedBuffer(info, slot);
+        }
+        return ptr;
+    };
+    auto assignUnmapped = [&](Slot slot, size_t size) {
+        BindBufferInfo info = bufferMgr->getStorage(size);
+        if (info) {
+            builder->assignSharedBuffer(info, slot);
+        }
+        return SkToBool(info);
+    };
+
+    void* linesBuffer = assignMapped(
+            kLinesSlot, sizeof(Config) + std::max<size_t>(lines.size(), 1) * sizeof(Line));
+    if (!linesBuffer ||
+        !assignMapped(kTileCountsSlot, tiles * sizeof(uint32_t)) ||
+        !assignMapped(kBackdropSlot, tiles * kTileSize * sizeof(int32_t)) ||
+        !assignMapped(kCursorsSlot, tiles * sizeof(uint32_t)) ||
+        !assignUnmapped(kTileOffsetsSlot, tiles * sizeof(uint32_t)) ||
+        !assignUnmapped(kRowBasesSlot, (config.fHeightInTiles + 1) * sizeof(uint32_t)) ||
+        !assignUnmapped(kSegmentsSlot, config.fSegmentCapacity * sizeof(uint32_t))) {
+        return nullptr;
+    }
+    memcpy(linesBuffer, &config, sizeof(Config));
+    if (!lines.empty()) {
+        memcpy(static_cast<uint8_t*>(linesBuffer) + sizeof(Config),
+               lines.data(),
+               lines.size() * sizeof(Line));
+    }
+
+    sk_sp<TextureProxy> coverage = TextureProxy::MakeStorage(
+            recorder->priv().caps(), area->size(), kRGBA_8888_SkColorType, Budgeted::kYes);
+    if (!coverage) {
+        return nullptr;
+    }
+    builder->assignSharedTexture(coverage, kCoverageSlot);
+
+    const std::pair<const ComputeStep*, Dispatch> steps[] = {
+            {fCountStep.get(), Dispatch::kPerLine},
+            {fRowScanStep.get(), Dispatch::kPerTileRow},
+            {fRowBaseStep.get(), Dispatch::kSingle},
+            {fFillStep.get(), Dispatch::kPerLine},
+            {fRasterizeStep.get(), Dispatch::kPerPixel},
+    };
+    for (const auto& [step, dispatch] : steps) {
+        if (!builder->appendStep(step, draw, /*ssboIndex=*/0, global_size(dispatch, config))) {
+            return nullptr;
+        }
+    }
+    return coverage;
+}
+
+ComputePathCoverage::Config ComputePathCoverage::Flatten(const SkPath& path,
+                                                         int width,
+                                                         int height,
+                                                         std::vector<Line>* lines) {
+    lines->clear();
+    return flatten_path(path, width, height, [&](const Line& l) { lines->push_back(l); });
+}
+
+void ComputePathCoverage::CPUCount(const Config& config,
+                                   SkSpan<const Line> lines,
+                                   SkSpan<uint32_t> tileCounts,
+                                   SkSpan<int32_t> backdrop) {
+    const int wTiles = config.fWidthInTiles;
+    for (const Line& l : lines.first(config.fLineCount)) {
+        walk_line(l, config,
+                  [&](int ty, int tx) { tileCounts[ty * wTiles + tx]++; },
+                  [&](int ty, int tx, int r, int32_t delta) {
+                      backdrop[(ty * wTiles + tx) * kTileSize + r] += delta;
+                  });
+    }
+}
+
+void ComputePathCoverage::CPURowScan(const Config& config,
+                                     SkSpan<const uint32_t> tileCounts,
+                                     SkSpan<int32_t> backdrop,
+                                     SkSpan<uint32_t> tileOffsets,
+                                     SkSpan<uint32_t> rowBases) {
+    const int wTiles = config.fWidthInTiles;
+    for (int ty = 0; ty < (int)config.fHeightInTiles; ++ty) {
+        uint32_t runningCount = 0;
+        int32_t winding[kTileSize] = {};
+        for (int tx = 0; tx < wTiles; ++tx) {
+            int tile = ty * wTiles + tx;
+            tileOffsets[tile] = runningCount;
+            runningCount += tileCounts[tile];
+            for (int r = 0; r < kTileSize; ++r) {
+                winding[r] += backdrop[tile * kTileSize + r];
+                backdrop[tile * kTileSize + r] = winding[r];
+            }
+        }
+        rowBases[ty] = runningCount;
+    }
+}
+
+void ComputePathCoverage::CPURowBase(const Config& config, SkSpan<uint32_t> rowBases) {
+    uint32_t total = 0;
+    for (uint32_t ty = 0; ty < config.fHeightInTiles; ++ty) {
+        uint32_t rowCount = rowBases[ty];
+        rowBases[ty] = total;
+        total += rowCount;
+    }
+    rowBases[config.fHeightInTiles] = total;
+}
+
+void ComputePathCoverage::CPUFill(const Config& config,
+                                  SkSpan<const Line> lines,
+                                  SkSpan<const uint32_t> tileOffsets,
+                                  SkSpan<const uint32_t> rowBases,
+                                  SkSpan<uint32_t> cursors,
+                                  SkSpan<uint32_t> segments) {
+    const int wTiles = config.fWidthInTiles;
+    for (uint32_t lineIdx = 0; lineIdx < config.fLineCount; ++lineIdx) {
+        walk_line(lines[lineIdx], config,
+                  [&](int ty, int tx) {
+                      int tile = ty * wTiles + tx;
+                      uint32_t slot = rowBases[ty] + tileOffsets[tile] + cursors[tile]++;
+                      if (slot < config.fSegmentCapacity) {
+                          segments[slot] = lineIdx;
+                      }
+                  },
+                  [](int, int, int, int32_t) {});
+    }
+}
+
+void ComputePathCoverage::CPURasterize(const Config& config,
+                                       SkSpan<const Line> lines,
+                                       SkSpan<const uint32_t> tileCounts,
+                                       SkSpan<const int32_t> backdrop,
+                                       SkSpan<const uint32_t> tileOffsets,
+                                       SkSpan<const uint32_t> rowBases,
+                                       SkSpan<const uint32_t> segments,
+                                       SkSpan<uint32_t> coverage) {
+    const int wTiles = config.fWidthInTiles;
+    for (int py = 0; py < (int)config.fHeight; ++py) {
+        for (int px = 0; px < (int)config.fWidth; ++px) {
+            int ty = py / kTileSize;
+            int tile = ty * wTiles + px / kTileSize;
+            float winding = (float)backdrop[tile * kTileSize + py % kTileSize] / kBackdropScale;
+            uint32_t start = rowBases[ty] + tileOffsets[tile];
+            uint32_t end = std::min(start + tileCounts[tile], config.fSegmentCapacity);
+            for (uint32_t i = start; i < end; ++i) {
+                winding += pixel_contribution(lines[segments[i]], (float)px, (float)py);
+            }
+            coverage[py * config.fWidth + px] = coverage_byte(winding, config.fFillFlags);
+        }
+    }
+}
+
+bool ComputePathCoverage::CPUCoverage(const DrawParams& draw, SkBitmap* coverage, SkIRect* area) {
+    SkIRect localArea;
+    area = area ? area : &localArea;
+    SkPath path = DevicePath(draw, area);
+    if (area->isEmpty()) {
+        return false;
+    }
+
+    std::vector<Line> lines;
+    const Config config = Flatten(path, area->width(), area->height(), &lines);
+    const size_t tiles = (size_t)config.fWidthInTiles * config.fHeightInTiles;
+    std::vector<uint32_t> tileCounts(tiles), tileOffsets(tiles), cursors(tiles);
+    std::vector<int32_t> backdrop(tiles * kTileSize);
+    std::vector<uint32_t> rowBases(config.fHeightInTiles + 1);
+    std::vector<uint32_t> segments(config.fSegmentCapacity);
+    std::vector<uint32_t> pixels((size_t)config.fWidth * config.fHeight);
+
+    CPUCount(config, lines, tileCounts, backdrop);
+    CPURowScan(config, tileCounts, backdrop, tileOffsets, rowBases);
+    CPURowBase(config, rowBases);
+    CPUFill(config, lines, tileOffsets, rowBases, cursors, segments);
+    CPURasterize(config, lines, tileCounts, backdrop, tileOffsets, rowBases, segments, pixels);
+
+    coverage->allocPixels(SkImageInfo::MakeA8(area->width(), area->height()));
+    for (int y = 0; y < area->height(); ++y) {
+        uint8_t* row = coverage->getAddr8(0, y);
+        for (int x = 0; x < area->width(); ++x) {
+            row[x] = (uint8_t)pixels[y * config.fWidth + x];
+        }
+    }
+    return true;
+}
+
+}  // namespace skgpu::graphite
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef skgpu_graphite_compute_ComputePathCoverage_DEFINED
+#define skgpu_graphite_compute_ComputePathCoverage_DEFINED
+
+#include "include/core/SkPath.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSpan.h"
+#include "src/gpu/graphite/compute/ComputeStep.h"
+#include "src/gpu/graphite/compute/DispatchGroup.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SkBitmap;
+
+namespace skgpu::graphite {
+
+class DrawParams;
+class Recorder;
+class TextureProxy;
+
+/**
+ * ComputePathCoverage computes the anti-aliased coverage mask of a filled or stroked path with a
+ * chain of ComputeSteps, using a "sparse strips" approach:
+ *
+ *   1. Count     (one invocation per line): bins each line segment into the 4x4 pixel tiles that it
+ *                touches, and accumulates the winding of the part of the line that lies to the
+ *                left of a tile into the per-pixel-row "backdrop" of the next tile over.
+ *   2. RowScan   (one invocation per tile row): assigns each tile an offset into its row's segment
+ *                list and prefix-sums the backdrops along the row.
+ *   3. RowBase   (single invocation): assigns each tile row an offset into the segment list.
+ *   4. Fill      (one invocation per line): writes the line indices into the per-tile lists.
+ *   5. Rasterize (one invocation per pixel): starts from the backdrop winding and adds the exact
+ *                signed area contributed by each of the tile's lines to get the final coverage.
+ *
+ * Only tiles along the path's edges are touched by per-line work; interior tiles are resolved by
+ * the backdrop alone, so cost scales with edge length rather than area.
+ *
+ * Curves are flattened and strokes are expanded to fills on the CPU when the steps are appended,
+ * and all the buffers are shared slots of a single DispatchGroup. As such, the coverage of only one
+ * path can be computed per DispatchGroup. The result is a storage texture that the CoverageMask
+ * Renderer samples when drawing the path.
+ *
+ * Each stage has a CPU reference implementation that operates on the same buffer layouts, which
+ * can be used to validate the GPU implementation or as a fallback when compute is unavailable.
+ */
+class ComputePathCoverage final {
+public:
+    // Width and height of a tile, in pixels.
+    static constexpr int kTileSize = 4;
+    // Backdrop windings are accumulated atomically as fixed point integers with this scale.
+    static constexpr int kBackdropScale = 1024;
+
+    // The shared slots that hold the intermediate buffers of the coverage computation.
+    enum Slot : int {
+        kLinesSlot = 0,    // Config followed by Lines (CPU-prepared)
+        kTileCountsSlot,   // uint32 per tile
+        kBackdropSlot,     // int32 per pixel row of each tile, kBackdropScale fixed point
+        kTileOffsetsSlot,  // uint32 per tile, relative to its row's base
+        kRowBasesSlot,     // uint32 per tile row, plus the total segment count
+        kCursorsSlot,      // uint32 per tile
+        kSegmentsSlot,     // uint32 line index per segment, up to Config::fSegmentCapacity
+        kCoverageSlot,     // RGBA8 storage texture, coverage replicated in every channel
+
+        kSlotCount
+    };
+
+    // Header of the lines buffer. Matches the `gridInfo` and `sizeInfo` uint4s in the SkSL.
+    struct Config {
+        uint32_t fWidthInTiles;
+        uint32_t fHeightInTiles;
+        uint32_t fLineCount;
+        uint32_t fFillFlags;
+        uint32_t fWidth;
+        uint32_t fHeight;
+        uint32_t fSegmentCapacity;
+        uint32_t fPad = 0;
+    };
+    static constexpr uint32_t kEvenOddFlag = 0x1;
+    static constexpr uint32_t kInverseFlag = 0x2;
+
+    // A line segment relative to the top-left corner of the coverage area.
+    struct Line {
+        float fX0, fY0, fX1, fY1;
+    };
+
+    ComputePathCoverage();
+    ~ComputePathCoverage();
+
+    // The steps hold the compute pipelines' unique IDs, so a ComputePathCoverage should be long
+    // lived (e.g. owned by the RendererProvider) rather than created per draw.
+    ComputePathCoverage(const ComputePathCoverage&) = delete;
+    ComputePathCoverage& operator=(const ComputePathCoverage&) = delete;
+
+    // Returns the device space fill path that covers the same pixels as 'draw', relative to the
+    // top-left of the returned 'area'. 'area' is the draw bounds rounded out and intersected with
+    // the scissor, or the whole scissor for inverse fills.
+    static SkPath DevicePath(const DrawParams& draw, SkIRect* area);
+
+    // Allocates the buffers and coverage texture for 'draw' from 'recorder', assigns them to the
+    // shared slots of 'builder', and appends the steps that compute the coverage. Returns the
+    // coverage texture, which maps onto 'area' once the DispatchGroup has run. Returns null if
+    // 'draw' covers no pixels or if the resources could not be allocated, in which case 'builder'
+    // should be discarded.
+    sk_sp<TextureProxy> appendSteps(Recorder* recorder,
+                                    DispatchGroup::Builder* builder,
+                                    const DrawParams& draw,
+                                    SkIRect* area = nullptr) const;
+
+    // Flattens 'path' (already in coverage space) into lines. Returns the Config describing the
+    // buffers needed to compute its coverage over a 'width' x 'height' area.
+    static Config Flatten(const SkPath& path, int width, int height, std::vector<Line>* lines);
+
+    // CPU reference implementations of the steps, run in the same order on the same layouts.
+    static void CPUCount(const Config&,
+                         SkSpan<const Line>,
+                         SkSpan<uint32_t> tileCounts,
+                         SkSpan<int32_t> backdrop);
+    static void CPURowScan(const Config&,
+                           SkSpan<const uint32_t> tileCounts,
+                           SkSpan<int32_t> backdrop,
+                           SkSpan<uint32_t> tileOffsets,
+                           SkSpan<uint32_t> rowBases);
+    static void CPURowBase(const Config&, SkSpan<uint32_t> rowBases);
+    static void CPUFill(const Config&,
+                        SkSpan<const Line>,
+                        SkSpan<const uint32_t> tileOffsets,
+                        SkSpan<const uint32_t> rowBases,
+                        SkSpan<uint32_t> cursors,
+                        SkSpan<uint32_t> segments);
+    static void CPURasterize(const Config&,
+                             SkSpan<const Line>,
+                             SkSpan<const uint32_t> tileCounts,
+                             SkSpan<const int32_t> backdrop,
+                             SkSpan<const uint32_t> tileOffsets,
+                             SkSpan<const uint32_t> rowBases,
+                             SkSpan<const uint32_t> segments,
+                             SkSpan<uint32_t> coverage);
+
+    // Runs all of the CPU reference stages for 'draw' and stores the result in 'coverage' as an
+    // A8 bitmap the size of 'area'. Returns false if 'draw' covers no pixels.
+    static bool CPUCoverage(const DrawParams& draw, SkBitmap* coverage, SkIRect* area = nullptr);
+
+private:
+    std::unique_ptr<ComputeStep> fCountStep;
+    std::unique_ptr<ComputeStep> fRowScanStep;
+    std::unique_ptr<ComputeStep> fRowBaseStep;
+    std::unique_ptr<ComputeStep> fFillStep;
+    std::unique_ptr<ComputeStep> fRasterizeStep;
+};
+
+}  // namespace skgpu::graphite
+
+#endif  // skgpu_graphite_compute_ComputePathCoverage_DEFINED
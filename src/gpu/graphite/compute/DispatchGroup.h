@@ -16,6 +16,7 @@
 #include "src/gpu/graphite/TextureProxy.h"
 #include "src/gpu/graphite/compute/ComputeStep.h"
 
+#include <optional>
 #include <variant>
 
 namespace skgpu::graphite {
@@ -122,7 +123,14 @@ public:
     // the new ComputeStep. If the ComputeStep specifies a geometry input resource, it will be
     // prompted to populate it using the draw parameters. All other resources will be assigned
     // dynamically.
-    bool appendStep(const ComputeStep*, const DrawParams&, int ssboIndex);
+    //
+    // If `globalSize` is provided, it is used as the step's global dispatch size instead of
+    // calling `ComputeStep::calculateGlobalDispatchSize`. This is meant for steps whose resources
+    // were all assigned up front by the caller, which then also knows the size of the workload.
+    bool appendStep(const ComputeStep*,
+                    const DrawParams&,
+                    int ssboIndex,
+                    std::optional<WorkgroupSize> globalSize = std::nullopt);
 
     // Directly assign a texture to a shared slot. ComputeSteps that are appended after this call
     // will use this resource if they reference the given `slot` index. Builder will not allocate
@@ -134,6 +142,11 @@ public:
     // resource.
     void assignSharedTexture(sk_sp<TextureProxy> texture, unsigned int slot);
 
+    // Directly assign a buffer to a shared slot, with the same semantics as
+    // `assignSharedTexture`. ComputeSteps will not receive calls to `calculateBufferSize` or
+    // `prepareBuffer` for the given `slot`; the caller is responsible for initializing the buffer.
+    void assignSharedBuffer(BindBufferInfo buffer, unsigned int slot);
+
     // Finalize and return the constructed DispatchGroup. The Builder can be used to construct a new
     // DispatchGroup after this method returns.
     std::unique_ptr<DispatchGroup> finalize();
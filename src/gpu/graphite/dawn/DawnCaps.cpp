@@ -9,6 +9,7 @@
 
 #include <algorithm>
 
+#include "include/core/SkString.h"
 #include "include/gpu/graphite/TextureInfo.h"
 #include "src/gpu/dawn/DawnUtilsPriv.h"
 #include "src/gpu/graphite/AttachmentTypes.h"
@@ -224,6 +225,16 @@ void DawnCaps::initCaps(const wgpu::Device& device) {
     }
     fMaxTextureSize = limits.limits.maxTextureDimension2D;
 
+    wgpu::AdapterProperties properties;
+    device.GetAdapter().GetProperties(&properties);
+    fDeviceIdentity = SkStringPrintf("%u %x:%x %s %s",
+                                     static_cast<uint32_t>(properties.backendType),
+                                     properties.vendorID,
+                                     properties.deviceID,
+                                     properties.name ? properties.name : "",
+                                     properties.driverDescription ? properties.driverDescription
+                                                                  : "").c_str();
+
     fRequiredTransferBufferAlignment = 4;
     fRequiredUniformBufferAlignment = 256;
     fRequiredStorageBufferAlignment = fRequiredUniformBufferAlignment;
@@ -13,6 +13,7 @@
 #include "src/gpu/graphite/ContextUtils.h"
 #include "src/gpu/graphite/GraphicsPipelineDesc.h"
 #include "src/gpu/graphite/Log.h"
+#include "src/gpu/graphite/PipelineCacheUtils.h"
 #include "src/gpu/graphite/RendererProvider.h"
 #include "src/gpu/graphite/UniformManager.h"
 #include "src/gpu/graphite/dawn/DawnGraphiteUtilsPriv.h"
@@ -220,12 +221,6 @@ sk_sp<DawnGraphicsPipeline> DawnGraphicsPipeline::Make(const DawnSharedContext*
                                                        const RenderPassDesc& renderPassDesc) {
     const auto& device = sharedContext->device();
 
-    SkSL::Program::Inputs vsInputs, fsInputs;
-    SkSL::ProgramSettings settings;
-
-    settings.fForceNoRTFlip = true;
-    settings.fSPIRVDawnCompatMode = true;
-
     ShaderErrorHandler* errorHandler = sharedContext->caps()->shaderErrorHandler();
 
     const RenderStep* step =
@@ -234,56 +229,74 @@ sk_sp<DawnGraphicsPipeline> DawnGraphicsPipeline::Make(const DawnSharedContext*
     bool useShadingSsboIndex =
             sharedContext->caps()->storageBufferPreferred() && step->performsShading();
 
-    std::string vsSPIRV, fsSPIRV;
-    wgpu::ShaderModule fsModule, vsModule;
+    auto compileSPIRV = [&](PipelineCacheUtils::CachedShaders* shaders) {
+        SkSL::Program::Inputs vsInputs, fsInputs;
+        SkSL::ProgramSettings settings;
+
+        settings.fForceNoRTFlip = true;
+        settings.fSPIRVDawnCompatMode = true;
+
+        // Some steps just render depth buffer but not color buffer, so the fragment
+        // shader is null.
+        const FragSkSLInfo fsSkSLInfo =
+                GetSkSLFS(sharedContext->caps()->resourceBindingRequirements(),
+                          sharedContext->shaderCodeDictionary(),
+                          runtimeDict,
+                          step,
+                          pipelineDesc.paintParamsID(),
+                          useShadingSsboIndex,
+                          renderPassDesc.fWriteSwizzle);
+        const std::string& fsSKSL = fsSkSLInfo.fSkSL;
+        const bool localCoordsNeeded = fsSkSLInfo.fRequiresLocalCoords;
+        shaders->fBlendInfo = fsSkSLInfo.fBlendInfo;
+        shaders->fNumTexturesAndSamplers = fsSkSLInfo.fNumTexturesAndSamplers;
+
+        if (!fsSKSL.empty() && !SkSLToSPIRV(compiler,
+                                            fsSKSL,
+                                            SkSL::ProgramKind::kGraphiteFragment,
+                                            settings,
+                                            &shaders->fFragmentShader,
+                                            &fsInputs,
+                                            errorHandler)) {
+            return false;
+        }
 
-    // Some steps just render depth buffer but not color buffer, so the fragment
-    // shader is null.
-    const FragSkSLInfo fsSkSLInfo = GetSkSLFS(sharedContext->caps()->resourceBindingRequirements(),
-                                              sharedContext->shaderCodeDictionary(),
-                                              runtimeDict,
-                                              step,
-                                              pipelineDesc.paintParamsID(),
-                                              useShadingSsboIndex,
-                                              renderPassDesc.fWriteSwizzle);
-    const std::string& fsSKSL = fsSkSLInfo.fSkSL;
-    const BlendInfo& blendInfo = fsSkSLInfo.fBlendInfo;
-    const bool localCoordsNeeded = fsSkSLInfo.fRequiresLocalCoords;
-    const int numTexturesAndSamplers = fsSkSLInfo.fNumTexturesAndSamplers;
-
-    bool hasFragment = !fsSKSL.empty();
+        return SkSLToSPIRV(compiler,
+                           GetSkSLVS(sharedContext->caps()->resourceBindingRequirements(),
+                                     step,
+                                     useShadingSsboIndex,
+                                     localCoordsNeeded),
+                           SkSL::ProgramKind::kGraphiteVertex,
+                           settings,
+                           &shaders->fVertexShader,
+                           &vsInputs,
+                           errorHandler);
+    };
+
+    PipelineCacheUtils::CachedShaders shaders;
+    if (!PipelineCacheUtils::FindOrCompileShaders(sharedContext,
+                                                  SkSetFourByteTag('S', 'P', 'R', 'V'),
+                                                  pipelineDesc,
+                                                  renderPassDesc,
+                                                  compileSPIRV,
+                                                  &shaders)) {
+        return {};
+    }
+    const BlendInfo& blendInfo = shaders.fBlendInfo;
+    const int numTexturesAndSamplers = shaders.fNumTexturesAndSamplers;
+
+    wgpu::ShaderModule fsModule, vsModule;
+    bool hasFragment = !shaders.fFragmentShader.empty();
     if (hasFragment) {
-        if (!SkSLToSPIRV(compiler,
-                         fsSKSL,
-                         SkSL::ProgramKind::kGraphiteFragment,
-                         settings,
-                         &fsSPIRV,
-                         &fsInputs,
-                         errorHandler)) {
-            return {};
-        }
         fsModule = DawnCompileSPIRVShaderModule(sharedContext,
-                                                fsSPIRV,
+                                                shaders.fFragmentShader,
                                                 errorHandler);
         if (!fsModule) {
             return {};
         }
     }
 
-    if (!SkSLToSPIRV(compiler,
-                     GetSkSLVS(sharedContext->caps()->resourceBindingRequirements(),
-                               step,
-                               useShadingSsboIndex,
-                               localCoordsNeeded),
-                     SkSL::ProgramKind::kGraphiteVertex,
-                     settings,
-                     &vsSPIRV,
-                     &vsInputs,
-                     errorHandler)) {
-        return {};
-    }
-
-    vsModule = DawnCompileSPIRVShaderModule(sharedContext, vsSPIRV, errorHandler);
+    vsModule = DawnCompileSPIRVShaderModule(sharedContext, shaders.fVertexShader, errorHandler);
     if (!vsModule) {
         return {};
     }
@@ -9,6 +9,7 @@
 #define skgpu_graphite_geom_BoundsManager_DEFINED
 
 #include "include/core/SkSize.h"
+#include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
 
 #include "src/base/SkTBlockList.h"
@@ -16,7 +17,9 @@
 #include "src/gpu/graphite/DrawOrder.h"
 #include "src/gpu/graphite/geom/Rect.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 namespace skgpu::graphite {
 
@@ -305,6 +308,194 @@ private:
     }
 };
 
+// An OcclusionGrid tracks which parts of a device are fully covered by opaque draws, and the
+// PaintersDepth of the latest such draw, so that draws hidden by later opaque draws can be culled
+// before they are converted into a DrawPass. Coverage is quantized conservatively to a grid: a
+// cell only counts as covered once a single opaque draw covers all of it.
+//
+// The cells are the base of a min-pyramid (each coarser cell holds the smallest depth of its 2x2
+// children) so that large queries are typically resolved by a few coarse cells and only descend
+// where the coverage is incomplete. The cell size scales with the device size to bound the memory
+// of the grid, and no memory is used until the first occluder is recorded.
+class OcclusionGrid {
+public:
+    explicit OcclusionGrid(const SkISize& deviceSize)
+            : fDeviceSize(deviceSize)
+            , fCellSize(std::max(kMinCellSize,
+                                 SkScalarCeilToInt(std::max(deviceSize.width(),
+                                                            deviceSize.height()) /
+                                                   (float) kMaxCellsPerSide)))
+            , fGridWidth(SkScalarCeilToInt(deviceSize.width() / (float) fCellSize))
+            , fGridHeight(SkScalarCeilToInt(deviceSize.height() / (float) fCellSize)) {
+        SkASSERT(deviceSize.width() > 0 && deviceSize.height() > 0);
+    }
+
+    bool hasOccluders() const { return fHasOccluders; }
+
+    // 'bounds' must be entirely covered by a draw with an opaque result at 'depth'.
+    void recordOccluder(const Rect& bounds, PaintersDepth depth) {
+        SkASSERT(!bounds.isEmptyNegativeOrNaN());
+
+        // Only cells completely inside 'bounds' are covered, except that the draw reaching the
+        // right or bottom edge of the device covers the padding of the last column or row.
+        int l = std::max(0, SkScalarCeilToInt(bounds.left() / fCellSize));
+        int t = std::max(0, SkScalarCeilToInt(bounds.top() / fCellSize));
+        int r = bounds.right() >= fDeviceSize.width() ? fGridWidth
+                        : std::min(fGridWidth, SkScalarFloorToInt(bounds.right() / fCellSize));
+        int b = bounds.bot() >= fDeviceSize.height() ? fGridHeight
+                        : std::min(fGridHeight, SkScalarFloorToInt(bounds.bot() / fCellSize));
+        if (l >= r || t >= b) {
+            return;
+        }
+
+        if (fLevels.empty()) {
+            this->allocateLevels();
+        }
+        uint16_t* row = fLevels[0].fCells.data() + t * fGridWidth;
+        for (int y = t; y < b; ++y, row += fGridWidth) {
+            for (int x = l; x < r; ++x) {
+                row[x] = std::max(row[x], depth.bits());
+            }
+        }
+        fHasOccluders = true;
+        fPyramidDirty = true;
+    }
+
+    // Returns true if every pixel touched by 'bounds' will be overwritten by an opaque draw that
+    // is deeper than 'depth'.
+    bool isOccluded(const Rect& bounds, PaintersDepth depth) {
+        SkASSERT(!bounds.isEmptyNegativeOrNaN());
+        if (!fHasOccluders) {
+            return false;
+        }
+        if (fPyramidDirty) {
+            this->buildPyramid();
+        }
+
+        // The range of base cells touched by 'bounds', inclusive
+        const skvx::int4 range = {
+                std::clamp(SkScalarFloorToInt(bounds.left() / fCellSize), 0, fGridWidth - 1),
+                std::clamp(SkScalarFloorToInt(bounds.top() / fCellSize), 0, fGridHeight - 1),
+                std::clamp(SkScalarCeilToInt(bounds.right() / fCellSize) - 1, 0, fGridWidth - 1),
+                std::clamp(SkScalarCeilToInt(bounds.bot() / fCellSize) - 1, 0, fGridHeight - 1)};
+
+        // Start from the finest level where the range spans at most 2x2 cells
+        int level = 0;
+        while ((range[2] >> level) - (range[0] >> level) > 1 ||
+               (range[3] >> level) - (range[1] >> level) > 1) {
+            ++level;
+        }
+        SkASSERT(level < fLevels.size());
+
+        for (int y = range[1] >> level; y <= range[3] >> level; ++y) {
+            for (int x = range[0] >> level; x <= range[2] >> level; ++x) {
+                if (!this->isCellOccluded(level, x, y, range, depth.bits())) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void reset() {
+        if (fHasOccluders) {
+            // Keep the storage around since the owning Device will likely record occluders again
+            for (Level& level : fLevels) {
+                memset(level.fCells.data(), 0, sizeof(uint16_t) * level.fWidth * level.fHeight);
+            }
+        }
+        fHasOccluders = false;
+        fPyramidDirty = false;
+    }
+
+    int cellSize() const { return fCellSize; }
+
+private:
+    static constexpr int kMinCellSize = 8;
+    static constexpr int kMaxCellsPerSide = 128;
+
+    struct Level {
+        int fWidth;
+        int fHeight;
+        skia_private::AutoTMalloc<uint16_t> fCells;
+    };
+
+    void allocateLevels() {
+        int w = fGridWidth;
+        int h = fGridHeight;
+        while (true) {
+            Level& level = fLevels.push_back();
+            level.fWidth = w;
+            level.fHeight = h;
+            level.fCells.reset((size_t) w * h);
+            memset(level.fCells.data(), 0, sizeof(uint16_t) * w * h);
+            if (w == 1 && h == 1) {
+                break;
+            }
+            w = (w + 1) / 2;
+            h = (h + 1) / 2;
+        }
+    }
+
+    void buildPyramid() {
+        for (int i = 1; i < fLevels.size(); ++i) {
+            const Level& src = fLevels[i - 1];
+            Level& dst = fLevels[i];
+            for (int y = 0; y < dst.fHeight; ++y) {
+                const int y0 = 2 * y;
+                const int y1 = std::min(y0 + 1, src.fHeight - 1);
+                for (int x = 0; x < dst.fWidth; ++x) {
+                    const int x0 = 2 * x;
+                    const int x1 = std::min(x0 + 1, src.fWidth - 1);
+                    dst.fCells[y * dst.fWidth + x] =
+                            std::min(std::min(src.fCells[y0 * src.fWidth + x0],
+                                              src.fCells[y0 * src.fWidth + x1]),
+                                     std::min(src.fCells[y1 * src.fWidth + x0],
+                                              src.fCells[y1 * src.fWidth + x1]));
+                }
+            }
+        }
+        fPyramidDirty = false;
+    }
+
+    // 'range' is the inclusive range of base cells that must be occluded
+    bool isCellOccluded(int level, int x, int y, const skvx::int4& range, uint16_t depth) const {
+        if (fLevels[level].fCells[y * fLevels[level].fWidth + x] > depth) {
+            // Every base cell under this one is covered by something deeper than 'depth'
+            return true;
+        }
+        if (level == 0) {
+            return false;
+        }
+
+        // Only the children that overlap 'range' matter
+        const int child = level - 1;
+        const int x0 = std::max(2 * x, range[0] >> child);
+        const int x1 = std::min(2 * x + 1, range[2] >> child);
+        const int y0 = std::max(2 * y, range[1] >> child);
+        const int y1 = std::min(2 * y + 1, range[3] >> child);
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                if (!this->isCellOccluded(child, cx, cy, range, depth)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    const SkISize fDeviceSize;
+    const int     fCellSize;
+    const int     fGridWidth;
+    const int     fGridHeight;
+
+    // Level 0 holds the base cells; each following level halves the resolution down to 1x1.
+    skia_private::TArray<Level> fLevels;
+
+    bool fHasOccluders = false;
+    bool fPyramidDirty = false;
+};
+
 } // namespace skgpu::graphite
 
 #endif // skgpu_graphite_geom_BoundsManager_DEFINED
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef skgpu_graphite_geom_CoverageMask_DEFINED
+#define skgpu_graphite_geom_CoverageMask_DEFINED
+
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "src/gpu/graphite/TextureProxy.h"
+#include "src/gpu/graphite/geom/Rect.h"
+
+namespace skgpu::graphite {
+
+/**
+ * CoverageMask is a texture holding the anti-aliased coverage of a shape that was computed ahead
+ * of the draw (e.g. by ComputePathCoverage), along with the device space bounds that it maps onto.
+ * Texel (0, 0) holds the coverage of the top-left pixel of the bounds, in the red channel.
+ */
+class CoverageMask {
+public:
+    CoverageMask() = delete;
+    CoverageMask(sk_sp<TextureProxy> texture, const SkIRect& deviceBounds)
+            : fTexture(std::move(texture))
+            , fDeviceBounds(deviceBounds) {
+        SkASSERT(fTexture && fTexture->dimensions() == fDeviceBounds.size());
+    }
+
+    CoverageMask(const CoverageMask&) = default;
+    ~CoverageMask() = default;
+
+    CoverageMask& operator=(const CoverageMask&) = default;
+
+    // The device space bounds of the mask.
+    Rect bounds() const { return Rect(SkRect::Make(fDeviceBounds)); }
+    const SkIRect& deviceBounds() const { return fDeviceBounds; }
+
+    const sk_sp<TextureProxy>& texture() const { return fTexture; }
+
+private:
+    sk_sp<TextureProxy> fTexture;
+    SkIRect fDeviceBounds;
+};
+
+}  // namespace skgpu::graphite
+
+#endif  // skgpu_graphite_geom_CoverageMask_DEFINED
@@ -10,6 +10,7 @@
 
 #include "include/core/SkVertices.h"
 #include "src/core/SkVerticesPriv.h"
+#include "src/gpu/graphite/geom/CoverageMask.h"
 #include "src/gpu/graphite/geom/EdgeAAQuad.h"
 #include "src/gpu/graphite/geom/Rect.h"
 #include "src/gpu/graphite/geom/Shape.h"
@@ -18,13 +19,14 @@
 namespace skgpu::graphite {
 
 /**
- * Geometry is a container that can house Shapes, SkVertices, text SubRuns, and per-edge AA quads.
+ * Geometry is a container that can house Shapes, SkVertices, text SubRuns, per-edge AA quads, and
+ * precomputed coverage masks.
  * TODO - Add unit tests for Geometry.
  */
 class Geometry {
 public:
     enum class Type : uint8_t {
-        kEmpty, kShape, kVertices, kSubRun, kEdgeAAQuad
+        kEmpty, kShape, kVertices, kSubRun, kEdgeAAQuad, kCoverageMask
     };
 
     Geometry() {}
@@ -35,6 +37,7 @@ public:
     explicit Geometry(const SubRunData& subrun) { this->setSubRun(subrun); }
     explicit Geometry(sk_sp<SkVertices> vertices) { this->setVertices(vertices); }
     explicit Geometry(const EdgeAAQuad& edgeAAQuad) { this->setEdgeAAQuad(edgeAAQuad); }
+    explicit Geometry(const CoverageMask& mask) { this->setCoverageMask(mask); }
 
     ~Geometry() { this->setType(Type::kEmpty); }
 
@@ -60,6 +63,10 @@ public:
                     this->setEdgeAAQuad(geom.edgeAAQuad());
                     geom.setType(Type::kEmpty);
                     break;
+                case Type::kCoverageMask:
+                    this->setCoverageMask(geom.coverageMask());
+                    geom.setType(Type::kEmpty);
+                    break;
             }
         }
         return *this;
@@ -71,6 +78,7 @@ public:
             case Type::kSubRun: this->setSubRun(geom.subRunData()); break;
             case Type::kVertices: this->setVertices(geom.fVertices); break;
             case Type::kEdgeAAQuad: this->setEdgeAAQuad(geom.edgeAAQuad()); break;
+            case Type::kCoverageMask: this->setCoverageMask(geom.coverageMask()); break;
             default: break;
         }
         return *this;
@@ -82,6 +90,7 @@ public:
     bool isVertices() const { return fType == Type::kVertices; }
     bool isSubRun() const { return fType == Type::kSubRun; }
     bool isEdgeAAQuad() const { return fType == Type::kEdgeAAQuad; }
+    bool isCoverageMask() const { return fType == Type::kCoverageMask; }
     bool isEmpty() const {
         return fType == (Type::kEmpty) || (this->isShape() && this->shape().isEmpty());
     }
@@ -89,6 +98,10 @@ public:
     const Shape& shape() const { SkASSERT(this->isShape()); return fShape; }
     const SubRunData& subRunData() const { SkASSERT(this->isSubRun()); return fSubRunData; }
     const EdgeAAQuad& edgeAAQuad() const { SkASSERT(this->isEdgeAAQuad()); return fEdgeAAQuad; }
+    const CoverageMask& coverageMask() const {
+        SkASSERT(this->isCoverageMask());
+        return fCoverageMask;
+    }
     const SkVertices* vertices() const { SkASSERT(this->isVertices()); return fVertices.get(); }
     sk_sp<SkVertices> refVertices() const {
         SkASSERT(this->isVertices());
@@ -129,6 +142,15 @@ public:
         }
     }
 
+    void setCoverageMask(const CoverageMask& mask) {
+        if (fType == Type::kCoverageMask) {
+            fCoverageMask = mask;
+        } else {
+            this->setType(Type::kCoverageMask);
+            new (&fCoverageMask) CoverageMask(mask);
+        }
+    }
+
     Rect bounds() const {
         switch (fType) {
             case Type::kEmpty: return Rect(0, 0, 0, 0);
@@ -136,6 +158,7 @@ public:
             case Type::kVertices: return fVertices->bounds();
             case Type::kSubRun: return fSubRunData.bounds();
             case Type::kEdgeAAQuad: return fEdgeAAQuad.bounds();
+            case Type::kCoverageMask: return fCoverageMask.bounds();
         }
         SkUNREACHABLE;
     }
@@ -149,6 +172,8 @@ private:
             fSubRunData.~SubRunData();
         } else if (this->isVertices() && type != Type::kVertices) {
             fVertices.~sk_sp<SkVertices>();
+        } else if (this->isCoverageMask() && type != Type::kCoverageMask) {
+            fCoverageMask.~CoverageMask();
         }
         fType = type;
     }
@@ -159,6 +184,7 @@ private:
         SubRunData fSubRunData;
         sk_sp<SkVertices> fVertices;
         EdgeAAQuad fEdgeAAQuad;
+        CoverageMask fCoverageMask;
     };
 };
 
@@ -287,6 +287,11 @@ void MtlCaps::initGPUFamily(id<MTLDevice> device) {
 }
 
 void MtlCaps::initCaps(const id<MTLDevice> device) {
+    // Metal drivers ship with the OS, so its version stands in for the driver version.
+    NSString* identity = [NSString stringWithFormat:@"%@ %@", device.name,
+                          [[NSProcessInfo processInfo] operatingSystemVersionString]];
+    fDeviceIdentity = identity.UTF8String;
+
     if (this->isMac() || fFamilyGroup >= 3) {
         fMaxTextureSize = 16384;
     } else {
@@ -317,6 +322,8 @@ void MtlCaps::initCaps(const id<MTLDevice> device) {
     fStorageBufferSupport = true;
     fStorageBufferPreferred = true;
 
+    fComputeSupport = true;
+
     if (@available(macOS 10.12, ios 14.0, *)) {
         fClampToBorderSupport = (this->isMac() || fFamilyGroup >= 7);
     } else {
@@ -18,6 +18,7 @@
 #include "src/gpu/graphite/ContextUtils.h"
 #include "src/gpu/graphite/GlobalCache.h"
 #include "src/gpu/graphite/GraphicsPipelineDesc.h"
+#include "src/gpu/graphite/PipelineCacheUtils.h"
 #include "src/gpu/graphite/Renderer.h"
 #include "src/gpu/graphite/RendererProvider.h"
 #include "src/gpu/graphite/compute/ComputeStep.h"
@@ -103,12 +104,6 @@ sk_sp<GraphicsPipeline> MtlResourceProvider::createGraphicsPipeline(
         const RuntimeEffectDictionary* runtimeDict,
         const GraphicsPipelineDesc& pipelineDesc,
         const RenderPassDesc& renderPassDesc) {
-    std::string vsMSL, fsMSL;
-    SkSL::Program::Inputs vsInputs, fsInputs;
-    SkSL::ProgramSettings settings;
-
-    settings.fForceNoRTFlip = true;
-
     auto skslCompiler = this->skslCompiler();
     ShaderErrorHandler* errorHandler = fSharedContext->caps()->shaderErrorHandler();
 
@@ -118,38 +113,60 @@ sk_sp<GraphicsPipeline> MtlResourceProvider::createGraphicsPipeline(
     bool useShadingSsboIndex =
             fSharedContext->caps()->storageBufferPreferred() && step->performsShading();
 
-    const FragSkSLInfo fsSkSLInfo = GetSkSLFS(fSharedContext->caps()->resourceBindingRequirements(),
-                                              fSharedContext->shaderCodeDictionary(),
-                                              runtimeDict,
-                                              step,
-                                              pipelineDesc.paintParamsID(),
-                                              useShadingSsboIndex,
-                                              renderPassDesc.fWriteSwizzle);
-    const std::string& fsSkSL = fsSkSLInfo.fSkSL;
-    const BlendInfo& blendInfo = fsSkSLInfo.fBlendInfo;
-    const bool localCoordsNeeded = fsSkSLInfo.fRequiresLocalCoords;
-    if (!SkSLToMSL(skslCompiler,
-                   fsSkSL,
-                   SkSL::ProgramKind::kGraphiteFragment,
-                   settings,
-                   &fsMSL,
-                   &fsInputs,
-                   errorHandler)) {
-        return nullptr;
-    }
+    auto compileMSL = [&](PipelineCacheUtils::CachedShaders* shaders) {
+        SkSL::Program::Inputs vsInputs, fsInputs;
+        SkSL::ProgramSettings settings;
+
+        settings.fForceNoRTFlip = true;
+
+        const FragSkSLInfo fsSkSLInfo =
+                GetSkSLFS(fSharedContext->caps()->resourceBindingRequirements(),
+                          fSharedContext->shaderCodeDictionary(),
+                          runtimeDict,
+                          step,
+                          pipelineDesc.paintParamsID(),
+                          useShadingSsboIndex,
+                          renderPassDesc.fWriteSwizzle);
+        const std::string& fsSkSL = fsSkSLInfo.fSkSL;
+        const bool localCoordsNeeded = fsSkSLInfo.fRequiresLocalCoords;
+        shaders->fBlendInfo = fsSkSLInfo.fBlendInfo;
+        shaders->fNumTexturesAndSamplers = fsSkSLInfo.fNumTexturesAndSamplers;
+        if (!SkSLToMSL(skslCompiler,
+                       fsSkSL,
+                       SkSL::ProgramKind::kGraphiteFragment,
+                       settings,
+                       &shaders->fFragmentShader,
+                       &fsInputs,
+                       errorHandler)) {
+            return false;
+        }
 
-    if (!SkSLToMSL(skslCompiler,
-                   GetSkSLVS(fSharedContext->caps()->resourceBindingRequirements(),
-                             step,
-                             useShadingSsboIndex,
-                             localCoordsNeeded),
-                   SkSL::ProgramKind::kGraphiteVertex,
-                   settings,
-                   &vsMSL,
-                   &vsInputs,
-                   errorHandler)) {
+        return SkSLToMSL(skslCompiler,
+                         GetSkSLVS(fSharedContext->caps()->resourceBindingRequirements(),
+                                   step,
+                                   useShadingSsboIndex,
+                                   localCoordsNeeded),
+                         SkSL::ProgramKind::kGraphiteVertex,
+                         settings,
+                         &shaders->fVertexShader,
+                         &vsInputs,
+                         errorHandler);
+    };
+
+    // Generating the SkSL and translating it to MSL is skipped entirely when the MSL is found in
+    // the client's persistent storage; only the MTLLibrary and pipeline state compiles remain.
+    PipelineCacheUtils::CachedShaders shaders;
+    if (!PipelineCacheUtils::FindOrCompileShaders(fSharedContext,
+                                                  SkSetFourByteTag('M', 'S', 'L', ' '),
+                                                  pipelineDesc,
+                                                  renderPassDesc,
+                                                  compileMSL,
+                                                  &shaders)) {
         return nullptr;
     }
+    const std::string& vsMSL = shaders.fVertexShader;
+    const std::string& fsMSL = shaders.fFragmentShader;
+    const BlendInfo& blendInfo = shaders.fBlendInfo;
 
     auto vsLibrary = MtlCompileShaderLibrary(this->mtlSharedContext(), vsMSL, errorHandler);
     auto fsLibrary = MtlCompileShaderLibrary(this->mtlSharedContext(), fsMSL, errorHandler);
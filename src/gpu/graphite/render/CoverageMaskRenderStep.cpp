@@ -0,0 +1,86 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/gpu/graphite/render/CoverageMaskRenderStep.h"
+
+#include "src/base/SkVx.h"
+#include "src/gpu/graphite/ContextUtils.h"
+#include "src/gpu/graphite/DrawParams.h"
+#include "src/gpu/graphite/DrawWriter.h"
+#include "src/gpu/graphite/PipelineData.h"
+#include "src/gpu/graphite/render/CommonDepthStencilSettings.h"
+
+namespace skgpu::graphite {
+
+CoverageMaskRenderStep::CoverageMaskRenderStep()
+        : RenderStep("CoverageMaskRenderStep",
+                     "",
+                     Flags::kPerformsShading | Flags::kHasTextures | Flags::kEmitsCoverage,
+                     /*uniforms=*/{},
+                     PrimitiveType::kTriangleStrip,
+                     kDirectDepthGreaterPass,
+                     /*vertexAttrs=*/{},
+                     /*instanceAttrs=*/{{"bounds", VertexAttribType::kFloat4, SkSLType::kFloat4},
+                                        {"depth", VertexAttribType::kFloat, SkSLType::kFloat},
+                                        {"ssboIndex", VertexAttribType::kInt, SkSLType::kInt},
+                                        {"mat0", VertexAttribType::kFloat3, SkSLType::kFloat3},
+                                        {"mat1", VertexAttribType::kFloat3, SkSLType::kFloat3},
+                                        {"mat2", VertexAttribType::kFloat3, SkSLType::kFloat3}},
+                     /*varyings=*/{{"textureCoords", SkSLType::kFloat2}}) {}
+
+CoverageMaskRenderStep::~CoverageMaskRenderStep() {}
+
+std::string CoverageMaskRenderStep::vertexSkSL() const {
+    return R"(
+        float2 corner = float2(float(sk_VertexID / 2), float(sk_VertexID % 2));
+        textureCoords = corner;
+
+        // The bounds are in device space and match the mask texture exactly, so the matrix is the
+        // inverse of the draw's transform and is only used for local coordinates.
+        corner = (1.0 - corner) * bounds.LT + corner * bounds.RB;
+        float4 devPosition = float4(corner, depth, 1.0);
+        // TODO: Support float3 local coordinates if the matrix has perspective so that W is
+        // interpolated correctly to the fragment shader.
+        float3 localCoords = float3x3(mat0, mat1, mat2) * corner.xy1;
+        stepLocalCoords = localCoords.xy / localCoords.z;
+    )";
+}
+
+std::string CoverageMaskRenderStep::texturesAndSamplersSkSL(
+        const ResourceBindingRequirements& bindingReqs, int* nextBindingIndex) const {
+    return EmitSamplerLayout(bindingReqs, nextBindingIndex) + " uniform sampler2D pathCoverage;\n";
+}
+
+const char* CoverageMaskRenderStep::fragmentCoverageSkSL() const {
+    return "outputCoverage = sample(pathCoverage, textureCoords).rrrr;";
+}
+
+void CoverageMaskRenderStep::writeVertices(DrawWriter* writer,
+                                           const DrawParams& params,
+                                           int ssboIndex) const {
+    // Each instance is 4 vertices, forming 2 triangles from a single triangle strip, so no indices
+    // are needed. sk_VertexID is used to place vertex positions, so no vertex buffer is needed.
+    DrawWriter::Instances instances{*writer, {}, {}, 4};
+
+    const SkM44& m = params.transform().inverse();
+    // Since the local coords always have Z=0, we can discard the 3rd row and column of the matrix.
+    instances.append(1) << params.geometry().coverageMask().bounds().ltrb()
+                        << params.order().depthAsFloat() << ssboIndex
+                        << m.rc(0,0) << m.rc(1,0) << m.rc(3,0)
+                        << m.rc(0,1) << m.rc(1,1) << m.rc(3,1)
+                        << m.rc(0,3) << m.rc(1,3) << m.rc(3,3);
+}
+
+void CoverageMaskRenderStep::writeUniformsAndTextures(const DrawParams& params,
+                                                      PipelineDataGatherer* gatherer) const {
+    // The mask is drawn 1:1 with device pixels, so nearest sampling is exact.
+    const SkSamplingOptions kSamplingOptions(SkFilterMode::kNearest);
+    constexpr SkTileMode kTileModes[2] = { SkTileMode::kClamp, SkTileMode::kClamp };
+    gatherer->add(kSamplingOptions, kTileModes, params.geometry().coverageMask().texture());
+}
+
+}  // namespace skgpu::graphite
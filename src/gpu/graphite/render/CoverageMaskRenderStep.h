@@ -0,0 +1,37 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef skgpu_graphite_render_CoverageMaskRenderStep_DEFINED
+#define skgpu_graphite_render_CoverageMaskRenderStep_DEFINED
+
+#include "src/gpu/graphite/Renderer.h"
+
+namespace skgpu::graphite {
+
+/**
+ * CoverageMaskRenderStep draws the device space bounds of a CoverageMask geometry, modulating the
+ * shading by the coverage sampled from the mask's texture. The draw's transform is only used to
+ * compute local coordinates.
+ */
+class CoverageMaskRenderStep final : public RenderStep {
+public:
+    CoverageMaskRenderStep();
+
+    ~CoverageMaskRenderStep() override;
+
+    std::string vertexSkSL() const override;
+    std::string texturesAndSamplersSkSL(const ResourceBindingRequirements&,
+                                        int* nextBindingIndex) const override;
+    const char* fragmentCoverageSkSL() const override;
+
+    void writeVertices(DrawWriter*, const DrawParams&, int ssboIndex) const override;
+    void writeUniformsAndTextures(const DrawParams&, PipelineDataGatherer*) const override;
+};
+
+}  // namespace skgpu::graphite
+
+#endif // skgpu_graphite_render_CoverageMaskRenderStep_DEFINED
@@ -9,18 +9,18 @@
 
 #include "include/core/SkColorSpace.h"
 #include "include/gpu/graphite/Recorder.h"
-#include "src/base/SkAutoMalloc.h"
-#include "src/codec/SkMasks.h"
 #include "src/core/SkDistanceFieldGen.h"
 #include "src/gpu/graphite/DrawAtlas.h"
 #include "src/gpu/graphite/RecorderPriv.h"
 #include "src/gpu/graphite/TextureProxy.h"
 #include "src/sksl/SkSLUtil.h"
 #include "src/text/gpu/Glyph.h"
+#include "src/text/gpu/GlyphMaskStore.h"
 #include "src/text/gpu/GlyphVector.h"
 #include "src/text/gpu/StrikeCache.h"
 
 using Glyph = sktext::gpu::Glyph;
+using GlyphMaskStore = sktext::gpu::GlyphMaskStore;
 
 namespace skgpu::graphite {
 
@@ -52,103 +52,6 @@ bool AtlasManager::hasGlyph(MaskFormat format, Glyph* glyph) {
     return this->getAtlas(format)->hasID(glyph->fAtlasLocator.plotLocator());
 }
 
-template <typename INT_TYPE>
-static void expand_bits(INT_TYPE* dst,
-                        const uint8_t* src,
-                        int width,
-                        int height,
-                        int dstRowBytes,
-                        int srcRowBytes) {
-    for (int y = 0; y < height; ++y) {
-        int rowWritesLeft = width;
-        const uint8_t* s = src;
-        INT_TYPE* d = dst;
-        while (rowWritesLeft > 0) {
-            unsigned mask = *s++;
-            for (int x = 7; x >= 0 && rowWritesLeft; --x, --rowWritesLeft) {
-                *d++ = (mask & (1 << x)) ? (INT_TYPE)(~0UL) : 0;
-            }
-        }
-        dst = reinterpret_cast<INT_TYPE*>(reinterpret_cast<intptr_t>(dst) + dstRowBytes);
-        src += srcRowBytes;
-    }
-}
-
-static void get_packed_glyph_image(
-        const SkGlyph& glyph, int dstRB, MaskFormat expectedMaskFormat, void* dst) {
-    const int width = glyph.width();
-    const int height = glyph.height();
-    const void* src = glyph.image();
-    SkASSERT(src != nullptr);
-
-    MaskFormat maskFormat = Glyph::FormatFromSkGlyph(glyph.maskFormat());
-    if (maskFormat == expectedMaskFormat) {
-        int srcRB = glyph.rowBytes();
-        // Notice this comparison is with the glyphs raw mask format, and not its MaskFormat.
-        if (glyph.maskFormat() != SkMask::kBW_Format) {
-            if (srcRB != dstRB) {
-                const int bbp = MaskFormatBytesPerPixel(expectedMaskFormat);
-                for (int y = 0; y < height; y++) {
-                    memcpy(dst, src, width * bbp);
-                    src = (const char*) src + srcRB;
-                    dst = (char*) dst + dstRB;
-                }
-            } else {
-                memcpy(dst, src, dstRB * height);
-            }
-        } else {
-            // Handle 8-bit format by expanding the mask to the expected format.
-            const uint8_t* bits = reinterpret_cast<const uint8_t*>(src);
-            switch (expectedMaskFormat) {
-                case MaskFormat::kA8: {
-                    uint8_t* bytes = reinterpret_cast<uint8_t*>(dst);
-                    expand_bits(bytes, bits, width, height, dstRB, srcRB);
-                    break;
-                }
-                case MaskFormat::kA565: {
-                    uint16_t* rgb565 = reinterpret_cast<uint16_t*>(dst);
-                    expand_bits(rgb565, bits, width, height, dstRB, srcRB);
-                    break;
-                }
-                default:
-                    SK_ABORT("Invalid MaskFormat");
-            }
-        }
-    } else if (maskFormat == MaskFormat::kA565 &&
-               expectedMaskFormat == MaskFormat::kARGB) {
-        // Convert if the glyph uses a 565 mask format since it is using LCD text rendering
-        // but the expected format is 8888 (will happen on Intel MacOS with Metal since that
-        // combination does not support 565).
-        static constexpr SkMasks masks{
-                {0b1111'1000'0000'0000, 11, 5},  // Red
-                {0b0000'0111'1110'0000,  5, 6},  // Green
-                {0b0000'0000'0001'1111,  0, 5},  // Blue
-                {0, 0, 0}                        // Alpha
-        };
-        constexpr int a565Bpp = MaskFormatBytesPerPixel(MaskFormat::kA565);
-        constexpr int argbBpp = MaskFormatBytesPerPixel(MaskFormat::kARGB);
-        char* dstRow = (char*)dst;
-        for (int y = 0; y < height; y++) {
-            dst = dstRow;
-            for (int x = 0; x < width; x++) {
-                uint16_t color565 = 0;
-                memcpy(&color565, src, a565Bpp);
-                // TODO: create Graphite version of GrColorPackRGBA?
-                uint32_t colorRGBA = masks.getRed(color565) |
-                                     (masks.getGreen(color565) << 8) |
-                                     (masks.getBlue(color565) << 16) |
-                                     (0xFF << 24);
-                memcpy(dst, &colorRGBA, argbBpp);
-                src = (char*)src + a565Bpp;
-                dst = (char*)dst + argbBpp;
-            }
-            dstRow += dstRB;
-        }
-    } else {
-        SkUNREACHABLE;
-    }
-}
-
 MaskFormat AtlasManager::resolveMaskFormat(MaskFormat format) const {
     if (MaskFormat::kA565 == format &&
         !fRecorder->priv().caps()->getDefaultSampledTextureInfo(kRGB_565_SkColorType,
@@ -162,8 +65,9 @@ MaskFormat AtlasManager::resolveMaskFormat(MaskFormat format) const {
 
 // Returns kSucceeded if glyph successfully added to texture atlas, kTryAgain if a RenderPassTask
 // needs to be snapped before adding the glyph, and kError if it can't be added at all.
-DrawAtlas::ErrorCode AtlasManager::addGlyphToAtlas(const SkGlyph& skGlyph,
+DrawAtlas::ErrorCode AtlasManager::addGlyphToAtlas(SkBulkGlyphMetricsAndImages* glyphs,
                                                    Glyph* glyph,
+                                                   MaskFormat glyphFormat,
                                                    int srcPadding) {
 #if !defined(SK_DISABLE_SDF_TEXT)
     SkASSERT(0 <= srcPadding && srcPadding <= SK_DistanceFieldInset);
@@ -171,14 +75,9 @@ DrawAtlas::ErrorCode AtlasManager::addGlyphToAtlas(const SkGlyph& skGlyph,
     SkASSERT(0 <= srcPadding);
 #endif
 
-    if (skGlyph.image() == nullptr) {
-        return DrawAtlas::ErrorCode::kError;
-    }
     SkASSERT(glyph != nullptr);
 
-    MaskFormat glyphFormat = Glyph::FormatFromSkGlyph(skGlyph.maskFormat());
     MaskFormat expectedMaskFormat = this->resolveMaskFormat(glyphFormat);
-    int bytesPerPixel = MaskFormatBytesPerPixel(expectedMaskFormat);
 
     int padding;
     switch (srcPadding) {
@@ -209,27 +108,20 @@ DrawAtlas::ErrorCode AtlasManager::addGlyphToAtlas(const SkGlyph& skGlyph,
             return DrawAtlas::ErrorCode::kError;
     }
 
-    const int width = skGlyph.width() + 2*padding;
-    const int height = skGlyph.height() + 2*padding;
-    int rowBytes = width * bytesPerPixel;
-    size_t size = height * rowBytes;
-
-    // Temporary storage for normalizing glyph image.
-    SkAutoSMalloc<1024> storage(size);
-    void* dataPtr = storage.get();
-    if (padding > 0) {
-        sk_bzero(dataPtr, size);
-        // Advance in one row and one column.
-        dataPtr = (char*)(dataPtr) + rowBytes + bytesPerPixel;
+    // The normalized mask is shared by all the contexts in the process, so the glyph is only
+    // rasterized if no context has uploaded it recently.
+    GlyphMaskStore::Mask mask = GlyphMaskStore::Global()->findOrCreate(
+            glyphs->descriptor(), glyph->fPackedID, expectedMaskFormat, padding,
+            [&] { return glyphs->glyph(glyph->fPackedID); });
+    if (!mask) {
+        return DrawAtlas::ErrorCode::kError;
     }
 
-    get_packed_glyph_image(skGlyph, rowBytes, expectedMaskFormat, dataPtr);
-
     DrawAtlas* atlas = this->getAtlas(expectedMaskFormat);
     auto errorCode = atlas->addToAtlas(fRecorder,
-                                       width,
-                                       height,
-                                       storage.get(),
+                                       mask.fWidth,
+                                       mask.fHeight,
+                                       mask.fPixels->data(),
                                        &glyph->fAtlasLocator);
 
     if (errorCode == DrawAtlas::ErrorCode::kSucceeded) {
@@ -335,8 +227,8 @@ std::tuple<bool, int> GlyphVector::regenerateAtlas(int begin, int end,
             SkASSERT(gpuGlyph != nullptr);
 
             if (!atlasManager->hasGlyph(maskFormat, gpuGlyph)) {
-                const SkGlyph& skGlyph = *metricsAndImages.glyph(gpuGlyph->fPackedID);
-                auto code = atlasManager->addGlyphToAtlas(skGlyph, gpuGlyph, srcPadding);
+                auto code = atlasManager->addGlyphToAtlas(&metricsAndImages, gpuGlyph, maskFormat,
+                                                          srcPadding);
                 if (code != DrawAtlas::ErrorCode::kSucceeded) {
                     success = code != DrawAtlas::ErrorCode::kError;
                     break;
@@ -16,7 +16,7 @@
 namespace sktext::gpu {
 class Glyph;
 }
-class SkGlyph;
+class SkBulkGlyphMetricsAndImages;
 
 namespace skgpu::graphite {
 
@@ -49,8 +49,11 @@ public:
 
     bool hasGlyph(MaskFormat, sktext::gpu::Glyph*);
 
-    DrawAtlas::ErrorCode addGlyphToAtlas(const SkGlyph&,
-                                         sktext::gpu::Glyph*,
+    // Uploads the mask of 'glyph' from the process-wide GlyphMaskStore, rasterizing it with
+    // 'glyphs' only if the store does not have it.
+    DrawAtlas::ErrorCode addGlyphToAtlas(SkBulkGlyphMetricsAndImages* glyphs,
+                                         sktext::gpu::Glyph* glyph,
+                                         MaskFormat glyphFormat,
                                          int srcPadding);
 
     // To ensure the DrawAtlas does not evict the Glyph Mask from its texture backing store,
@@ -20,6 +20,7 @@
 #include "src/core/SkCachedData.h"
 #include "src/core/SkNextID.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkYUVAToRGB.h"
 #include "src/core/SkYUVPlanesCache.h"
 
 #if defined(SK_GANESH)
@@ -177,11 +178,7 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
         if (!cacheRec) {
             return false;
         }
-        bool success = false;
-        {   // make sure ScopedGenerator goes out of scope before we try readPixelsProxy
-            success = ScopedGenerator(fSharedGenerator)->getPixels(pmap);
-        }
-        if (!success && !this->readPixelsProxy(ctx, pmap)) {
+        if (!this->generatePixels(ctx, pmap)) {
             return false;
         }
         SkBitmapCache::Add(std::move(cacheRec), bitmap);
@@ -190,11 +187,7 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
         if (!bitmap->tryAllocPixels(this->imageInfo())) {
             return false;
         }
-        bool success = false;
-        {   // make sure ScopedGenerator goes out of scope before we try readPixelsProxy
-            success = ScopedGenerator(fSharedGenerator)->getPixels(bitmap->pixmap());
-        }
-        if (!success && !this->readPixelsProxy(ctx, bitmap->pixmap())) {
+        if (!this->generatePixels(ctx, bitmap->pixmap())) {
             return false;
         }
         bitmap->setImmutable();
@@ -203,6 +196,72 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
     return true;
 }
 
+bool SkImage_Lazy::generatePixels(GrDirectContext* ctx, const SkPixmap& pmap) const {
+    bool success = false;
+    {   // make sure ScopedGenerator goes out of scope before we try readPixelsProxy
+        success = ScopedGenerator(fSharedGenerator)->getPixels(pmap);
+    }
+    // Some generators can only produce planes. Other generators always take getPixels() so that
+    // the result doesn't depend on whether their planes happen to be in the SkYUVPlanesCache.
+    return success || this->readPixelsFromPlanes(pmap) ||
+           this->readPixelsProxy(ctx, pmap);
+}
+
+static SkYUVAPixmapInfo::SupportedDataTypes raster_supported_data_types() {
+    // SkYUVAToRGB only converts 8-bit planes.
+    SkYUVAPixmapInfo::SupportedDataTypes dataTypes;
+    for (int numChannels = 1; numChannels <= 4; ++numChannels) {
+        dataTypes.enableDataType(SkYUVAPixmapInfo::DataType::kUnorm8, numChannels);
+    }
+    return dataTypes;
+}
+
+bool SkImage_Lazy::readPixelsFromPlanes(const SkPixmap& pmap) const {
+    if (pmap.colorType() != kRGBA_8888_SkColorType && pmap.colorType() != kBGRA_8888_SkColorType) {
+        return false;
+    }
+    {
+        ScopedGenerator generator(fSharedGenerator);
+        // The planes convert to the generator's color space.
+        if (!SkColorSpace::Equals(generator->getInfo().colorSpace(), pmap.colorSpace())) {
+            return false;
+        }
+    }
+    SkYUVAPixmaps yuvaPixmaps;
+    sk_sp<SkCachedData> data = this->getPlanes(raster_supported_data_types(), &yuvaPixmaps);
+    return data && SkYUVAToRGB(yuvaPixmaps, pmap);
+}
+
+sk_sp<SkCachedData> SkImage_Lazy::getPlanes(
+        const SkYUVAPixmapInfo::SupportedDataTypes& supportedDataTypes,
+        SkYUVAPixmaps* yuvaPixmaps) const {
+    ScopedGenerator generator(fSharedGenerator);
+
+    sk_sp<SkCachedData> data(SkYUVPlanesCache::FindAndRef(generator->uniqueID(), yuvaPixmaps));
+
+    if (data) {
+        SkASSERT(yuvaPixmaps->isValid());
+        SkASSERT(yuvaPixmaps->yuvaInfo().dimensions() == this->dimensions());
+        return data;
+    }
+    SkYUVAPixmapInfo yuvaPixmapInfo;
+    if (!generator->queryYUVAInfo(supportedDataTypes, &yuvaPixmapInfo) ||
+        yuvaPixmapInfo.yuvaInfo().dimensions() != this->dimensions()) {
+        return nullptr;
+    }
+    data.reset(SkResourceCache::NewCachedData(yuvaPixmapInfo.computeTotalBytes()));
+    SkYUVAPixmaps tempPixmaps = SkYUVAPixmaps::FromExternalMemory(yuvaPixmapInfo,
+                                                                  data->writable_data());
+    SkASSERT(tempPixmaps.isValid());
+    if (!generator->getYUVAPlanes(tempPixmaps)) {
+        return nullptr;
+    }
+    // Decoding is done, cache the resulting YUV planes
+    *yuvaPixmaps = tempPixmaps;
+    SkYUVPlanesCache::Add(this->uniqueID(), data.get(), *yuvaPixmaps);
+    return data;
+}
+
 bool SkImage_Lazy::readPixelsProxy(GrDirectContext* ctx, const SkPixmap& pixmap) const {
 #if defined(SK_GANESH)
     if (!ctx) {
@@ -450,36 +509,6 @@ GrSurfaceProxyView SkImage_Lazy::textureProxyViewFromPlanes(GrRecordingContext*
     return sfc->readSurfaceView();
 }
 
-sk_sp<SkCachedData> SkImage_Lazy::getPlanes(
-        const SkYUVAPixmapInfo::SupportedDataTypes& supportedDataTypes,
-        SkYUVAPixmaps* yuvaPixmaps) const {
-    ScopedGenerator generator(fSharedGenerator);
-
-    sk_sp<SkCachedData> data(SkYUVPlanesCache::FindAndRef(generator->uniqueID(), yuvaPixmaps));
-
-    if (data) {
-        SkASSERT(yuvaPixmaps->isValid());
-        SkASSERT(yuvaPixmaps->yuvaInfo().dimensions() == this->dimensions());
-        return data;
-    }
-    SkYUVAPixmapInfo yuvaPixmapInfo;
-    if (!generator->queryYUVAInfo(supportedDataTypes, &yuvaPixmapInfo) ||
-        yuvaPixmapInfo.yuvaInfo().dimensions() != this->dimensions()) {
-        return nullptr;
-    }
-    data.reset(SkResourceCache::NewCachedData(yuvaPixmapInfo.computeTotalBytes()));
-    SkYUVAPixmaps tempPixmaps = SkYUVAPixmaps::FromExternalMemory(yuvaPixmapInfo,
-                                                                  data->writable_data());
-    SkASSERT(tempPixmaps.isValid());
-    if (!generator->getYUVAPlanes(tempPixmaps)) {
-        return nullptr;
-    }
-    // Decoding is done, cache the resulting YUV planes
-    *yuvaPixmaps = tempPixmaps;
-    SkYUVPlanesCache::Add(this->uniqueID(), data.get(), *yuvaPixmaps);
-    return data;
-}
-
 /*
  *  We have 4 ways to try to return a texture (in sorted order)
  *
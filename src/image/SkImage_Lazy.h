@@ -14,6 +14,7 @@
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkTypes.h"
+#include "include/core/SkYUVAPixmaps.h"
 #include "include/private/SkIDChangeListener.h"
 #include "include/private/base/SkMutex.h"
 #include "src/image/SkImage_Base.h"
@@ -24,7 +25,6 @@
 #include <tuple>
 
 #if defined(SK_GANESH)
-#include "include/core/SkYUVAPixmaps.h"
 class GrCaps;
 class GrDirectContext;
 class GrFragmentProcessor;
@@ -110,6 +110,14 @@ public:
 private:
     void addUniqueIDListener(sk_sp<SkIDChangeListener>) const;
     bool readPixelsProxy(GrDirectContext*, const SkPixmap&) const;
+    // Fills pmap from the generator, or from the image's YUVA planes if the generator only
+    // produces planes, or else from the texture that ctx makes from the image.
+    bool generatePixels(GrDirectContext*, const SkPixmap&) const;
+    // Converts the image's YUVA planes to pmap on the CPU, decoding them if they aren't already in
+    // the SkYUVPlanesCache.
+    bool readPixelsFromPlanes(const SkPixmap&) const;
+    sk_sp<SkCachedData> getPlanes(const SkYUVAPixmapInfo::SupportedDataTypes& supportedDataTypes,
+                                  SkYUVAPixmaps* pixmaps) const;
 #if defined(SK_GANESH)
     std::tuple<GrSurfaceProxyView, GrColorType> onAsView(GrRecordingContext*,
                                                          skgpu::Mipmapped,
@@ -122,8 +130,6 @@ private:
                                                                const SkRect*) const override;
 
     GrSurfaceProxyView textureProxyViewFromPlanes(GrRecordingContext*, skgpu::Budgeted) const;
-    sk_sp<SkCachedData> getPlanes(const SkYUVAPixmapInfo::SupportedDataTypes& supportedDataTypes,
-                                  SkYUVAPixmaps* pixmaps) const;
 #endif
 
 #if defined(SK_GRAPHITE)
@@ -13,9 +13,12 @@
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkYUVAInfo.h"
+#include "include/core/SkYUVAPixmaps.h"
 #include "include/private/base/SkMath.h"
 #include "src/core/SkCompressedDataUtils.h"
 #include "src/core/SkImagePriv.h"
+#include "src/core/SkYUVAToRGB.h"
 #include "src/image/SkImage_Base.h"
 #include "src/image/SkImage_Raster.h"
 
@@ -126,6 +129,34 @@ sk_sp<SkImage> RasterFromCompressedTextureData(sk_sp<SkData> data,
     return RasterFromBitmap(bitmap);
 }
 
+sk_sp<SkImage> RasterFromYUVAPixmaps(const SkYUVAPixmaps& pixmaps,
+                                     sk_sp<SkColorSpace> imageColorSpace) {
+    if (!pixmaps.isValid()) {
+        return nullptr;
+    }
+    const SkYUVAInfo& yuvaInfo = pixmaps.yuvaInfo();
+    SkAlphaType at = yuvaInfo.hasAlpha() ? kPremul_SkAlphaType : kOpaque_SkAlphaType;
+
+    SkImageInfo ii = SkImageInfo::MakeN32(yuvaInfo.width(), yuvaInfo.height(), at,
+                                          std::move(imageColorSpace));
+
+    if (!valid_args(ii, ii.minRowBytes(), nullptr)) {
+        return nullptr;
+    }
+
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocPixels(ii)) {
+        return nullptr;
+    }
+
+    if (!SkYUVAToRGB(pixmaps, bitmap.pixmap())) {
+        return nullptr;
+    }
+
+    bitmap.setImmutable();
+    return RasterFromBitmap(bitmap);
+}
+
 sk_sp<SkImage> RasterFromPixmap(const SkPixmap& pmap, RasterReleaseProc proc, ReleaseContext ctx) {
     size_t size;
     if (!valid_args(pmap.info(), pmap.rowBytes(), &size) || !pmap.addr()) {
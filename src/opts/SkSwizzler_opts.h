@@ -1384,6 +1384,298 @@ static void RGB_to_BGR1_portable(uint32_t dst[], const uint8_t* src, int count)
     }
 #endif
 
+// 16-bit per component sources are big-endian, so we keep the first (most significant) byte
+// of each component.
+static void RGBA16_to_RGBA_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = (uint32_t)src[6] << 24
+               | (uint32_t)src[4] << 16
+               | (uint32_t)src[2] <<  8
+               | (uint32_t)src[0] <<  0;
+        src += 8;
+    }
+}
+static void RGBA16_to_BGRA_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = (uint32_t)src[6] << 24
+               | (uint32_t)src[0] << 16
+               | (uint32_t)src[2] <<  8
+               | (uint32_t)src[4] <<  0;
+        src += 8;
+    }
+}
+static void RGB16_to_RGB1_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = (uint32_t)0xFF   << 24
+               | (uint32_t)src[4] << 16
+               | (uint32_t)src[2] <<  8
+               | (uint32_t)src[0] <<  0;
+        src += 6;
+    }
+}
+static void RGB16_to_BGR1_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = (uint32_t)0xFF   << 24
+               | (uint32_t)src[0] << 16
+               | (uint32_t)src[2] <<  8
+               | (uint32_t)src[4] <<  0;
+        src += 6;
+    }
+}
+#if defined(SK_ARM_HAS_NEON)
+    static void strip16_should_swaprb(bool kSwapRB,
+                                      uint32_t dst[], const uint8_t* src, int count) {
+        while (count >= 8) {
+            // Load 8 pixels, deinterleaved.  Read as little-endian, the most significant
+            // byte of each big-endian component is in the low half of its lane.
+            uint16x8x4_t rgba16 = vld4q_u16((const uint16_t*) src);
+
+            uint8x8x4_t rgba;
+            rgba.val[0] = vmovn_u16(rgba16.val[kSwapRB ? 2 : 0]);
+            rgba.val[1] = vmovn_u16(rgba16.val[1]);
+            rgba.val[2] = vmovn_u16(rgba16.val[kSwapRB ? 0 : 2]);
+            rgba.val[3] = vmovn_u16(rgba16.val[3]);
+
+            // Store 8 pixels.
+            vst4_u8((uint8_t*) dst, rgba);
+            src += 8*8;
+            dst += 8;
+            count -= 8;
+        }
+        auto proc = kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable;
+        proc(dst, src, count);
+    }
+
+    static void strip16_insert_alpha_should_swaprb(bool kSwapRB,
+                                                   uint32_t dst[], const uint8_t* src, int count) {
+        while (count >= 8) {
+            // Load 8 pixels, deinterleaved.
+            uint16x8x3_t rgb16 = vld3q_u16((const uint16_t*) src);
+
+            uint8x8x4_t rgba;
+            rgba.val[0] = vmovn_u16(rgb16.val[kSwapRB ? 2 : 0]);
+            rgba.val[1] = vmovn_u16(rgb16.val[1]);
+            rgba.val[2] = vmovn_u16(rgb16.val[kSwapRB ? 0 : 2]);
+            rgba.val[3] = vdup_n_u8(0xFF);
+
+            // Store 8 pixels.
+            vst4_u8((uint8_t*) dst, rgba);
+            src += 8*6;
+            dst += 8;
+            count -= 8;
+        }
+        auto proc = kSwapRB ? RGB16_to_BGR1_portable : RGB16_to_RGB1_portable;
+        proc(dst, src, count);
+    }
+
+    /*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_should_swaprb(false, dst, src, count);
+    }
+    /*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_should_swaprb(true, dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_insert_alpha_should_swaprb(false, dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_insert_alpha_should_swaprb(true, dst, src, count);
+    }
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    // As with gray_to_RGB1, we found no benefit from AVX-512 here.
+    static void strip16_should_swaprb(bool kSwapRB,
+                                      uint32_t dst[], const uint8_t* src, int count) {
+        const __m256i lo = _mm256_set1_epi16(0x00FF);
+        while (count >= 8) {
+            __m256i p0 = _mm256_loadu_si256((const __m256i*) (src +  0)),  // p0 p1 | p2 p3
+                    p1 = _mm256_loadu_si256((const __m256i*) (src + 32));  // p4 p5 | p6 p7
+
+            // Read as little-endian, the most significant byte of each big-endian
+            // component is in the low half of its lane.
+            if (kSwapRB) {
+                p0 = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(p0, 0xC6), 0xC6);
+                p1 = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(p1, 0xC6), 0xC6);
+            }
+            __m256i rgba = _mm256_packus_epi16(_mm256_and_si256(p0, lo),
+                                               _mm256_and_si256(p1, lo));
+
+            // packus works within 128-bit lanes, leaving p0 p1 p4 p5 | p2 p3 p6 p7.
+            rgba = _mm256_permute4x64_epi64(rgba, 0xD8);
+
+            _mm256_storeu_si256((__m256i*) dst, rgba);
+            src += 8*8;
+            dst += 8;
+            count -= 8;
+        }
+        auto proc = kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable;
+        proc(dst, src, count);
+    }
+
+    static void strip16_insert_alpha_should_swaprb(bool kSwapRB,
+                                                   uint32_t dst[], const uint8_t* src, int count) {
+        const __m256i alphaMask = _mm256_set1_epi32(0xFF000000);
+        const uint8_t X = 0xFF; // Used a placeholder.  The value of X is irrelevant.
+        __m256i expandLo, expandHi;
+        if (kSwapRB) {
+            expandLo = _mm256_setr_epi8(4,2,0,X, 10,8,6,X, X,X,X,X, X,X,X,X,
+                                        4,2,0,X, 10,8,6,X, X,X,X,X, X,X,X,X);
+            expandHi = _mm256_setr_epi8(X,X,X,X, X,X,X,X, 4,2,0,X, 10,8,6,X,
+                                        X,X,X,X, X,X,X,X, 4,2,0,X, 10,8,6,X);
+        } else {
+            expandLo = _mm256_setr_epi8(0,2,4,X, 6,8,10,X, X,X,X,X, X,X,X,X,
+                                        0,2,4,X, 6,8,10,X, X,X,X,X, X,X,X,X);
+            expandHi = _mm256_setr_epi8(X,X,X,X, X,X,X,X, 0,2,4,X, 6,8,10,X,
+                                        X,X,X,X, X,X,X,X, 0,2,4,X, 6,8,10,X);
+        }
+
+        // Each 16 byte load holds two pixels plus some of the next, so the last load of an
+        // iteration reads 4 bytes past the 8th pixel.  Stop while a 9th pixel is available.
+        while (count >= 9) {
+            auto load = [&](int pixel) {
+                return _mm_loadu_si128((const __m128i*) (src + 6*pixel));
+            };
+            __m256i p0145 = _mm256_inserti128_si256(_mm256_castsi128_si256(load(0)), load(4), 1),
+                    p2367 = _mm256_inserti128_si256(_mm256_castsi128_si256(load(2)), load(6), 1);
+
+            __m256i rgba = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(p0145, expandLo),
+                                                           _mm256_shuffle_epi8(p2367, expandHi)),
+                                           alphaMask);
+
+            _mm256_storeu_si256((__m256i*) dst, rgba);
+            src += 8*6;
+            dst += 8;
+            count -= 8;
+        }
+        auto proc = kSwapRB ? RGB16_to_BGR1_portable : RGB16_to_RGB1_portable;
+        proc(dst, src, count);
+    }
+
+    /*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_should_swaprb(false, dst, src, count);
+    }
+    /*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_should_swaprb(true, dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_insert_alpha_should_swaprb(false, dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_insert_alpha_should_swaprb(true, dst, src, count);
+    }
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+    static void strip16_should_swaprb(bool kSwapRB,
+                                      uint32_t dst[], const uint8_t* src, int count) {
+        const __m128i lo = _mm_set1_epi16(0x00FF);
+        while (count >= 4) {
+            __m128i p01 = _mm_loadu_si128((const __m128i*) (src +  0)),
+                    p23 = _mm_loadu_si128((const __m128i*) (src + 16));
+
+            // Read as little-endian, the most significant byte of each big-endian
+            // component is in the low half of its lane.
+            if (kSwapRB) {
+                p01 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p01, 0xC6), 0xC6);
+                p23 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p23, 0xC6), 0xC6);
+            }
+            __m128i rgba = _mm_packus_epi16(_mm_and_si128(p01, lo), _mm_and_si128(p23, lo));
+
+            _mm_storeu_si128((__m128i*) dst, rgba);
+            src += 4*8;
+            dst += 4;
+            count -= 4;
+        }
+        auto proc = kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable;
+        proc(dst, src, count);
+    }
+
+    static void strip16_insert_alpha_should_swaprb(bool kSwapRB,
+                                                   uint32_t dst[], const uint8_t* src, int count) {
+        const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+        const uint8_t X = 0xFF; // Used a placeholder.  The value of X is irrelevant.
+        __m128i expandLo, expandHi;
+        if (kSwapRB) {
+            expandLo = _mm_setr_epi8(4,2,0,X, 10,8,6,X, X,X,X,X, X,X,X,X);
+            expandHi = _mm_setr_epi8(X,X,X,X, X,X,X,X, 4,2,0,X, 10,8,6,X);
+        } else {
+            expandLo = _mm_setr_epi8(0,2,4,X, 6,8,10,X, X,X,X,X, X,X,X,X);
+            expandHi = _mm_setr_epi8(X,X,X,X, X,X,X,X, 0,2,4,X, 6,8,10,X);
+        }
+
+        // The second load reads 4 bytes past the 4th pixel, so stop while a 5th is available.
+        while (count >= 5) {
+            __m128i p01 = _mm_loadu_si128((const __m128i*) (src +  0)),
+                    p23 = _mm_loadu_si128((const __m128i*) (src + 12));
+
+            __m128i rgba = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(p01, expandLo),
+                                                     _mm_shuffle_epi8(p23, expandHi)),
+                                        alphaMask);
+
+            _mm_storeu_si128((__m128i*) dst, rgba);
+            src += 4*6;
+            dst += 4;
+            count -= 4;
+        }
+        auto proc = kSwapRB ? RGB16_to_BGR1_portable : RGB16_to_RGB1_portable;
+        proc(dst, src, count);
+    }
+
+    /*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_should_swaprb(false, dst, src, count);
+    }
+    /*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_should_swaprb(true, dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_insert_alpha_should_swaprb(false, dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+        strip16_insert_alpha_should_swaprb(true, dst, src, count);
+    }
+#else
+    /*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const uint8_t* src, int count) {
+        RGBA16_to_RGBA_portable(dst, src, count);
+    }
+    /*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const uint8_t* src, int count) {
+        RGBA16_to_BGRA_portable(dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+        RGB16_to_RGB1_portable(dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+        RGB16_to_BGR1_portable(dst, src, count);
+    }
+#endif
+
+// Color table lookups only gain from a hardware gather.
+static void index8_to_8888_portable(uint32_t dst[], const uint8_t* src, int count,
+                                    const uint32_t ctable[]) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = ctable[src[i]];
+    }
+}
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    /*not static*/ inline void index8_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                              const uint32_t ctable[]) {
+        while (count >= 16) {
+            __m128i indices = _mm_loadu_si128((const __m128i*) src);
+            __m256i lo = _mm256_i32gather_epi32((const int*) ctable,
+                                                _mm256_cvtepu8_epi32(indices), 4),
+                    hi = _mm256_i32gather_epi32((const int*) ctable,
+                                                _mm256_cvtepu8_epi32(_mm_srli_si128(indices, 8)),
+                                                4);
+            _mm256_storeu_si256((__m256i*) (dst + 0), lo);
+            _mm256_storeu_si256((__m256i*) (dst + 8), hi);
+            src += 16;
+            dst += 16;
+            count -= 16;
+        }
+        index8_to_8888_portable(dst, src, count, ctable);
+    }
+#else
+    /*not static*/ inline void index8_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                              const uint32_t ctable[]) {
+        index8_to_8888_portable(dst, src, count, ctable);
+    }
+#endif
+
 }  // namespace SK_OPTS_NS
 
 #endif // SkSwizzler_opts_DEFINED
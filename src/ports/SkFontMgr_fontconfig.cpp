@@ -13,6 +13,7 @@
 #include "include/core/SkString.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
+#include "include/private/SkChecksum.h"
 #include "include/private/base/SkFixed.h"
 #include "include/private/base/SkMath.h"
 #include "include/private/base/SkMutex.h"
@@ -20,6 +21,7 @@
 #include "include/private/base/SkTemplates.h"
 #include "src/core/SkAdvancedTypefaceMetrics.h"
 #include "src/core/SkFontDescriptor.h"
+#include "src/core/SkLRUCache.h"
 #include "src/core/SkOSFile.h"
 #include "src/core/SkTypefaceCache.h"
 #include "src/ports/SkFontHost_FreeType_common.h"
@@ -673,12 +675,59 @@ class SkFontMgr_fontconfig : public SkFontMgr {
         return face;
     }
 
+    /** Key for the results of onMatchFamilyStyleCharacter, failed matches included.
+     *  Results are kept per character: the best match for one character of a block is not
+     *  necessarily the one FcFontMatch picks for its neighbours, even when it covers them.
+     */
+    struct FallbackKey {
+        SkString fFamilyName;
+        SkString fLanguages;
+        SkFontStyle fStyle;
+        SkUnichar fCharacter;
+
+        bool operator==(const FallbackKey& that) const {
+            return fCharacter == that.fCharacter &&
+                   fStyle == that.fStyle &&
+                   fFamilyName == that.fFamilyName &&
+                   fLanguages == that.fLanguages;
+        }
+        struct Hash {
+            uint32_t operator()(const FallbackKey& key) const {
+                return SkGoodHash()(key.fFamilyName) ^
+                       SkGoodHash()(key.fLanguages) ^
+                       SkGoodHash()(key.fStyle) ^
+                       SkChecksum::Mix(key.fCharacter);
+            }
+        };
+    };
+    static constexpr int kFallbackCacheSize = 4096;
+
+    mutable SkMutex fFallbackCacheMutex;
+    mutable SkLRUCache<FallbackKey, sk_sp<SkTypeface>, FallbackKey::Hash> fFallbackCache
+            SK_GUARDED_BY(fFallbackCacheMutex);
+    // The number of fonts known to fFC when the cache was filled; the cache is dropped
+    // as soon as fonts are added to (or removed from) the config.
+    mutable int fFallbackCacheFontCount SK_GUARDED_BY(fFallbackCacheMutex);
+
+    /** Must hold FCLocker. */
+    int countFonts() const {
+        int count = 0;
+        for (FcSetName setName : { FcSetSystem, FcSetApplication }) {
+            if (FcFontSet* fontSet = FcConfigGetFonts(fFC, setName)) {
+                count += fontSet->nfont;
+            }
+        }
+        return count;
+    }
+
 public:
     /** Takes control of the reference to 'config'. */
     explicit SkFontMgr_fontconfig(FcConfig* config)
         : fFC(config ? config : FcInitLoadConfigAndFonts())
         , fSysroot(reinterpret_cast<const char*>(FcConfigGetSysRoot(fFC)))
-        , fFamilyNames(GetFamilyNames(fFC)) { }
+        , fFamilyNames(GetFamilyNames(fFC))
+        , fFallbackCache(kFallbackCacheSize)
+        , fFallbackCacheFontCount(-1) { }
 
     ~SkFontMgr_fontconfig() override {
         // Hold the lock while unrefing the config.
@@ -872,6 +921,31 @@ protected:
                                                   int bcp47Count,
                                                   SkUnichar character) const override
     {
+        FallbackKey key;
+        key.fFamilyName = familyName ? familyName : "";
+        for (int i = 0; i < bcp47Count; ++i) {
+            key.fLanguages.append(bcp47[i]);
+            key.fLanguages.append(";");
+        }
+        key.fStyle = style;
+        key.fCharacter = character;
+
+        const int fontCount = [&]() {
+            FCLocker lock;
+            return this->countFonts();
+        }();
+        {
+            // Cannot hold FCLocker here; dropped typefaces may need to lock.
+            SkAutoMutexExclusive ama(fFallbackCacheMutex);
+            if (fFallbackCacheFontCount != fontCount) {
+                fFallbackCache.reset();
+                fFallbackCacheFontCount = fontCount;
+            }
+            if (sk_sp<SkTypeface>* found = fFallbackCache.find(key)) {
+                return *found;
+            }
+        }
+
         SkAutoFcPattern font([&](){
             FCLocker lock;
 
@@ -907,7 +981,13 @@ protected:
             }
             return font;
         }());
-        return createTypefaceFromFcPattern(std::move(font));
+        sk_sp<SkTypeface> typeface = createTypefaceFromFcPattern(std::move(font));
+
+        SkAutoMutexExclusive ama(fFallbackCacheMutex);
+        if (fFallbackCacheFontCount == fontCount) {
+            fFallbackCache.insert_or_update(key, typeface);
+        }
+        return typeface;
     }
 
     sk_sp<SkTypeface> onMakeFromStreamIndex(std::unique_ptr<SkStreamAsset> stream,
@@ -0,0 +1,293 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/text/gpu/GlyphMaskStore.h"
+
+#include "src/codec/SkMasks.h"
+#include "src/text/gpu/Glyph.h"
+
+#include <cstring>
+
+using MaskFormat = skgpu::MaskFormat;
+
+namespace sktext::gpu {
+
+struct GlyphMaskStore::Strike {
+    explicit Strike(const SkDescriptor& desc, uint32_t id) : fDescriptor{desc}, fID{id} {}
+
+    SkAutoDescriptor fDescriptor;
+    const uint32_t fID;
+    int fMaskCount = 0;
+};
+
+struct GlyphMaskStore::Node {
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(Node);
+
+    MaskKey fKey;
+    Strike* fStrike;
+    Mask fMask;
+};
+
+const SkDescriptor& GlyphMaskStore::StrikeTraits::GetKey(const std::unique_ptr<Strike>& strike) {
+    return *strike->fDescriptor.getDesc();
+}
+
+uint32_t GlyphMaskStore::StrikeTraits::Hash(const SkDescriptor& descriptor) {
+    return descriptor.getChecksum();
+}
+
+GlyphMaskStore* GlyphMaskStore::Global() {
+    static auto* store = new GlyphMaskStore;
+    return store;
+}
+
+GlyphMaskStore::GlyphMaskStore(size_t byteLimit) : fByteLimit(byteLimit) {}
+
+GlyphMaskStore::~GlyphMaskStore() = default;
+
+GlyphMaskStore::Mask GlyphMaskStore::findOrCreate(const SkDescriptor& strikeDesc,
+                                                  SkPackedGlyphID packedID,
+                                                  MaskFormat atlasFormat,
+                                                  int padding,
+                                                  const std::function<const SkGlyph*()>& getGlyph) {
+    SkASSERT(0 <= padding && padding <= UINT8_MAX);
+    {
+        SkAutoMutexExclusive lock(fLock);
+        if (std::unique_ptr<Strike>* strike = fStrikes.find(strikeDesc)) {
+            MaskKey key{(*strike)->fID, packedID, (uint8_t)atlasFormat, (uint8_t)padding};
+            if (std::unique_ptr<Node>* node = fMasks.find(key)) {
+                fLRU.remove(node->get());
+                fLRU.addToHead(node->get());
+                ++fHits;
+                return (*node)->fMask;
+            }
+        }
+        ++fMisses;
+    }
+
+    // Rasterize and normalize outside of the lock so that other threads are not blocked on it.
+    const SkGlyph* glyph = getGlyph();
+    if (glyph == nullptr || glyph->image() == nullptr) {
+        return {};
+    }
+    Mask mask;
+    mask.fWidth = glyph->width() + 2 * padding;
+    mask.fHeight = glyph->height() + 2 * padding;
+    sk_sp<SkData> pixels = SkData::MakeUninitialized(PaddedMaskSize(*glyph, atlasFormat, padding));
+    PackPaddedGlyphImage(*glyph, atlasFormat, padding, pixels->writable_data());
+    mask.fPixels = std::move(pixels);
+
+    SkAutoMutexExclusive lock(fLock);
+    if (mask.fPixels->size() > fByteLimit) {
+        return mask;
+    }
+    Strike* strike = this->findOrCreateStrike(strikeDesc);
+    MaskKey key{strike->fID, packedID, (uint8_t)atlasFormat, (uint8_t)padding};
+    if (std::unique_ptr<Node>* existing = fMasks.find(key)) {
+        // Another thread stored the same mask while this one was rasterizing it.
+        return (*existing)->fMask;
+    }
+    auto node = std::make_unique<Node>();
+    node->fKey = key;
+    node->fStrike = strike;
+    node->fMask = mask;
+    strike->fMaskCount++;
+    fBytesUsed += mask.fPixels->size();
+    fLRU.addToHead(node.get());
+    fMasks.set(key, std::move(node));
+    this->purgeToLimit();
+    return mask;
+}
+
+GlyphMaskStore::Strike* GlyphMaskStore::findOrCreateStrike(const SkDescriptor& desc) {
+    if (std::unique_ptr<Strike>* strike = fStrikes.find(desc)) {
+        return strike->get();
+    }
+    auto strike = std::make_unique<Strike>(desc, fNextStrikeID++);
+    Strike* result = strike.get();
+    fStrikes.set(std::move(strike));
+    return result;
+}
+
+void GlyphMaskStore::removeNode(Node* node) {
+    fLRU.remove(node);
+    fBytesUsed -= node->fMask.fPixels->size();
+    Strike* strike = node->fStrike;
+    // Destroys the node.
+    fMasks.remove(MaskKey{node->fKey});
+    if (--strike->fMaskCount == 0) {
+        SkAutoDescriptor desc{*strike->fDescriptor.getDesc()};
+        fStrikes.remove(*desc.getDesc());
+    }
+}
+
+void GlyphMaskStore::purgeToLimit() {
+    while (fBytesUsed > fByteLimit) {
+        Node* node = fLRU.tail();
+        SkASSERT(node);
+        this->removeNode(node);
+    }
+}
+
+void GlyphMaskStore::setByteLimit(size_t byteLimit) {
+    SkAutoMutexExclusive lock(fLock);
+    fByteLimit = byteLimit;
+    this->purgeToLimit();
+}
+
+size_t GlyphMaskStore::byteLimit() const {
+    SkAutoMutexExclusive lock(fLock);
+    return fByteLimit;
+}
+
+size_t GlyphMaskStore::bytesUsed() const {
+    SkAutoMutexExclusive lock(fLock);
+    return fBytesUsed;
+}
+
+int GlyphMaskStore::maskCount() const {
+    SkAutoMutexExclusive lock(fLock);
+    return fMasks.count();
+}
+
+void GlyphMaskStore::purgeAll() {
+    SkAutoMutexExclusive lock(fLock);
+    while (Node* node = fLRU.tail()) {
+        this->removeNode(node);
+    }
+    SkASSERT(fBytesUsed == 0);
+    SkASSERT(fStrikes.count() == 0);
+}
+
+int GlyphMaskStore::hitCount() const {
+    SkAutoMutexExclusive lock(fLock);
+    return fHits;
+}
+
+int GlyphMaskStore::missCount() const {
+    SkAutoMutexExclusive lock(fLock);
+    return fMisses;
+}
+
+size_t GlyphMaskStore::PaddedMaskSize(const SkGlyph& glyph, MaskFormat atlasFormat, int padding) {
+    return (size_t)(glyph.width() + 2 * padding) * (glyph.height() + 2 * padding) *
+           MaskFormatBytesPerPixel(atlasFormat);
+}
+
+void GlyphMaskStore::PackPaddedGlyphImage(const SkGlyph& glyph,
+                                          MaskFormat atlasFormat,
+                                          int padding,
+                                          void* dst) {
+    const int bytesPerPixel = MaskFormatBytesPerPixel(atlasFormat);
+    const size_t rowBytes = (glyph.width() + 2 * padding) * bytesPerPixel;
+    if (padding > 0) {
+        sk_bzero(dst, PaddedMaskSize(glyph, atlasFormat, padding));
+        dst = static_cast<char*>(dst) + padding * (rowBytes + bytesPerPixel);
+    }
+    PackGlyphImage(glyph, atlasFormat, rowBytes, dst);
+}
+
+template <typename INT_TYPE>
+static void expand_bits(INT_TYPE* dst,
+                        const uint8_t* src,
+                        int width,
+                        int height,
+                        int dstRowBytes,
+                        int srcRowBytes) {
+    for (int y = 0; y < height; ++y) {
+        int rowWritesLeft = width;
+        const uint8_t* s = src;
+        INT_TYPE* d = dst;
+        while (rowWritesLeft > 0) {
+            unsigned mask = *s++;
+            for (int x = 7; x >= 0 && rowWritesLeft; --x, --rowWritesLeft) {
+                *d++ = (mask & (1 << x)) ? (INT_TYPE)(~0UL) : 0;
+            }
+        }
+        dst = reinterpret_cast<INT_TYPE*>(reinterpret_cast<intptr_t>(dst) + dstRowBytes);
+        src += srcRowBytes;
+    }
+}
+
+void GlyphMaskStore::PackGlyphImage(const SkGlyph& glyph,
+                                    MaskFormat expectedMaskFormat,
+                                    size_t dstRB,
+                                    void* dst) {
+    const int width = glyph.width();
+    const int height = glyph.height();
+    const void* src = glyph.image();
+    SkASSERT(src != nullptr);
+
+    MaskFormat maskFormat = Glyph::FormatFromSkGlyph(glyph.maskFormat());
+    if (maskFormat == expectedMaskFormat) {
+        size_t srcRB = glyph.rowBytes();
+        // Notice this comparison is with the glyphs raw mask format, and not its MaskFormat.
+        if (glyph.maskFormat() != SkMask::kBW_Format) {
+            if (srcRB != dstRB) {
+                const int bbp = MaskFormatBytesPerPixel(expectedMaskFormat);
+                for (int y = 0; y < height; y++) {
+                    memcpy(dst, src, width * bbp);
+                    src = (const char*) src + srcRB;
+                    dst = (char*) dst + dstRB;
+                }
+            } else {
+                memcpy(dst, src, dstRB * height);
+            }
+        } else {
+            // Handle 8-bit format by expanding the mask to the expected format.
+            const uint8_t* bits = reinterpret_cast<const uint8_t*>(src);
+            switch (expectedMaskFormat) {
+                case MaskFormat::kA8: {
+                    uint8_t* bytes = reinterpret_cast<uint8_t*>(dst);
+                    expand_bits(bytes, bits, width, height, dstRB, srcRB);
+                    break;
+                }
+                case MaskFormat::kA565: {
+                    uint16_t* rgb565 = reinterpret_cast<uint16_t*>(dst);
+                    expand_bits(rgb565, bits, width, height, dstRB, srcRB);
+                    break;
+                }
+                default:
+                    SK_ABORT("Invalid MaskFormat");
+            }
+        }
+    } else if (maskFormat == MaskFormat::kA565 &&
+               expectedMaskFormat == MaskFormat::kARGB) {
+        // Convert if the glyph uses a 565 mask format since it is using LCD text rendering
+        // but the expected format is 8888 (will happen on macOS with Metal since that
+        // combination does not support 565).
+        static constexpr SkMasks masks{
+                {0b1111'1000'0000'0000, 11, 5},  // Red
+                {0b0000'0111'1110'0000,  5, 6},  // Green
+                {0b0000'0000'0001'1111,  0, 5},  // Blue
+                {0, 0, 0}                        // Alpha
+        };
+        constexpr int a565Bpp = MaskFormatBytesPerPixel(MaskFormat::kA565);
+        constexpr int argbBpp = MaskFormatBytesPerPixel(MaskFormat::kARGB);
+        char* dstRow = (char*)dst;
+        for (int y = 0; y < height; y++) {
+            dst = dstRow;
+            for (int x = 0; x < width; x++) {
+                uint16_t color565 = 0;
+                memcpy(&color565, src, a565Bpp);
+                // RGBA in memory regardless of endianness, matching GrColorPackRGBA.
+                const uint8_t colorRGBA[4] = {(uint8_t)masks.getRed(color565),
+                                              (uint8_t)masks.getGreen(color565),
+                                              (uint8_t)masks.getBlue(color565),
+                                              0xFF};
+                memcpy(dst, colorRGBA, argbBpp);
+                src = (char*)src + a565Bpp;
+                dst = (char*)dst + argbBpp;
+            }
+            dstRow += dstRB;
+        }
+    } else {
+        SkUNREACHABLE;
+    }
+}
+
+}  // namespace sktext::gpu
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef sktext_gpu_GlyphMaskStore_DEFINED
+#define sktext_gpu_GlyphMaskStore_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include "src/base/SkTInternalLList.h"
+#include "src/core/SkDescriptor.h"
+#include "src/core/SkGlyph.h"
+#include "src/core/SkTHash.h"
+#include "src/gpu/AtlasTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// The default size of the process-wide glyph mask store. It can be set using -D on your compiler
+// command line or by calling GlyphMaskStore::Global()->setByteLimit().
+#ifndef SK_DEFAULT_GLYPH_MASK_STORE_LIMIT
+    #define SK_DEFAULT_GLYPH_MASK_STORE_LIMIT (2 * 1024 * 1024)
+#endif
+
+namespace sktext::gpu {
+
+// GlyphMaskStore is a process-wide cache of glyph masks that have already been padded and
+// converted to the format of a glyph atlas, ready to be uploaded. The atlas managers of every
+// Ganesh and Graphite context pull from it, so a glyph that is drawn by several contexts is only
+// rasterized and normalized once per process; every other context's upload copies the stored
+// bytes. Masks are evicted in least recently used order once the store exceeds its byte limit.
+// Setting the limit to zero turns the sharing off: every upload is then packed afresh.
+class GlyphMaskStore {
+public:
+    // An atlas-ready glyph mask. The pixels are tightly packed (rowBytes = width * bytes per pixel
+    // of the atlas format) and include any padding that was requested.
+    struct Mask {
+        sk_sp<SkData> fPixels;
+        int fWidth = 0;
+        int fHeight = 0;
+
+        explicit operator bool() const { return fPixels != nullptr; }
+    };
+
+    // The store shared by all the contexts in the process.
+    static GlyphMaskStore* Global();
+
+    explicit GlyphMaskStore(size_t byteLimit = SK_DEFAULT_GLYPH_MASK_STORE_LIMIT);
+    ~GlyphMaskStore();
+
+    // Returns the mask of the glyph 'packedID' from the strike described by 'strikeDesc', converted
+    // to 'atlasFormat' and surrounded by 'padding' pixels of transparency. On a miss, 'getGlyph' is
+    // called (without holding the store's lock) to get the rasterized glyph. Returns an empty Mask
+    // if the glyph has no image.
+    Mask findOrCreate(const SkDescriptor& strikeDesc,
+                      SkPackedGlyphID packedID,
+                      skgpu::MaskFormat atlasFormat,
+                      int padding,
+                      const std::function<const SkGlyph*()>& getGlyph);
+
+    // Writes the image of 'glyph' to 'dst' converted to 'atlasFormat'. 'dst' must be big enough
+    // for glyph.height() rows of 'dstRowBytes'.
+    static void PackGlyphImage(const SkGlyph& glyph,
+                               skgpu::MaskFormat atlasFormat,
+                               size_t dstRowBytes,
+                               void* dst);
+
+    // Writes the mask that findOrCreate() would return for 'glyph' to 'dst', which must hold
+    // PaddedMaskSize() bytes.
+    static size_t PaddedMaskSize(const SkGlyph& glyph, skgpu::MaskFormat atlasFormat, int padding);
+    static void PackPaddedGlyphImage(const SkGlyph& glyph,
+                                     skgpu::MaskFormat atlasFormat,
+                                     int padding,
+                                     void* dst);
+
+    void setByteLimit(size_t byteLimit);
+    size_t byteLimit() const;
+    size_t bytesUsed() const;
+    int maskCount() const;
+    void purgeAll();
+
+    // The number of findOrCreate() calls satisfied by a stored mask, and those that were not.
+    int hitCount() const;
+    int missCount() const;
+
+private:
+    struct Strike;
+    struct Node;
+    struct MaskKey {
+        uint32_t fStrikeID;
+        SkPackedGlyphID fPackedID;
+        uint8_t fAtlasFormat;
+        uint8_t fPadding;
+        uint16_t fUnused = 0;
+
+        bool operator==(const MaskKey& that) const {
+            return fStrikeID == that.fStrikeID && fPackedID == that.fPackedID &&
+                   fAtlasFormat == that.fAtlasFormat && fPadding == that.fPadding;
+        }
+    };
+
+    struct StrikeTraits {
+        static const SkDescriptor& GetKey(const std::unique_ptr<Strike>& strike);
+        static uint32_t Hash(const SkDescriptor& descriptor);
+    };
+
+    Strike* findOrCreateStrike(const SkDescriptor&) SK_REQUIRES(fLock);
+    void purgeToLimit() SK_REQUIRES(fLock);
+    void removeNode(Node*) SK_REQUIRES(fLock);
+
+    mutable SkMutex fLock;
+    skia_private::THashTable<std::unique_ptr<Strike>, SkDescriptor, StrikeTraits> fStrikes
+            SK_GUARDED_BY(fLock);
+    skia_private::THashMap<MaskKey, std::unique_ptr<Node>> fMasks SK_GUARDED_BY(fLock);
+    SkTInternalLList<Node> fLRU SK_GUARDED_BY(fLock);
+    uint32_t fNextStrikeID SK_GUARDED_BY(fLock) = 1;
+    size_t fByteLimit SK_GUARDED_BY(fLock);
+    size_t fBytesUsed SK_GUARDED_BY(fLock) = 0;
+    int fHits SK_GUARDED_BY(fLock) = 0;
+    int fMisses SK_GUARDED_BY(fLock) = 0;
+};
+
+}  // namespace sktext::gpu
+
+#endif  // sktext_gpu_GlyphMaskStore_DEFINED
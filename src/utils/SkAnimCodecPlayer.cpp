@@ -13,6 +13,7 @@
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
@@ -22,6 +23,7 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <algorithm>
 #include <cstddef>
@@ -33,6 +35,7 @@ SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(st
     fImageInfo = fCodec->getInfo();
     fFrameInfos = fCodec->getFrameInfo();
     fImages.resize(fFrameInfos.size());
+    fLastUse.resize(fFrameInfos.size());
 
     // change the interpretation of fDuration to a end-time for that frame
     size_t dur = 0;
@@ -51,7 +54,10 @@ SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(st
     }
 }
 
-SkAnimCodecPlayer::~SkAnimCodecPlayer() {}
+SkAnimCodecPlayer::~SkAnimCodecPlayer() {
+    // The decode ahead tasks use this player.
+    fDecodeAhead.reset();
+}
 
 SkISize SkAnimCodecPlayer::dimensions() const {
     if (!fCodec) {
@@ -67,10 +73,37 @@ SkISize SkAnimCodecPlayer::dimensions() const {
 sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
     SkASSERT((unsigned)index < fFrameInfos.size());
 
+    fLastUse[index] = ++fUseCount;
     if (fImages[index]) {
         return fImages[index];
     }
 
+    // Decode the frames this one depends on that are not decoded yet, back to one that is, or
+    // that does not depend on another frame. Otherwise the codec would replay them itself, and
+    // the next seek would have to replay them again.
+    std::vector<int> frames = {index};
+    for (int required = fFrameInfos[index].fRequiredFrame;
+         required != SkCodec::kNoFrame && !fImages[required];
+         required = fFrameInfos[required].fRequiredFrame) {
+        frames.push_back(required);
+    }
+    const int firstRequired = fFrameInfos[frames.back()].fRequiredFrame;
+    sk_sp<SkImage> image = firstRequired != SkCodec::kNoFrame ? fImages[firstRequired] : nullptr;
+    for (auto frame = frames.rbegin(); frame != frames.rend(); ++frame) {
+        image = this->decodeFrame(*frame, image);
+        if (!image) {
+            return nullptr;
+        }
+        if (*frame == index || *frame % fKeyFrameInterval == 0) {
+            this->cacheFrame(*frame, image);
+        }
+    }
+    return image;
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::decodeFrame(int index, const sk_sp<SkImage>& requiredImage) {
+    SkASSERT(SkToBool(requiredImage) == (fFrameInfos[index].fRequiredFrame != SkCodec::kNoFrame));
+
     size_t rb = fImageInfo.minRowBytes();
     size_t size = fImageInfo.computeByteSize(rb);
     auto data = SkData::MakeUninitialized(size);
@@ -90,9 +123,7 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
     if (fFrameInfos[index].fAlphaType != kOpaque_SkAlphaType && imageInfo.isOpaque()) {
         imageInfo = imageInfo.makeAlphaType(kPremul_SkAlphaType);
     }
-    const int requiredFrame = fFrameInfos[index].fRequiredFrame;
-    if (requiredFrame != SkCodec::kNoFrame && fImages[requiredFrame]) {
-        auto requiredImage = fImages[requiredFrame];
+    if (requiredImage) {
         auto canvas = SkCanvas::MakeRasterDirect(imageInfo, data->writable_data(), rb);
         if (origin != kDefault_SkEncodedOrigin) {
             // The required frame is stored after applying the origin. Undo that,
@@ -107,7 +138,7 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
             canvas->concat(inverse);
         }
         canvas->drawImage(requiredImage, 0, 0, SkSamplingOptions(), &paint);
-        opts.fPriorFrame = requiredFrame;
+        opts.fPriorFrame = fFrameInfos[index].fRequiredFrame;
     }
 
     if (SkCodec::kSuccess != fCodec->getPixels(imageInfo, data->writable_data(), rb, &opts)) {
@@ -125,15 +156,79 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
         canvas->drawImage(image, 0, 0, SkSamplingOptions(), &paint);
         image = SkImages::RasterFromData(imageInfo, std::move(data), rb);
     }
-    return fImages[index] = image;
+    return image;
+}
+
+void SkAnimCodecPlayer::cacheFrame(int index, sk_sp<SkImage> image) {
+    SkASSERT(!fImages[index]);
+    fCacheBytes += image->imageInfo().computeMinByteSize();
+    fImages[index] = std::move(image);
+    fLastUse[index] = ++fUseCount;
+    this->purgeFrames();
+}
+
+void SkAnimCodecPlayer::purgeFrames() {
+    const int keyFrameInterval = fKeyFrameInterval;
+    auto isKeyFrame = [keyFrameInterval](int index) { return index % keyFrameInterval == 0; };
+    while (fCacheBytes > fCacheLimit) {
+        // Release the least recently used frame other than the current one, preferring frames
+        // that are not key frames.
+        int victim = -1;
+        for (int i = 0; i < (int)fImages.size(); ++i) {
+            if (!fImages[i] || i == fCurrIndex) {
+                continue;
+            }
+            if (victim < 0 ||
+                (isKeyFrame(i) != isKeyFrame(victim) ? !isKeyFrame(i)
+                                                     : fLastUse[i] < fLastUse[victim])) {
+                victim = i;
+            }
+        }
+        if (victim < 0) {
+            break;
+        }
+        fCacheBytes -= fImages[victim]->imageInfo().computeMinByteSize();
+        fImages[victim] = nullptr;
+    }
+}
+
+void SkAnimCodecPlayer::decodeAhead() {
+    if (!fDecodeAhead) {
+        return;
+    }
+    const int next = (fCurrIndex + 1) % (int)fFrameInfos.size();
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        // Replaying dependencies would hold the codec for longer than the caller is likely to
+        // spend drawing the current frame, so only frames that are ready to decode are started.
+        const int required = fFrameInfos[next].fRequiredFrame;
+        if (fImages[next] || fDecodeAheadIndex == next ||
+            (required != SkCodec::kNoFrame && !fImages[required])) {
+            return;
+        }
+        fDecodeAheadIndex = next;
+    }
+    fDecodeAhead->add([this, next] {
+        SkAutoMutexExclusive lock(fMutex);
+        this->getFrameAt(next);
+        fDecodeAheadIndex = -1;
+    });
 }
 
 sk_sp<SkImage> SkAnimCodecPlayer::getFrame() {
     SkASSERT(fTotalDuration > 0 || fImages.size() == 1);
 
-    return fTotalDuration > 0
-        ? this->getFrameAt(fCurrIndex)
-        : fImages.front();
+    if (!fTotalDuration) {
+        return fImages.front();
+    }
+
+    sk_sp<SkImage> image;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        image = this->getFrameAt(fCurrIndex);
+    }
+    this->decodeAhead();
+    return image;
 }
 
 bool SkAnimCodecPlayer::seek(uint32_t msec) {
@@ -148,8 +243,37 @@ bool SkAnimCodecPlayer::seek(uint32_t msec) {
                                       return (uint32_t)info.fDuration <= msec;
                                   });
     int prevIndex = fCurrIndex;
-    fCurrIndex = lower - fFrameInfos.begin();
+    {
+        // The decode ahead tasks read fCurrIndex to keep the current frame.
+        SkAutoMutexExclusive lock(fMutex);
+        fCurrIndex = lower - fFrameInfos.begin();
+    }
     return fCurrIndex != prevIndex;
 }
 
+void SkAnimCodecPlayer::setFrameCacheLimit(size_t bytes) {
+    SkAutoMutexExclusive lock(fMutex);
+    fCacheLimit = bytes;
+    this->purgeFrames();
+}
+
+void SkAnimCodecPlayer::setKeyFrameInterval(int interval) {
+    SkAutoMutexExclusive lock(fMutex);
+    fKeyFrameInterval = std::max(interval, 1);
+    this->purgeFrames();
+}
+
+void SkAnimCodecPlayer::setDecodeAheadExecutor(SkExecutor* executor) {
+    // Finish the tasks on the previous executor, which may go away after this call.
+    fDecodeAhead.reset();
+    if (executor && fTotalDuration) {
+        fDecodeAhead = std::make_unique<SkTaskGroup>(*executor);
+    }
+}
+
+size_t SkAnimCodecPlayer::frameCacheBytes() {
+    SkAutoMutexExclusive lock(fMutex);
+    return fCacheBytes;
+}
+
 
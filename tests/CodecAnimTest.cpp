@@ -13,6 +13,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
@@ -626,3 +627,49 @@ DEF_TEST(AnimCodecPlayer, r) {
                         "Mismatched size for frame at 500 ms of %s", test.fFile);
     }
 }
+
+DEF_TEST(AnimCodecPlayer_frameCache, r) {
+    for (const char* file : {"images/alphabetAnim.gif", "images/required.webp",
+                             "images/stoplight.webp"}) {
+        sk_sp<SkData> data = GetResourceAsData(file);
+        if (!data) {
+            continue;
+        }
+        std::vector<uint32_t> frameTimes;
+        uint32_t time = 0;
+        for (const SkCodec::FrameInfo& info : SkCodec::MakeFromData(data)->getFrameInfo()) {
+            frameTimes.push_back(time);
+            time += info.fDuration;
+        }
+
+        // Without a limit, every frame is kept.
+        SkAnimCodecPlayer expected(SkCodec::MakeFromData(data));
+        std::vector<sk_sp<SkImage>> expectedFrames;
+        for (uint32_t frameTime : frameTimes) {
+            expected.seek(frameTime);
+            expectedFrames.push_back(expected.getFrame());
+            REPORTER_ASSERT(r, expectedFrames.back());
+        }
+        const size_t frameBytes = expectedFrames.front()->imageInfo().computeMinByteSize();
+        REPORTER_ASSERT(r, expected.frameCacheBytes() >= frameBytes * 2);
+
+        // Seeking around with room for only two frames, and decoding ahead, matches.
+        std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(1);
+        SkAnimCodecPlayer player(SkCodec::MakeFromData(data));
+        player.setFrameCacheLimit(2 * frameBytes);
+        player.setKeyFrameInterval(2);
+        player.setDecodeAheadExecutor(executor.get());
+        const int frameCount = (int)frameTimes.size();
+        for (int i = 0; i < 2 * frameCount; ++i) {
+            const int index = (i * 7 + 3) % frameCount;
+            player.seek(frameTimes[index]);
+            sk_sp<SkImage> frame = player.getFrame();
+            REPORTER_ASSERT(r, frame && ToolUtils::equal_pixels(frame.get(),
+                                                                expectedFrames[index].get()),
+                            "%s frame %d", file, index);
+            REPORTER_ASSERT(r, frame == player.getFrame());
+            REPORTER_ASSERT(r, player.frameCacheBytes() <= 2 * frameBytes);
+        }
+        player.setDecodeAheadExecutor(nullptr);
+    }
+}
@@ -7,6 +7,8 @@
 
 #include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
@@ -154,6 +156,90 @@ DEF_TEST(Codec_partial, r) {
     test_partial(r, "images/box.gif");
     test_partial(r, "images/randPixels.gif", 215);
     test_partial(r, "images/color_wheel.gif");
+
+    test_partial(r, "images/baby_tux.webp");
+    test_partial(r, "images/yellow_rose.webp");
+    test_partial(r, "images/color_wheel.webp");
+    test_partial(r, "images/stoplight.webp");
+
+    test_partial(r, "images/mandrill_512_q075.jpg");
+    test_partial(r, "images/color_wheel.jpg");
+    test_partial(r, "images/CMYK.jpg");
+    test_partial(r, "images/brickwork-texture.jpg");
+}
+
+// Small increments that are not a multiple of the row size stop BMP decodes partway through
+// rows, and partway through RLE entries.
+DEF_TEST(Codec_partialBmp, r) {
+    for (const char* path : {"images/randPixels.bmp", "images/rle.bmp"}) {
+        sk_sp<SkData> file = GetResourceAsData(path);
+        if (!file) {
+            SkDebugf("missing resource %s\n", path);
+            continue;
+        }
+        for (size_t increment : {7, 97}) {
+            test_partial(r, path, file, 100, increment);
+        }
+    }
+}
+
+// F16 decodes of RLE BMPs go through a color xform buffer, which must hold on to the row that the
+// data ran out in.
+DEF_TEST(Codec_partialBmpRLE_F16, r) {
+    const char* path = "images/rle.bmp";
+    sk_sp<SkData> file = GetResourceAsData(path);
+    if (!file) {
+        SkDebugf("missing resource %s\n", path);
+        return;
+    }
+
+    std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(file));
+    if (!codec) {
+        ERRORF(r, "Failed to create codec for %s", path);
+        return;
+    }
+    const SkImageInfo info = codec->getInfo().makeColorType(kRGBA_F16_SkColorType)
+                                             .makeColorSpace(SkColorSpace::MakeSRGBLinear());
+    SkBitmap truth;
+    truth.allocPixels(info);
+    if (SkCodec::kSuccess != codec->getPixels(info, truth.getPixels(), truth.rowBytes())) {
+        ERRORF(r, "Failed to decode %s", path);
+        return;
+    }
+
+    for (size_t increment : {7, 97}) {
+        HaltingStream* stream = new HaltingStream(file, 100);
+        auto partialCodec = SkCodec::MakeFromStream(std::unique_ptr<SkStream>(stream));
+        if (!partialCodec) {
+            ERRORF(r, "Failed to create codec for %s with 100 bytes", path);
+            return;
+        }
+
+        SkBitmap incremental;
+        incremental.allocPixels(info);
+        SkCodec::Result result;
+        while (SkCodec::kSuccess != (result = partialCodec->startIncrementalDecode(
+                info, incremental.getPixels(), incremental.rowBytes()))) {
+            if (stream->isAllDataReceived()) {
+                ERRORF(r, "Failed to start incremental decode of %s: %s", path,
+                       SkCodec::ResultToString(result));
+                return;
+            }
+            stream->addNewData(increment);
+        }
+
+        while (SkCodec::kSuccess != (result = partialCodec->incrementalDecode())) {
+            REPORTER_ASSERT(r, SkCodec::kIncompleteInput == result,
+                            "%s", SkCodec::ResultToString(result));
+            if (SkCodec::kIncompleteInput != result || stream->isAllDataReceived()) {
+                ERRORF(r, "Failed to completely decode %s", path);
+                return;
+            }
+            stream->addNewData(increment);
+        }
+
+        compare_bitmaps(r, truth, incremental);
+    }
 }
 
 DEF_TEST(Codec_partialWuffs, r) {
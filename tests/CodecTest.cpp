@@ -16,6 +16,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageGenerator.h"
@@ -23,6 +24,8 @@
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkScalar.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
@@ -56,6 +59,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <initializer_list>
 #include <memory>
@@ -308,9 +312,10 @@ static void check_scanline_decode(skiatest::Reporter* r,
     if (supportsNewScanlineDecoding && !supportsIncomplete) {
         test_incremental_decode(r, codec, info, *codecDigest);
         // This is only supported by codecs that use incremental decoding to
-        // support subset decodes - png and jpeg (once SkJpegCodec is
+        // support subset decodes - png, bmp and jpeg (once SkJpegCodec is
         // converted).
-        if (SkStrEndsWith(path, "png") || SkStrEndsWith(path, "PNG")) {
+        if (SkStrEndsWith(path, "png") || SkStrEndsWith(path, "PNG") ||
+            SkStrEndsWith(path, "bmp")) {
             test_in_stripes(r, codec, info, *codecDigest);
         }
     }
@@ -534,8 +539,71 @@ DEF_TEST(Codec_webp, r) {
 }
 
 DEF_TEST(Codec_bmp, r) {
-    check(r, "images/randPixels.bmp", SkISize::Make(8, 8), true, false, true);
-    check(r, "images/rle.bmp", SkISize::Make(320, 240), true, false, true);
+    check(r, "images/randPixels.bmp", SkISize::Make(8, 8), true, false, true, true);
+    check(r, "images/rle.bmp", SkISize::Make(320, 240), true, false, true, true);
+}
+
+// Region decodes skip the rows above (or, for bottom-up bmps, below) the region instead of
+// decoding them, and RLE bmps index their rows so that later regions skip them faster. Every
+// region should match the same pixels of a full decode.
+static void check_regions(skiatest::Reporter* r, const char path[]) {
+    std::unique_ptr<SkStream> stream(GetResourceAsStream(path));
+    if (!stream) {
+        return;
+    }
+    std::unique_ptr<SkAndroidCodec> codec = SkAndroidCodec::MakeFromStream(std::move(stream));
+    if (!codec) {
+        ERRORF(r, "Unable to decode '%s'", path);
+        return;
+    }
+
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap full;
+    full.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(info, full.getPixels(),
+                                                                    full.rowBytes()));
+
+    SkRandom rand;
+    for (int sampleSize : {1, 2, 3}) {
+        for (int i = 0; i < 5; i++) {
+            SkIRect subset = generate_random_subset(&rand, info.width(), info.height());
+            SkAndroidCodec::AndroidOptions options;
+            options.fSubset = &subset;
+            options.fSampleSize = sampleSize;
+            SkBitmap bm;
+            bm.allocPixels(info.makeDimensions(
+                    codec->getSampledSubsetDimensions(sampleSize, subset)));
+
+            // Sampling keeps the middle pixel of each sampleX by sampleY block of the region.
+            const int sampleX = subset.width() / bm.width();
+            const int sampleY = subset.height() / bm.height();
+            for (int pass = 0; pass < 2; pass++) {
+                bm.eraseColor(SK_ColorYELLOW);
+                const SkCodec::Result result = codec->getAndroidPixels(
+                        bm.info(), bm.getPixels(), bm.rowBytes(), &options);
+                REPORTER_ASSERT(r, SkCodec::kSuccess == result, "%s: %s", path,
+                                SkCodec::ResultToString(result));
+
+                int mismatches = 0;
+                for (int y = 0; y < bm.height(); y++) {
+                    for (int x = 0; x < bm.width(); x++) {
+                        const int srcX = subset.left() + sampleX / 2 + x * sampleX;
+                        const int srcY = subset.top() + sampleY / 2 + y * sampleY;
+                        mismatches += *bm.getAddr32(x, y) != *full.getAddr32(srcX, srcY);
+                    }
+                }
+                REPORTER_ASSERT(r, 0 == mismatches, "%s: %d pixels differ in region (%d, %d, "
+                                "%d, %d) with sample size %d", path, mismatches, subset.left(),
+                                subset.top(), subset.right(), subset.bottom(), sampleSize);
+            }
+        }
+    }
+}
+
+DEF_TEST(Codec_regions, r) {
+    check_regions(r, "images/randPixels.bmp");
+    check_regions(r, "images/rle.bmp");
+    check_regions(r, "images/mandrill.wbmp");
 }
 
 DEF_TEST(Codec_ico, r) {
@@ -555,13 +623,13 @@ DEF_TEST(Codec_gif, r) {
 }
 
 DEF_TEST(Codec_jpg, r) {
-    check(r, "images/CMYK.jpg", SkISize::Make(642, 516), true, false, true);
-    check(r, "images/color_wheel.jpg", SkISize::Make(128, 128), true, false, true);
+    check(r, "images/CMYK.jpg", SkISize::Make(642, 516), true, false, true, true);
+    check(r, "images/color_wheel.jpg", SkISize::Make(128, 128), true, false, true, true);
     // grayscale.jpg is too small to test incomplete
-    check(r, "images/grayscale.jpg", SkISize::Make(128, 128), true, false, false);
-    check(r, "images/mandrill_512_q075.jpg", SkISize::Make(512, 512), true, false, true);
+    check(r, "images/grayscale.jpg", SkISize::Make(128, 128), true, false, false, true);
+    check(r, "images/mandrill_512_q075.jpg", SkISize::Make(512, 512), true, false, true, true);
     // randPixels.jpg is too small to test incomplete
-    check(r, "images/randPixels.jpg", SkISize::Make(8, 8), true, false, false);
+    check(r, "images/randPixels.jpg", SkISize::Make(8, 8), true, false, false, true);
 }
 
 DEF_TEST(Codec_png, r) {
@@ -1236,8 +1304,8 @@ static void test_conversion_possible(skiatest::Reporter* r, const char* path,
 }
 
 DEF_TEST(Codec_F16ConversionPossible, r) {
-    test_conversion_possible(r, "images/color_wheel.webp", false, false);
-    test_conversion_possible(r, "images/mandrill_512_q075.jpg", true, false);
+    test_conversion_possible(r, "images/color_wheel.webp", false, true);
+    test_conversion_possible(r, "images/mandrill_512_q075.jpg", true, true);
     test_conversion_possible(r, "images/yellow_rose.png", false, true);
 }
 
@@ -1338,7 +1406,6 @@ DEF_TEST(Codec_fallBack, r) {
 
     // Formats that currently do not support incremental decoding
     auto files = {
-            "images/CMYK.jpg",
             "images/color_wheel.ico",
             "images/mandrill.wbmp",
             "images/randPixels.bmp",
@@ -1957,3 +2024,229 @@ DEF_TEST(Codec_kBGR_101010x_XR_SkColorType_supported, r) {
     bool success = codec->getPixels(dstInfo, dstBm.getPixels(), dstBm.rowBytes());
     REPORTER_ASSERT(r, SkCodec::kSuccess == success);
 }
+
+DEF_TEST(Codec_getResizedPixels, r) {
+    std::unique_ptr<SkCodec> codec(
+            SkCodec::MakeFromData(GetResourceAsData("images/mandrill_512.png")));
+    if (!codec) {
+        return;
+    }
+    SkBitmap full;
+    full.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType));
+    REPORTER_ASSERT(r, codec->getPixels(full.pixmap()) == SkCodec::kSuccess);
+
+    // Nearest at an integer factor picks the pixel under each destination pixel's center.
+    SkBitmap nearest;
+    nearest.allocPixels(full.info().makeWH(128, 128));
+    REPORTER_ASSERT(r, codec->getResizedPixels(nearest.pixmap(), SkSamplingOptions()) ==
+                       SkCodec::kSuccess);
+    bool matches = true;
+    for (int y = 0; y < nearest.height(); ++y) {
+        for (int x = 0; x < nearest.width(); ++x) {
+            matches &= *nearest.getAddr32(x, y) == *full.getAddr32(4 * x + 2, 4 * y + 2);
+        }
+    }
+    REPORTER_ASSERT(r, matches);
+
+    // The filters preserve a solid color, for any factor and with or without alpha.
+    for (SkColor color : {SkColorSetARGB(0xFF, 0x33, 0x66, 0x99),
+                          SkColorSetARGB(0x80, 0x40, 0x80, 0xC0)}) {
+        SkBitmap src;
+        src.allocN32Pixels(300, 200);
+        src.eraseColor(color);
+        std::unique_ptr<SkCodec> solid(
+                SkCodec::MakeFromData(SkEncodeBitmap(src, SkEncodedImageFormat::kPNG, 100)));
+        REPORTER_ASSERT(r, solid->getPixels(src.pixmap()) == SkCodec::kSuccess);
+        const uint32_t expected = *src.getAddr32(0, 0);
+
+        for (SkSamplingOptions sampling : {SkSamplingOptions(SkFilterMode::kLinear),
+                                           SkSamplingOptions(SkCubicResampler::Mitchell()),
+                                           SkSamplingOptions(SkCubicResampler::CatmullRom())}) {
+            for (SkISize size : {SkISize{77, 51}, SkISize{300, 7}, SkISize{450, 333}}) {
+                SkBitmap dst;
+                dst.allocPixels(src.info().makeDimensions(size));
+                REPORTER_ASSERT(r, solid->getResizedPixels(dst.pixmap(), sampling) ==
+                                   SkCodec::kSuccess);
+                bool isSolid = true;
+                for (int y = 0; y < dst.height(); ++y) {
+                    for (int x = 0; x < dst.width(); ++x) {
+                        isSolid &= *dst.getAddr32(x, y) == expected;
+                    }
+                }
+                REPORTER_ASSERT(r, isSolid, "%dx%d", size.width(), size.height());
+            }
+        }
+    }
+
+    // When upscaling, the filters reconstruct the same signal as drawing the decoded image with
+    // the same sampling. (When downscaling they are stretched to cover every source pixel, which
+    // scalePixels() does not do, so those are only checked on solid colors above.) At the edges
+    // the resampler drops the taps outside the image while the image shader clamps them, which
+    // only matters for the negative lobes of the cubics, so those skip a border.
+    std::unique_ptr<SkCodec> textured(
+            SkCodec::MakeFromData(GetResourceAsData("images/mandrill_128.png")));
+    if (textured) {
+        SkBitmap decoded;
+        decoded.allocPixels(textured->getInfo().makeColorType(kN32_SkColorType));
+        REPORTER_ASSERT(r, textured->getPixels(decoded.pixmap()) == SkCodec::kSuccess);
+
+        const SkImageInfo dstInfo = decoded.info().makeWH(301, 211);
+        const struct {
+            SkSamplingOptions fSampling;
+            bool              fSkipBorder;
+        } kSamplings[] = {
+            {SkSamplingOptions(SkFilterMode::kLinear),        false},
+            {SkSamplingOptions(SkCubicResampler::Mitchell()),   true},
+            {SkSamplingOptions(SkCubicResampler::CatmullRom()), true},
+        };
+        for (const auto& rec : kSamplings) {
+            SkBitmap actual, expected;
+            actual.allocPixels(dstInfo);
+            expected.allocPixels(dstInfo);
+            REPORTER_ASSERT(r, textured->getResizedPixels(actual.pixmap(), rec.fSampling) ==
+                               SkCodec::kSuccess);
+            REPORTER_ASSERT(r, decoded.pixmap().scalePixels(expected.pixmap(), rec.fSampling));
+
+            // Two source pixels on either side, in destination pixels.
+            const int borderX = rec.fSkipBorder
+                    ? SkScalarCeilToInt(2.5f * dstInfo.width() / decoded.width()) : 0;
+            const int borderY = rec.fSkipBorder
+                    ? SkScalarCeilToInt(2.5f * dstInfo.height() / decoded.height()) : 0;
+            int maxDiff = 0;
+            for (int y = borderY; y < dstInfo.height() - borderY; ++y) {
+                for (int x = borderX; x < dstInfo.width() - borderX; ++x) {
+                    const SkColor a = actual.getColor(x, y),
+                                  e = expected.getColor(x, y);
+                    for (int shift : {0, 8, 16, 24}) {
+                        maxDiff = std::max(maxDiff, std::abs((int)((a >> shift) & 0xFF) -
+                                                             (int)((e >> shift) & 0xFF)));
+                    }
+                }
+            }
+            REPORTER_ASSERT(r, maxDiff <= 3, "%s differs by %d",
+                            rec.fSampling.useCubic ? "cubic" : "linear", maxDiff);
+        }
+    }
+
+    // Codecs that scale natively, and color types that the resampler does not filter, work too.
+    std::unique_ptr<SkCodec> jpeg(
+            SkCodec::MakeFromData(GetResourceAsData("images/mandrill_512_q075.jpg")));
+    if (jpeg) {
+        for (SkColorType colorType : {kN32_SkColorType, kRGB_565_SkColorType}) {
+            SkBitmap dst;
+            dst.allocPixels(jpeg->getInfo().makeWH(100, 100).makeColorType(colorType));
+            REPORTER_ASSERT(r, jpeg->getResizedPixels(dst.pixmap(),
+                                                      SkSamplingOptions(SkFilterMode::kLinear)) ==
+                               SkCodec::kSuccess);
+        }
+    }
+}
+
+DEF_TEST(Codec_estimateDecodeCost, r) {
+    auto cost = [](SkCodec* codec, const SkIRect* subset) {
+        SkCodec::Options options;
+        options.fSubset = subset;
+        SkImageInfo info = codec->getInfo();
+        if (subset) {
+            info = info.makeDimensions(subset->size());
+        }
+        return codec->estimateDecodeCost(info, &options);
+    };
+
+    // Interlaced PNGs combine passes in a buffer that holds the whole image.
+    std::unique_ptr<SkCodec> png(SkCodec::MakeFromData(GetResourceAsData("images/plane.png")));
+    std::unique_ptr<SkCodec> interlaced(
+            SkCodec::MakeFromData(GetResourceAsData("images/plane_interlaced.png")));
+    if (png && interlaced) {
+        const SkCodec::DecodeCost plain = cost(png.get(), nullptr);
+        const SkCodec::DecodeCost combined = cost(interlaced.get(), nullptr);
+        REPORTER_ASSERT(r, plain.fWork > 0);
+        REPORTER_ASSERT(r, combined.fWork > plain.fWork);
+        REPORTER_ASSERT(r, combined.fScratchBytes >
+                           (size_t) interlaced->dimensions().area());
+    }
+
+    // Baseline JPEGs pay for the rows above a subset, but not for the rows below it.
+    std::unique_ptr<SkCodec> jpeg(
+            SkCodec::MakeFromData(GetResourceAsData("images/mandrill_512_q075.jpg")));
+    if (jpeg) {
+        const SkIRect top = SkIRect::MakeXYWH(0, 0, 128, 128);
+        const SkIRect bottom = SkIRect::MakeXYWH(0, 384, 128, 128);
+        const double full = cost(jpeg.get(), nullptr).fWork;
+        REPORTER_ASSERT(r, cost(jpeg.get(), &top).fWork < cost(jpeg.get(), &bottom).fWork);
+        REPORTER_ASSERT(r, cost(jpeg.get(), &bottom).fWork < full);
+
+        // Sampling uses the scaled IDCT, but every source pixel is still entropy decoded.
+        std::unique_ptr<SkAndroidCodec> androidCodec = SkAndroidCodec::MakeFromData(
+                GetResourceAsData("images/mandrill_512_q075.jpg"));
+        SkAndroidCodec::AndroidOptions options;
+        options.fSampleSize = 4;
+        const SkImageInfo sampled = androidCodec->getInfo().makeDimensions(
+                androidCodec->getSampledDimensions(options.fSampleSize));
+        const double sampledWork = androidCodec->estimateDecodeCost(sampled, &options).fWork;
+        REPORTER_ASSERT(r, sampledWork < 0.5 * full);
+        REPORTER_ASSERT(r, sampledWork > 0.25 * full);
+
+        // A size between two IDCT scales costs as much as the larger of them.
+        const SkImageInfo eighth = jpeg->getInfo().makeDimensions(
+                jpeg->getScaledDimensions(0.125f));
+        const SkImageInfo between = eighth.makeWH(eighth.width() + 1, eighth.height() + 1);
+        const double eighthWork = jpeg->estimateDecodeCost(eighth).fWork;
+        REPORTER_ASSERT(r, eighthWork < sampledWork);
+        REPORTER_ASSERT(r, eighthWork < jpeg->estimateDecodeCost(between).fWork);
+    }
+
+    // Progressive JPEGs hold coefficients for the whole image.
+    std::unique_ptr<SkCodec> progressive(
+            SkCodec::MakeFromData(GetResourceAsData("images/brickwork-texture.jpg")));
+    if (progressive) {
+        const SkIRect subset = SkIRect::MakeWH(16, 16);
+        REPORTER_ASSERT(r, cost(progressive.get(), &subset).fScratchBytes >=
+                           (size_t) progressive->dimensions().area());
+    }
+}
+
+DEF_TEST(Codec_pngExecutor, r) {
+    // A PNG that is tall enough for the rows to be converted in batches.
+    SkBitmap noise;
+    noise.allocN32Pixels(97, 301);
+    SkRandom random;
+    for (int y = 0; y < noise.height(); ++y) {
+        for (int x = 0; x < noise.width(); ++x) {
+            *noise.getAddr32(x, y) = SkPreMultiplyColor(random.nextU());
+        }
+    }
+    sk_sp<SkData> noiseData = SkEncodeBitmap(noise, SkEncodedImageFormat::kPNG, 100);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+    for (sk_sp<SkData> data : {noiseData,
+                               GetResourceAsData("images/plane.png"),
+                               GetResourceAsData("images/plane_interlaced.png")}) {
+        if (!data) {
+            continue;
+        }
+        std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(data));
+        for (sk_sp<SkColorSpace> colorSpace :
+                {sk_sp<SkColorSpace>(nullptr),
+                 SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kRec2020)}) {
+            SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                               .makeColorSpace(colorSpace);
+            SkBitmap expected, actual;
+            expected.allocPixels(info);
+            actual.allocPixels(info);
+            REPORTER_ASSERT(r, codec->getPixels(expected.pixmap()) == SkCodec::kSuccess);
+
+            SkCodec::Options options;
+            options.fExecutor = executor.get();
+            REPORTER_ASSERT(r, codec->getPixels(actual.pixmap(), &options) == SkCodec::kSuccess);
+            REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual));
+
+            actual.eraseColor(SK_ColorTRANSPARENT);
+            REPORTER_ASSERT(r, codec->startIncrementalDecode(info, actual.getPixels(),
+                                                             actual.rowBytes(), &options) ==
+                               SkCodec::kSuccess);
+            REPORTER_ASSERT(r, codec->incrementalDecode() == SkCodec::kSuccess);
+            REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual));
+        }
+    }
+}
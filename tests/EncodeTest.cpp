@@ -15,6 +15,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageInfo.h"
@@ -35,8 +36,10 @@
 
 #include <png.h>
 #include <webp/decode.h>
+#include <webp/encode.h>
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <initializer_list>
 #include <memory>
@@ -162,7 +165,9 @@ DEF_TEST(Encode_JPG, r) {
                      kRGB_565_SkColorType,
                      kARGB_4444_SkColorType,
                      kGray_8_SkColorType,
-                     kRGBA_F16_SkColorType }) {
+                     kRGBA_F16_SkColorType,
+                     kRGBA_1010102_SkColorType,
+                     kRGBA_F32_SkColorType }) {
         for (auto at : { kPremul_SkAlphaType, kUnpremul_SkAlphaType, kOpaque_SkAlphaType }) {
             auto info = SkImageInfo::Make(image->width(), image->height(), ct, at);
             auto surface = SkSurface::MakeRaster(info);
@@ -230,6 +235,36 @@ DEF_TEST(Encode_JpegDownsample, r) {
     REPORTER_ASSERT(r, almost_equals(bm1, bm2, 60));
 }
 
+DEF_TEST(Encode_JpegStripes, r) {
+    SkBitmap bitmap;
+    if (!GetResourceAsBitmap("images/mandrill_512_q075.jpg", &bitmap)) {
+        return;
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (auto downsample : { SkJpegEncoder::Downsample::k420,
+                             SkJpegEncoder::Downsample::k422,
+                             SkJpegEncoder::Downsample::k444 }) {
+        SkJpegEncoder::Options options;
+        options.fDownsample = downsample;
+        SkDynamicMemoryWStream serial, striped;
+        REPORTER_ASSERT(r, SkJpegEncoder::Encode(&serial, bitmap.pixmap(), options));
+        options.fExecutor = executor.get();
+        REPORTER_ASSERT(r, SkJpegEncoder::Encode(&striped, bitmap.pixmap(), options));
+
+        // Restart markers and Huffman tables do not change the decoded pixels.
+        SkBitmap bm0, bm1;
+        auto image0 = SkImages::DeferredFromEncodedData(serial.detachAsData());
+        auto image1 = SkImages::DeferredFromEncodedData(striped.detachAsData());
+        if (!image0 || !image1 ||
+            !image0->asLegacyBitmap(&bm0) || !image1->asLegacyBitmap(&bm1)) {
+            ERRORF(r, "Failed to decode the encoded jpegs");
+            continue;
+        }
+        REPORTER_ASSERT(r, almost_equals(bm0, bm1, 0));
+    }
+}
+
 static inline void pushComment(
         std::vector<std::string>& comments, const char* keyword, const char* text) {
     comments.push_back(keyword);
@@ -445,6 +480,135 @@ DEF_TEST(Encode_WebpOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm2, bm3, 50));
 }
 
+// Decodes |data| with libwebp into tightly packed unpremul RGBA.
+static std::vector<uint8_t> webp_decode_rgba(const void* data, size_t size, int w, int h) {
+    int decodedW = 0, decodedH = 0;
+    uint8_t* rgba = WebPDecodeRGBA(static_cast<const uint8_t*>(data), size, &decodedW, &decodedH);
+    if (!rgba || decodedW != w || decodedH != h) {
+        WebPFree(rgba);
+        return {};
+    }
+    std::vector<uint8_t> pixels(rgba, rgba + 4 * w * h);
+    WebPFree(rgba);
+    return pixels;
+}
+
+// Encodes |rgba| the way SkWebpEncoder did before it converted pixels itself: by handing an
+// unpremul RGBA copy to WebPPictureImportRGBA, with the same config. Returns the decoded result.
+static std::vector<uint8_t> webp_reference_rgba(const std::vector<uint8_t>& rgba,
+                                                int w,
+                                                int h,
+                                                const SkWebpEncoder::Options& options) {
+    WebPConfig config;
+    if (!WebPConfigPreset(&config, WEBP_PRESET_DEFAULT, options.fQuality)) {
+        return {};
+    }
+    const bool lossy = options.fCompression == SkWebpEncoder::Compression::kLossy;
+    config.lossless = lossy ? 0 : 1;
+    config.method = lossy ? 3 : 0;
+
+    WebPPicture pic;
+    WebPPictureInit(&pic);
+    pic.width = w;
+    pic.height = h;
+    pic.use_argb = lossy ? 0 : 1;
+    WebPMemoryWriter writer;
+    WebPMemoryWriterInit(&writer);
+    pic.writer = WebPMemoryWrite;
+    pic.custom_ptr = &writer;
+
+    std::vector<uint8_t> decoded;
+    if (WebPPictureImportRGBA(&pic, rgba.data(), 4 * w) && WebPEncode(&config, &pic)) {
+        decoded = webp_decode_rgba(writer.mem, writer.size, w, h);
+    }
+    WebPPictureFree(&pic);
+    WebPMemoryWriterClear(&writer);
+    return decoded;
+}
+
+// The PSNR of |b| against |a| over all four channels, capped at 99dB for identical inputs.
+static double psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+    SkASSERT(a.size() == b.size() && !a.empty());
+    double squaredError = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        double d = (double)a[i] - (double)b[i];
+        squaredError += d * d;
+    }
+    if (squaredError == 0) {
+        return 99;
+    }
+    return 10 * std::log10(255.0 * 255.0 * a.size() / squaredError);
+}
+
+DEF_TEST(Encode_WebpOddSize, r) {
+    // Taller than a band of converted rows, with an odd width and height so that the last row and
+    // column of chroma blocks are partial.
+    constexpr int kW = 37;
+    constexpr int kH = 35;
+
+    // A smooth gradient that is opaque, and one whose alpha varies across it. The translucent one
+    // stays clear of zero alpha, whose color libwebp's lossless mode is free to change.
+    SkBitmap opaque, translucent;
+    opaque.allocN32Pixels(kW, kH, /*isOpaque=*/true);
+    translucent.allocN32Pixels(kW, kH);
+    for (int y = 0; y < kH; y++) {
+        for (int x = 0; x < kW; x++) {
+            const U8CPU red = 255 * x / (kW - 1);
+            const U8CPU green = 255 * y / (kH - 1);
+            const U8CPU blue = 255 - (red + green) / 2;
+            *opaque.getAddr32(x, y) = SkPreMultiplyARGB(0xFF, red, green, blue);
+            const U8CPU alpha = 32 + 191 * (x + y) / (kW + kH - 2);
+            *translucent.getAddr32(x, y) = SkPreMultiplyARGB(alpha, red, green, blue);
+        }
+    }
+
+    for (const SkBitmap* src : {&opaque, &translucent}) {
+        const char* name = src == &opaque ? "opaque" : "translucent";
+
+        // The unpremul pixels that libwebp is meant to encode.
+        std::vector<uint8_t> expected(4 * kW * kH);
+        const SkImageInfo rgbaInfo =
+                SkImageInfo::Make(kW, kH, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType);
+        REPORTER_ASSERT(r, src->readPixels(rgbaInfo, expected.data(), 4 * kW, 0, 0));
+
+        for (auto compression : {SkWebpEncoder::Compression::kLossy,
+                                 SkWebpEncoder::Compression::kLossless}) {
+            const bool lossy = compression == SkWebpEncoder::Compression::kLossy;
+            SkWebpEncoder::Options options;
+            options.fCompression = compression;
+            options.fThreadLevel = 1;
+            SkDynamicMemoryWStream dst;
+            REPORTER_ASSERT(r, SkWebpEncoder::Encode(&dst, src->pixmap(), options));
+            sk_sp<SkData> data = dst.detachAsData();
+
+            std::vector<uint8_t> decoded = webp_decode_rgba(data->data(), data->size(), kW, kH);
+            std::vector<uint8_t> reference = webp_reference_rgba(expected, kW, kH, options);
+            if (decoded.empty() || reference.empty()) {
+                ERRORF(r, "%s %s: failed to encode or decode", name, lossy ? "lossy" : "lossless");
+                continue;
+            }
+
+            if (!lossy) {
+                REPORTER_ASSERT(r, decoded == expected, "%s lossless", name);
+                REPORTER_ASSERT(r, decoded == reference, "%s lossless", name);
+                continue;
+            }
+
+            // Lossy chroma is averaged linearly rather than in libwebp's gamma-compressed space,
+            // so the results are close to, but not the same as, libwebp's own import.
+            const double ours = psnr(expected, decoded);
+            const double theirs = psnr(expected, reference);
+            REPORTER_ASSERT(r, ours >= 30, "%s lossy: PSNR %.2fdB", name, ours);
+            REPORTER_ASSERT(r, ours >= theirs - 1,
+                            "%s lossy: PSNR %.2fdB, libwebp's import gets %.2fdB",
+                            name, ours, theirs);
+            REPORTER_ASSERT(r, psnr(reference, decoded) >= 30,
+                            "%s lossy: PSNR %.2fdB against libwebp's import",
+                            name, psnr(reference, decoded));
+        }
+    }
+}
+
 DEF_TEST(Encode_WebpAnimated, r) {
     const int frameCount = 3;
     const int width = 16;
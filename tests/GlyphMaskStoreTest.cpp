@@ -0,0 +1,152 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkFont.h"
+#include "include/core/SkFontStyle.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/core/SkTypeface.h"
+#include "src/core/SkGlyph.h"
+#include "src/core/SkScalerContext.h"
+#include "src/core/SkStrikeSpec.h"
+#include "src/gpu/AtlasTypes.h"
+#include "src/text/gpu/GlyphMaskStore.h"
+#include "tests/Test.h"
+#include "tools/ToolUtils.h"
+
+#include <cstring>
+#include <vector>
+
+using GlyphMaskStore = sktext::gpu::GlyphMaskStore;
+using MaskFormat = skgpu::MaskFormat;
+
+DEF_TEST(GlyphMaskStore_FindOrCreate, reporter) {
+    GlyphMaskStore store;
+
+    sk_sp<SkTypeface> typeface = ToolUtils::create_portable_typeface("serif", SkFontStyle());
+    SkFont font(typeface, 24);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+
+    SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+            font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I());
+    SkBulkGlyphMetricsAndImages glyphs{strikeSpec};
+
+    const SkPackedGlyphID packedID{font.unicharToGlyph('A')};
+    int rasterizations = 0;
+    auto getGlyph = [&] {
+        ++rasterizations;
+        return glyphs.glyph(packedID);
+    };
+    const SkGlyph* skGlyph = glyphs.glyph(packedID);
+    REPORTER_ASSERT(reporter, skGlyph->image() != nullptr);
+
+    GlyphMaskStore::Mask mask =
+            store.findOrCreate(glyphs.descriptor(), packedID, MaskFormat::kA8, 1, getGlyph);
+    REPORTER_ASSERT(reporter, mask);
+    REPORTER_ASSERT(reporter, mask.fWidth == skGlyph->width() + 2);
+    REPORTER_ASSERT(reporter, mask.fHeight == skGlyph->height() + 2);
+    REPORTER_ASSERT(reporter, mask.fPixels->size() == (size_t)(mask.fWidth * mask.fHeight));
+    REPORTER_ASSERT(reporter, rasterizations == 1);
+    REPORTER_ASSERT(reporter, store.missCount() == 1 && store.hitCount() == 0);
+    REPORTER_ASSERT(reporter, store.maskCount() == 1);
+    REPORTER_ASSERT(reporter, store.bytesUsed() == mask.fPixels->size());
+
+    // The padding is transparent and the interior is the glyph's image.
+    const uint8_t* pixels = mask.fPixels->bytes();
+    bool paddingIsClear = true;
+    bool interiorMatches = true;
+    for (int y = 0; y < mask.fHeight; ++y) {
+        for (int x = 0; x < mask.fWidth; ++x) {
+            uint8_t pixel = pixels[y * mask.fWidth + x];
+            if (x == 0 || y == 0 || x == mask.fWidth - 1 || y == mask.fHeight - 1) {
+                paddingIsClear &= pixel == 0;
+            } else {
+                const uint8_t* src = static_cast<const uint8_t*>(skGlyph->image());
+                interiorMatches &= pixel == src[(y - 1) * skGlyph->rowBytes() + (x - 1)];
+            }
+        }
+    }
+    REPORTER_ASSERT(reporter, paddingIsClear);
+    REPORTER_ASSERT(reporter, interiorMatches);
+
+    // A second request is served from the store without rasterizing.
+    GlyphMaskStore::Mask again =
+            store.findOrCreate(glyphs.descriptor(), packedID, MaskFormat::kA8, 1, getGlyph);
+    REPORTER_ASSERT(reporter, again.fPixels == mask.fPixels);
+    REPORTER_ASSERT(reporter, rasterizations == 1);
+    REPORTER_ASSERT(reporter, store.hitCount() == 1);
+
+    // A different padding is a different mask.
+    GlyphMaskStore::Mask unpadded =
+            store.findOrCreate(glyphs.descriptor(), packedID, MaskFormat::kA8, 0, getGlyph);
+    REPORTER_ASSERT(reporter, unpadded.fWidth == skGlyph->width());
+    REPORTER_ASSERT(reporter, rasterizations == 2);
+    REPORTER_ASSERT(reporter, store.maskCount() == 2);
+
+    // Packing the glyph directly gives the same bytes.
+    REPORTER_ASSERT(reporter,
+                    GlyphMaskStore::PaddedMaskSize(*skGlyph, MaskFormat::kA8, 1) ==
+                    mask.fPixels->size());
+    std::vector<uint8_t> packed(mask.fPixels->size());
+    GlyphMaskStore::PackPaddedGlyphImage(*skGlyph, MaskFormat::kA8, 1, packed.data());
+    REPORTER_ASSERT(reporter, !memcmp(packed.data(), mask.fPixels->data(), packed.size()));
+
+    store.purgeAll();
+    REPORTER_ASSERT(reporter, store.maskCount() == 0);
+    REPORTER_ASSERT(reporter, store.bytesUsed() == 0);
+    // Masks handed out before the purge stay valid.
+    REPORTER_ASSERT(reporter, mask.fPixels->size() == (size_t)(mask.fWidth * mask.fHeight));
+}
+
+DEF_TEST(GlyphMaskStore_Purge, reporter) {
+    sk_sp<SkTypeface> typeface = ToolUtils::create_portable_typeface("serif", SkFontStyle());
+    SkFont font(typeface, 24);
+    SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+            font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I());
+    SkBulkGlyphMetricsAndImages glyphs{strikeSpec};
+
+    const SkPackedGlyphID first{font.unicharToGlyph('A')};
+    const SkPackedGlyphID second{font.unicharToGlyph('B')};
+    auto glyphFor = [&](SkPackedGlyphID packedID) {
+        return [&glyphs, packedID] { return glyphs.glyph(packedID); };
+    };
+
+    GlyphMaskStore store;
+    GlyphMaskStore::Mask a =
+            store.findOrCreate(glyphs.descriptor(), first, MaskFormat::kA8, 0, glyphFor(first));
+    GlyphMaskStore::Mask b =
+            store.findOrCreate(glyphs.descriptor(), second, MaskFormat::kA8, 0, glyphFor(second));
+    REPORTER_ASSERT(reporter, a && b);
+    REPORTER_ASSERT(reporter, store.maskCount() == 2);
+
+    // Shrinking the limit evicts the least recently used mask first.
+    store.setByteLimit(b.fPixels->size());
+    REPORTER_ASSERT(reporter, store.maskCount() == 1);
+    REPORTER_ASSERT(reporter, store.bytesUsed() == b.fPixels->size());
+    store.findOrCreate(glyphs.descriptor(), second, MaskFormat::kA8, 0, glyphFor(second));
+    REPORTER_ASSERT(reporter, store.hitCount() == 1);
+
+    // Masks bigger than the limit are returned but not stored.
+    store.setByteLimit(0);
+    REPORTER_ASSERT(reporter, store.maskCount() == 0);
+    GlyphMaskStore::Mask uncached =
+            store.findOrCreate(glyphs.descriptor(), first, MaskFormat::kA8, 0, glyphFor(first));
+    REPORTER_ASSERT(reporter, uncached);
+    REPORTER_ASSERT(reporter, store.maskCount() == 0);
+    REPORTER_ASSERT(reporter, store.bytesUsed() == 0);
+}
+
+DEF_TEST(GlyphMaskStore_Global, reporter) {
+    GlyphMaskStore* store = GlyphMaskStore::Global();
+    REPORTER_ASSERT(reporter, store != nullptr);
+    REPORTER_ASSERT(reporter, store == GlyphMaskStore::Global());
+    REPORTER_ASSERT(reporter, store->byteLimit() == SK_DEFAULT_GLYPH_MASK_STORE_LIMIT);
+}
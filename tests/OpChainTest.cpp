@@ -199,6 +199,46 @@ private:
 
     using INHERITED = GrOp;
 };
+
+/**
+ * A 1 pixel tall op that covers [x, x + width). Ops of the kMergeable kind always merge with one
+ * another; the others never combine with anything.
+ */
+template <bool kMergeable>
+class SpanOp : public GrOp {
+public:
+    DEFINE_OP_CLASS_ID
+
+    static GrOp::Owner Make(GrRecordingContext* context, int x, int width = 1) {
+        return GrOp::Make<SpanOp>(context, x, width);
+    }
+
+    const char* name() const override { return kMergeable ? "MergeableSpanOp" : "SpanOp"; }
+
+private:
+    friend class ::GrOp;  // for ctor
+
+    SpanOp(int x, int width) : INHERITED(ClassID()) {
+        this->setBounds(SkRect::MakeXYWH(x, 0, width, 1), HasAABloat::kNo, IsHairline::kNo);
+    }
+
+    void onPrePrepare(GrRecordingContext*,
+                      const GrSurfaceProxyView& writeView,
+                      GrAppliedClip*,
+                      const GrDstProxyView&,
+                      GrXferBarrierFlags renderPassXferBarriers,
+                      GrLoadOp colorLoadOp) override {}
+
+    void onPrepare(GrOpFlushState*) override {}
+
+    void onExecute(GrOpFlushState*, const SkRect& chainBounds) override {}
+
+    CombineResult onCombineIfPossible(GrOp*, SkArenaAlloc*, const GrCaps&) override {
+        return kMergeable ? CombineResult::kMerged : CombineResult::kCannotCombine;
+    }
+
+    using INHERITED = GrOp;
+};
 }  // namespace
 
 /**
@@ -300,3 +340,69 @@ DEF_GANESH_TEST(OpChainTest, reporter, /*ctxInfo*/, CtsEnforcement::kApiLevel_T)
         }
     }
 }
+
+/**
+ * Interleaves mergeable ops with many more ops of another kind than the OpsTask used to look
+ * through, and checks that they still merge unless painter's order forbids it.
+ */
+DEF_GANESH_TEST(OpChainLongRangeMergeTest, reporter, /*ctxInfo*/, CtsEnforcement::kNever) {
+    sk_sp<GrDirectContext> dContext = GrDirectContext::MakeMock(nullptr);
+    SkASSERT(dContext);
+    const GrCaps* caps = dContext->priv().caps();
+    static constexpr int kNumGroups = 8;
+    static constexpr int kNumBlockers = 20;
+    static constexpr SkISize kDims = {kNumGroups * (kNumBlockers + 1) + 1, 1};
+
+    const GrBackendFormat format = caps->getDefaultBackendFormat(GrColorType::kRGBA_8888,
+                                                                 GrRenderable::kYes);
+    static const GrSurfaceOrigin kOrigin = kTopLeft_GrSurfaceOrigin;
+    auto proxy = dContext->priv().proxyProvider()->createProxy(format,
+                                                               kDims,
+                                                               GrRenderable::kYes,
+                                                               1,
+                                                               GrMipmapped::kNo,
+                                                               SkBackingFit::kExact,
+                                                               skgpu::Budgeted::kNo,
+                                                               GrProtected::kNo,
+                                                               /*label=*/"OpChainTest",
+                                                               GrInternalSurfaceFlags::kNone);
+    SkASSERT(proxy);
+    proxy->instantiate(dContext->priv().resourceProvider());
+    skgpu::Swizzle writeSwizzle = caps->getWriteSwizzle(format, GrColorType::kRGBA_8888);
+
+    GrDrawingManager* drawingMgr = dContext->priv().drawingManager();
+    sk_sp<GrArenas> arenas = sk_make_sp<GrArenas>();
+
+    for (bool overlap : {false, true}) {
+        skgpu::ganesh::OpsTask opsTask(drawingMgr,
+                                       GrSurfaceProxyView(proxy, kOrigin, writeSwizzle),
+                                       dContext->priv().auditTrail(),
+                                       arenas);
+        auto addOp = [&](GrOp::Owner op) {
+            opsTask.addOp(drawingMgr, std::move(op),
+                          GrTextureResolveManager(dContext->priv().drawingManager()), *caps);
+        };
+        int x = kNumGroups;
+        for (int g = 0; g < kNumGroups; ++g) {
+            if (overlap && g == kNumGroups - 1) {
+                // The last mergeable op can't move before this one.
+                addOp(SpanOp<false>::Make(dContext.get(), 0, kNumGroups));
+            }
+            addOp(SpanOp<true>::Make(dContext.get(), g));
+            for (int b = 0; b < kNumBlockers; ++b) {
+                addOp(SpanOp<false>::Make(dContext.get(), x++));
+            }
+        }
+        opsTask.makeClosed(dContext.get());
+
+        int numChains = 0;
+        for (int i = 0; i < opsTask.numOpChains(); ++i) {
+            numChains += opsTask.getChain(i) ? 1 : 0;
+        }
+        int expected = kNumGroups * kNumBlockers + (overlap ? 3 : 1);
+        REPORTER_ASSERT(reporter, numChains == expected, "%d != %d", numChains, expected);
+
+        opsTask.endFlush(drawingMgr);
+        opsTask.disown(drawingMgr);
+    }
+}
@@ -10,6 +10,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkSwizzle.h"
+#include "include/private/SkColorData.h"
 #include "src/codec/SkSampler.h"
 #include "src/core/SkOpts.h"
 #include "tests/Test.h"
@@ -159,3 +160,42 @@ DEF_TEST(PublicSwizzleOpts, r) {
     SkSwapRB(&dst, &src, 1);
     REPORTER_ASSERT(r, dst == 0xFA04B0CE);
 }
+
+DEF_TEST(SwizzleOpts_16bitAndIndex8, r) {
+    // Long enough to run the SIMD loops and the scalar tails.
+    constexpr int kCount = 37;
+    uint8_t src[8*kCount];
+    for (int i = 0; i < (int)sizeof(src); i++) {
+        src[i] = (uint8_t)(i * 37 + 11);
+    }
+    uint32_t ctable[256];
+    for (int i = 0; i < 256; i++) {
+        ctable[i] = 0x01000193u * (uint32_t)i;
+    }
+
+    uint32_t dst[kCount];
+    SkOpts::RGBA16_to_RGBA(dst, src, kCount);
+    for (int i = 0; i < kCount; i++) {
+        const uint8_t* p = src + 8*i;
+        REPORTER_ASSERT(r, dst[i] == SkPackARGB_as_RGBA(p[6], p[0], p[2], p[4]));
+    }
+    SkOpts::RGBA16_to_BGRA(dst, src, kCount);
+    for (int i = 0; i < kCount; i++) {
+        const uint8_t* p = src + 8*i;
+        REPORTER_ASSERT(r, dst[i] == SkPackARGB_as_BGRA(p[6], p[0], p[2], p[4]));
+    }
+    SkOpts::RGB16_to_RGB1(dst, src, kCount);
+    for (int i = 0; i < kCount; i++) {
+        const uint8_t* p = src + 6*i;
+        REPORTER_ASSERT(r, dst[i] == SkPackARGB_as_RGBA(0xFF, p[0], p[2], p[4]));
+    }
+    SkOpts::RGB16_to_BGR1(dst, src, kCount);
+    for (int i = 0; i < kCount; i++) {
+        const uint8_t* p = src + 6*i;
+        REPORTER_ASSERT(r, dst[i] == SkPackARGB_as_BGRA(0xFF, p[0], p[2], p[4]));
+    }
+    SkOpts::index8_to_8888(dst, src, kCount, ctable);
+    for (int i = 0; i < kCount; i++) {
+        REPORTER_ASSERT(r, dst[i] == ctable[src[i]]);
+    }
+}
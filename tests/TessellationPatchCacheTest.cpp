@@ -0,0 +1,133 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkStrokeRec.h"
+#include "include/gpu/GrDirectContext.h"
+#include "include/gpu/mock/GrMockTypes.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/gpu/ganesh/GrDirectContextPriv.h"
+#include "src/gpu/ganesh/GrResourceCache.h"
+#include "src/gpu/ganesh/GrThreadSafeCache.h"
+#include "src/gpu/ganesh/mock/GrMockOpTarget.h"
+#include "src/gpu/ganesh/tessellate/PatchCache.h"
+#include "src/gpu/ganesh/tessellate/PathTessellator.h"
+#include "src/gpu/ganesh/tessellate/StrokeTessellator.h"
+#include "tests/Test.h"
+
+using namespace skgpu::ganesh;
+
+namespace {
+
+sk_sp<GrDirectContext> make_mock_context() {
+    GrMockOptions mockOptions;
+    mockOptions.fDrawInstancedSupport = true;
+    mockOptions.fMapBufferFlags = GrCaps::kCanMap_MapFlag;
+    return GrDirectContext::MakeMock(&mockOptions);
+}
+
+SkPath make_wavy_path(int cubicCount) {
+    SkPath path;
+    path.moveTo(0, 0);
+    for (int i = 0; i < cubicCount; ++i) {
+        float x = 10.f * i;
+        path.cubicTo(x + 3, 20, x + 7, -20, x + 10, 0);
+    }
+    path.lineTo(10.f * cubicCount, 50);
+    path.lineTo(0, 50);
+    path.close();
+    return path;
+}
+
+void prepare_wedges(GrMockOpTarget* target, const SkMatrix& viewMatrix, const SkPath& path) {
+    SkArenaAlloc arena(1024);
+    auto tess = PathWedgeTessellator::Make(&arena,
+                                           target->caps().shaderCaps()->fInfinitySupport);
+    // Mirrors PathTessellateOp: scale/skew on the CPU, translation in the shader.
+    SkMatrix pathMatrix = viewMatrix;
+    pathMatrix.setTranslateX(0);
+    pathMatrix.setTranslateY(0);
+    tess->prepareWithPatchCache(target,
+                                SkMatrix::Translate(viewMatrix.getTranslateX(),
+                                                    viewMatrix.getTranslateY()),
+                                {pathMatrix, path, SK_PMColor4fWHITE},
+                                path.countVerbs());
+    target->resetAllocator();
+}
+
+}  // namespace
+
+DEF_TEST(TessellationPatchCache_Wedges, reporter) {
+    sk_sp<GrDirectContext> dContext = make_mock_context();
+    if (!dContext) {
+        return;
+    }
+    GrMockOpTarget target(dContext);
+    GrThreadSafeCache* cache = dContext->priv().threadSafeCache();
+
+    SkPath path = make_wavy_path(40);
+    REPORTER_ASSERT(reporter, PatchCache::ShouldCache(path, path.countVerbs()));
+
+    prepare_wedges(&target, SkMatrix::I(), path);
+    REPORTER_ASSERT(reporter, cache->numEntries() == 1);
+
+    // Only translating reuses the cached patches.
+    prepare_wedges(&target, SkMatrix::Translate(17.5f, -3), path);
+    prepare_wedges(&target, SkMatrix::Translate(-200, 400), path);
+    REPORTER_ASSERT(reporter, cache->numEntries() == 1);
+
+    // Scaling changes the patches.
+    prepare_wedges(&target, SkMatrix::Scale(2, 2), path);
+    REPORTER_ASSERT(reporter, cache->numEntries() == 2);
+
+    // Volatile and small paths are not cached.
+    SkPath volatilePath = make_wavy_path(40);
+    volatilePath.setIsVolatile(true);
+    prepare_wedges(&target, SkMatrix::I(), volatilePath);
+    SkPath smallPath = make_wavy_path(2);
+    REPORTER_ASSERT(reporter, !PatchCache::ShouldCache(smallPath, smallPath.countVerbs()));
+    prepare_wedges(&target, SkMatrix::I(), smallPath);
+    REPORTER_ASSERT(reporter, cache->numEntries() == 2);
+
+    // Editing the path invalidates its patches.
+    path.lineTo(5, 60);
+    dContext->priv().getResourceCache()->purgeAsNeeded();
+    REPORTER_ASSERT(reporter, cache->numEntries() == 0);
+    prepare_wedges(&target, SkMatrix::Translate(1, 1), path);
+    REPORTER_ASSERT(reporter, cache->numEntries() == 1);
+}
+
+DEF_TEST(TessellationPatchCache_Strokes, reporter) {
+    sk_sp<GrDirectContext> dContext = make_mock_context();
+    if (!dContext) {
+        return;
+    }
+    GrMockOpTarget target(dContext);
+    GrThreadSafeCache* cache = dContext->priv().threadSafeCache();
+
+    SkStrokeRec stroke(SkStrokeRec::kFill_InitStyle);
+    stroke.setStrokeStyle(4);
+    stroke.setStrokeParams(SkPaint::kRound_Cap, SkPaint::kMiter_Join, 4);
+    StrokeTessellator::PathStrokeList pathStroke(make_wavy_path(40), stroke, SK_PMColor4fWHITE);
+
+    auto prepare = [&](const SkMatrix& viewMatrix) {
+        StrokeTessellator tessellator(StrokeTessellator::PatchAttribs::kNone);
+        tessellator.prepareWithPatchCache(&target, viewMatrix, &pathStroke,
+                                          pathStroke.fPath.countVerbs());
+        target.resetAllocator();
+    };
+
+    prepare(SkMatrix::Scale(1.5f, 1.5f));
+    prepare(SkMatrix::Scale(1.5f, 1.5f).postTranslate(30, 40));
+    REPORTER_ASSERT(reporter, cache->numEntries() == 1);
+
+    // A different stroke width changes the patches.
+    pathStroke.fStroke.setStrokeStyle(6);
+    prepare(SkMatrix::Scale(1.5f, 1.5f));
+    REPORTER_ASSERT(reporter, cache->numEntries() == 2);
+}
@@ -25,11 +25,15 @@
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
+#include "src/core/SkPicturePriv.h"
+#include "src/core/SkReadBuffer.h"
 #include "src/core/SkTextBlobPriv.h"
+#include "src/core/SkWriteBuffer.h"
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <string>
@@ -446,6 +450,116 @@ DEF_TEST(TextBlob_serialize, reporter) {
     }
 }
 
+/*
+ *  Serialize horizontal runs with positions that can and cannot be stored compactly,
+ *  and check that the glyphs and the positions survive the round trip exactly, down to
+ *  the sign of zero.
+ */
+DEF_TEST(TextBlob_serializeCompactRuns, reporter) {
+    constexpr int kCount = 100;
+    const SkScalar compactPos[] = { 0, 10.5f, 21.015625f, 33.25f, 40 };
+    const SkScalar plainPos[] = { 0, 10.1f, 20.2f, 30.3f, 40.4f };
+
+    SkTextBlobBuilder builder;
+    SkFont font;
+    const SkScalar* runPositions[] = { compactPos, plainPos, compactPos };
+    for (int r = 0; r < 3; ++r) {
+        // Each run gets its own y so the builder doesn't merge them
+        const auto& run = builder.allocRunPosH(font, kCount, 20 * r);
+        for (int i = 0; i < kCount; ++i) {
+            run.glyphs[i] = SkToU16(i * 997 % 1200);
+            run.pos[i] = runPositions[r][i % 5] + 50 * (i / 5);
+        }
+        if (r == 2) {
+            // Exact 26.6 values except for a negative zero, which must not lose its sign
+            run.pos[0] = -0.0f;
+        }
+    }
+    sk_sp<SkTextBlob> blob0 = builder.make();
+
+    sk_sp<SkData> data = blob0->serialize(SkSerialProcs());
+    sk_sp<SkTextBlob> blob1 = SkTextBlob::Deserialize(data->data(), data->size(),
+                                                      SkDeserialProcs());
+    REPORTER_ASSERT(reporter, blob1);
+    if (!blob1) {
+        return;
+    }
+
+    SkTextBlobRunIterator it0(blob0.get()), it1(blob1.get());
+    for (; !it0.done() && !it1.done(); it0.next(), it1.next()) {
+        REPORTER_ASSERT(reporter, it0.positioning() == it1.positioning());
+        REPORTER_ASSERT(reporter, it0.glyphCount() == it1.glyphCount());
+        REPORTER_ASSERT(reporter, !memcmp(it0.glyphs(), it1.glyphs(),
+                                          it0.glyphCount() * sizeof(uint16_t)));
+        REPORTER_ASSERT(reporter, !memcmp(it0.pos(), it1.pos(),
+                                          it0.glyphCount() * sizeof(SkScalar)));
+        REPORTER_ASSERT(reporter, std::signbit(it0.pos()[0]) == std::signbit(it1.pos()[0]));
+    }
+    REPORTER_ASSERT(reporter, it0.done() && it1.done());
+
+    // Check which encoding each kind of run gets from its serialized size: plain floats
+    // take the same space whatever their values, so any saving comes from the compact form.
+    auto serializedRunSize = [&](int r, bool negativeZero) {
+        SkTextBlobBuilder runBuilder;
+        const auto& run = runBuilder.allocRunPosH(font, kCount, 0);
+        for (int i = 0; i < kCount; ++i) {
+            run.glyphs[i] = SkToU16(i * 997 % 1200);
+            run.pos[i] = runPositions[r][i % 5] + 50 * (i / 5);
+        }
+        if (negativeZero) {
+            run.pos[0] = -0.0f;
+        }
+        return runBuilder.make()->serialize(SkSerialProcs())->size();
+    };
+    const size_t compactSize = serializedRunSize(0, false);
+    const size_t plainSize = serializedRunSize(1, false);
+    REPORTER_ASSERT(reporter, compactSize < plainSize);
+    REPORTER_ASSERT(reporter, serializedRunSize(0, true) == plainSize);
+}
+
+/*
+ *  Runs in pictures from before kCompactTextBlobRuns are never compact, whatever the bits that
+ *  now hold the compact flags contain.
+ */
+DEF_TEST(TextBlob_compactFlagsIgnoredInOldPictures, reporter) {
+    // Glyph ids this large take more room as varints, so they are written plainly.
+    constexpr int kCount = 8;
+    SkTextBlobBuilder builder;
+    const auto& run = builder.allocRun(SkFont(), kCount, 10, 20);
+    for (int i = 0; i < kCount; ++i) {
+        run.glyphs[i] = SkToU16(0x4000 + i);
+    }
+    sk_sp<SkTextBlob> blob0 = builder.make();
+
+    SkBinaryWriteBuffer writeBuffer;
+    SkTextBlobPriv::Flatten(*blob0, writeBuffer);
+    sk_sp<SkData> data = writeBuffer.snapshotAsData();
+
+    // Bounds, then the glyph count, then the run header with the compact flags in its high
+    // 16 bits. Claim that the glyph ids are varints.
+    AutoTMalloc<uint8_t> storage(data->size());
+    memcpy(storage.get(), data->data(), data->size());
+    const size_t headerOffset = sizeof(SkRect) + sizeof(int32_t);
+    int32_t header;
+    memcpy(&header, storage.get() + headerOffset, sizeof(header));
+    REPORTER_ASSERT(reporter, (header >> 16) == 0);
+    header |= 1 << 16;
+    memcpy(storage.get() + headerOffset, &header, sizeof(header));
+
+    SkReadBuffer readBuffer(storage.get(), data->size());
+    readBuffer.setVersion(SkPicturePriv::kShaderImageFilterSerializeShader);
+    sk_sp<SkTextBlob> blob1 = SkTextBlobPriv::MakeFromBuffer(readBuffer);
+    REPORTER_ASSERT(reporter, blob1);
+    if (!blob1) {
+        return;
+    }
+    SkTextBlobRunIterator it0(blob0.get()), it1(blob1.get());
+    REPORTER_ASSERT(reporter, !it1.done() && it1.glyphCount() == kCount);
+    if (!it1.done() && it1.glyphCount() == kCount) {
+        REPORTER_ASSERT(reporter, !memcmp(it0.glyphs(), it1.glyphs(), kCount * sizeof(uint16_t)));
+    }
+}
+
 DEF_TEST(TextBlob_MakeAsDrawText, reporter) {
     const char text[] = "Hello";
     auto blob = SkTextBlob::MakeFromString(text, SkFont(), SkTextEncoding::kUTF8);
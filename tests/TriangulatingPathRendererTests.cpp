@@ -6,9 +6,11 @@
  */
 
 #include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPathTypes.h"
@@ -23,6 +25,7 @@
 #include "include/core/SkTypes.h"
 #include "include/effects/SkGradientShader.h"
 #include "include/gpu/GpuTypes.h"
+#include "include/gpu/GrContextOptions.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/gpu/GrTypes.h"
 #include "include/private/base/SkFloatBits.h"
@@ -33,10 +36,14 @@
 #include "src/core/SkPathPriv.h"
 #include "src/gpu/SkBackingFit.h"
 #include "src/gpu/ganesh/GrColorInfo.h"
+#include "src/gpu/ganesh/GrDirectContextPriv.h"
 #include "src/gpu/ganesh/GrEagerVertexAllocator.h"
 #include "src/gpu/ganesh/GrFragmentProcessor.h"
 #include "src/gpu/ganesh/GrPaint.h"
+#include "src/gpu/ganesh/GrPixmap.h"
+#include "src/gpu/ganesh/GrRecordingContextPriv.h"
 #include "src/gpu/ganesh/GrStyle.h"
+#include "src/gpu/ganesh/GrThreadSafeCache.h"
 #include "src/gpu/ganesh/GrUserStencilSettings.h"
 #include "src/gpu/ganesh/PathRenderer.h"
 #include "src/gpu/ganesh/SurfaceDrawContext.h"
@@ -50,6 +57,7 @@
 #include "tests/CtsEnforcement.h"
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
+#include "tools/gpu/GrContextFactory.h"
 
 #include <cmath>
 #include <cstddef>
@@ -62,7 +70,6 @@ using namespace skia_private;
 
 class GrRecordingContext;
 class SkShader;
-struct GrContextOptions;
 
 #if !defined(SK_ENABLE_OPTIMIZE_SIZE)
 
@@ -909,6 +916,93 @@ DEF_GANESH_TEST_FOR_ALL_CONTEXTS(TriangulatingPathRendererTests,
     test_path(ctx, sdc.get(), create_path_47(), SkMatrix(), GrAAType::kCoverage);
 }
 
+// Draws the same paths as above, with and without AA and each in its own color, and reads back the
+// result. Returns false if the context can't render them.
+static bool draw_threaded_prepare_paths(GrDirectContext* ctx, SkBitmap* result) {
+    auto sdc = skgpu::ganesh::SurfaceDrawContext::Make(ctx,
+                                                       GrColorType::kRGBA_8888,
+                                                       nullptr,
+                                                       SkBackingFit::kExact,
+                                                       {800, 800},
+                                                       SkSurfaceProps(),
+                                                       /*label=*/{},
+                                                       1,
+                                                       GrMipmapped::kNo,
+                                                       GrProtected::kNo,
+                                                       kTopLeft_GrSurfaceOrigin);
+    if (!sdc) {
+        return false;
+    }
+    sdc->clear(SK_PMColor4fTRANSPARENT);
+
+    static constexpr SkPMColor4f kColors[] = {{1, 0, 0, 1}, {0, 1, 0, 1}, {0, 0, 1, 1},
+                                              {0.5f, 0.5f, 0, 1}, {0, 0.5f, 0.5f, 1}};
+    int colorIndex = 0;
+    for (GrAAType aaType : {GrAAType::kNone, GrAAType::kCoverage}) {
+        for (CreatePathFn createPath : kNonEdgeAAPaths) {
+            const SkPMColor4f& color = kColors[colorIndex++ % std::size(kColors)];
+            test_path(ctx, sdc.get(), createPath(), SkMatrix(), aaType,
+                      GrFragmentProcessor::MakeColor(color));
+        }
+        ctx->flushAndSubmit();
+    }
+
+    result->allocPixels(SkImageInfo::Make(sdc->dimensions(), kRGBA_8888_SkColorType,
+                                          kPremul_SkAlphaType));
+    return sdc->readPixels(ctx, result->pixmap(), {0, 0});
+}
+
+// Triangulates the paths on worker threads at flush time, and checks that the result matches
+// triangulating them on the flushing thread.
+DEF_GANESH_TEST(TriangulatingPathRendererThreadedPrepare, reporter, options,
+                CtsEnforcement::kNever) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    GrContextOptions threadedOptions = options;
+    threadedOptions.fExecutor = executor.get();
+    threadedOptions.fThreadedOpPrepare = true;
+    sk_gpu_test::GrContextFactory factory(options);
+    sk_gpu_test::GrContextFactory threadedFactory(threadedOptions);
+
+    for (int ct = 0; ct < sk_gpu_test::GrContextFactory::kContextTypeCnt; ++ct) {
+        auto contextType = static_cast<sk_gpu_test::GrContextFactory::ContextType>(ct);
+        GrDirectContext* ctx = factory.get(contextType);
+        GrDirectContext* threadedCtx = threadedFactory.get(contextType);
+        if (!ctx || !threadedCtx) {
+            continue;
+        }
+
+        SkBitmap expected, actual;
+        bool drewExpected = draw_threaded_prepare_paths(ctx, &expected);
+        bool drewActual = draw_threaded_prepare_paths(threadedCtx, &actual);
+        REPORTER_ASSERT(reporter, drewExpected == drewActual);
+        if (!drewExpected || !drewActual) {
+            continue;
+        }
+
+#if GR_GPU_STATS
+        // Every triangulating op was prepared by the executor, and only when asked to.
+        REPORTER_ASSERT(reporter, ctx->priv().stats()->numThreadedOpPrepares() == 0);
+        REPORTER_ASSERT(reporter, threadedCtx->priv().stats()->numThreadedOpPrepares() > 0);
+#endif
+        // The non-AA triangulations done on the worker threads went through the cache.
+        REPORTER_ASSERT(reporter, threadedCtx->priv().threadSafeCache()->numEntries() > 0);
+
+        if (!sk_gpu_test::GrContextFactory::IsRenderingContext(contextType)) {
+            continue;
+        }
+        const SkPixmap& e = expected.pixmap();
+        const SkPixmap& a = actual.pixmap();
+        int numMismatches = 0;
+        for (int y = 0; y < e.height(); ++y) {
+            numMismatches += memcmp(e.addr32(0, y), a.addr32(0, y), e.info().minRowBytes()) != 0;
+        }
+        REPORTER_ASSERT(reporter, numMismatches == 0,
+                        "%s: %d rows differ with threaded op prepare",
+                        sk_gpu_test::GrContextFactory::ContextTypeName(contextType),
+                        numMismatches);
+    }
+}
+
 #endif // defined(SK_GANESH)
 
 namespace {
@@ -7,8 +7,11 @@
 
 #include "include/codec/SkCodec.h"
 #include "include/codec/SkEncodedOrigin.h"
+#include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageGenerator.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkScalar.h"
@@ -20,11 +23,18 @@
 #include "include/effects/SkColorMatrix.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/private/base/SkTo.h"
+#include "src/core/SkAutoPixmapStorage.h"
+#include "src/core/SkCachedData.h"
+#include "src/core/SkResourceCache.h"
+#include "src/core/SkYUVAToRGB.h"
+#include "src/core/SkYUVPlanesCache.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <utility>
 
@@ -238,3 +248,219 @@ DEF_TEST(YUVMath, reporter) {
         }
     }
 }
+
+// Converting the planes on the CPU should match libjpeg's own conversion to RGBA, which also uses
+// "fancy" upsampling.
+DEF_TEST(YUVAToRGB, r) {
+    for (const char* path : {"images/mandrill_512_q075.jpg",  // 4:2:0
+                             "images/mandrill_h1v1.jpg",      // 4:4:4
+                             "images/mandrill_h2v1.jpg",      // 4:2:2
+                             "images/cropped_mandrill.jpg"}) {
+        std::unique_ptr<SkStream> stream(GetResourceAsStream(path));
+        if (!stream) {
+            continue;
+        }
+        std::unique_ptr<SkCodec> codec(SkCodec::MakeFromStream(std::move(stream)));
+        REPORTER_ASSERT(r, codec);
+        if (!codec) {
+            continue;
+        }
+        SkYUVAPixmapInfo yuvaPixmapInfo;
+        SkYUVAPixmapInfo::SupportedDataTypes dataTypes;
+        dataTypes.enableDataType(SkYUVAPixmapInfo::DataType::kUnorm8, 1);
+        REPORTER_ASSERT(r, codec->queryYUVAInfo(dataTypes, &yuvaPixmapInfo));
+        auto planes = SkYUVAPixmaps::Allocate(yuvaPixmapInfo);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getYUVAPlanes(planes));
+
+        SkImageInfo info = codec->getInfo().makeColorType(kRGBA_8888_SkColorType);
+        SkAutoPixmapStorage expected, actual;
+        expected.alloc(info);
+        actual.alloc(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(expected));
+        REPORTER_ASSERT(r, SkYUVAToRGB(planes, actual));
+
+        // The BGRA conversion only swaps red and blue.
+        SkAutoPixmapStorage bgra;
+        bgra.alloc(info.makeColorType(kBGRA_8888_SkColorType));
+        REPORTER_ASSERT(r, SkYUVAToRGB(planes, bgra));
+
+        int maxDiff = 0;
+        for (int y = 0; y < info.height(); ++y) {
+            for (int x = 0; x < info.width(); ++x) {
+                const uint8_t* e = static_cast<const uint8_t*>(expected.addr(x, y));
+                const uint8_t* a = static_cast<const uint8_t*>(actual.addr(x, y));
+                const uint8_t* b = static_cast<const uint8_t*>(bgra.addr(x, y));
+                for (int c = 0; c < 4; ++c) {
+                    maxDiff = std::max(maxDiff, std::abs(e[c] - a[c]));
+                }
+                REPORTER_ASSERT(r, a[0] == b[2] && a[1] == b[1] && a[2] == b[0] && a[3] == b[3]);
+            }
+        }
+        REPORTER_ASSERT(r, maxDiff <= 2, "%s: max difference %d", path, maxDiff);
+    }
+
+    // Unsupported destinations are rejected.
+    std::unique_ptr<SkStream> stream(GetResourceAsStream("images/mandrill_h2v1.jpg"));
+    if (stream) {
+        SkYUVAPixmaps planes = decode_yuva(r, std::move(stream));
+        SkAutoPixmapStorage f16, small;
+        f16.alloc(SkImageInfo::Make(planes.yuvaInfo().dimensions(), kRGBA_F16_SkColorType,
+                                    kOpaque_SkAlphaType));
+        small.alloc(SkImageInfo::MakeN32Premul(16, 16));
+        REPORTER_ASSERT(r, !SkYUVAToRGB(planes, f16));
+        REPORTER_ASSERT(r, !SkYUVAToRGB(planes, small));
+    }
+}
+
+DEF_TEST(RasterFromYUVAPixmaps, r) {
+    std::unique_ptr<SkStream> stream(GetResourceAsStream("images/mandrill_512_q075.jpg"));
+    if (!stream) {
+        return;
+    }
+    SkYUVAPixmaps planes = decode_yuva(r, std::move(stream));
+
+    sk_sp<SkImage> image = SkImages::RasterFromYUVAPixmaps(planes, SkColorSpace::MakeSRGB());
+    REPORTER_ASSERT(r, image);
+    if (!image) {
+        return;
+    }
+    REPORTER_ASSERT(r, !image->isTextureBacked());
+    REPORTER_ASSERT(r, image->dimensions() == planes.yuvaInfo().dimensions());
+    REPORTER_ASSERT(r, image->isOpaque());
+    REPORTER_ASSERT(r, SkColorSpace::Equals(image->colorSpace(), sk_srgb_singleton()));
+
+    // The image holds exactly what SkYUVAToRGB converts.
+    const SkImageInfo info = image->imageInfo().makeColorType(kRGBA_8888_SkColorType);
+    SkAutoPixmapStorage expected, actual;
+    expected.alloc(info);
+    actual.alloc(info);
+    REPORTER_ASSERT(r, SkYUVAToRGB(planes, expected));
+    REPORTER_ASSERT(r, image->readPixels(nullptr, actual, 0, 0));
+    for (int y = 0; y < info.height(); ++y) {
+        REPORTER_ASSERT(r, !memcmp(expected.addr(0, y), actual.addr(0, y), info.minRowBytes()),
+                        "row %d", y);
+    }
+
+    // Planes that need to be reoriented are not supported.
+    stream = GetResourceAsStream("images/exif-orientation-2-ur.jpg");
+    if (stream) {
+        SkYUVAPixmaps oriented = decode_yuva(r, std::move(stream));
+        REPORTER_ASSERT(r, oriented.yuvaInfo().origin() != kTopLeft_SkEncodedOrigin);
+        REPORTER_ASSERT(r, !SkImages::RasterFromYUVAPixmaps(oriented));
+    }
+}
+
+namespace {
+
+// Decodes a JPEG's pixels or planes, optionally refusing to decode pixels, and counts the decodes.
+class CountingYUVAGenerator final : public SkImageGenerator {
+public:
+    CountingYUVAGenerator(std::unique_ptr<SkCodec> codec, bool supportsPixels)
+            : SkImageGenerator(codec->getInfo())
+            , fCodec(std::move(codec))
+            , fSupportsPixels(supportsPixels) {}
+
+    int numPixelDecodes() const { return fNumPixelDecodes; }
+    int numPlaneDecodes() const { return fNumPlaneDecodes; }
+
+protected:
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                     const Options&) override {
+        if (!fSupportsPixels) {
+            return false;
+        }
+        ++fNumPixelDecodes;
+        return fCodec->getPixels(info, pixels, rowBytes) == SkCodec::kSuccess;
+    }
+
+    bool onQueryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes& dataTypes,
+                         SkYUVAPixmapInfo* yuvaPixmapInfo) const override {
+        return fCodec->queryYUVAInfo(dataTypes, yuvaPixmapInfo);
+    }
+
+    bool onGetYUVAPlanes(const SkYUVAPixmaps& planes) override {
+        ++fNumPlaneDecodes;
+        return fCodec->getYUVAPlanes(planes) == SkCodec::kSuccess;
+    }
+
+private:
+    std::unique_ptr<SkCodec> fCodec;
+    const bool fSupportsPixels;
+    int fNumPixelDecodes = 0;
+    int fNumPlaneDecodes = 0;
+};
+
+} // anonymous namespace
+
+// A lazy image's raster pixels come from the generator's getPixels() whenever it has them, so they
+// don't change when the image's planes get cached. Only generators that can't produce pixels have
+// their planes converted.
+DEF_TEST(ImageLazyYUVAPixels, r) {
+    const char* path = "images/mandrill_512_q075.jpg";
+    auto make_generator = [r, path](bool supportsPixels) {
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromStream(GetResourceAsStream(path));
+        REPORTER_ASSERT(r, codec);
+        return codec ? std::make_unique<CountingYUVAGenerator>(std::move(codec), supportsPixels)
+                     : nullptr;
+    };
+    auto read_pixels = [r](const sk_sp<SkImage>& image, SkAutoPixmapStorage* pixmap) {
+        pixmap->alloc(image->imageInfo().makeColorType(kRGBA_8888_SkColorType));
+        REPORTER_ASSERT(r, image->readPixels(nullptr, *pixmap, 0, 0,
+                                             SkImage::kDisallow_CachingHint));
+    };
+    if (!GetResourceAsData(path)) {
+        return;
+    }
+
+    {
+        std::unique_ptr<CountingYUVAGenerator> gen = make_generator(/*supportsPixels=*/true);
+        if (!gen) {
+            return;
+        }
+        CountingYUVAGenerator* counter = gen.get();
+        sk_sp<SkImage> image = SkImages::DeferredFromGenerator(std::move(gen));
+        REPORTER_ASSERT(r, image);
+
+        SkAutoPixmapStorage before;
+        read_pixels(image, &before);
+        REPORTER_ASSERT(r, counter->numPixelDecodes() == 1 && counter->numPlaneDecodes() == 0);
+
+        // Put the image's planes in the cache, as uploading them to a GPU would.
+        SkYUVAPixmapInfo yuvaPixmapInfo;
+        SkYUVAPixmapInfo::SupportedDataTypes dataTypes;
+        dataTypes.enableDataType(SkYUVAPixmapInfo::DataType::kUnorm8, 1);
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromStream(GetResourceAsStream(path));
+        REPORTER_ASSERT(r, codec->queryYUVAInfo(dataTypes, &yuvaPixmapInfo));
+        sk_sp<SkCachedData> data(
+                SkResourceCache::NewCachedData(yuvaPixmapInfo.computeTotalBytes()));
+        auto planes = SkYUVAPixmaps::FromExternalMemory(yuvaPixmapInfo, data->writable_data());
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getYUVAPlanes(planes));
+        SkYUVPlanesCache::Add(image->uniqueID(), data.get(), planes);
+
+        SkAutoPixmapStorage after;
+        read_pixels(image, &after);
+        REPORTER_ASSERT(r, counter->numPixelDecodes() == 2 && counter->numPlaneDecodes() == 0);
+        REPORTER_ASSERT(r, before.computeByteSize() == after.computeByteSize() &&
+                           !memcmp(before.addr(), after.addr(), before.computeByteSize()));
+    }
+
+    {
+        std::unique_ptr<CountingYUVAGenerator> gen = make_generator(/*supportsPixels=*/false);
+        if (!gen) {
+            return;
+        }
+        CountingYUVAGenerator* counter = gen.get();
+        sk_sp<SkImage> image = SkImages::DeferredFromGenerator(std::move(gen));
+        REPORTER_ASSERT(r, image);
+
+        SkAutoPixmapStorage pixels;
+        read_pixels(image, &pixels);
+        REPORTER_ASSERT(r, counter->numPixelDecodes() == 0 && counter->numPlaneDecodes() == 1);
+
+        // The planes are cached, so reading again converts them without decoding.
+        SkAutoPixmapStorage again;
+        read_pixels(image, &again);
+        REPORTER_ASSERT(r, counter->numPlaneDecodes() == 1);
+        REPORTER_ASSERT(r, !memcmp(pixels.addr(), again.addr(), pixels.computeByteSize()));
+    }
+}
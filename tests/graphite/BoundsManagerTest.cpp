@@ -47,4 +47,45 @@ DEF_TEST(BoundsManager, r) {
     // TODO: Then test calls where the new value is not larger than the current max
 }
 
+DEF_TEST(OcclusionGrid, r) {
+    OcclusionGrid grid({256, 256});
+    const float cell = grid.cellSize();
+
+    PaintersDepth behind = PaintersDepth::First().next();
+    PaintersDepth occluderDepth = behind.next();
+    PaintersDepth inFront = occluderDepth.next();
+
+    // Nothing is occluded before an occluder is recorded
+    REPORTER_ASSERT(r, !grid.hasOccluders());
+    REPORTER_ASSERT(r, !grid.isOccluded(Rect::XYWH(10, 10, 4, 4), behind));
+
+    // An occluder that doesn't fully cover any cell is ignored
+    grid.recordOccluder(Rect::XYWH(1, 1, cell - 2, cell - 2), occluderDepth);
+    REPORTER_ASSERT(r, !grid.hasOccluders());
+
+    // Cover cells [1,5) x [1,5), with fractional edges that spill into the neighboring cells
+    grid.recordOccluder(Rect(cell - 0.5f, cell - 0.5f, 5 * cell + 0.5f, 5 * cell + 0.5f),
+                        occluderDepth);
+    REPORTER_ASSERT(r, grid.hasOccluders());
+
+    const Rect inside = Rect(cell + 1, cell + 1, 5 * cell - 1, 5 * cell - 1);
+    REPORTER_ASSERT(r, grid.isOccluded(inside, behind));
+    // Draws at or after the occluder's depth are not hidden by it
+    REPORTER_ASSERT(r, !grid.isOccluded(inside, occluderDepth));
+    REPORTER_ASSERT(r, !grid.isOccluded(inside, inFront));
+    // Draws that touch a partially covered cell are kept
+    REPORTER_ASSERT(r, !grid.isOccluded(Rect(cell - 0.25f, cell + 1, 2 * cell, 2 * cell), behind));
+    REPORTER_ASSERT(r, !grid.isOccluded(Rect(cell + 1, cell + 1, 6 * cell, 2 * cell), behind));
+
+    // Occluders reaching the device edges cover the cells along the edges
+    grid.recordOccluder(Rect(5 * cell, 0, 256, 256), inFront);
+    REPORTER_ASSERT(r, grid.isOccluded(Rect(200, 200, 256, 256), occluderDepth));
+    // Coverage from several occluders combines
+    REPORTER_ASSERT(r, grid.isOccluded(Rect(cell + 1, cell + 1, 200, 2 * cell), behind));
+
+    grid.reset();
+    REPORTER_ASSERT(r, !grid.hasOccluders());
+    REPORTER_ASSERT(r, !grid.isOccluded(inside, behind));
+}
+
 }  // namespace skgpu::graphite
@@ -0,0 +1,279 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "tests/Test.h"
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkM44.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkSurface.h"
+#include "include/gpu/graphite/Context.h"
+#include "include/gpu/graphite/Recorder.h"
+#include "include/gpu/graphite/Recording.h"
+#include "src/gpu/graphite/Caps.h"
+#include "src/gpu/graphite/ComputeTask.h"
+#include "src/gpu/graphite/ContextPriv.h"
+#include "src/gpu/graphite/DrawParams.h"
+#include "src/gpu/graphite/RecorderPriv.h"
+#include "src/gpu/graphite/TextureProxy.h"
+#include "src/gpu/graphite/compute/ComputePathCoverage.h"
+#include "src/gpu/graphite/compute/DispatchGroup.h"
+
+#include <optional>
+
+using namespace skgpu::graphite;
+
+namespace {
+
+constexpr SkIRect kDeviceBounds = SkIRect::MakeWH(96, 80);
+
+struct TestCase {
+    const char* fName;
+    SkPath fPath;
+    SkMatrix fMatrix = SkMatrix::I();
+    std::optional<StrokeStyle> fStroke;
+};
+
+std::vector<TestCase> test_cases() {
+    std::vector<TestCase> cases;
+
+    cases.push_back({"triangle", SkPath::Polygon({{3.3f, 2.1f}, {70.7f, 9.2f}, {30.2f, 61.9f}},
+                                                 /*isClosed=*/true)});
+
+    cases.push_back({"circle", SkPath::Circle(40.5f, 37.25f, 29.f)});
+
+    SkPath star;
+    for (int i = 0; i < 5; ++i) {
+        float angle = i * 4 * SK_ScalarPI / 5 - SK_ScalarPI / 2;
+        SkPoint p = {48 + 34 * std::cos(angle), 40 + 34 * std::sin(angle)};
+        i == 0 ? star.moveTo(p) : star.lineTo(p);
+    }
+    star.close();
+    cases.push_back({"star (nonzero)", star});
+    star.setFillType(SkPathFillType::kEvenOdd);
+    cases.push_back({"star (evenodd)", star});
+
+    SkPath cubic;
+    cubic.moveTo(10, 70);
+    cubic.cubicTo(20, -20, 80, 120, 88, 8);
+    cubic.lineTo(40, 40);
+    cases.push_back({"cubic", cubic});
+
+    SkMatrix rotate = SkMatrix::RotateDeg(30, {48, 40});
+    rotate.preScale(1.5f, 0.75f, 48, 40);
+    cases.push_back({"transformed rect", SkPath::Rect({20, 20, 76, 60}), rotate});
+
+    SkPath curve;
+    curve.moveTo(12, 60);
+    curve.quadTo(48, -10, 84, 60);
+    cases.push_back({"stroke", curve, SkMatrix::I(),
+                     StrokeStyle(6.f, 4.f, SkPaint::kRound_Join, SkPaint::kRound_Cap)});
+
+    SkPath inverse = SkPath::Circle(48, 40, 20);
+    inverse.setFillType(SkPathFillType::kInverseWinding);
+    cases.push_back({"inverse circle", inverse});
+
+    // Extends far outside of the device bounds on every side.
+    cases.push_back({"offscreen triangle", SkPath::Polygon({{-1000, -50}, {2000, 30}, {40, 3000}},
+                                                           /*isClosed=*/true)});
+    return cases;
+}
+
+DrawParams make_draw_params(const Transform& transform, const TestCase& test) {
+    return DrawParams(transform,
+                      Geometry(Shape(test.fPath)),
+                      Clip(Rect(SkRect::Make(kDeviceBounds)), kDeviceBounds),
+                      DrawOrder({}),
+                      test.fStroke ? &*test.fStroke : nullptr);
+}
+
+// Renders the coverage of 'test' over 'area' with the raster backend.
+SkBitmap raster_coverage(const TestCase& test, const SkIRect& area) {
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeA8(area.width(), area.height()));
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+
+    SkCanvas canvas(bitmap);
+    canvas.translate(-area.fLeft, -area.fTop);
+    canvas.concat(test.fMatrix);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    if (test.fStroke) {
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(test.fStroke->width());
+        paint.setStrokeJoin(test.fStroke->join());
+        paint.setStrokeCap(test.fStroke->cap());
+        paint.setStrokeMiter(test.fStroke->miterLimit());
+    }
+    canvas.drawPath(test.fPath, paint);
+    return bitmap;
+}
+
+}  // namespace
+
+DEF_TEST(ComputePathCoverage_CPUReference, reporter) {
+    for (const TestCase& test : test_cases()) {
+        const Transform transform{SkM44(test.fMatrix)};
+        DrawParams draw = make_draw_params(transform, test);
+
+        SkBitmap coverage;
+        SkIRect area;
+        if (!ComputePathCoverage::CPUCoverage(draw, &coverage, &area)) {
+            ERRORF(reporter, "%s: no coverage computed", test.fName);
+            continue;
+        }
+        REPORTER_ASSERT(reporter, kDeviceBounds.contains(area), "%s", test.fName);
+        SkBitmap expected = raster_coverage(test, area);
+
+        // The raster backend's analytic AA and the exact area coverage differ slightly at
+        // vertices and self-intersections; elsewhere they should agree closely.
+        int mismatches = 0;
+        for (int y = 0; y < area.height(); ++y) {
+            for (int x = 0; x < area.width(); ++x) {
+                int diff = std::abs(*coverage.getAddr8(x, y) - *expected.getAddr8(x, y));
+                if (diff > 24) {
+                    ++mismatches;
+                }
+            }
+        }
+        int allowed = std::max(4, area.width() * area.height() / 100);
+        REPORTER_ASSERT(reporter, mismatches <= allowed,
+                        "%s: %d pixels differ from raster coverage (allowed %d)",
+                        test.fName, mismatches, allowed);
+    }
+
+    // A draw that lies entirely outside of the scissor has no coverage to compute.
+    TestCase offscreen = {"offscreen", SkPath::Circle(500, 500, 10)};
+    const Transform& identity = Transform::Identity();
+    SkBitmap coverage;
+    REPORTER_ASSERT(reporter,
+                    !ComputePathCoverage::CPUCoverage(make_draw_params(identity, offscreen),
+                                                      &coverage));
+}
+
+// TODO(b/262427430, b/262429132): Enable this test on other backends once they all support
+// compute programs.
+DEF_GRAPHITE_TEST_FOR_METAL_CONTEXT(ComputePathCoverage_MatchesCPUReference, reporter, context) {
+    ComputePathCoverage pathCoverage;
+
+    for (const TestCase& test : test_cases()) {
+        const Transform transform{SkM44(test.fMatrix)};
+        DrawParams draw = make_draw_params(transform, test);
+
+        std::unique_ptr<Recorder> recorder = context->makeRecorder();
+        DispatchGroup::Builder builder(recorder.get());
+        SkIRect area;
+        sk_sp<TextureProxy> coverage =
+                pathCoverage.appendSteps(recorder.get(), &builder, draw, &area);
+        if (!coverage) {
+            ERRORF(reporter, "%s: failed to append the coverage steps", test.fName);
+            continue;
+        }
+
+        ComputeTask::DispatchGroupList groups;
+        groups.push_back(builder.finalize());
+        recorder->priv().add(ComputeTask::Make(std::move(groups)));
+
+        std::unique_ptr<Recording> recording = recorder->snap();
+        if (!recording) {
+            ERRORF(reporter, "%s: failed to make recording", test.fName);
+            continue;
+        }
+        InsertRecordingInfo insertInfo;
+        insertInfo.fRecording = recording.get();
+        context->insertRecording(insertInfo);
+        context->submit(SyncToCpu::kYes);
+
+        SkBitmap expected;
+        SkIRect expectedArea;
+        ComputePathCoverage::CPUCoverage(draw, &expected, &expectedArea);
+        REPORTER_ASSERT(reporter, area == expectedArea, "%s", test.fName);
+
+        SkBitmap bitmap;
+        SkImageInfo imgInfo = SkImageInfo::Make(
+                area.width(), area.height(), kRGBA_8888_SkColorType, kUnpremul_SkAlphaType);
+        bitmap.allocPixels(imgInfo);
+        SkPixmap pixels;
+        bool peekPixelsSuccess = bitmap.peekPixels(&pixels);
+        REPORTER_ASSERT(reporter, peekPixelsSuccess);
+        if (!context->priv().readPixels(pixels, coverage.get(), imgInfo, 0, 0)) {
+            ERRORF(reporter, "%s: failed to read back the coverage texture", test.fName);
+            continue;
+        }
+
+        int worst = 0;
+        for (int y = 0; y < area.height(); ++y) {
+            for (int x = 0; x < area.width(); ++x) {
+                int found = SkColorGetR(pixels.getColor(x, y));
+                worst = std::max(worst, std::abs(found - *expected.getAddr8(x, y)));
+            }
+        }
+        // Allow for differences in floating point rounding and in the order that a tile's
+        // segments are summed.
+        REPORTER_ASSERT(reporter, worst <= 2,
+                        "%s: GPU coverage differs from the CPU reference by up to %d",
+                        test.fName, worst);
+    }
+}
+
+// Large, complex fills are drawn with the CoverageMask renderer when compute is supported, so this
+// exercises the whole path from Device through the ComputeTask and the render pass.
+DEF_GRAPHITE_TEST_FOR_METAL_CONTEXT(ComputePathCoverage_DrawsComplexFills, reporter, context) {
+    constexpr int kSize = 320;
+    SkPath star;
+    constexpr int kPoints = 61;
+    for (int i = 0; i < kPoints; ++i) {
+        float angle = i * 2 * SK_ScalarPI * 23 / kPoints;
+        SkPoint p = {160 + 150 * std::cos(angle), 160 + 150 * std::sin(angle)};
+        i == 0 ? star.moveTo(p) : star.lineTo(p);
+    }
+    star.close();
+    star.setFillType(SkPathFillType::kEvenOdd);
+    REPORTER_ASSERT(reporter, context->priv().caps()->computeSupport());
+
+    const SkImageInfo info = SkImageInfo::Make(kSize, kSize, kRGBA_8888_SkColorType,
+                                               kPremul_SkAlphaType);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorBLACK);
+
+    std::unique_ptr<Recorder> recorder = context->makeRecorder();
+    sk_sp<SkSurface> surface = SkSurface::MakeGraphite(recorder.get(), info);
+    surface->getCanvas()->clear(SK_ColorWHITE);
+    surface->getCanvas()->drawPath(star, paint);
+
+    SkBitmap actual;
+    actual.allocPixels(info);
+    SkPixmap pm;
+    bool peekPixelsSuccess = actual.peekPixels(&pm);
+    REPORTER_ASSERT(reporter, peekPixelsSuccess);
+    bool readPixelsSuccess = surface->readPixels(pm, 0, 0);
+    REPORTER_ASSERT(reporter, readPixelsSuccess);
+
+    SkBitmap expected;
+    expected.allocPixels(info);
+    SkCanvas canvas(expected);
+    canvas.clear(SK_ColorWHITE);
+    canvas.drawPath(star, paint);
+
+    // As in the CPU reference test, the raster backend's AA differs slightly at vertices.
+    int mismatches = 0;
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            int diff = std::abs((int)SkColorGetR(pm.getColor(x, y)) -
+                                (int)SkColorGetR(expected.getColor(x, y)));
+            if (diff > 24) {
+                ++mismatches;
+            }
+        }
+    }
+    int allowed = kSize * kSize / 100;
+    REPORTER_ASSERT(reporter, mismatches <= allowed,
+                    "%d pixels differ from raster (allowed %d)", mismatches, allowed);
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "tests/Test.h"
+
+#include "include/core/SkBlendMode.h"
+#include "include/private/base/SkTArray.h"
+#include "src/gpu/graphite/AttachmentTypes.h"
+#include "src/gpu/graphite/ContextPriv.h"
+#include "src/gpu/graphite/GraphicsPipelineDesc.h"
+#include "src/gpu/graphite/PaintParamsKey.h"
+#include "src/gpu/graphite/PipelineCacheUtils.h"
+#include "src/gpu/graphite/Renderer.h"
+#include "src/gpu/graphite/RendererProvider.h"
+#include "src/gpu/graphite/ShaderCodeDictionary.h"
+
+using namespace skgpu::graphite;
+
+namespace {
+
+class TestStorage : public ContextOptions::PersistentPipelineStorage {
+public:
+    sk_sp<SkData> load(const SkData& key) override {
+        ++fNumLoads;
+        for (const auto& [storedKey, data] : fEntries) {
+            if (storedKey->equals(&key)) {
+                ++fNumHits;
+                return data;
+            }
+        }
+        return nullptr;
+    }
+
+    void store(const SkData& key, const SkData& data) override {
+        fEntries.push_back({SkData::MakeWithCopy(key.data(), key.size()),
+                            SkData::MakeWithCopy(data.data(), data.size())});
+    }
+
+    int numLoads() const { return fNumLoads; }
+    int numHits() const { return fNumHits; }
+    int numEntries() const { return fEntries.size(); }
+
+private:
+    skia_private::TArray<std::pair<sk_sp<SkData>, sk_sp<SkData>>> fEntries;
+    int fNumLoads = 0;
+    int fNumHits = 0;
+};
+
+UniquePaintParamsID make_paint_id(ShaderCodeDictionary* dict, int snippetID) {
+    PaintParamsKeyBuilder builder(dict);
+    builder.beginBlock(snippetID);
+    builder.endBlock();
+    return dict->findOrCreate(&builder)->uniqueID();
+}
+
+} // anonymous namespace
+
+DEF_TEST(PipelineCacheUtilsPackUnpack, reporter) {
+    static constexpr SkFourByteTag kTag = SkSetFourByteTag('T', 'E', 'S', 'T');
+
+    PipelineCacheUtils::CachedShaders shaders;
+    shaders.fVertexShader = "vertex";
+    shaders.fFragmentShader = std::string("frag\0ment", 9);  // binary shaders may contain zeros
+    shaders.fBlendInfo.fSrcBlend = skgpu::BlendCoeff::kSA;
+    shaders.fBlendInfo.fDstBlend = skgpu::BlendCoeff::kISA;
+    shaders.fBlendInfo.fWritesColor = false;
+    shaders.fNumTexturesAndSamplers = 4;
+
+    sk_sp<SkData> data = PipelineCacheUtils::PackCachedShaders(kTag, shaders);
+    REPORTER_ASSERT(reporter, data);
+
+    PipelineCacheUtils::CachedShaders unpacked;
+    REPORTER_ASSERT(reporter, PipelineCacheUtils::UnpackCachedShaders(*data, kTag, &unpacked));
+    REPORTER_ASSERT(reporter, unpacked.fVertexShader == shaders.fVertexShader);
+    REPORTER_ASSERT(reporter, unpacked.fFragmentShader == shaders.fFragmentShader);
+    REPORTER_ASSERT(reporter, unpacked.fBlendInfo == shaders.fBlendInfo);
+    REPORTER_ASSERT(reporter, unpacked.fNumTexturesAndSamplers == 4);
+
+    // Data for another backend is rejected and leaves the output untouched
+    PipelineCacheUtils::CachedShaders other;
+    REPORTER_ASSERT(reporter, !PipelineCacheUtils::UnpackCachedShaders(
+            *data, SkSetFourByteTag('M', 'S', 'L', ' '), &other));
+    REPORTER_ASSERT(reporter, other.fVertexShader.empty());
+
+    // As is truncated data
+    sk_sp<SkData> truncated = SkData::MakeSubset(data.get(), 0, data->size() - 8);
+    REPORTER_ASSERT(reporter, !PipelineCacheUtils::UnpackCachedShaders(*truncated, kTag, &other));
+    REPORTER_ASSERT(reporter, other.fVertexShader.empty());
+}
+
+DEF_GRAPHITE_TEST_FOR_ALL_CONTEXTS(PipelineCacheUtilsKeys, reporter, context) {
+    static constexpr SkFourByteTag kTag = SkSetFourByteTag('T', 'E', 'S', 'T');
+
+    const SharedContext* sharedContext = context->priv().sharedContext();
+    ShaderCodeDictionary* dict = context->priv().shaderCodeDictionary();
+    const RenderStep* step = &context->priv().rendererProvider()->analyticRRect()->step(0);
+    const RenderPassDesc renderPassDesc = {};
+
+    const int srcOverID = kFixedFunctionBlendModeIDOffset + static_cast<int>(SkBlendMode::kSrcOver);
+    const GraphicsPipelineDesc builtInDesc(step, make_paint_id(dict, srcOverID));
+    const GraphicsPipelineDesc userDefinedDesc(
+            step, make_paint_id(dict, dict->addUserDefinedSnippet("PipelineCacheUtilsKeys")));
+
+    // Keys only depend on values that are stable across sessions
+    sk_sp<SkData> key = PipelineCacheUtils::MakePipelineKey(sharedContext, kTag, builtInDesc,
+                                                            renderPassDesc);
+    REPORTER_ASSERT(reporter, key);
+    sk_sp<SkData> sameKey = PipelineCacheUtils::MakePipelineKey(sharedContext, kTag, builtInDesc,
+                                                                renderPassDesc);
+    REPORTER_ASSERT(reporter, sameKey && key->equals(sameKey.get()));
+
+    // Runtime effects and other user-defined snippets get per-process IDs, so their pipelines
+    // can't be persisted
+    REPORTER_ASSERT(reporter, !PipelineCacheUtils::MakePipelineKey(sharedContext, kTag,
+                                                                   userDefinedDesc,
+                                                                   renderPassDesc));
+
+    TestStorage storage;
+    int numCompiles = 0;
+    auto compile = [&numCompiles](PipelineCacheUtils::CachedShaders* shaders) {
+        ++numCompiles;
+        shaders->fVertexShader = "vertex";
+        shaders->fFragmentShader = "fragment";
+        return true;
+    };
+
+    // The first lookup misses and stores the compiled shaders
+    PipelineCacheUtils::CachedShaders shaders;
+    REPORTER_ASSERT(reporter, PipelineCacheUtils::FindOrCompileShaders(&storage, key.get(), kTag,
+                                                                       compile, &shaders));
+    REPORTER_ASSERT(reporter, numCompiles == 1);
+    REPORTER_ASSERT(reporter, storage.numLoads() == 1 && storage.numHits() == 0);
+    REPORTER_ASSERT(reporter, storage.numEntries() == 1);
+
+    // The second one, with an equal key, finds them without compiling
+    PipelineCacheUtils::CachedShaders found;
+    REPORTER_ASSERT(reporter, PipelineCacheUtils::FindOrCompileShaders(&storage, sameKey.get(),
+                                                                       kTag, compile, &found));
+    REPORTER_ASSERT(reporter, numCompiles == 1);
+    REPORTER_ASSERT(reporter, storage.numLoads() == 2 && storage.numHits() == 1);
+    REPORTER_ASSERT(reporter, storage.numEntries() == 1);
+    REPORTER_ASSERT(reporter, found.fVertexShader == "vertex");
+    REPORTER_ASSERT(reporter, found.fFragmentShader == "fragment");
+
+    // Without a key, e.g. for a runtime effect, the shaders are compiled and never stored
+    REPORTER_ASSERT(reporter, PipelineCacheUtils::FindOrCompileShaders(&storage, nullptr, kTag,
+                                                                       compile, &found));
+    REPORTER_ASSERT(reporter, numCompiles == 2);
+    REPORTER_ASSERT(reporter, storage.numLoads() == 2 && storage.numEntries() == 1);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "tests/Test.h"
+
+#if defined(SK_GRAPHITE)
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkSurface.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/gpu/graphite/Context.h"
+#include "include/gpu/graphite/Recorder.h"
+#include "src/gpu/graphite/ContextPriv.h"
+#include "src/gpu/graphite/GlobalCache.h"
+#include "src/gpu/graphite/PipelineKeyCollector.h"
+#include "src/gpu/graphite/PublicPrecompile.h"
+#include "src/gpu/graphite/RecorderPriv.h"
+
+using namespace skgpu::graphite;
+
+namespace {
+
+void draw_content(Recorder* recorder) {
+    SkImageInfo ii = SkImageInfo::MakeN32Premul(64, 64);
+    sk_sp<SkSurface> surface = SkSurface::MakeGraphite(recorder, ii);
+    SkCanvas* canvas = surface->getCanvas();
+
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeWH(32, 32), paint);
+    canvas->drawRRect(SkRRect::MakeOval(SkRect::MakeXYWH(16, 16, 32, 32)), paint);
+
+    const SkPoint pts[2] = {{0, 0}, {64, 64}};
+    const SkColor colors[2] = {SK_ColorBLUE, SK_ColorGREEN};
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kClamp));
+    canvas->drawCircle(32, 32, 20, paint);
+
+    // A concave path is stenciled before it is covered, so its pipelines need a stencil
+    // attachment.
+    SkPath star;
+    star.moveTo(32, 4);
+    star.lineTo(48, 60);
+    star.lineTo(4, 24);
+    star.lineTo(60, 24);
+    star.lineTo(16, 60);
+    star.close();
+    paint.setShader(nullptr);
+    canvas->drawPath(star, paint);
+}
+
+} // anonymous namespace
+
+DEF_GRAPHITE_TEST_FOR_ALL_CONTEXTS(PipelineKeyCollectorTest, reporter, context) {
+    GlobalCache* globalCache = context->priv().globalCache();
+    globalCache->resetGraphicsPipelines();
+
+    PipelineKeyCollector collector;
+    {
+        std::unique_ptr<Recorder> recorder = context->makeRecorder();
+        recorder->priv().setPipelineKeyCollector(&collector);
+        draw_content(recorder.get());
+        REPORTER_ASSERT(reporter, !recorder->snap());
+    }
+    // Collecting never compiles anything
+    REPORTER_ASSERT(reporter, collector.numPipelines() > 0);
+    REPORTER_ASSERT(reporter, collector.numSkippedPipelines() == 0);
+    REPORTER_ASSERT(reporter, globalCache->numGraphicsPipelines() == 0);
+
+    sk_sp<SkData> keys = collector.serialize();
+    std::vector<PipelineKeyCollector::Entry> entries;
+    REPORTER_ASSERT(reporter, PipelineKeyCollector::Deserialize(*keys, &entries));
+    REPORTER_ASSERT(reporter, static_cast<int>(entries.size()) == collector.numPipelines());
+    bool hasStencil = false;
+    for (const PipelineKeyCollector::Entry& entry : entries) {
+        hasStencil |= SkToBool(entry.fDepthStencilFlags & DepthStencilFlags::kStencil);
+    }
+    REPORTER_ASSERT(reporter, hasStencil);
+
+    REPORTER_ASSERT(reporter, Precompile(context, *keys));
+    const int numPrecompiled = globalCache->numGraphicsPipelines();
+    REPORTER_ASSERT(reporter, numPrecompiled > 0 && numPrecompiled <= collector.numPipelines());
+
+    // Drawing the same content for real shouldn't need any new pipelines, including the
+    // stencil ones
+    {
+        std::unique_ptr<Recorder> recorder = context->makeRecorder();
+        draw_content(recorder.get());
+        REPORTER_ASSERT(reporter, recorder->snap());
+    }
+    REPORTER_ASSERT(reporter, globalCache->numGraphicsPipelines() == numPrecompiled);
+
+    // Truncated or otherwise corrupted lists are rejected
+    sk_sp<SkData> truncated = SkData::MakeSubset(keys.get(), 0, keys->size() / 2);
+    REPORTER_ASSERT(reporter, !PipelineKeyCollector::Deserialize(*truncated, &entries));
+    REPORTER_ASSERT(reporter, !Precompile(context, *truncated));
+}
+
+#endif // SK_GRAPHITE
@@ -7,9 +7,16 @@
 
 #include "tests/Test.h"
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkSurface.h"
 #include "include/gpu/graphite/Context.h"
 #include "include/gpu/graphite/Recorder.h"
+#include "include/gpu/graphite/Recording.h"
+#include "src/gpu/graphite/Caps.h"
 #include "src/gpu/graphite/Device.h"
+#include "src/gpu/graphite/RecorderPriv.h"
 
 using namespace skgpu::graphite;
 using Mipmapped = skgpu::Mipmapped;
@@ -78,3 +85,108 @@ DEF_GRAPHITE_TEST_FOR_ALL_CONTEXTS(RecorderDevicePtrTest, reporter, context) {
     device1.reset();
     device3.reset();
 }
+
+// Disjoint draws that alternate between two paints should be sorted so that neither the pipeline
+// nor the paint uniforms are rebound for every draw.
+DEF_GRAPHITE_TEST_FOR_RENDERING_CONTEXTS(RecorderDrawPassStatsTest, reporter, context) {
+    std::unique_ptr<Recorder> recorder = context->makeRecorder();
+
+    SkImageInfo info = SkImageInfo::Make({256, 256}, kRGBA_8888_SkColorType, kPremul_SkAlphaType);
+    sk_sp<SkSurface> surface = SkSurface::MakeGraphite(recorder.get(), info);
+    if (!surface) {
+        ERRORF(reporter, "Surface creation failed");
+        return;
+    }
+    recorder->resetDrawPassStats();
+
+    static constexpr int kNumRects = 32 * 32;
+    SkCanvas* canvas = surface->getCanvas();
+    SkPaint paints[2];
+    paints[0].setColor(SK_ColorRED);
+    paints[1].setColor(SK_ColorBLUE);
+    for (int i = 0; i < kNumRects; ++i) {
+        canvas->drawRect(SkRect::MakeXYWH(8 * (i % 32), 8 * (i / 32), 6, 6), paints[i % 2]);
+    }
+    std::unique_ptr<Recording> recording = recorder->snap();
+
+    // Every rect is drawn by the single-step AnalyticRRect renderer, which takes no geometry
+    // uniforms or textures, and both paints share the solid color pipeline. The draws are
+    // disjoint, so they share a paint order and sort by their shading uniforms: those are bound
+    // once per color, or once in total when they are all in one storage buffer.
+    const int expectedUniformChanges = recorder->priv().caps()->storageBufferPreferred() ? 1 : 2;
+    const Recorder::DrawPassStats& stats = recorder->drawPassStats();
+    REPORTER_ASSERT(reporter, stats.fNumDrawPasses == 1, "%d", stats.fNumDrawPasses);
+    REPORTER_ASSERT(reporter, stats.fNumDrawSteps == kNumRects, "%d", stats.fNumDrawSteps);
+    REPORTER_ASSERT(reporter, stats.fNumCulledDraws == 0, "%d", stats.fNumCulledDraws);
+    REPORTER_ASSERT(reporter, stats.fPipelineChanges == 1, "%d", stats.fPipelineChanges);
+    REPORTER_ASSERT(reporter, stats.fUniformChanges == expectedUniformChanges,
+                    "%d", stats.fUniformChanges);
+    REPORTER_ASSERT(reporter, stats.fTextureChanges == 0, "%d", stats.fTextureChanges);
+
+    // A second snap with nothing new drawn adds nothing.
+    recording = recorder->snap();
+    REPORTER_ASSERT(reporter, recorder->drawPassStats().fNumDrawPasses == 1);
+}
+
+// Draws that a later opaque rect covers completely should be culled before the DrawPass is built,
+// without changing what is rendered.
+DEF_GRAPHITE_TEST_FOR_RENDERING_CONTEXTS(RecorderCullsOccludedDrawsTest, reporter, context) {
+    constexpr int kSize = 128;
+    const SkImageInfo info = SkImageInfo::Make(kSize, kSize, kRGBA_8888_SkColorType,
+                                               kPremul_SkAlphaType);
+
+    auto drawScene = [](SkCanvas* canvas) {
+        canvas->clear(SK_ColorWHITE);
+
+        // Only partially covered by the occluder, so it stays visible.
+        SkPaint visible;
+        visible.setColor(SK_ColorRED);
+        canvas->drawRect(SkRect::MakeLTRB(0, 0, 40, 40), visible);
+
+        // Entirely inside the occluder.
+        SkPaint hidden;
+        hidden.setAntiAlias(true);
+        hidden.setColor(SK_ColorGREEN);
+        canvas->drawCircle(64, 64, 24, hidden);
+        hidden.setColor(SK_ColorBLUE);
+        canvas->drawRect(SkRect::MakeLTRB(32, 48, 96, 80), hidden);
+        hidden.setColor(0x80FF00FF);
+        canvas->drawOval(SkRect::MakeLTRB(40, 32, 88, 96), hidden);
+
+        SkPaint occluder;
+        occluder.setColor(SK_ColorBLACK);
+        canvas->drawRect(SkRect::MakeLTRB(16, 16, 112, 112), occluder);
+    };
+
+    std::unique_ptr<Recorder> recorder = context->makeRecorder();
+    sk_sp<SkSurface> surface = SkSurface::MakeGraphite(recorder.get(), info);
+    if (!surface) {
+        ERRORF(reporter, "Surface creation failed");
+        return;
+    }
+    recorder->resetDrawPassStats();
+    drawScene(surface->getCanvas());
+
+    SkBitmap actual;
+    actual.allocPixels(info);
+    if (!surface->readPixels(actual.pixmap(), 0, 0)) {
+        ERRORF(reporter, "readPixels failed");
+        return;
+    }
+    const Recorder::DrawPassStats& stats = recorder->drawPassStats();
+    REPORTER_ASSERT(reporter, stats.fNumCulledDraws == 3, "%d", stats.fNumCulledDraws);
+
+    // Every remaining draw is pixel-aligned and non-AA, so the result matches raster exactly.
+    SkBitmap expected;
+    expected.allocPixels(info);
+    SkCanvas canvas(expected);
+    drawScene(&canvas);
+
+    int mismatches = 0;
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            mismatches += actual.getColor(x, y) != expected.getColor(x, y);
+        }
+    }
+    REPORTER_ASSERT(reporter, mismatches == 0, "%d pixels differ from raster", mismatches);
+}
@@ -7,21 +7,30 @@
 
 #include "tools/DDLTileHelper.h"
 
+#include "include/core/SkBBHFactory.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkDeferredDisplayListRecorder.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkSurfaceCharacterization.h"
+#include "include/core/SkTime.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/gpu/ganesh/SkImageGanesh.h"
 #include "src/base/SkRandom.h"
+#include "src/core/SkBigPicture.h"
 #include "src/core/SkDeferredDisplayListPriv.h"
+#include "src/core/SkPicturePriv.h"
 #include "src/core/SkTaskGroup.h"
+#include "src/core/SkTraceEvent.h"
 #include "src/gpu/ganesh/GrCaps.h"
 #include "src/gpu/ganesh/GrDirectContextPriv.h"
 #include "src/gpu/ganesh/image/SkImage_Ganesh.h"
 #include "tools/DDLPromiseImageHelper.h"
 
+#include <algorithm>
+#include <vector>
+
 void DDLTileHelper::TileData::init(int id,
                                    GrDirectContext* direct,
                                    const SkSurfaceCharacterization& dstSurfaceCharacterization,
@@ -47,6 +56,8 @@ DDLTileHelper::TileData::~TileData() {}
 
 void DDLTileHelper::TileData::createDDL(const SkPicture* picture) {
     SkASSERT(!fDisplayList && picture);
+    TRACE_EVENT1("skia.gpu", "DDLTileHelper::TileData::createDDL", "tile", fID);
+    const double start = SkTime::GetMSecs();
 
     auto recordingChar = fPlaybackChar.createResized(fClip.width(), fClip.height());
     SkASSERT(recordingChar.isValid());
@@ -66,6 +77,8 @@ void DDLTileHelper::TileData::createDDL(const SkPicture* picture) {
     recordingCanvas->drawPicture(picture);
 
     fDisplayList = recorder.detach();
+
+    fRecordTimeMs = SkTime::GetMSecs() - start;
 }
 
 void DDLTileHelper::createComposeDDL() {
@@ -153,6 +166,8 @@ void DDLTileHelper::TileData::drawSKPDirectly(GrDirectContext* dContext,
 
 void DDLTileHelper::TileData::draw(GrDirectContext* direct) {
     SkASSERT(fDisplayList && !fTileSurface);
+    TRACE_EVENT1("skia.gpu", "DDLTileHelper::TileData::draw", "tile", fID);
+    const double start = SkTime::GetMSecs();
 
     fTileSurface = this->makeWrappedTileDest(direct);
     if (fTileSurface) {
@@ -161,6 +176,8 @@ void DDLTileHelper::TileData::draw(GrDirectContext* direct) {
         // We can't snap an image here bc, since we're using wrapped backend textures for the
         // surfaces, that would incur a copy.
     }
+
+    fReplayTimeMs = SkTime::GetMSecs() - start;
 }
 
 void DDLTileHelper::TileData::reset() {
@@ -266,17 +283,65 @@ DDLTileHelper::DDLTileHelper(GrDirectContext* direct,
     }
 }
 
-void DDLTileHelper::createDDLsInParallel(SkPicture* picture) {
+void DDLTileHelper::computeRecordOrder(const SkPicture* picture) {
+    fRecordOrder.reset(this->numTiles());
+    for (int i = 0; i < this->numTiles(); ++i) {
+        fRecordOrder[i] = i;
+    }
+
+    if (fSchedulingPolicy == SchedulingPolicy::kRowMajor) {
+        return;
+    }
+
+    // The number of ops the picture's bounding box hierarchy places in a tile is used as a
+    // proxy for the tile's recording cost. Without a BBH all the tiles look the same.
+    const SkBigPicture* bigPicture = SkPicturePriv::AsSkBigPicture(sk_ref_sp(picture));
+    const SkBBoxHierarchy* bbh = bigPicture ? bigPicture->bbh() : nullptr;
+    if (!bbh) {
+        return;
+    }
+
+    skia_private::AutoTArray<int> costs(this->numTiles());
+    std::vector<int> ops;
+    for (int i = 0; i < this->numTiles(); ++i) {
+        ops.clear();
+        bbh->search(SkRect::Make(fTiles[i].clipRect()), &ops);
+        costs[i] = SkToInt(ops.size());
+    }
+
+    std::stable_sort(fRecordOrder.get(), fRecordOrder.get() + this->numTiles(), [&costs](int a, int b) {
+        return costs[a] > costs[b];
+    });
+}
+
+DDLTileHelper::TimingStats DDLTileHelper::timingStats() const {
+    TimingStats stats;
+    for (int i = 0; i < this->numTiles(); ++i) {
+        const TileData& tile = fTiles[i];
+        stats.fTotalRecordMs += tile.recordTimeMs();
+        stats.fMaxRecordMs = std::max(stats.fMaxRecordMs, tile.recordTimeMs());
+        stats.fTotalReplayMs += tile.replayTimeMs();
+        stats.fMaxReplayMs = std::max(stats.fMaxReplayMs, tile.replayTimeMs());
+    }
+    return stats;
+}
+
+void DDLTileHelper::createDDLsInParallel(SkPicture* picture, SkExecutor* executor) {
+    this->computeRecordOrder(picture);
+
 #if 1
-    SkTaskGroup().batch(this->numTiles(), [&](int i) {
-        fTiles[i].createDDL(picture);
+    SkTaskGroup recordingTaskGroup(executor ? *executor : SkExecutor::GetDefault());
+    recordingTaskGroup.batch(this->numTiles(), [&](int i) {
+        fTiles[fRecordOrder[i]].createDDL(picture);
     });
-    SkTaskGroup().add([this]{ this->createComposeDDL(); });
-    SkTaskGroup().wait();
+    // The compose DDL is only recorded once all the tiles have been.
+    recordingTaskGroup.wait();
+    recordingTaskGroup.add([this]{ this->createComposeDDL(); });
+    recordingTaskGroup.wait();
 #else
     // Use this code path to debug w/o threads
     for (int i = 0; i < this->numTiles(); ++i) {
-        fTiles[i].createDDL(picture);
+        fTiles[fRecordOrder[i]].createDDL(picture);
     }
     this->createComposeDDL();
 #endif
@@ -303,8 +368,10 @@ void DDLTileHelper::kickOffThreadedWork(SkTaskGroup* recordingTaskGroup,
                                         SkPicture* picture) {
     SkASSERT(recordingTaskGroup && gpuTaskGroup && dContext);
 
+    this->computeRecordOrder(picture);
+
     for (int i = 0; i < this->numTiles(); ++i) {
-        TileData* tile = &fTiles[i];
+        TileData* tile = &fTiles[fRecordOrder[i]];
         if (!tile->initialized()) {
             continue;
         }
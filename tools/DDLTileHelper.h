@@ -20,6 +20,7 @@ class PromiseImageCallbackContext;
 class SkCanvas;
 class SkData;
 class SkDeferredDisplayListRecorder;
+class SkExecutor;
 class SkImage;
 class SkPicture;
 class SkSurface;
@@ -28,6 +29,13 @@ class SkTaskGroup;
 
 class DDLTileHelper {
 public:
+    // The order in which the tiles are handed to the recording threads.
+    enum class SchedulingPolicy {
+        kRowMajor,         // tiles are recorded left-to-right, top-to-bottom
+        kCostliestFirst,   // tiles holding the most picture ops are recorded first so that the
+                           // expensive tiles don't end up as the tail of the recording work
+    };
+
     // The TileData class encapsulates the information and behavior of a single tile when
     // rendering with DDLs.
     class TileData {
@@ -71,6 +79,11 @@ public:
 
         SkDeferredDisplayList* ddl() { return fDisplayList.get(); }
 
+        // Wall-clock time spent in the last 'createDDL' and 'draw' calls for this tile. Both are
+        // also reported as trace events (tagged with the tile's id).
+        double recordTimeMs() const { return fRecordTimeMs; }
+        double replayTimeMs() const { return fReplayTimeMs; }
+
         sk_sp<SkImage> makePromiseImageForDst(sk_sp<GrContextThreadSafeProxy>);
         void dropCallbackContext() { fCallbackContext.reset(); }
 
@@ -98,6 +111,9 @@ public:
         sk_sp<SkSurface>              fTileSurface;
 
         sk_sp<SkDeferredDisplayList>  fDisplayList;
+
+        double                        fRecordTimeMs = 0;
+        double                        fReplayTimeMs = 0;
     };
 
     DDLTileHelper(GrDirectContext*,
@@ -106,12 +122,18 @@ public:
                   int numXDivisions, int numYDivisions,
                   bool addRandomPaddingToDst);
 
+    void setSchedulingPolicy(SchedulingPolicy policy) { fSchedulingPolicy = policy; }
+
     void kickOffThreadedWork(SkTaskGroup* recordingTaskGroup,
                              SkTaskGroup* gpuTaskGroup,
                              GrDirectContext*,
                              SkPicture*);
 
-    void createDDLsInParallel(SkPicture*);
+    // Record all the tile DDLs (and the compose DDL) on the threads of 'executor' - or on the
+    // default executor if none is supplied - and wait for them to complete. All the recorders
+    // share the destination's GrContextThreadSafeProxy so cached resources (e.g., the
+    // GrThreadSafeCache's views and vertex data) created for one tile are reused by the others.
+    void createDDLsInParallel(SkPicture*, SkExecutor* executor = nullptr);
 
     // Create the DDL that will compose all the tile images into a final result.
     void createComposeDDL();
@@ -132,16 +154,32 @@ public:
     void resetAllTiles();
 
     int numTiles() const { return fNumXDivisions * fNumYDivisions; }
+    const TileData& tile(int i) const { return fTiles[i]; }
+
+    // Sums of the per-tile recording and replay times along with the slowest single tile of each
+    struct TimingStats {
+        double fTotalRecordMs = 0;
+        double fMaxRecordMs = 0;
+        double fTotalReplayMs = 0;
+        double fMaxReplayMs = 0;
+    };
+    TimingStats timingStats() const;
 
     void createBackendTextures(SkTaskGroup*, GrDirectContext*);
     void deleteBackendTextures(SkTaskGroup*, GrDirectContext*);
 
 private:
+    // Fills in 'fRecordOrder' w/ the tile indices in the order dictated by 'fSchedulingPolicy'
+    void computeRecordOrder(const SkPicture*);
+
     int                                    fNumXDivisions; // number of tiles horizontally
     int                                    fNumYDivisions; // number of tiles vertically
     skia_private::AutoTArray<TileData>   fTiles;        // 'fNumXDivisions' x
     // 'fNumYDivisions'
 
+    SchedulingPolicy                       fSchedulingPolicy = SchedulingPolicy::kRowMajor;
+    skia_private::AutoTArray<int>          fRecordOrder;  // indices into 'fTiles'
+
     sk_sp<SkDeferredDisplayList>           fComposeDDL;
 
     const SkSurfaceCharacterization        fDstCharacterization;
@@ -84,6 +84,37 @@
     int64_t sk_tools::getCurrResidentSetSizeBytes() { return -1; }
 #endif
 
+#if defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_ANDROID)  // N.B. /proc is Linux-only.
+    bool sk_tools::resetPeakResidentSetSize() {
+        FILE* clearRefs = fopen("/proc/self/clear_refs", "w");
+        if (!clearRefs) {
+            return false;
+        }
+        // Writing 5 resets the peak resident set size (VmHWM) to the current one.
+        const bool reset = fputs("5", clearRefs) >= 0;
+        return (0 == fclose(clearRefs)) && reset;
+    }
+
+    int64_t sk_tools::getPeakResidentSetSizeBytes() {
+        FILE* status = fopen("/proc/self/status", "r");
+        if (!status) {
+            return -1;
+        }
+        long long hwmKB = -1;
+        char line[256];
+        while (fgets(line, sizeof(line), status)) {
+            if (1 == sscanf(line, "VmHWM: %lld kB", &hwmKB)) {
+                break;
+            }
+        }
+        fclose(status);
+        return hwmKB < 0 ? -1 : hwmKB * 1024;
+    }
+#else
+    bool sk_tools::resetPeakResidentSetSize() { return false; }
+    int64_t sk_tools::getPeakResidentSetSizeBytes() { return -1; }
+#endif
+
 int sk_tools::getMaxResidentSetSizeMB() {
     int64_t bytes = sk_tools::getMaxResidentSetSizeBytes();
     return bytes < 0 ? -1 : static_cast<int>(bytes / 1024 / 1024);
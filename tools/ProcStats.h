@@ -28,6 +28,18 @@ int64_t getCurrResidentSetSizeBytes();
  */
 int64_t getMaxResidentSetSizeBytes();
 
+/**
+ *  If implemented, resets the peak that getPeakResidentSetSizeBytes() reports to the current
+ *  resident set size, and returns true. If not, returns false.
+ */
+bool resetPeakResidentSetSize();
+
+/**
+ *  If implemented, returns the maximum resident set size in bytes since the last call to
+ *  resetPeakResidentSetSize(), or since the process started. If not, returns -1.
+ */
+int64_t getPeakResidentSetSizeBytes();
+
 /**
  *  If implemented, returns the maximum resident set size in MB.
  *  If not, returns -1.
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkSurface.h"
+#include "include/gpu/graphite/Context.h"
+#include "include/gpu/graphite/Recorder.h"
+#include "src/core/SkOSFile.h"
+#include "src/gpu/graphite/PipelineKeyCollector.h"
+#include "src/gpu/graphite/PublicPrecompile.h"
+#include "src/gpu/graphite/RecorderPriv.h"
+#include "src/utils/SkOSPath.h"
+#include "tools/flags/CommandLineFlags.h"
+#include "tools/graphite/ContextFactory.h"
+
+#include <cstdio>
+
+// Replays a corpus of SKPs through a Graphite Recorder in key collection mode and writes out the
+// distinct pipelines they need. Passing the list to skgpu::graphite::Precompile() at startup
+// compiles exactly those pipelines. No pipelines are compiled while collecting.
+
+static DEFINE_string2(skps, s, "skps", "A path to a directory of skps or a single skp.");
+static DEFINE_string2(out, o, "", "Path of the pipeline key list to write.");
+static DEFINE_string(backend, "metal", "Backend to collect pipelines for: metal, dawn or vulkan.");
+static DEFINE_bool(verify, false,
+                   "Precompile the collected list afterwards to check that it can be loaded.");
+
+using namespace skgpu::graphite;
+
+static bool collect_from_file(const SkString& path, Recorder* recorder) {
+    sk_sp<SkData> data = SkData::MakeFromFileName(path.c_str());
+    sk_sp<SkPicture> picture = data ? SkPicture::MakeFromData(data.get()) : nullptr;
+    if (!picture) {
+        fprintf(stderr, "Could not read %s.\n", path.c_str());
+        return false;
+    }
+
+    SkIRect bounds = picture->cullRect().roundOut();
+    SkImageInfo ii = SkImageInfo::MakeN32Premul(std::max(bounds.width(), 1),
+                                                std::max(bounds.height(), 1));
+    sk_sp<SkSurface> surface = SkSurface::MakeGraphite(recorder, ii);
+    if (!surface) {
+        fprintf(stderr, "Could not make a %dx%d surface for %s.\n",
+                ii.width(), ii.height(), path.c_str());
+        return false;
+    }
+    surface->getCanvas()->translate(-bounds.left(), -bounds.top());
+    surface->getCanvas()->drawPicture(picture);
+
+    // Always null in key collection mode; this reports the pipelines to the collector.
+    SkAssertResult(!recorder->snap());
+    return true;
+}
+
+int main(int argc, char** argv) {
+    CommandLineFlags::SetUsage(
+            "Usage: graphite_precompile_keys -s <dir of skps> -o <output file> "
+            "--backend <metal|dawn|vulkan> --verify\n");
+    CommandLineFlags::Parse(argc, argv);
+
+    if (FLAGS_skps.isEmpty() || FLAGS_out.isEmpty()) {
+        CommandLineFlags::PrintUsage();
+        return 1;
+    }
+
+    sk_gpu_test::GrContextFactory::ContextType contextType;
+    if (0 == strcmp(FLAGS_backend[0], "metal")) {
+        contextType = sk_gpu_test::GrContextFactory::kMetal_ContextType;
+    } else if (0 == strcmp(FLAGS_backend[0], "dawn")) {
+        contextType = sk_gpu_test::GrContextFactory::kDawn_ContextType;
+    } else if (0 == strcmp(FLAGS_backend[0], "vulkan")) {
+        contextType = sk_gpu_test::GrContextFactory::kVulkan_ContextType;
+    } else {
+        CommandLineFlags::PrintUsage();
+        return 1;
+    }
+
+    skiatest::graphite::ContextFactory factory;
+    auto [_, context] = factory.getContextInfo(contextType);
+    if (!context) {
+        fprintf(stderr, "Could not create a Graphite context for %s.\n", FLAGS_backend[0]);
+        return 2;
+    }
+
+    PipelineKeyCollector collector;
+    std::unique_ptr<Recorder> recorder = context->makeRecorder();
+    recorder->priv().setPipelineKeyCollector(&collector);
+
+    const char* inputs = FLAGS_skps[0];
+    int numFiles = 0;
+    if (sk_isdir(inputs)) {
+        SkOSFile::Iter iter(inputs, "skp");
+        for (SkString file; iter.next(&file); ) {
+            numFiles += collect_from_file(SkOSPath::Join(inputs, file.c_str()), recorder.get());
+        }
+    } else {
+        numFiles += collect_from_file(SkString(inputs), recorder.get());
+    }
+
+    sk_sp<SkData> keys = collector.serialize();
+    SkFILEWStream out(FLAGS_out[0]);
+    if (!out.isValid() || !out.write(keys->data(), keys->size())) {
+        fprintf(stderr, "Could not write %s.\n", FLAGS_out[0]);
+        return 3;
+    }
+    out.fsync();
+
+    printf("%d pipelines collected from %d skps, %d skipped because they use runtime effects.\n",
+           collector.numPipelines(), numFiles, collector.numSkippedPipelines());
+
+    if (FLAGS_verify && !Precompile(context, *keys)) {
+        fprintf(stderr, "Could not precompile the collected pipelines.\n");
+        return 4;
+    }
+    return 0;
+}